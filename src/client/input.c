@@ -45,6 +45,39 @@ void input_to_uppercase(char *str)
     }
 }
 
+/*
+ * Separa una línea con varios comandos ("STOP 10; STOP 11") en su lugar:
+ * reemplaza cada ';' por '\0', recorta los espacios de cada comando y
+ * descarta los vacíos. Función pura: no depende de ncurses.
+ */
+int input_split_commands(char *line, char **cmds, int max)
+{
+    int count = 0;
+    char *p = line;
+
+    if (!line || !cmds) {
+        return 0;
+    }
+    while (p) {
+        char *sep = strchr(p, ';');
+        if (sep) {
+            *sep = '\0';
+        }
+        while (*p == ' ') {
+            p++;
+        }
+        size_t len = strlen(p);
+        while (len > 0 && p[len - 1] == ' ') {
+            p[--len] = '\0';
+        }
+        if (len > 0 && count < max) {
+            cmds[count++] = p;
+        }
+        p = sep ? sep + 1 : NULL;
+    }
+    return count;
+}
+
 /*
  * Genera el prompt con formato "remote@{IP}:{PUERTO}> ".
  * Función pura: no depende de ncurses, facilita testing.
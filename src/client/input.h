@@ -45,4 +45,12 @@ void input_format_prompt(char *buf, int buf_size, const char *ip, int port);
  */
 void input_to_uppercase(char *str);
 
+/*
+ * Separa una línea de comandos encadenados con ';' (in-place).
+ * Guarda en cmds hasta max comandos, sin espacios al principio ni al
+ * final y sin los vacíos, y retorna cuántos encontró.
+ * Función pura expuesta para testing.
+ */
+int input_split_commands(char *line, char **cmds, int max);
+
 #endif /* INPUT_H */
@@ -1,7 +1,22 @@
 #include "net.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <errno.h>
+
+#ifdef MSG_NOSIGNAL
+    #define SEND_FLAGS MSG_NOSIGNAL  /* Servidor caído: error en vez de SIGPIPE */
+#else
+    #define SEND_FLAGS 0
+#endif
+
+/* Una señal (SIGWINCH al redimensionar la terminal) cortó la llamada: reintentar */
+#ifdef _WIN32
+    #define INTERRUPTED() 0
+#else
+    #define INTERRUPTED() (errno == EINTR)
+#endif
 
 int net_init_platform(void) {
 #ifdef _WIN32
@@ -54,47 +69,532 @@ int net_send(SOCKET sock, const char *cmd) {
     if (sock == INVALID_SOCKET || cmd == NULL) {
         return -1;
     }
-    int len = (int)strlen(cmd);
-    int sent = send(sock, cmd, len, 0);
-    if (sent < 0) {
+    size_t len = strlen(cmd);
+    if (net_send_all(sock, cmd, len) != 0) {
         return -1;
     }
-    return sent;
+    return (int)len;
 }
 
-int net_recv(SOCKET sock, char *buf, int buf_size) {
-    if (sock == INVALID_SOCKET || buf == NULL || buf_size <= 0) {
-        return -1;
-    }
+/* Reloj monotónico en milisegundos para los timeouts de recepción. */
+static long now_ms(void) {
+#ifdef _WIN32
+    return (long)GetTickCount();
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec * 1000L + tv.tv_usec / 1000;
+#endif
+}
+
+/* Reloj en microsegundos para medir la descompresión. */
+static long long now_us(void) {
+#ifdef _WIN32
+    return (long long)GetTickCount() * 1000;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (long long)tv.tv_sec * 1000000 + tv.tv_usec;
+#endif
+}
 
+/* Espera hasta timeout_ms a que el socket sea legible. 1 = legible. */
+static int wait_readable(SOCKET sock, int timeout_ms) {
     fd_set read_fds;
     struct timeval tv;
+    int ready;
 
-    FD_ZERO(&read_fds);
-    FD_SET(sock, &read_fds);
+    do {
+        FD_ZERO(&read_fds);
+        FD_SET(sock, &read_fds);
+        tv.tv_sec = timeout_ms / 1000;
+        tv.tv_usec = (timeout_ms % 1000) * 1000;
+        ready = select((int)sock + 1, &read_fds, NULL, NULL, &tv);
+    } while (ready < 0 && INTERRUPTED());
+    if (ready < 0) {
+        return -1;
+    }
+    return ready > 0;
+}
 
-    /* Zero timeout for non-blocking check */
-    tv.tv_sec = 0;
-    tv.tv_usec = 0;
+int net_send_all(SOCKET sock, const char *data, size_t len) {
+    size_t off = 0;
+    while (off < len) {
+        int sent = send(sock, data + off, (int)(len - off), SEND_FLAGS);
+        if (sent < 0 && INTERRUPTED()) {
+            continue;
+        }
+        if (sent <= 0) {
+            return -1; /* Error, o SO_SNDTIMEO vencido con el servidor sin leer */
+        }
+        off += (size_t)sent;
+    }
+    return 0;
+}
 
-    int ready = select((int)sock + 1, &read_fds, NULL, NULL, &tv);
-    if (ready < 0) {
+/* Asegura que buf tenga al menos `extra` bytes libres (más el '\0'). */
+static int grow(char **buf, size_t *cap, size_t used, size_t extra) {
+    if (*cap - used >= extra + 1) {
+        return 0;
+    }
+    size_t new_cap = *cap ? *cap : NET_BUFFER_SIZE;
+    while (new_cap - used < extra + 1) {
+        new_cap *= 2;
+    }
+    char *tmp = realloc(*buf, new_cap);
+    if (!tmp) {
         return -1;
     }
-    if (ready == 0) {
-        return 0; /* No data available */
+    *buf = tmp;
+    *cap = new_cap;
+    return 0;
+}
+
+void net_reader_init(NetReader *rd) {
+    memset(rd, 0, sizeof(*rd));
+}
+
+void net_reader_free(NetReader *rd) {
+    free(rd->buf);
+    free(rd->msg);
+    free(rd->raw);
+    memset(rd, 0, sizeof(*rd));
+}
+
+/* Primer byte recibido y aún no consumido. */
+static char *reader_data(const NetReader *rd) {
+    return rd->buf + rd->start;
+}
+
+/*
+ * Hace un recv() y agrega lo leído al buffer. Retorna los bytes leídos,
+ * 0 si lo interrumpió una señal, -1 si la conexión cayó.
+ */
+static int reader_fill(SOCKET sock, NetReader *rd) {
+    /*
+     * Lo pendiente son pocos bytes (los frames se copian al mensaje a
+     * medida que llegan): se mueve al principio solo si al final no
+     * queda lugar para otro recv
+     */
+    if (rd->start > 0 && rd->cap - rd->start - rd->len < NET_BUFFER_SIZE + 1) {
+        memmove(rd->buf, reader_data(rd), rd->len);
+        rd->start = 0;
+    }
+    if (grow(&rd->buf, &rd->cap, rd->start + rd->len, NET_BUFFER_SIZE) != 0) {
+        return -1;
+    }
+    int received = recv(sock, reader_data(rd) + rd->len, NET_BUFFER_SIZE, 0);
+    if (received < 0 && INTERRUPTED()) {
+        return 0;
+    }
+    if (received <= 0) {
+        return -1; /* Error o conexión cerrada por el servidor */
+    }
+    rd->len += (size_t)received;
+    return received;
+}
+
+/* Descarta los primeros n bytes pendientes (sin mover el resto). */
+static void reader_consume(NetReader *rd, size_t n) {
+    rd->start += n;
+    rd->len -= n;
+    if (rd->len == 0) {
+        rd->start = 0;
     }
+}
+
+/* Lee el resto de un largo cuyo nibble quedó en 15. -1 si se corta. */
+static int lz_length(const unsigned char **p, const unsigned char *end, size_t *n) {
+    unsigned char b;
+    do {
+        if (*p >= end) {
+            return -1;
+        }
+        b = *(*p)++;
+        *n += b;
+    } while (b == 255);
+    return 0;
+}
+
+int net_decompress_block(const unsigned char *src, size_t len,
+                         unsigned char *dst, size_t raw) {
+    const unsigned char *end = src + len;
+    size_t out = 0;
 
-    int received = recv(sock, buf, buf_size - 1, 0);
-    if (received < 0) {
+    while (src < end) {
+        unsigned char token = *src++;
+        size_t nlit = token >> 4;
+        size_t mlen = token & 15;
+
+        if (nlit == 15 && lz_length(&src, end, &nlit) != 0) {
+            return -1;
+        }
+        if ((size_t)(end - src) < nlit || raw - out < nlit) {
+            return -1;
+        }
+        memcpy(dst + out, src, nlit);
+        src += nlit;
+        out += nlit;
+        if (src == end) {
+            break; /* La última secuencia solo lleva literales */
+        }
+
+        if (end - src < 2) {
+            return -1;
+        }
+        size_t offset = (size_t)src[0] | ((size_t)src[1] << 8);
+        src += 2;
+        if (mlen == 15 && lz_length(&src, end, &mlen) != 0) {
+            return -1;
+        }
+        mlen += 4;
+        if (offset == 0 || offset > out || raw - out < mlen) {
+            return -1;
+        }
+        if (offset >= mlen) {
+            memcpy(dst + out, dst + out - offset, mlen);
+        } else {
+            /* Byte a byte: el match se solapa con lo que copia (rachas) */
+            for (size_t i = 0; i < mlen; i++) {
+                dst[out + i] = dst[out - offset + i];
+            }
+        }
+        out += mlen;
+    }
+    return out == raw ? 0 : -1;
+}
+
+/*
+ * Reemplaza el mensaje comprimido por su contenido. Retorna 0 si OK, -1
+ * si está corrupto o falta memoria.
+ */
+static int reader_unpack(NetReader *rd) {
+    const unsigned char *p = (const unsigned char *)rd->msg;
+    if (rd->msg_len < 4) {
         return -1;
     }
-    if (received == 0) {
-        return -1; /* Connection closed by peer */
+    size_t raw = ((size_t)p[0] << 24) | ((size_t)p[1] << 16) |
+                 ((size_t)p[2] << 8) | (size_t)p[3];
+    if (raw > NET_FRAME_MAX_PAYLOAD || grow(&rd->raw, &rd->raw_cap, 0, raw) != 0) {
+        return -1;
     }
 
-    buf[received] = '\0';
-    return received;
+    long long t0 = now_us();
+    if (net_decompress_block(p + 4, rd->msg_len - 4, (unsigned char *)rd->raw, raw) != 0) {
+        return -1;
+    }
+    rd->unpack_us += now_us() - t0;
+    rd->unpacked++;
+    rd->packed_bytes += rd->msg_len;
+    rd->raw_bytes += raw;
+
+    /* Intercambiar los buffers: el descomprimido pasa a ser el mensaje */
+    char *tmp = rd->msg;
+    size_t tmp_cap = rd->msg_cap;
+    rd->msg = rd->raw;
+    rd->msg_cap = rd->raw_cap;
+    rd->raw = tmp;
+    rd->raw_cap = tmp_cap;
+    rd->msg_len = raw;
+    rd->msg[raw] = '\0';
+    return 0;
+}
+
+/*
+ * Intenta completar un mensaje con lo que hay en el buffer. Los frames
+ * se copian al mensaje a medida que llegan, aunque estén incompletos,
+ * así el buffer de recepción no crece con el tamaño de las respuestas.
+ * Retorna 1 si msg quedó completo, 0 si falta data, -1 si el flujo
+ * está corrupto.
+ */
+static int reader_extract(NetReader *rd) {
+    if (!rd->framed) {
+        /* Modo texto: se entregan las líneas completas recibidas */
+        size_t n = rd->len;
+        while (n > 0 && reader_data(rd)[n - 1] != '\n') {
+            n--;
+        }
+        if (n == 0) {
+            return 0;
+        }
+        if (grow(&rd->msg, &rd->msg_cap, 0, n) != 0) {
+            return -1;
+        }
+        memcpy(rd->msg, reader_data(rd), n);
+        rd->msg_len = n;
+        rd->msg[rd->msg_len] = '\0';
+        rd->msg_type = NET_FRAME_RESP;
+        reader_consume(rd, n);
+        return 1;
+    }
+
+    for (;;) {
+        if (!rd->frame_open) {
+            if (rd->len < NET_FRAME_HEADER_SIZE) {
+                return 0;
+            }
+            const unsigned char *h = (const unsigned char *)reader_data(rd);
+            size_t plen = ((size_t)h[0] << 24) | ((size_t)h[1] << 16) |
+                          ((size_t)h[2] << 8) | (size_t)h[3];
+            if (plen > NET_FRAME_MAX_PAYLOAD || h[4] == 0 || h[6] != 0 || h[7] != 0 ||
+                rd->msg_len + plen > NET_FRAME_MAX_PAYLOAD) {
+                return -1;
+            }
+            rd->msg_type = h[4];
+            rd->msg_packed |= h[5] & NET_FRAME_F_COMPRESSED;
+            rd->frame_last = !(h[5] & NET_FRAME_F_MORE);
+            rd->frame_left = plen;
+            rd->frame_open = 1;
+            reader_consume(rd, NET_FRAME_HEADER_SIZE);
+        }
+
+        size_t n = rd->len < rd->frame_left ? rd->len : rd->frame_left;
+        if (grow(&rd->msg, &rd->msg_cap, rd->msg_len, n) != 0) {
+            return -1;
+        }
+        memcpy(rd->msg + rd->msg_len, reader_data(rd), n);
+        rd->msg_len += n;
+        rd->msg[rd->msg_len] = '\0';
+        rd->frame_left -= n;
+        reader_consume(rd, n);
+        if (rd->frame_left > 0) {
+            return 0; /* Frame incompleto: esperar más datos */
+        }
+        rd->frame_open = 0;
+        if (rd->frame_last) {
+            break;
+        }
+    }
+
+    if (rd->msg_packed) {
+        rd->msg_packed = 0;
+        if (reader_unpack(rd) != 0) {
+            return -1;
+        }
+    }
+    return 1;
+}
+
+int net_recv_msg(SOCKET sock, NetReader *rd, int timeout_ms,
+                 const char **msg, int *len) {
+    if (sock == INVALID_SOCKET || rd == NULL) {
+        return -1;
+    }
+
+    /* El mensaje entregado en la llamada anterior ya no se necesita */
+    if (rd->msg_ready) {
+        rd->msg_len = 0;
+        rd->msg_ready = 0;
+    }
+
+    long deadline = now_ms() + timeout_ms;
+    int r = reader_extract(rd);
+
+    while (r == 0) {
+        long remaining = deadline - now_ms();
+        if (remaining < 0) {
+            remaining = 0;
+        }
+        int ready = wait_readable(sock, (int)remaining);
+        if (ready < 0) {
+            return -1;
+        }
+        if (ready == 0) {
+            return 0; /* Sin mensaje completo todavía */
+        }
+        if (reader_fill(sock, rd) < 0) {
+            return -1;
+        }
+        r = reader_extract(rd);
+    }
+    if (r < 0) {
+        return -1;
+    }
+
+    rd->msg_ready = 1;
+    *msg = rd->msg;
+    *len = (int)rd->msg_len;
+    return 1;
+}
+
+int net_recv_reply(SOCKET sock, NetReader *rd, int timeout_ms,
+                   NetEventFn on_event, void *ctx,
+                   const char **msg, int *len) {
+    long deadline = now_ms() + timeout_ms;
+
+    for (;;) {
+        long remaining = deadline - now_ms();
+        if (remaining < 0) {
+            remaining = 0;
+        }
+        int r = net_recv_msg(sock, rd, (int)remaining, msg, len);
+        if (r <= 0 || rd->msg_type != NET_FRAME_EVENT) {
+            return r;
+        }
+        if (on_event) {
+            on_event(ctx, *msg, *len);
+        }
+    }
+}
+
+/* Escribe un comando en p: con '\n' en modo texto o como frame NET_FRAME_CMD. */
+static size_t put_cmd(char *p, int framed, const char *cmd, size_t len) {
+    if (!framed) {
+        memcpy(p, cmd, len);
+        p[len] = '\n';
+        return len + 1;
+    }
+    unsigned char *hdr = (unsigned char *)p;
+    hdr[0] = (unsigned char)(len >> 24);
+    hdr[1] = (unsigned char)(len >> 16);
+    hdr[2] = (unsigned char)(len >> 8);
+    hdr[3] = (unsigned char)len;
+    hdr[4] = NET_FRAME_CMD;
+    hdr[5] = 0;
+    hdr[6] = 0;
+    hdr[7] = 0;
+    memcpy(p + NET_FRAME_HEADER_SIZE, cmd, len);
+    return NET_FRAME_HEADER_SIZE + len;
+}
+
+int net_send_cmds(SOCKET sock, const NetReader *rd, const char *const *cmds, int count) {
+    if (sock == INVALID_SOCKET || cmds == NULL || count <= 0) {
+        return -1;
+    }
+    int framed = rd != NULL && rd->framed;
+    size_t total = 0;
+    for (int i = 0; i < count; i++) {
+        if (cmds[i] == NULL) {
+            return -1;
+        }
+        total += strlen(cmds[i]) + (framed ? NET_FRAME_HEADER_SIZE : 1);
+    }
+
+    char *out = malloc(total);
+    if (!out) {
+        return -1;
+    }
+    size_t used = 0;
+    for (int i = 0; i < count; i++) {
+        used += put_cmd(out + used, framed, cmds[i], strlen(cmds[i]));
+    }
+    int res = net_send_all(sock, out, used);
+    free(out);
+    return res;
+}
+
+int net_send_cmd(SOCKET sock, const NetReader *rd, const char *cmd) {
+    return net_send_cmds(sock, rd, &cmd, 1);
+}
+
+/*
+ * Espera la primera línea de una respuesta de texto (antes de pasar al
+ * modo enmarcado). Retorna 1 y su largo (sin '\n') en *line_len, 0 si
+ * no llegó a tiempo, -1 si se perdió la conexión. No la consume.
+ */
+static int reader_text_line(SOCKET sock, NetReader *rd, int timeout_ms, size_t *line_len) {
+    long deadline = now_ms() + timeout_ms;
+    char *nl = rd->len ? memchr(reader_data(rd), '\n', rd->len) : NULL;
+
+    while (nl == NULL) {
+        long remaining = deadline - now_ms();
+        if (remaining <= 0) {
+            return 0;
+        }
+        int ready = wait_readable(sock, (int)remaining);
+        if (ready < 0) {
+            return -1;
+        }
+        if (ready == 0) {
+            return 0;
+        }
+        if (reader_fill(sock, rd) < 0) {
+            return -1;
+        }
+        nl = memchr(reader_data(rd), '\n', rd->len);
+    }
+    *line_len = (size_t)(nl - reader_data(rd));
+    return 1;
+}
+
+/* Descarta una respuesta de error completa de un servidor antiguo. */
+static int reader_drain_text(SOCKET sock, NetReader *rd) {
+    reader_consume(rd, rd->len);
+    while (wait_readable(sock, 100) > 0) {
+        if (reader_fill(sock, rd) < 0) {
+            return -1;
+        }
+        reader_consume(rd, rd->len);
+    }
+    return 0;
+}
+
+int net_negotiate_framing(SOCKET sock, NetReader *rd, int timeout_ms) {
+    size_t line_len;
+
+    if (net_send_cmd(sock, rd, "FRAMED") != 0) {
+        return -1;
+    }
+
+    /* La confirmación llega en texto */
+    int r = reader_text_line(sock, rd, timeout_ms, &line_len);
+    if (r <= 0) {
+        return r;
+    }
+    if (strncmp(reader_data(rd), "OK FRAMED", 9) == 0) {
+        reader_consume(rd, line_len + 1);
+        rd->framed = 1;
+        return 1;
+    }
+
+    /* Servidor antiguo: descartar su mensaje de error completo */
+    return reader_drain_text(sock, rd) < 0 ? -1 : 0;
+}
+
+int net_hello(SOCKET sock, NetReader *rd, int version, const char *caps, int timeout_ms) {
+    char cmd[256];
+    char line[256];
+    size_t line_len;
+
+    snprintf(cmd, sizeof(cmd), "HELLO %d %s", version, caps);
+    if (net_send_cmd(sock, rd, cmd) != 0) {
+        return -1;
+    }
+
+    /* La respuesta llega en texto aunque se acepte FRAMED */
+    int r = reader_text_line(sock, rd, timeout_ms, &line_len);
+    if (r <= 0) {
+        return r;
+    }
+    if (strncmp(reader_data(rd), "OK HELLO ", 9) != 0) {
+        return reader_drain_text(sock, rd) < 0 ? -1 : 0;
+    }
+
+    snprintf(line, sizeof(line), "%.*s", (int)line_len, reader_data(rd));
+    reader_consume(rd, line_len + 1);
+    line[strcspn(line, "\r")] = '\0';
+
+    /* OK HELLO <versión> [<capacidad>,...] */
+    const char *p = line + 9;
+    rd->version = atoi(p);
+    rd->caps = 0;
+    p = strchr(p, ' ');
+    while (p && *p) {
+        p += strspn(p, " ,");
+        size_t n = strcspn(p, ",= ");
+        if (n == 6 && strncmp(p, "FRAMED", n) == 0) {
+            rd->caps |= NET_CAP_FRAMED;
+        } else if (n == 6 && strncmp(p, "BINARY", n) == 0) {
+            rd->caps |= NET_CAP_BINARY;
+        } else if (n == 2 && strncmp(p, "LZ", n) == 0) {
+            rd->caps |= NET_CAP_LZ;
+        } else if (n == 4 && strncmp(p, "PUSH", n) == 0) {
+            rd->caps |= NET_CAP_PUSH;
+        }
+        p += strcspn(p, ",");
+    }
+    rd->framed = (rd->caps & NET_CAP_FRAMED) != 0;
+    return 1;
 }
 
 void net_close(SOCKET sock) {
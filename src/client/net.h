@@ -16,16 +16,152 @@
     #define close_socket close
 #endif
 
+#include <stddef.h>
+
 #define NET_BUFFER_SIZE 65536
 
+/*
+ * Protocolo enmarcado (modo FRAMED), negociado al conectar.
+ * Cabecera de 8 bytes: longitud del payload (4, big-endian), tipo (1),
+ * flags (1) y 2 bytes reservados. El servidor envía cada mensaje en un
+ * solo frame y no acepta comandos con NET_FRAME_F_MORE (reservado; el
+ * lector igual concatena los frames que lo lleven). Con COMPRESS
+ * LZ, los mensajes grandes llegan con NET_FRAME_F_COMPRESSED: el payload
+ * es el largo original (4 bytes, big-endian) y un bloque LZ (ver
+ * src/server/compress.h), que el lector descomprime antes de entregarlo.
+ */
+#define NET_FRAME_HEADER_SIZE 8
+#define NET_FRAME_MAX_PAYLOAD (64u * 1024 * 1024)
+#define NET_FRAME_CMD         1
+#define NET_FRAME_RESP        2
+#define NET_FRAME_EVENT       3   /* Cambios enviados por el servidor (SUBSCRIBE) */
+#define NET_FRAME_F_MORE      0x01
+#define NET_FRAME_F_COMPRESSED 0x02
+
+/*
+ * Saludo (HELLO): versión del protocolo que habla el cliente y
+ * capacidades que puede activar el servidor en la conexión.
+ */
+#define NET_PROTO_VERSION     1
+#define NET_CAP_FRAMED        0x01    /* Mensajes enmarcados */
+#define NET_CAP_BINARY        0x02    /* Tablas en binario (ENCODING BINARY) */
+#define NET_CAP_LZ            0x04    /* Respuestas grandes comprimidas */
+#define NET_CAP_PUSH          0x08    /* Cambios enviados como eventos (SUBSCRIBE) */
+
+/*
+ * Estado de recepción de una conexión: acumula bytes recibidos y
+ * reensambla mensajes completos aunque lleguen partidos en varios recv().
+ * Los bytes pendientes empiezan en buf + start: consumir solo avanza
+ * start, y lo que queda se mueve al principio cuando hace falta lugar
+ * para otro recv(). Los frames se copian al mensaje a medida que llegan,
+ * así que buf no crece con el tamaño de las respuestas.
+ */
+typedef struct {
+    int framed;         /* 1 si el servidor aceptó el modo FRAMED */
+    int version;        /* Versión acordada con HELLO (0 = servidor sin HELLO) */
+    unsigned int caps;  /* Capacidades aceptadas con HELLO (NET_CAP_*) */
+    char *buf;          /* Bytes recibidos aún no consumidos */
+    size_t start;       /* Inicio de los pendientes en buf */
+    size_t len;         /* Bytes pendientes desde start */
+    size_t cap;
+    int frame_open;     /* Cabecera leída, payload del frame en curso */
+    int frame_last;     /* El frame en curso cierra el mensaje */
+    size_t frame_left;  /* Bytes del payload que faltan recibir */
+    char *msg;          /* Último mensaje completo ('\0' al final) */
+    size_t msg_len;
+    size_t msg_cap;
+    int msg_type;
+    int msg_ready;      /* 1 si msg contiene un mensaje ya entregado */
+    int msg_packed;     /* Algún frame del mensaje en curso venía comprimido */
+    char *raw;          /* Buffer para descomprimir (se intercambia con msg) */
+    size_t raw_cap;
+    /* Mensajes comprimidos recibidos */
+    unsigned long unpacked;
+    unsigned long long packed_bytes;    /* Bytes que ocuparon en la red */
+    unsigned long long raw_bytes;       /* Bytes ya descomprimidos */
+    long long unpack_us;                /* Tiempo descomprimiendo */
+} NetReader;
+
 /* Connects to the server. Returns socket or INVALID_SOCKET on error. */
 SOCKET net_connect(const char *ip, int port);
 
 /* Sends a command string to the server. Returns bytes sent or -1 on error. */
 int net_send(SOCKET sock, const char *cmd);
 
-/* Non-blocking receive using select(). Returns bytes read, 0 if no data, -1 on error. */
-int net_recv(SOCKET sock, char *buf, int buf_size);
+/*
+ * Envía los len bytes completos: reintenta los envíos parciales y los
+ * interrumpidos por una señal. Retorna 0 si OK, -1 si la conexión cayó
+ * o el servidor no leyó nada durante el timeout de envío.
+ */
+int net_send_all(SOCKET sock, const char *data, size_t len);
+
+/* Inicializa el lector (modo texto). */
+void net_reader_init(NetReader *rd);
+
+/* Libera la memoria del lector. */
+void net_reader_free(NetReader *rd);
+
+/*
+ * Negocia el modo FRAMED enviando "FRAMED". Si el servidor responde
+ * "OK FRAMED" el lector pasa a modo enmarcado; con un servidor antiguo
+ * se queda en modo texto. Retorna 1 si quedó enmarcado, 0 si texto,
+ * -1 si se perdió la conexión.
+ */
+int net_negotiate_framing(SOCKET sock, NetReader *rd, int timeout_ms);
+
+/*
+ * Saludo HELLO: propone la versión y las capacidades separadas por comas
+ * ("FRAMED,BINARY,LZ,PUSH"). El servidor responde en texto
+ * "OK HELLO <versión> <aceptadas>"; las aceptadas quedan en rd->caps y,
+ * si incluyen FRAMED, el lector pasa a modo enmarcado. Retorna 1 si el
+ * servidor conoce HELLO, 0 si no (sigue en texto, sin nada activado),
+ * -1 si se perdió la conexión.
+ */
+int net_hello(SOCKET sock, NetReader *rd, int version, const char *caps, int timeout_ms);
+
+/*
+ * Envía un comando. En modo texto agrega '\n'; en modo enmarcado lo
+ * envía como un frame NET_FRAME_CMD. Retorna 0 si OK, -1 en error.
+ */
+int net_send_cmd(SOCKET sock, const NetReader *rd, const char *cmd);
+
+/*
+ * Envía varios comandos en un solo envío, sin esperar respuestas entre
+ * ellos. El servidor los ejecuta en orden y responde uno por uno, así
+ * que el llamador recibe después `count` respuestas (net_recv_reply) en
+ * el mismo orden. Retorna 0 si OK, -1 en error.
+ */
+int net_send_cmds(SOCKET sock, const NetReader *rd, const char *const *cmds, int count);
+
+/*
+ * Espera hasta timeout_ms (0 = sin esperar) por un mensaje completo.
+ * En modo enmarcado reensambla frames de forma incremental; en modo
+ * texto entrega las líneas completas recibidas hasta el momento.
+ * Retorna 1 y deja el mensaje en *msg / *len (válido hasta la siguiente
+ * llamada), 0 si aún no hay mensaje completo, -1 si se perdió la conexión.
+ */
+int net_recv_msg(SOCKET sock, NetReader *rd, int timeout_ms,
+                 const char **msg, int *len);
+
+/*
+ * Descomprime un bloque LZ (sin la cabecera de largo) en dst, que debe
+ * tener exactamente raw bytes. Retorna 0 si OK, -1 si el bloque está
+ * corrupto o no da raw bytes.
+ */
+int net_decompress_block(const unsigned char *src, size_t len,
+                         unsigned char *dst, size_t raw);
+
+/* Recibe un evento que llegó mientras se esperaba una respuesta. */
+typedef void (*NetEventFn)(void *ctx, const char *msg, int len);
+
+/*
+ * Como net_recv_msg, pero espera la respuesta a un comando: los eventos
+ * (NET_FRAME_EVENT) que lleguen antes se pasan a on_event (si no es
+ * NULL) y se sigue esperando dentro del mismo timeout.
+ */
+int net_recv_reply(SOCKET sock, NetReader *rd, int timeout_ms,
+                   NetEventFn on_event, void *ctx,
+                   const char **msg, int *len);
 
 /* Closes the socket connection. */
 void net_close(SOCKET sock);
@@ -253,3 +253,44 @@ int scroll_clamp(int current_offset, int delta,
     return new_offset;
 }
 
+/*
+ * Decide si hay que pedir otra ventana de la lista al servidor.
+ *
+ * Se necesita lo visible más media página de margen a cada lado (sin
+ * salir de [0, total_entries)); si lo descargado no lo cubre se pide
+ * una ventana de tres páginas centrada en lo visible.
+ */
+int page_window(int scroll_offset, int visible_height, int total_entries,
+                int loaded_offset, int loaded_count, int *offset, int *limit)
+{
+    int margin;
+    int want_from;
+    int want_to;
+
+    if (visible_height < 1) {
+        visible_height = 1;
+    }
+    margin = (visible_height + 1) / 2;
+
+    /* Ventana a pedir */
+    *offset = scroll_offset - visible_height;
+    if (*offset < 0) {
+        *offset = 0;
+    }
+    *limit = 3 * visible_height;
+
+    /* Filas que deberían estar descargadas */
+    want_from = scroll_offset - margin;
+    if (want_from < 0) {
+        want_from = 0;
+    }
+    want_to = scroll_offset + visible_height + margin;
+    if (want_to > total_entries) {
+        want_to = total_entries;
+    }
+    if (want_from >= want_to) {
+        return 0;
+    }
+
+    return want_from < loaded_offset || want_to > loaded_offset + loaded_count;
+}
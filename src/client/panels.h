@@ -51,4 +51,23 @@ void panels_calc_dimensions(int lines, int cols,
 int scroll_clamp(int current_offset, int delta,
                  int total_entries, int visible_height);
 
+/*
+ * Decide si hay que pedir otra ventana de la lista al servidor.
+ * Función pura expuesta para testing.
+ *
+ * Parámetros:
+ *   scroll_offset  - primera fila visible (índice en la lista completa)
+ *   visible_height - filas visibles en el panel (H)
+ *   total_entries  - filas de la lista completa en el servidor (N)
+ *   loaded_offset  - índice de la primera fila descargada
+ *   loaded_count   - filas descargadas
+ *   offset, limit  - ventana alrededor de lo visible: la página anterior,
+ *                    la visible y la siguiente (siempre se completan)
+ *
+ * Retorna 1 si a lo visible le falta media página de margen descargado
+ * (así la siguiente llega antes de hacer falta), 0 si alcanza.
+ */
+int page_window(int scroll_offset, int visible_height, int total_entries,
+                int loaded_offset, int loaded_count, int *offset, int *limit);
+
 #endif /* PANELS_H */
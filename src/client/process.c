@@ -7,6 +7,78 @@
 #include "colors.h"
 
 #define INITIAL_CAPACITY 32
+#define PROC_METRICS_WIDTH 45  /* Margen y columnas antes del nombre */
+
+/*
+ * Lee un entero con signo opcional entre *s y end, saltando espacios
+ * iniciales (sin pasar de la línea). Retorna 0 si OK, -1 si no hay número.
+ */
+static int read_number(const char **s, const char *end, long long *value)
+{
+    const char *p = *s;
+    long long v = 0;
+    int neg = 0;
+
+    while (p < end && *p == ' ')
+        p++;
+    if (p < end && *p == '-') {
+        neg = 1;
+        p++;
+    }
+    if (p >= end || !isdigit((unsigned char)*p))
+        return -1;
+    while (p < end && isdigit((unsigned char)*p))
+        v = v * 10 + (*p++ - '0');
+
+    *value = neg ? -v : v;
+    *s = p;
+    return 0;
+}
+
+/*
+ * Parsea las columnas de LIST LONG que van entre el PID y el nombre:
+ *   UID S THR RSS_KB %CPU START
+ * Retorna 0 si OK (y avanza *s), -1 si la línea está mal formada.
+ */
+static int parse_metrics(const char **s, const char *end, ProcessEntry *e)
+{
+    long long uid, threads, rss, cpu_int, cpu_dec, start;
+    const char *p = *s;
+
+    if (read_number(&p, end, &uid) != 0)
+        return -1;
+    while (p < end && *p == ' ')
+        p++;
+    if (p >= end)
+        return -1;
+    e->state = *p++;
+    if (read_number(&p, end, &threads) != 0 || read_number(&p, end, &rss) != 0 ||
+        read_number(&p, end, &cpu_int) != 0)
+        return -1;
+    if (p >= end || *p != '.')
+        return -1;
+    p++;
+    if (read_number(&p, end, &cpu_dec) != 0 || read_number(&p, end, &start) != 0)
+        return -1;
+
+    e->uid        = (int)uid;
+    e->threads    = (int)threads;
+    e->rss_kb     = (long)rss;
+    e->cpu_tenths = (int)(cpu_int * 10 + cpu_dec);
+    e->start_time = (time_t)start;
+    *s = p;
+    return 0;
+}
+
+/* Indica si el encabezado es el de LIST LONG (tiene la columna %CPU). */
+static int is_long_header(const char *line, int len)
+{
+    for (int i = 0; i + 4 <= len; i++) {
+        if (memcmp(line + i, "%CPU", 4) == 0)
+            return 1;
+    }
+    return 0;
+}
 
 /*
  * Parsea la respuesta cruda del servidor (texto de `ps -e -o pid,comm`)
@@ -15,6 +87,8 @@
  * Formato esperado por línea (después del header):
  *   "  1234 nginx"
  *   "  5678 node"
+ * o, si el encabezado es el de LIST LONG:
+ *   "  1234  1000 S   4     20480  12.5 1700000000 nginx"
  *
  * Retorna 0 si OK, -1 en error de memoria.
  */
@@ -27,9 +101,10 @@ int process_list_parse(const char *raw_response, ProcessList *list)
     if (!list)
         return -1;
 
-    list->entries  = NULL;
-    list->count    = 0;
-    list->capacity = 0;
+    list->entries     = NULL;
+    list->count       = 0;
+    list->capacity    = 0;
+    list->has_metrics = 0;
 
     if (!raw_response || raw_response[0] == '\0')
         return 0;
@@ -55,6 +130,7 @@ int process_list_parse(const char *raw_response, ProcessList *list)
         if (is_first_line) {
             /* Omitir la línea de encabezado */
             is_first_line = 0;
+            list->has_metrics = is_long_header(line_start, line_len);
         } else if (line_len > 0) {
             /* Parsear PID y nombre */
             const char *s = line_start;
@@ -73,6 +149,13 @@ int process_list_parse(const char *raw_response, ProcessList *list)
                     s++;
                 }
 
+                ProcessEntry metrics;
+                memset(&metrics, 0, sizeof(metrics));
+                metrics.uid = -1;
+                if (has_digit && list->has_metrics &&
+                    parse_metrics(&s, line_start + line_len, &metrics) != 0)
+                    has_digit = 0; /* Línea mal formada: se omite */
+
                 if (has_digit) {
                     /* Saltar espacios entre PID y nombre */
                     while (s < line_start + line_len && isspace((unsigned char)*s))
@@ -93,6 +176,7 @@ int process_list_parse(const char *raw_response, ProcessList *list)
                     }
 
                     ProcessEntry *entry = &list->entries[list->count];
+                    *entry = metrics;
                     entry->pid = pid;
 
                     if (name_len > 0 && name_len < PROC_NAME_SIZE) {
@@ -120,6 +204,312 @@ int process_list_parse(const char *raw_response, ProcessList *list)
     return 0;
 }
 
+/* Copia un nombre de proceso truncándolo a PROC_NAME_SIZE - 1. */
+static void copy_name(char *dst, const char *src, int len)
+{
+    if (len >= PROC_NAME_SIZE)
+        len = PROC_NAME_SIZE - 1;
+    if (len < 0)
+        len = 0;
+    memcpy(dst, src, (size_t)len);
+    dst[len] = '\0';
+}
+
+/* Busca un PID en la lista ordenada. Retorna su índice o -1. */
+static int find_pid(const ProcessList *list, int pid)
+{
+    int lo = 0, hi = list->count - 1;
+
+    while (lo <= hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (list->entries[mid].pid == pid)
+            return mid;
+        if (list->entries[mid].pid < pid)
+            lo = mid + 1;
+        else
+            hi = mid - 1;
+    }
+    return -1;
+}
+
+/*
+ * Parsea una línea de delta: operación, PID y (para + y ~) el nombre.
+ * Retorna 0 si OK, -1 si la línea está mal formada.
+ */
+static int parse_delta_line(const char *s, const char *end, char *op, int *pid,
+                            const char **name, int *name_len)
+{
+    if (end - s < 3 || (s[0] != '+' && s[0] != '-' && s[0] != '~') || s[1] != ' ')
+        return -1;
+    *op = s[0];
+    s += 2;
+
+    if (s >= end || !isdigit((unsigned char)*s))
+        return -1;
+    *pid = 0;
+    while (s < end && isdigit((unsigned char)*s))
+        *pid = *pid * 10 + (*s++ - '0');
+
+    if (*op == '-') {
+        *name = NULL;
+        *name_len = 0;
+        return s == end ? 0 : -1;
+    }
+    if (s >= end || *s != ' ')
+        return -1;
+    *name = s + 1;
+    *name_len = (int)(end - s - 1);
+    return 0;
+}
+
+/*
+ * Aplica un delta en tres pasos sin reparsear la lista: renombres y
+ * bajas por búsqueda binaria (las bajas se marcan con PID 0 y se
+ * compactan en una pasada), y las altas, que llegan ordenadas, se
+ * mezclan desde el final del arreglo.
+ */
+int process_list_apply_delta(ProcessList *list, const char *delta)
+{
+    ProcessEntry *adds = NULL;
+    int add_count = 0, add_cap = 0;
+    int removed = 0;
+    const char *line_start;
+
+    if (!list || !delta)
+        return -1;
+
+    /* Paso 1: renombres y bajas; las altas se juntan aparte */
+    line_start = delta;
+    while (*line_start != '\0') {
+        const char *p = line_start;
+        while (*p != '\0' && *p != '\n')
+            p++;
+
+        if (p > line_start) {
+            char op;
+            int pid, name_len, idx;
+            const char *name;
+
+            if (parse_delta_line(line_start, p, &op, &pid, &name, &name_len) != 0)
+                goto fail;
+            idx = find_pid(list, pid);
+
+            if (op == '+') {
+                if (idx >= 0 || (add_count > 0 && adds[add_count - 1].pid >= pid))
+                    goto fail;
+                if (add_count >= add_cap) {
+                    int new_cap = add_cap ? add_cap * 2 : INITIAL_CAPACITY;
+                    ProcessEntry *tmp = realloc(adds, (size_t)new_cap * sizeof(ProcessEntry));
+                    if (!tmp)
+                        goto fail;
+                    adds    = tmp;
+                    add_cap = new_cap;
+                }
+                /* Las métricas llegan con el próximo LIST LONG */
+                memset(&adds[add_count], 0, sizeof(ProcessEntry));
+                adds[add_count].uid = -1;
+                adds[add_count].pid = pid;
+                copy_name(adds[add_count].name, name, name_len);
+                add_count++;
+            } else if (idx < 0) {
+                goto fail;
+            } else if (op == '-') {
+                list->entries[idx].pid = 0;
+                removed++;
+            } else {
+                copy_name(list->entries[idx].name, name, name_len);
+            }
+        }
+
+        if (*p == '\n')
+            line_start = p + 1;
+        else
+            break;
+    }
+
+    /* Paso 2: compactar las bajas */
+    if (removed > 0) {
+        int w = 0;
+        for (int r = 0; r < list->count; r++) {
+            if (list->entries[r].pid != 0) {
+                if (w != r)
+                    list->entries[w] = list->entries[r];
+                w++;
+            }
+        }
+        list->count = w;
+    }
+
+    /* Paso 3: mezclar las altas desde el final */
+    if (add_count > 0) {
+        int total = list->count + add_count;
+        if (total > list->capacity) {
+            int new_cap = list->capacity ? list->capacity : INITIAL_CAPACITY;
+            while (new_cap < total)
+                new_cap *= 2;
+            ProcessEntry *tmp = realloc(list->entries, (size_t)new_cap * sizeof(ProcessEntry));
+            if (!tmp)
+                goto fail;
+            list->entries  = tmp;
+            list->capacity = new_cap;
+        }
+
+        int i = list->count - 1, j = add_count - 1;
+        for (int w = total - 1; j >= 0; w--) {
+            if (i >= 0 && list->entries[i].pid > adds[j].pid)
+                list->entries[w] = list->entries[i--];
+            else
+                list->entries[w] = adds[j--];
+        }
+        list->count = total;
+    }
+
+    free(adds);
+    return 0;
+
+fail:
+    free(adds);
+    return -1;
+}
+
+/* Lector de la codificación binaria: marca err al pasarse del final. */
+typedef struct {
+    const unsigned char *p;
+    const unsigned char *end;
+    int err;
+} WireReader;
+
+static unsigned long long wire_varint(WireReader *r)
+{
+    unsigned long long v = 0;
+    int shift = 0;
+
+    while (r->p < r->end && shift < 64) {
+        unsigned char b = *r->p++;
+        v |= (unsigned long long)(b & 0x7f) << shift;
+        if (!(b & 0x80))
+            return v;
+        shift += 7;
+    }
+    r->err = 1;
+    return 0;
+}
+
+static unsigned int wire_u32(WireReader *r)
+{
+    if (r->end - r->p < 4) {
+        r->err = 1;
+        return 0;
+    }
+    unsigned int v = ((unsigned int)r->p[0] << 24) | ((unsigned int)r->p[1] << 16) |
+                     ((unsigned int)r->p[2] << 8) | (unsigned int)r->p[3];
+    r->p += 4;
+    return v;
+}
+
+int process_list_is_binary(const char *data, size_t len)
+{
+    return len >= PROC_WIRE_MAGIC_LEN && memcmp(data, PROC_WIRE_MAGIC, PROC_WIRE_MAGIC_LEN) == 0;
+}
+
+int process_list_decode(const char *data, size_t len, ProcessList *list,
+                        unsigned long *generation, int *offset, int *total)
+{
+    WireReader r = { (const unsigned char *)data, (const unsigned char *)data + len, 0 };
+    const unsigned char **names = NULL;
+    int *name_lens = NULL;
+
+    list->entries     = NULL;
+    list->count       = 0;
+    list->capacity    = 0;
+    list->has_metrics = 0;
+
+    if (!process_list_is_binary(data, len) || len < PROC_WIRE_MAGIC_LEN + 2 ||
+        (unsigned char)data[PROC_WIRE_MAGIC_LEN] != PROC_WIRE_VERSION)
+        return -1;
+    r.p += PROC_WIRE_MAGIC_LEN + 1;
+    int flags = *r.p++;
+
+    *generation = (unsigned long)wire_varint(&r);
+    *offset     = (int)wire_varint(&r);
+    *total      = (int)wire_varint(&r);
+    unsigned long long count = wire_varint(&r);
+    unsigned long long nnames = wire_varint(&r);
+
+    /* Cada fila ocupa al menos 2 bytes y cada nombre 1: acota las reservas */
+    if (r.err || count > (size_t)(r.end - r.p) / 2 || nnames > (size_t)(r.end - r.p))
+        return -1;
+
+    names = malloc((size_t)(nnames + 1) * sizeof(*names));
+    name_lens = malloc((size_t)(nnames + 1) * sizeof(*name_lens));
+    list->entries = malloc((size_t)(count + 1) * sizeof(ProcessEntry));
+    if (!names || !name_lens || !list->entries)
+        goto fail;
+    list->capacity = (int)count + 1;
+
+    for (unsigned long long k = 0; k < nnames; k++) {
+        unsigned long long n = wire_varint(&r);
+        if (r.err || n > (size_t)(r.end - r.p))
+            goto fail;
+        names[k] = r.p;
+        name_lens[k] = (int)n;
+        r.p += n;
+    }
+
+    /* Columnas: PIDs como diferencias, luego el índice de cada nombre */
+    int pid = 0;
+    for (unsigned long long i = 0; i < count; i++) {
+        ProcessEntry *e = &list->entries[i];
+        pid += (int)wire_varint(&r);
+        e->pid = pid;
+        e->uid = -1;
+        e->state = 0;
+        e->threads = 0;
+        e->rss_kb = 0;
+        e->cpu_tenths = 0;
+        e->start_time = 0;
+    }
+    for (unsigned long long i = 0; i < count; i++) {
+        unsigned long long k = wire_varint(&r);
+        if (r.err || k >= nnames)
+            goto fail;
+        copy_name(list->entries[i].name, (const char *)names[k], name_lens[k]);
+    }
+
+    if (flags & PROC_WIRE_F_METRICS) {
+        if ((size_t)(r.end - r.p) < count * 21)
+            goto fail;
+        for (unsigned long long i = 0; i < count; i++) {
+            unsigned int uid = wire_u32(&r);
+            list->entries[i].uid = uid == 0xffffffffu ? -1 : (int)uid;
+        }
+        for (unsigned long long i = 0; i < count; i++)
+            list->entries[i].state = (char)*r.p++;
+        for (unsigned long long i = 0; i < count; i++)
+            list->entries[i].threads = (int)wire_u32(&r);
+        for (unsigned long long i = 0; i < count; i++)
+            list->entries[i].rss_kb = (long)wire_u32(&r);
+        for (unsigned long long i = 0; i < count; i++)
+            list->entries[i].cpu_tenths = (int)wire_u32(&r);
+        for (unsigned long long i = 0; i < count; i++)
+            list->entries[i].start_time = (time_t)wire_u32(&r);
+        list->has_metrics = 1;
+    }
+    if (r.err)
+        goto fail;
+
+    list->count = (int)count;
+    free(names);
+    free(name_lens);
+    return 0;
+
+fail:
+    free(names);
+    free(name_lens);
+    process_list_free(list);
+    return -1;
+}
+
 /*
  * Libera la memoria de la lista de procesos.
  */
@@ -132,8 +522,39 @@ void process_list_free(ProcessList *list)
         free(list->entries);
         list->entries = NULL;
     }
-    list->count    = 0;
-    list->capacity = 0;
+    list->count       = 0;
+    list->capacity    = 0;
+    list->has_metrics = 0;
+}
+
+/* RSS legible en 7 columnas: KB, MB o GB. */
+static void format_rss(long kb, char *buf, size_t size)
+{
+    if (kb < 10000)
+        snprintf(buf, size, "%ldK", kb);
+    else if (kb < 100 * 1024)
+        snprintf(buf, size, "%.1fM", kb / 1024.0);
+    else if (kb < 10000L * 1024)
+        snprintf(buf, size, "%ldM", kb / 1024);
+    else
+        snprintf(buf, size, "%.1fG", kb / (1024.0 * 1024.0));
+}
+
+/* Inicio como hace ps: la hora si fue hoy, si no el día. */
+static void format_start(time_t start, time_t now, char *buf, size_t size)
+{
+    struct tm then_tm, now_tm;
+
+    if (start <= 0) {
+        snprintf(buf, size, "-");
+        return;
+    }
+    localtime_r(&start, &then_tm);
+    localtime_r(&now, &now_tm);
+    if (then_tm.tm_year == now_tm.tm_year && then_tm.tm_yday == now_tm.tm_yday)
+        strftime(buf, size, "%H:%M", &then_tm);
+    else
+        strftime(buf, size, "%b%d", &then_tm);
 }
 
 /*
@@ -176,6 +597,30 @@ void process_list_render(const ProcessList *list, Panel *panel, int scroll_offse
         wattron(panel->win, COLOR_PAIR(COLOR_PAIR_TEXT));
         mvwprintw(panel->win, cy, cx, "%s", msg);
         wattroff(panel->win, COLOR_PAIR(COLOR_PAIR_TEXT));
+    } else if (list->has_metrics && inner_w - PROC_METRICS_WIDTH >= 8) {
+        /* Con métricas: PID UID S THR RSS %CPU INICIO NOMBRE */
+        int name_w = inner_w - PROC_METRICS_WIDTH;
+        time_t now = time(NULL);
+
+        wattron(panel->win, COLOR_PAIR(COLOR_PAIR_HEADER) | A_BOLD);
+        mvwprintw(panel->win, 1, 2, "%-8s %5s %s %4s %7s %5s %6s %-*s", "PID", "UID", "S",
+                  "THR", "RSS", "%CPU", "INICIO", name_w, "NOMBRE");
+        wattroff(panel->win, COLOR_PAIR(COLOR_PAIR_HEADER) | A_BOLD);
+
+        int visible_rows = inner_h - 1; /* -1 por el encabezado */
+        for (row = 0; row < visible_rows && (scroll_offset + row) < list->count; row++) {
+            const ProcessEntry *e = &list->entries[scroll_offset + row];
+            char rss[24], start[16];
+
+            format_rss(e->rss_kb, rss, sizeof(rss));
+            format_start(e->start_time, now, start, sizeof(start));
+            wattron(panel->win, COLOR_PAIR(COLOR_PAIR_TEXT));
+            mvwprintw(panel->win, row + 2, 2, "%-8d %5d %c %4d %7s %3d.%d %6s %-*.*s",
+                      e->pid, e->uid, e->state ? e->state : '?', e->threads, rss,
+                      e->cpu_tenths / 10, e->cpu_tenths % 10, start,
+                      name_w, name_w, e->name);
+            wattroff(panel->win, COLOR_PAIR(COLOR_PAIR_TEXT));
+        }
     } else {
         /* Dibujar encabezado de columnas */
         wattron(panel->win, COLOR_PAIR(COLOR_PAIR_HEADER) | A_BOLD);
@@ -1,6 +1,9 @@
 #ifndef PROCESS_H
 #define PROCESS_H
 
+#include <stddef.h>
+#include <time.h>
+
 #include "panels.h"
 
 #define PROC_NAME_SIZE 256
@@ -8,16 +11,25 @@
 typedef struct {
     int pid;
     char name[PROC_NAME_SIZE];
+    /* Solo con LIST LONG (has_metrics); en cero si no */
+    int uid;                /* -1 si el servidor no lo sabe */
+    char state;             /* R, S, D, Z... */
+    int threads;
+    long rss_kb;
+    int cpu_tenths;         /* %CPU x 10 */
+    time_t start_time;
 } ProcessEntry;
 
 typedef struct {
     ProcessEntry *entries;
     int count;
     int capacity;
+    int has_metrics;        /* La respuesta traía las columnas de LIST LONG */
 } ProcessList;
 
 /*
- * Parsea la respuesta cruda del servidor (texto de `ps -e -o pid,comm`)
+ * Parsea la respuesta cruda del servidor (texto de `ps -e -o pid,comm`,
+ * o el de LIST LONG, que se reconoce por la columna %CPU del encabezado)
  * en una ProcessList. La primera línea (encabezado) se omite.
  *
  * Retorna 0 si OK, -1 en error.
@@ -25,13 +37,52 @@ typedef struct {
  */
 int process_list_parse(const char *raw_response, ProcessList *list);
 
+/*
+ * Aplica en el lugar los cambios de una respuesta `LIST SINCE` (las
+ * líneas después de "DELTA <desde> <hasta>"), sin volver a parsear la
+ * lista completa:
+ *   "+ <pid> <nombre>"  agrega
+ *   "- <pid>"           quita
+ *   "~ <pid> <nombre>"  renombra
+ * La lista debe estar ordenada por PID (como la envía el servidor) y los
+ * cambios también. Retorna 0 si OK, -1 si el delta no corresponde a la
+ * lista (hay que pedir la lista completa) o en error de memoria.
+ * Esta función es pura (sin dependencia de ncurses).
+ */
+int process_list_apply_delta(ProcessList *list, const char *delta);
+
+/*
+ * Codificación binaria de las tablas (ENCODING BINARY, modo FRAMED). El
+ * formato está descrito en src/server/wire.h: magia, cabecera con
+ * generación/desde/total, tabla de nombres, PIDs como diferencias y
+ * columnas de métricas de ancho fijo.
+ */
+#define PROC_WIRE_MAGIC      "\0PSB"
+#define PROC_WIRE_MAGIC_LEN  4
+#define PROC_WIRE_VERSION    1
+#define PROC_WIRE_F_METRICS  0x01
+
+/* Indica si la respuesta es una tabla en binario. */
+int process_list_is_binary(const char *data, size_t len);
+
+/*
+ * Decodifica una tabla en binario directo en la lista, sin pasar por
+ * texto, y deja la generación, el índice de la primera fila y el total
+ * de la lista completa. Retorna 0 si OK, -1 si está mal formada o en
+ * error de memoria (la lista queda vacía).
+ * Esta función es pura (sin dependencia de ncurses).
+ */
+int process_list_decode(const char *data, size_t len, ProcessList *list,
+                        unsigned long *generation, int *offset, int *total);
+
 /*
  * Libera la memoria de la lista de procesos.
  */
 void process_list_free(ProcessList *list);
 
 /*
- * Renderiza la lista de procesos en el Panel_Procesos con columnas alineadas.
+ * Renderiza la lista de procesos en el Panel_Procesos con columnas alineadas
+ * (con métricas, si las hay y el panel es lo bastante ancho).
  * Muestra "Sin procesos activos" centrado si la lista está vacía.
  *
  * scroll_offset: offset de scroll actual para la vista.
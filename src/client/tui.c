@@ -9,7 +9,189 @@
 #include "curses_compat.h"
 
 #define LIST_INTERVAL    10 /* segundos entre refrescos automáticos de LIST */
+#define METRICS_INTERVAL  3 /* segundos entre LIST LONG (%CPU, RSS...) */
 #define CMD_REFRESH_DELAY 5  /* segundos tras START/STOP para refrescar lista */
+#define RESPONSE_TIMEOUT_MS 3000 /* espera máxima por la respuesta de un comando */
+
+/*
+ * Pide la lista de procesos: solo los cambios desde la última generación
+ * recibida, o la lista completa si todavía no hay ninguna.
+ */
+static void request_process_list(TUIState *state)
+{
+    char cmd[64];
+    snprintf(cmd, sizeof(cmd), "LIST SINCE %lu", state->list_generation);
+    net_send_cmd(state->sock, &state->reader, cmd);
+}
+
+/* Filas visibles del Panel_Procesos (sin bordes ni encabezado). */
+static int proc_visible_rows(const TUIState *state)
+{
+    int h = state->layout->proc.height - 3;
+    return h > 0 ? h : 1;
+}
+
+/*
+ * Pide una ventana de la lista (LIST OFFSET/LIMIT, con métricas). Con pin
+ * se fija a la generación que ya se muestra, para que las páginas no se
+ * corran mientras se desplaza; sin pin, trae la tabla más reciente.
+ */
+static void request_process_page(TUIState *state, int offset, int limit, int pin)
+{
+    char cmd[96];
+
+    if (pin && state->list_generation != 0)
+        snprintf(cmd, sizeof(cmd), "LIST OFFSET %d LIMIT %d AT %lu",
+                 offset, limit, state->list_generation);
+    else
+        snprintf(cmd, sizeof(cmd), "LIST OFFSET %d LIMIT %d", offset, limit);
+    net_send_cmd(state->sock, &state->reader, cmd);
+    state->page_pending = 1;
+}
+
+/* Pide la ventana alrededor de lo visible si la descargada no alcanza. */
+static void prefetch_process_page(TUIState *state)
+{
+    int offset, limit;
+
+    if (!state->paged || state->page_pending || state->sock == INVALID_SOCKET)
+        return;
+    if (page_window(state->proc_scroll_offset, proc_visible_rows(state),
+                    state->proc_total, state->page_offset, state->proc_list.count,
+                    &offset, &limit))
+        request_process_page(state, offset, limit, 1);
+}
+
+/*
+ * Pide la tabla con métricas: la ventana visible si el servidor pagina,
+ * o completa (LIST LONG); con un servidor que no la conoce, los cambios
+ * como siempre.
+ */
+static void request_process_table(TUIState *state)
+{
+    if (state->paged) {
+        int offset, limit;
+        page_window(state->proc_scroll_offset, proc_visible_rows(state),
+                    state->proc_total, state->page_offset, state->proc_list.count,
+                    &offset, &limit);
+        request_process_page(state, offset, limit, 0);
+    } else if (state->list_long) {
+        net_send_cmd(state->sock, &state->reader, "LIST LONG");
+    } else {
+        request_process_list(state);
+    }
+}
+
+/*
+ * Registra la ventana recién guardada en proc_list: su generación, dónde
+ * empieza y cuántas filas tiene la lista completa.
+ */
+static void store_window(TUIState *state, unsigned long gen, int offset, int total)
+{
+    state->list_generation = gen;
+    state->page_offset = offset;
+    state->proc_total = total;
+    state->page_pending = 0;
+
+    /* La lista pudo achicarse, o lo visible moverse mientras llegaba */
+    state->proc_scroll_offset = scroll_clamp(state->proc_scroll_offset, 0,
+                                             total, proc_visible_rows(state));
+    prefetch_process_page(state);
+}
+
+/*
+ * Guarda una respuesta de LIST en proc_list. Las respuestas de
+ * `LIST SINCE` traen una línea inicial: "FULL <gen>" reemplaza la lista y
+ * "DELTA <desde> <gen>" la modifica en el lugar. Sin esa línea (LIST
+ * simple o servidor antiguo) se parsea completa y se olvida la generación.
+ * "ROWS <gen> <desde> <total>" es una ventana de la lista: se guarda solo
+ * esa parte y dónde empieza.
+ */
+static void store_process_list(TUIState *state, const char *msg, int n)
+{
+    unsigned long from, gen;
+    int offset, total;
+    int header_len = 0;
+
+    /* Servidor sin LIST OFFSET: descargar la lista entera */
+    if (state->paged && (strncmp(msg, "Error: Uso: LIST", 16) == 0 ||
+                         strncmp(msg, "Error: Clausula desconocida", 27) == 0)) {
+        state->paged = 0;
+        state->page_pending = 0;
+        state->list_generation = 0;
+        request_process_table(state);
+        return;
+    }
+
+    /* Tabla en binario (ENCODING BINARY): se decodifica directo en la lista */
+    if (process_list_is_binary(msg, (size_t)n)) {
+        ProcessList decoded;
+        if (process_list_decode(msg, (size_t)n, &decoded, &gen, &offset, &total) != 0)
+            return;
+        process_list_free(&state->proc_list);
+        state->proc_list = decoded;
+        store_window(state, gen, offset, total);
+        return;
+    }
+
+    if (sscanf(msg, "ROWS %lu %d %d%n", &gen, &offset, &total, &header_len) == 3 &&
+        msg[header_len] == '\n') {
+        process_list_free(&state->proc_list);
+        process_list_parse(msg + header_len + 1, &state->proc_list);
+        store_window(state, gen, offset, total);
+        return;
+    }
+
+    /* Con páginas, los cambios de SUBSCRIBE solo avisan que hay otra tabla */
+    if (state->paged && (sscanf(msg, "DELTA %lu %lu", &from, &gen) == 2 ||
+                         sscanf(msg, "FULL %lu", &gen) == 1)) {
+        if (gen != state->list_generation)
+            request_process_table(state);
+        return;
+    }
+
+    /* Servidor sin LIST LONG: seguir con la lista simple */
+    if (state->list_long && strncmp(msg, "Error: Uso: LIST", 16) == 0) {
+        state->list_long = 0;
+        request_process_table(state);
+        return;
+    }
+
+    if (sscanf(msg, "DELTA %lu %lu%n", &from, &gen, &header_len) == 2 &&
+        (msg[header_len] == '\n' || msg[header_len] == '\0')) {
+        const char *body = msg[header_len] ? msg + header_len + 1 : msg + header_len;
+        if (from == state->list_generation &&
+            process_list_apply_delta(&state->proc_list, body) == 0) {
+            state->list_generation = gen;
+            state->proc_total = state->proc_list.count;
+            return;
+        }
+        /* El delta no corresponde a nuestra lista: pedirla completa */
+        state->list_generation = 0;
+        request_process_table(state);
+        return;
+    }
+
+    if (sscanf(msg, "FULL %lu%n", &gen, &header_len) == 1 &&
+        msg[header_len] == '\n') {
+        msg += header_len + 1;
+        state->list_generation = gen;
+    } else {
+        state->list_generation = 0;
+    }
+
+    /* Parsear en la lista estructurada */
+    process_list_free(&state->proc_list);
+    process_list_parse(msg, &state->proc_list);
+    state->page_offset = 0;
+    state->proc_total = state->proc_list.count;
+}
+
+/* Evento de SUBSCRIBE recibido mientras se esperaba otra respuesta. */
+static void on_list_event(void *ctx, const char *msg, int n)
+{
+    store_process_list(ctx, msg, n);
+}
 
 TUIState *tui_init(void) {
     TUIState *state = calloc(1, sizeof(TUIState));
@@ -40,12 +222,16 @@ TUIState *tui_init(void) {
     /* Estado inicial */
     state->running = 1;
     state->sock = INVALID_SOCKET;
+    net_reader_init(&state->reader);
     state->server_ip[0] = '\0';
     state->server_port = 0;
     state->status_msg[0] = '\0';
-    state->proc_lines = NULL;
     state->proc_scroll_offset = 0;
-    state->proc_line_count = 0;
+    state->list_generation = 0;
+    state->list_long = 1;
+    state->paged = 1;
+    state->proc_total  = 0;
+    state->page_offset = 0;
     state->proc_list.entries  = NULL;
     state->proc_list.count    = 0;
     state->proc_list.capacity = 0;
@@ -196,48 +382,65 @@ int tui_connection_dialog(TUIState *state) {
             snprintf(state->status_msg, sizeof(state->status_msg),
                      "Conectado a %s:%d", ip_buf, port);
 
-            /* Enviar LIST automáticamente */
-            net_send(sock, "LIST\n");
-
-            /* Recibir respuesta con timeout breve usando select */
-            char recv_buf[NET_BUFFER_SIZE];
-            fd_set rfds;
-            struct timeval tv;
-            FD_ZERO(&rfds);
-            FD_SET(sock, &rfds);
-            tv.tv_sec = 3;
-            tv.tv_usec = 0;
-
-            int ready = select((int)sock + 1, &rfds, NULL, NULL, &tv);
-            if (ready > 0) {
-                int n = recv(sock, recv_buf, NET_BUFFER_SIZE - 1, 0);
-                if (n > 0) {
-                    recv_buf[n] = '\0';
-                    /* Almacenar la lista cruda de procesos */
-                    if (state->proc_lines)
-                        free(state->proc_lines);
-                    state->proc_lines = malloc((size_t)n + 1);
-                    if (state->proc_lines) {
-                        memcpy(state->proc_lines, recv_buf, (size_t)n + 1);
-                        /* Contar líneas */
-                        state->proc_line_count = 0;
-                        for (int i = 0; i < n; i++) {
-                            if (recv_buf[i] == '\n')
-                                state->proc_line_count++;
+            /* Saludo: versión del protocolo y capacidades (mensajes
+             * enmarcados, tablas en binario, compresión y eventos). Un
+             * servidor sin HELLO responde con un error: probar solo el
+             * modo enmarcado, y si tampoco lo conoce seguir en texto */
+            net_reader_init(&state->reader);
+            int hello = net_hello(sock, &state->reader, NET_PROTO_VERSION,
+                                  "FRAMED,BINARY,LZ,PUSH", RESPONSE_TIMEOUT_MS);
+            if (hello == 0) {
+                hello = net_negotiate_framing(sock, &state->reader, RESPONSE_TIMEOUT_MS);
+            }
+            if (hello < 0) {
+                net_close(sock);
+                state->sock = INVALID_SOCKET;
+                snprintf(error_msg, sizeof(error_msg),
+                         "Error: conexion cerrada por %s", ip_buf);
+                continue;
+            }
+
+            /* Pedir la lista automáticamente: solo la ventana visible si
+             * el servidor pagina (LIST OFFSET/LIMIT), si no completa */
+            state->list_generation = 0;
+            state->subscribed = 0;
+            state->list_long = 1;
+            state->paged = 1;
+            state->page_pending = 0;
+            state->proc_scroll_offset = 0;
+            state->page_offset = 0;
+            state->proc_total = 0;
+            request_process_table(state);
+
+            /* Recibir la respuesta completa con timeout breve */
+            {
+                const char *msg;
+                int n;
+                if (net_recv_reply(sock, &state->reader, RESPONSE_TIMEOUT_MS,
+                                   on_list_event, state, &msg, &n) > 0) {
+                    store_process_list(state, msg, n);
+
+                    /* Con eventos (PUSH, o el modo enmarcado de un
+                     * servidor sin HELLO), SUBSCRIBE para que el servidor
+                     * envíe los cambios sin tener que consultar
+                     * periódicamente. Desde la generación recibida, así la
+                     * respuesta no repite la lista */
+                    if (state->reader.framed &&
+                        (state->reader.version == 0 || (state->reader.caps & NET_CAP_PUSH))) {
+                        char cmd[64];
+                        snprintf(cmd, sizeof(cmd), "SUBSCRIBE %lu", state->list_generation);
+                        net_send_cmd(sock, &state->reader, cmd);
+                        if (net_recv_reply(sock, &state->reader, RESPONSE_TIMEOUT_MS,
+                                           on_list_event, state, &msg, &n) > 0) {
+                            store_process_list(state, msg, n);
+                            /* Un servidor sin SUBSCRIBE responde con un error:
+                             * seguir con el refresco periódico */
+                            state->subscribed = state->list_generation != 0;
                         }
-                        /* Si no termina en newline, contar la última línea */
-                        if (n > 0 && recv_buf[n - 1] != '\n')
-                            state->proc_line_count++;
                     }
-
-                    /* Parsear en la lista estructurada */
-                    process_list_free(&state->proc_list);
-                    process_list_parse(recv_buf, &state->proc_list);
                 }
             }
 
-            state->proc_scroll_offset = 0;
-
             delwin(dwin);
             return 0;
         }
@@ -283,9 +486,7 @@ void tui_shutdown(TUIState *state) {
     if (state->sock != INVALID_SOCKET)
         net_close(state->sock);
 
-    /* Liberar buffer de procesos */
-    if (state->proc_lines)
-        free(state->proc_lines);
+    net_reader_free(&state->reader);
 
     /* Liberar lista estructurada de procesos */
     process_list_free(&state->proc_list);
@@ -356,6 +557,10 @@ static void show_help_dialog(TUIState *state)
         "    Envia SIGTERM al proceso con el PID indicado.",
         "    Ejemplo:  END 5678",
         "",
+        "  <comando>; <comando>; ...",
+        "    Envia varios comandos juntos, sin esperar",
+        "    cada respuesta. Ejemplo:  STOP 10; STOP 11",
+        "",
         "  EXIT",
         "    Desconecta del servidor y cierra el cliente.",
         "    No requiere argumentos.",
@@ -503,24 +708,18 @@ static void show_run_dialog(TUIState *state, time_t *deferred_list_at)
             }
             /* Enviar START <comando> al servidor */
             char send_buf[INPUT_BUF_SIZE + 8];
-            snprintf(send_buf, sizeof(send_buf), "START %s\n", cmd_buf);
-            net_send(state->sock, send_buf);
+            snprintf(send_buf, sizeof(send_buf), "START %s", cmd_buf);
+            net_send_cmd(state->sock, &state->reader, send_buf);
 
             /* Leer respuesta del servidor */
-            char recv_buf[NET_BUFFER_SIZE];
-            fd_set rfds;
-            struct timeval tv;
-            FD_ZERO(&rfds);
-            FD_SET(state->sock, &rfds);
-            tv.tv_sec = 3; tv.tv_usec = 0;
-            int ready = select((int)state->sock + 1, &rfds, NULL, NULL, &tv);
-            if (ready > 0) {
-                int nr = recv(state->sock, recv_buf, NET_BUFFER_SIZE - 1, 0);
-                if (nr > 0) {
-                    recv_buf[nr] = '\0';
+            {
+                const char *msg;
+                int nr;
+                if (net_recv_reply(state->sock, &state->reader,
+                                   RESPONSE_TIMEOUT_MS, on_list_event, state,
+                                   &msg, &nr) > 0) {
                     /* Mostrar respuesta del servidor brevemente */
-                    recv_buf[sizeof(result_msg) - 1] = '\0';
-                    strncpy(result_msg, recv_buf, sizeof(result_msg) - 1);
+                    snprintf(result_msg, sizeof(result_msg), "%s", msg);
                     /* Eliminar newline del mensaje */
                     char *nl = strchr(result_msg, '\n');
                     if (nl) *nl = '\0';
@@ -565,16 +764,31 @@ static void show_run_dialog(TUIState *state, time_t *deferred_list_at)
     panels_draw_borders(state->layout);
 }
 
+/*
+ * Mensaje de estado de la conexión, con lo que ahorró la compresión si
+ * el servidor envió algo comprimido.
+ */
+static void set_connected_status(TUIState *state)
+{
+    const NetReader *rd = &state->reader;
+
+    if (rd->unpacked == 0) {
+        snprintf(state->status_msg, sizeof(state->status_msg),
+                 "Conectado a %s:%d", state->server_ip, state->server_port);
+        return;
+    }
+    snprintf(state->status_msg, sizeof(state->status_msg),
+             "Conectado a %s:%d  LZ: %llu -> %llu KB, %.1f ms",
+             state->server_ip, state->server_port,
+             rd->raw_bytes / 1024, rd->packed_bytes / 1024, rd->unpack_us / 1000.0);
+}
+
 /*
  * Envía un comando al servidor, recibe la respuesta y actualiza el estado.
  * Retorna 1 si el comando fue EXIT (señal de salir), 0 en otro caso.
  */
 static int handle_command(TUIState *state, const char *cmd, time_t *deferred_list_at)
 {
-    char send_buf[INPUT_BUF_SIZE + 2];
-    char recv_buf[NET_BUFFER_SIZE];
-    int n;
-
     /* Verificar si es HELP */
     if (strcmp(cmd, "HELP") == 0) {
         show_help_dialog(state);
@@ -586,28 +800,19 @@ static int handle_command(TUIState *state, const char *cmd, time_t *deferred_lis
         char aliased[INPUT_BUF_SIZE + 2];
         snprintf(aliased, sizeof(aliased), "START %s", cmd + 4);
         /* Reenviar como START */
-        char send_buf2[INPUT_BUF_SIZE + 4];
-        snprintf(send_buf2, sizeof(send_buf2), "%s\n", aliased);
         snprintf(state->status_msg, sizeof(state->status_msg), "Iniciando: %s", cmd + 4);
         render_status_bar(state);
-        net_send(state->sock, send_buf2);
+        net_send_cmd(state->sock, &state->reader, aliased);
         /* Leer respuesta */
         {
-            fd_set rfds; struct timeval tv;
-            char recv_buf2[NET_BUFFER_SIZE];
-            FD_ZERO(&rfds); FD_SET(state->sock, &rfds);
-            tv.tv_sec = 3; tv.tv_usec = 0;
-            int ready = select((int)state->sock + 1, &rfds, NULL, NULL, &tv);
-            if (ready > 0) {
-                int nr = recv(state->sock, recv_buf2, NET_BUFFER_SIZE - 1, 0);
-                if (nr > 0) {
-                    recv_buf2[nr] = '\0';
-                    /* Mostrar respuesta en status */
-                    char *nl = strchr(recv_buf2, '\n');
-                    if (nl) *nl = '\0';
-                    snprintf(state->status_msg, sizeof(state->status_msg), "%.*s",
-                             (int)sizeof(state->status_msg) - 1, recv_buf2);
-                }
+            const char *msg;
+            int nr;
+            if (net_recv_reply(state->sock, &state->reader, RESPONSE_TIMEOUT_MS,
+                               on_list_event, state, &msg, &nr) > 0) {
+                /* Mostrar respuesta en status (solo la primera línea) */
+                int first_len = (int)strcspn(msg, "\n");
+                snprintf(state->status_msg, sizeof(state->status_msg), "%.*s",
+                         first_len, msg);
             }
         }
         if (deferred_list_at)
@@ -620,7 +825,7 @@ static int handle_command(TUIState *state, const char *cmd, time_t *deferred_lis
         snprintf(state->status_msg, sizeof(state->status_msg),
                  "Desconectando...");
         render_status_bar(state);
-        net_send(state->sock, "EXIT\n");
+        net_send_cmd(state->sock, &state->reader, "EXIT");
         return 1;
     }
 
@@ -629,54 +834,22 @@ static int handle_command(TUIState *state, const char *cmd, time_t *deferred_lis
              "Enviando comando...");
     render_status_bar(state);
 
-    /* Enviar comando con newline */
-    snprintf(send_buf, sizeof(send_buf), "%s\n", cmd);
-    net_send(state->sock, send_buf);
-
-    /* Recibir respuesta con timeout usando select */
+    /* Enviar comando y esperar la respuesta completa */
+    net_send_cmd(state->sock, &state->reader, cmd);
     {
-        fd_set rfds;
-        struct timeval tv;
-        FD_ZERO(&rfds);
-        FD_SET(state->sock, &rfds);
-        tv.tv_sec = 3;
-        tv.tv_usec = 0;
-
-        int ready = select((int)state->sock + 1, &rfds, NULL, NULL, &tv);
-        if (ready > 0) {
-            n = recv(state->sock, recv_buf, NET_BUFFER_SIZE - 1, 0);
-            if (n > 0) {
-                recv_buf[n] = '\0';
-
-                /* Actualizar buffer crudo */
-                if (state->proc_lines)
-                    free(state->proc_lines);
-                state->proc_lines = malloc((size_t)n + 1);
-                if (state->proc_lines) {
-                    memcpy(state->proc_lines, recv_buf, (size_t)n + 1);
-                    state->proc_line_count = 0;
-                    {
-                        int i;
-                        for (i = 0; i < n; i++) {
-                            if (recv_buf[i] == '\n')
-                                state->proc_line_count++;
-                        }
-                        if (n > 0 && recv_buf[n - 1] != '\n')
-                            state->proc_line_count++;
-                    }
-                }
-
-                /* Parsear lista estructurada */
-                process_list_free(&state->proc_list);
-                process_list_parse(recv_buf, &state->proc_list);
-                state->proc_scroll_offset = 0;
-            } else if (n == 0) {
-                /* Servidor cerró la conexión */
-                snprintf(state->status_msg, sizeof(state->status_msg),
-                         "Conexion perdida");
-                state->running = 0;
-                return 0;
-            }
+        const char *msg;
+        int n = 0;
+        int r = net_recv_reply(state->sock, &state->reader, RESPONSE_TIMEOUT_MS,
+                               on_list_event, state, &msg, &n);
+        if (r > 0) {
+            store_process_list(state, msg, n);
+            state->proc_scroll_offset = 0;
+        } else if (r < 0) {
+            /* Servidor cerró la conexión */
+            snprintf(state->status_msg, sizeof(state->status_msg),
+                     "Conexion perdida");
+            state->running = 0;
+            return 0;
         }
     }
 
@@ -687,9 +860,102 @@ static int handle_command(TUIState *state, const char *cmd, time_t *deferred_lis
     }
 
     /* Restaurar mensaje de estado normal */
+    set_connected_status(state);
+
+    return 0;
+}
+
+/*
+ * Ejecuta una línea de la entrada, que puede encadenar varios comandos
+ * con ';' ("STOP 10; STOP 11; RUN sleep 5"). En modo enmarcado se
+ * envían todos juntos y las respuestas se leen después, en orden, así
+ * el lote cuesta un solo viaje de ida y vuelta. En modo texto las
+ * respuestas no tienen límites: se ejecutan de a uno.
+ * Retorna 1 si el comando fue EXIT, 0 en otro caso.
+ */
+static int handle_command_line(TUIState *state, const char *line, time_t *deferred_list_at)
+{
+    char copy[INPUT_BUF_SIZE];
+    char *cmds[INPUT_BUF_SIZE / 2];
+    const char *batch[INPUT_BUF_SIZE / 2];
+    char aliased[INPUT_BUF_SIZE * 2];
+    size_t used = 0;
+    int refresh = 0;
+
+    snprintf(copy, sizeof(copy), "%s", line);
+    int count = input_split_commands(copy, cmds, INPUT_BUF_SIZE / 2);
+    if (count == 0)
+        return 0;
+    if (count == 1)
+        return handle_command(state, cmds[0], deferred_list_at);
+
+    if (!state->reader.framed) {
+        for (int i = 0; i < count && state->running; i++) {
+            if (handle_command(state, cmds[i], deferred_list_at))
+                return 1;
+        }
+        return 0;
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (strcmp(cmds[i], "HELP") == 0 || strcmp(cmds[i], "EXIT") == 0) {
+            snprintf(state->status_msg, sizeof(state->status_msg),
+                     "%s no se puede encadenar con ';'", cmds[i]);
+            return 0;
+        }
+        /* RUN <cmd> es alias de START <cmd>; cada alias suma 2 bytes */
+        if (strncmp(cmds[i], "RUN ", 4) == 0) {
+            batch[i] = aliased + used;
+            used += (size_t)snprintf(aliased + used, sizeof(aliased) - used,
+                                     "START %s", cmds[i] + 4) + 1;
+        } else {
+            batch[i] = cmds[i];
+        }
+        if (strncmp(batch[i], "START ", 6) == 0 || strncmp(batch[i], "STOP ", 5) == 0)
+            refresh = 1;
+    }
+
     snprintf(state->status_msg, sizeof(state->status_msg),
-             "Conectado a %s:%d", state->server_ip, state->server_port);
+             "Enviando %d comandos...", count);
+    render_status_bar(state);
+    if (net_send_cmds(state->sock, &state->reader, batch, count) != 0) {
+        snprintf(state->status_msg, sizeof(state->status_msg), "Conexion perdida");
+        state->running = 0;
+        return 0;
+    }
 
+    /* Las respuestas llegan en el orden de los comandos */
+    int ok = 0, failed = 0;
+    char first_error[128] = "";
+    for (int i = 0; i < count; i++) {
+        const char *msg;
+        int n = 0;
+        int r = net_recv_reply(state->sock, &state->reader, RESPONSE_TIMEOUT_MS,
+                               on_list_event, state, &msg, &n);
+        if (r < 0) {
+            snprintf(state->status_msg, sizeof(state->status_msg), "Conexion perdida");
+            state->running = 0;
+            return 0;
+        }
+        if (r == 0) {
+            snprintf(state->status_msg, sizeof(state->status_msg),
+                     "Sin respuesta a %d de %d comandos", count - i, count);
+            return 0;
+        }
+        if (strncmp(msg, "Error", 5) == 0) {
+            if (failed++ == 0)
+                snprintf(first_error, sizeof(first_error), "%.*s",
+                         (int)strcspn(msg, "\n"), msg);
+        } else {
+            ok++;
+        }
+    }
+
+    if (refresh && deferred_list_at)
+        *deferred_list_at = time(NULL) + CMD_REFRESH_DELAY;
+    snprintf(state->status_msg, sizeof(state->status_msg),
+             "%d comandos: %d OK, %d con error%s%s",
+             count, ok, failed, failed ? "  " : "", first_error);
     return 0;
 }
 
@@ -723,8 +989,15 @@ void tui_run(TUIState *state)
         panels_draw_borders(state->layout);
 
         /* --- Renderizar Panel_Procesos --- */
-        process_list_render(&state->proc_list, &state->layout->proc,
-                            state->proc_scroll_offset);
+        {
+            /* Con páginas, proc_list empieza en page_offset */
+            int rel = state->proc_scroll_offset - state->page_offset;
+            if (rel < 0)
+                rel = 0;
+            if (rel > state->proc_list.count)
+                rel = state->proc_list.count;
+            process_list_render(&state->proc_list, &state->layout->proc, rel);
+        }
 
         /* --- Renderizar Panel_Entrada --- */
         input_render(&state->input_line, &state->layout->input, prompt);
@@ -785,29 +1058,13 @@ void tui_run(TUIState *state)
         if (ch == ERR) {
             /* Sin tecla — verificar socket para datos entrantes */
             if (state->sock != INVALID_SOCKET) {
-                char async_buf[NET_BUFFER_SIZE];
-                int nr = net_recv(state->sock, async_buf, NET_BUFFER_SIZE);
-                if (nr > 0) {
-                    /* Datos recibidos asíncronamente — actualizar lista */
-                    if (state->proc_lines)
-                        free(state->proc_lines);
-                    state->proc_lines = malloc((size_t)nr + 1);
-                    if (state->proc_lines) {
-                        memcpy(state->proc_lines, async_buf, (size_t)nr + 1);
-                        state->proc_line_count = 0;
-                        {
-                            int i;
-                            for (i = 0; i < nr; i++) {
-                                if (async_buf[i] == '\n')
-                                    state->proc_line_count++;
-                            }
-                            if (nr > 0 && async_buf[nr - 1] != '\n')
-                                state->proc_line_count++;
-                        }
-                    }
-                    process_list_free(&state->proc_list);
-                    process_list_parse(async_buf, &state->proc_list);
-                } else if (nr < 0) {
+                const char *msg;
+                int nr = 0;
+                int r = net_recv_msg(state->sock, &state->reader, 0, &msg, &nr);
+                if (r > 0) {
+                    /* Respuesta de LIST o evento de SUBSCRIBE — actualizar lista */
+                    store_process_list(state, msg, nr);
+                } else if (r < 0) {
                     /* Conexión perdida */
                     snprintf(state->status_msg, sizeof(state->status_msg),
                              "Conexion perdida");
@@ -815,6 +1072,9 @@ void tui_run(TUIState *state)
                 }
             }
 
+            /* Tras un cambio de tamaño o de scroll puede faltar ventana */
+            prefetch_process_page(state);
+
             /* Pequeña pausa para no saturar la CPU */
             napms(30);
 
@@ -823,16 +1083,17 @@ void tui_run(TUIState *state)
                 if (time(NULL) >= deferred_list_at) {
                     deferred_list_at = 0;
                     last_list_time   = time(NULL);
-                    net_send(state->sock, "LIST\n");
+                    request_process_table(state);
                 }
             }
 
-            /* Refresco periódico automático de la lista de procesos */
-            if (state->sock != INVALID_SOCKET) {
+            /* Refresco periódico automático de la lista de procesos. Si el
+             * servidor envía los cambios solo hace falta por las métricas */
+            if (state->sock != INVALID_SOCKET && (state->list_long || !state->subscribed)) {
                 time_t now = time(NULL);
-                if (now - last_list_time >= LIST_INTERVAL) {
+                if (now - last_list_time >= (state->list_long ? METRICS_INTERVAL : LIST_INTERVAL)) {
                     last_list_time = now;
-                    net_send(state->sock, "LIST\n");
+                    request_process_table(state);
                 }
             }
             continue;
@@ -864,14 +1125,16 @@ void tui_run(TUIState *state)
                 visible_h = state->layout->proc.height - 3; /* -2 borde -1 header */
                 state->proc_scroll_offset = scroll_clamp(
                     state->proc_scroll_offset, -1,
-                    state->proc_list.count, visible_h);
+                    state->proc_total, visible_h);
+                prefetch_process_page(state);
                 continue;
             }
             if (ch == KEY_DOWN) {
                 visible_h = state->layout->proc.height - 3;
                 state->proc_scroll_offset = scroll_clamp(
                     state->proc_scroll_offset, 1,
-                    state->proc_list.count, visible_h);
+                    state->proc_total, visible_h);
+                prefetch_process_page(state);
                 continue;
             }
         }
@@ -893,7 +1156,7 @@ void tui_run(TUIState *state)
         /* --- Delegar a input_handle_key --- */
         if (input_handle_key(&state->input_line, ch)) {
             /* Enter presionado con comando listo */
-            if (handle_command(state, state->input_line.buffer, &deferred_list_at)) {
+            if (handle_command_line(state, state->input_line.buffer, &deferred_list_at)) {
                 /* EXIT — salir del bucle */
                 state->running = 0;
             }
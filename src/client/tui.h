@@ -10,14 +10,20 @@ typedef struct {
     TUILayout *layout;
     InputLine input_line;
     SOCKET sock;
+    NetReader reader;       /* Reensamblado de respuestas del servidor */
     char server_ip[46];
     int server_port;
     int running;
     char status_msg[256];
-    char *proc_lines;       /* Buffer crudo con la lista de procesos */
-    int proc_scroll_offset; /* Offset de scroll en Panel_Procesos */
-    int proc_line_count;    /* Número total de líneas de procesos */
-    ProcessList proc_list;  /* Lista estructurada de procesos */
+    int proc_scroll_offset; /* Offset de scroll en Panel_Procesos (en la lista completa) */
+    ProcessList proc_list;  /* Procesos descargados (con páginas, solo una ventana) */
+    int proc_total;         /* Filas de la lista completa */
+    int page_offset;        /* Índice de proc_list.entries[0] en la lista completa */
+    int paged;              /* 1 mientras el servidor acepte LIST OFFSET/LIMIT */
+    int page_pending;       /* Hay una ventana pedida sin respuesta */
+    unsigned long list_generation; /* Generación de proc_list (0 = desconocida) */
+    int subscribed;         /* 1 si el servidor envía los cambios (SUBSCRIBE) */
+    int list_long;          /* 1 mientras el servidor acepte LIST LONG (métricas) */
 } TUIState;
 
 /* Inicializa ncurses, colores, paneles. Retorna el estado de la TUI. */
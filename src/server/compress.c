@@ -0,0 +1,169 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "compress.h"
+
+#define HASH_BITS   13
+#define MIN_MATCH   4
+#define MAX_OFFSET  65535
+
+static unsigned long packed, skipped, sent;
+static unsigned long long bytes_in, bytes_out, nanos, sent_raw, sent_wire;
+
+static long long now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static uint32_t read32(const unsigned char *p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static unsigned int hash4(uint32_t v)
+{
+    return (v * 2654435761u) >> (32 - HASH_BITS);
+}
+
+/* Resto de un largo cuyo nibble quedó en 15. */
+static unsigned char *put_length(unsigned char *p, size_t n)
+{
+    while (n >= 255) {
+        *p++ = 255;
+        n -= 255;
+    }
+    *p++ = (unsigned char)n;
+    return p;
+}
+
+/* Escribe una secuencia: literales y, si match_len > 0, el match. */
+static unsigned char *put_sequence(unsigned char *p, const unsigned char *lit, size_t nlit,
+                                   size_t match_len, size_t offset)
+{
+    size_t extra = match_len ? match_len - MIN_MATCH : 0;
+    unsigned char *token = p++;
+
+    *token = (unsigned char)((nlit < 15 ? nlit : 15) << 4 | (extra < 15 ? extra : 15));
+    if (nlit >= 15)
+        p = put_length(p, nlit - 15);
+    memcpy(p, lit, nlit);
+    p += nlit;
+    if (match_len == 0)
+        return p;
+
+    *p++ = (unsigned char)offset;
+    *p++ = (unsigned char)(offset >> 8);
+    if (extra >= 15)
+        p = put_length(p, extra - 15);
+    return p;
+}
+
+size_t compress_bound(size_t len)
+{
+    return len + len / 255 + 16;
+}
+
+size_t compress_block(const unsigned char *src, size_t len, unsigned char *dst)
+{
+    uint32_t table[1 << HASH_BITS];
+    unsigned char *p = dst;
+    size_t anchor = 0, i = 0;
+
+    memset(table, 0, sizeof(table));
+    while (i + MIN_MATCH <= len) {
+        uint32_t v = read32(src + i);
+        unsigned int h = hash4(v);
+        size_t cand = table[h];
+
+        table[h] = (uint32_t)i;
+        if (cand < i && i - cand <= MAX_OFFSET && read32(src + cand) == v) {
+            size_t n = MIN_MATCH;
+            while (i + n < len && src[cand + n] == src[i + n])
+                n++;
+            p = put_sequence(p, src + anchor, i - anchor, n, i - cand);
+            i += n;
+            anchor = i;
+        } else {
+            /* Sin matches hace tiempo: saltar más rápido sobre lo incompresible */
+            i += 1 + ((i - anchor) >> 6);
+        }
+    }
+    return (size_t)(put_sequence(p, src + anchor, len - anchor, 0, 0) - dst);
+}
+
+int compress_message(const struct iovec *iov, int iovcnt, char **data, size_t *len)
+{
+    size_t total = 0;
+    for (int i = 0; i < iovcnt; i++)
+        total += iov[i].iov_len;
+
+    /* El matcher necesita el mensaje contiguo */
+    const unsigned char *src = iovcnt == 1 ? iov[0].iov_base : NULL;
+    unsigned char *flat = NULL;
+    if (iovcnt != 1) {
+        flat = malloc(total + 1);
+        if (!flat)
+            return -1;
+        size_t off = 0;
+        for (int i = 0; i < iovcnt; i++) {
+            memcpy(flat + off, iov[i].iov_base, iov[i].iov_len);
+            off += iov[i].iov_len;
+        }
+        src = flat;
+    }
+
+    unsigned char *out = malloc(COMPRESS_HEADER_SIZE + compress_bound(total));
+    if (!out) {
+        free(flat);
+        return -1;
+    }
+
+    long long t0 = now_ns();
+    out[0] = (unsigned char)(total >> 24);
+    out[1] = (unsigned char)(total >> 16);
+    out[2] = (unsigned char)(total >> 8);
+    out[3] = (unsigned char)total;
+    size_t n = COMPRESS_HEADER_SIZE + compress_block(src, total, out + COMPRESS_HEADER_SIZE);
+    __atomic_fetch_add(&nanos, (unsigned long long)(now_ns() - t0), __ATOMIC_RELAXED);
+    free(flat);
+
+    if (n >= total) {
+        __atomic_fetch_add(&skipped, 1, __ATOMIC_RELAXED);
+        free(out);
+        return 1;
+    }
+    __atomic_fetch_add(&packed, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&bytes_in, total, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&bytes_out, n, __ATOMIC_RELAXED);
+
+    /* Puede quedar en caché mientras viva la instantánea: devolver el sobrante */
+    unsigned char *shrunk = realloc(out, n);
+    *data = (char *)(shrunk ? shrunk : out);
+    *len  = n;
+    return 0;
+}
+
+void compress_note_sent(size_t raw, size_t wire)
+{
+    __atomic_fetch_add(&sent, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&sent_raw, raw, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&sent_wire, wire, __ATOMIC_RELAXED);
+}
+
+void compress_stats(CompressStats *stats)
+{
+    stats->packed    = __atomic_load_n(&packed, __ATOMIC_RELAXED);
+    stats->skipped   = __atomic_load_n(&skipped, __ATOMIC_RELAXED);
+    stats->bytes_in  = __atomic_load_n(&bytes_in, __ATOMIC_RELAXED);
+    stats->bytes_out = __atomic_load_n(&bytes_out, __ATOMIC_RELAXED);
+    stats->nanos     = __atomic_load_n(&nanos, __ATOMIC_RELAXED);
+    stats->sent      = __atomic_load_n(&sent, __ATOMIC_RELAXED);
+    stats->sent_raw  = __atomic_load_n(&sent_raw, __ATOMIC_RELAXED);
+    stats->sent_wire = __atomic_load_n(&sent_wire, __ATOMIC_RELAXED);
+}
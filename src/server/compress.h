@@ -0,0 +1,64 @@
+#ifndef COMPRESS_H
+#define COMPRESS_H
+
+#include <stddef.h>
+#include <sys/uio.h>
+
+/*
+ * Compresión de mensajes (COMPRESS LZ, solo en modo FRAMED). Un mensaje
+ * que supera el umbral de la conexión viaja comprimido y todos sus
+ * frames llevan FRAME_F_COMPRESSED. El payload es:
+ *
+ *   u32            largo sin comprimir (big-endian)
+ *   secuencias     token u8: 4 bits altos = literales, 4 bajos = largo
+ *                  del match - 4; un nibble en 15 sigue en bytes
+ *                  extra que se suman hasta uno menor que 255. Después
+ *                  del token van los literales, el offset del match
+ *                  (u16 little-endian, 1..65535) y el largo extra.
+ *                  La última secuencia solo lleva literales.
+ *
+ * Es un LZ77 sin entropía, del estilo de LZ4: no necesita bibliotecas,
+ * comprime en una pasada con una tabla hash y se descomprime con copias.
+ * Los nombres y columnas repetidos de las tablas de procesos se reducen
+ * a un par de bytes. Las respuestas compartidas (snapshot.h) se comprimen
+ * una vez por instantánea; el resto, por mensaje.
+ */
+
+#define COMPRESS_HEADER_SIZE    4
+#define COMPRESS_MIN_DEFAULT    1024    /* Umbral si el cliente no indica otro */
+#define COMPRESS_MIN_FLOOR      64      /* Por debajo no compensa ni la cabecera */
+
+typedef struct {
+    unsigned long packed;           /* Mensajes comprimidos */
+    unsigned long skipped;          /* No se achicaban: van sin comprimir */
+    unsigned long long bytes_in;    /* Bytes comprimidos (una vez cada uno) */
+    unsigned long long bytes_out;
+    unsigned long long nanos;       /* Tiempo comprimiendo */
+    unsigned long sent;             /* Mensajes enviados comprimidos */
+    unsigned long long sent_raw;    /* Su tamaño sin comprimir */
+    unsigned long long sent_wire;   /* Lo que ocuparon en la red */
+} CompressStats;
+
+/* Cota del bloque comprimido de len bytes (sin la cabecera). */
+size_t compress_bound(size_t len);
+
+/*
+ * Comprime src en dst (al menos compress_bound(len) bytes) sin cabecera.
+ * Retorna los bytes escritos.
+ */
+size_t compress_block(const unsigned char *src, size_t len, unsigned char *dst);
+
+/*
+ * Comprime los segmentos de iov en un payload nuevo (con cabecera) que
+ * el llamador libera con free(). Retorna 0 si OK, 1 si no se achica (no
+ * se genera nada), -1 sin memoria.
+ */
+int compress_message(const struct iovec *iov, int iovcnt, char **data, size_t *len);
+
+/* Cuenta un mensaje enviado comprimido: raw bytes originales, wire en la red. */
+void compress_note_sent(size_t raw, size_t wire);
+
+/* Copia los contadores. */
+void compress_stats(CompressStats *stats);
+
+#endif /* COMPRESS_H */
@@ -0,0 +1,236 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/wait.h>
+
+#include "jobs.h"
+
+#define JOBS_BUCKETS  (JOBS_CAPACITY * 2)
+
+typedef struct {
+    JobInfo info;
+    unsigned long seq;      /* Orden de llegada, para listar y reemplazar */
+    int used;
+    int hnext;              /* Siguiente en el bucket o libre (índice + 1, 0 = fin) */
+} Slot;
+
+static pthread_mutex_t jobs_lock = PTHREAD_MUTEX_INITIALIZER;
+static Slot slots[JOBS_CAPACITY];
+static int buckets[JOBS_BUCKETS];   /* Primer slot del bucket (índice + 1) */
+static int used;                    /* Slots entregados alguna vez (prefijo de slots) */
+static int free_list;               /* Slots descartados para reusar (índice + 1) */
+static int cursor;                  /* Por donde sigue la búsqueda de reemplazo */
+static unsigned long seq;
+
+static long long realtime_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static unsigned int bucket_of(pid_t pid)
+{
+    return ((unsigned int)pid * 2654435761u) % JOBS_BUCKETS;
+}
+
+static Slot *find(pid_t pid)
+{
+    for (int i = buckets[bucket_of(pid)]; i; i = slots[i - 1].hnext) {
+        if (slots[i - 1].info.pid == pid)
+            return &slots[i - 1];
+    }
+    return NULL;
+}
+
+static void unlink_slot(Slot *slot)
+{
+    int idx = (int)(slot - slots) + 1;
+    for (int *link = &buckets[bucket_of(slot->info.pid)]; *link;
+         link = &slots[*link - 1].hnext) {
+        if (*link == idx) {
+            *link = slot->hnext;
+            break;
+        }
+    }
+    slot->used = 0;
+}
+
+/* Descarta un registro: su slot vuelve a la lista libre. */
+static void release_slot(Slot *slot)
+{
+    unlink_slot(slot);
+    slot->hnext = free_list;
+    free_list = (int)(slot - slots) + 1;
+}
+
+/*
+ * Toma un slot descartado, uno sin usar o, con la tabla llena, el del
+ * registro terminado más antiguo que encuentre el cursor. Si todos siguen
+ * corriendo se pierde el que está bajo el cursor.
+ */
+static Slot *alloc_slot(pid_t pid)
+{
+    Slot *slot = NULL;
+
+    if (free_list) {
+        slot = &slots[free_list - 1];
+        free_list = slot->hnext;
+    } else if (used < JOBS_CAPACITY) {
+        slot = &slots[used++];
+    } else {
+        for (int n = 0; n < JOBS_CAPACITY && !slot; n++) {
+            Slot *s = &slots[(cursor + n) % JOBS_CAPACITY];
+            if (!s->info.running)
+                slot = s;
+        }
+        if (!slot)
+            slot = &slots[cursor];
+        cursor = (int)(slot - slots + 1) % JOBS_CAPACITY;
+        unlink_slot(slot);
+    }
+
+    memset(&slot->info, 0, sizeof(slot->info));
+    slot->info.pid = pid;
+    slot->seq = ++seq;
+    slot->used = 1;
+    slot->hnext = buckets[bucket_of(pid)];
+    buckets[bucket_of(pid)] = (int)(slot - slots) + 1;
+    return slot;
+}
+
+void jobs_started(pid_t pid, const char *command, int group)
+{
+    long long now = realtime_ms();
+
+    pthread_mutex_lock(&jobs_lock);
+    Slot *slot = find(pid);
+    /*
+     * La salida puede llegar antes que este registro (el recolector corre
+     * en otro hilo): en ese caso el slot ya existe sin inicio. Si tiene
+     * inicio es un registro viejo de un PID reutilizado.
+     */
+    if (slot && (slot->info.running || slot->info.started_ms != 0)) {
+        release_slot(slot);
+        slot = NULL;
+    }
+    if (!slot) {
+        slot = alloc_slot(pid);
+        slot->info.running = 1;
+    }
+    slot->info.started_ms = now;
+    slot->info.group = group;
+    snprintf(slot->info.command, sizeof(slot->info.command), "%s", command);
+    pthread_mutex_unlock(&jobs_lock);
+}
+
+void jobs_exited(pid_t pid, int status, const struct rusage *ru)
+{
+    long long now = realtime_ms();
+
+    pthread_mutex_lock(&jobs_lock);
+    Slot *slot = find(pid);
+    if (!slot)
+        slot = alloc_slot(pid);
+    slot->info.running = 0;
+    slot->info.status = status;
+    slot->info.ended_ms = now;
+    slot->info.utime_us = ru->ru_utime.tv_sec * 1000000LL + ru->ru_utime.tv_usec;
+    slot->info.stime_us = ru->ru_stime.tv_sec * 1000000LL + ru->ru_stime.tv_usec;
+    slot->info.maxrss_kb = ru->ru_maxrss;
+    pthread_mutex_unlock(&jobs_lock);
+}
+
+int jobs_lookup(pid_t pid, JobInfo *info)
+{
+    pthread_mutex_lock(&jobs_lock);
+    Slot *slot = find(pid);
+    if (slot)
+        *info = slot->info;
+    pthread_mutex_unlock(&jobs_lock);
+    return slot ? 0 : -1;
+}
+
+/* Hora local HH:MM:SS de un tiempo en ms ("-" si no se conoce). */
+static void format_clock(long long ms, char *buf, size_t size)
+{
+    struct tm tm;
+    time_t secs = (time_t)(ms / 1000);
+
+    if (ms == 0 || !localtime_r(&secs, &tm))
+        snprintf(buf, size, "-");
+    else
+        strftime(buf, size, "%H:%M:%S", &tm);
+}
+
+void jobs_format_one(const JobInfo *info, RespBuf *out)
+{
+    char start[16], end[16];
+
+    format_clock(info->started_ms, start, sizeof(start));
+    if (info->running) {
+        respbuf_printf(out, "PID %d '%s': en ejecucion desde %s%s\n",
+                       info->pid, info->command, start,
+                       info->group ? ", lidera su grupo" : "");
+        return;
+    }
+
+    format_clock(info->ended_ms, end, sizeof(end));
+    if (WIFSIGNALED(info->status))
+        respbuf_printf(out, "PID %d '%s': termino por la senal %d",
+                       info->pid, info->command, WTERMSIG(info->status));
+    else
+        respbuf_printf(out, "PID %d '%s': termino (codigo %d)",
+                       info->pid, info->command, WEXITSTATUS(info->status));
+    respbuf_printf(out, ", inicio %s, fin %s, cpu usr %.3f s sys %.3f s, rss max %ld KB\n",
+                   start, end, info->utime_us / 1e6, info->stime_us / 1e6,
+                   info->maxrss_kb);
+}
+
+static int cmp_seq(const void *a, const void *b)
+{
+    const Slot *sa = a, *sb = b;
+    return (sa->seq > sb->seq) - (sa->seq < sb->seq);
+}
+
+void jobs_format(RespBuf *out)
+{
+    Slot *copy = malloc(sizeof(Slot) * JOBS_CAPACITY);
+    int count = 0;
+
+    if (!copy) {
+        respbuf_puts(out, "Error: Sin memoria.\n");
+        return;
+    }
+    pthread_mutex_lock(&jobs_lock);
+    for (int i = 0; i < used; i++) {
+        if (slots[i].used)
+            copy[count++] = slots[i];
+    }
+    pthread_mutex_unlock(&jobs_lock);
+    qsort(copy, (size_t)count, sizeof(Slot), cmp_seq);
+
+    respbuf_printf(out, "%7s %-10s %6s %8s %8s %9s %9s %9s %s\n", "PID", "ESTADO",
+                   "CODIGO", "INICIO", "FIN", "USR s", "SYS s", "RSS KB", "COMANDO");
+    for (int i = 0; i < count; i++) {
+        const JobInfo *j = &copy[i].info;
+        char start[16], end[16];
+
+        format_clock(j->started_ms, start, sizeof(start));
+        if (j->running) {
+            respbuf_printf(out, "%7d %-10s %6s %8s %8s %9s %9s %9s %s\n", j->pid,
+                           "corriendo", "-", start, "-", "-", "-", "-", j->command);
+            continue;
+        }
+        format_clock(j->ended_ms, end, sizeof(end));
+        int signaled = WIFSIGNALED(j->status);
+        respbuf_printf(out, "%7d %-10s %6d %8s %8s %9.3f %9.3f %9ld %s\n", j->pid,
+                       signaled ? "senal" : "salio",
+                       signaled ? WTERMSIG(j->status) : WEXITSTATUS(j->status),
+                       start, end, j->utime_us / 1e6, j->stime_us / 1e6,
+                       j->maxrss_kb, j->command);
+    }
+    free(copy);
+}
@@ -0,0 +1,48 @@
+#ifndef JOBS_H
+#define JOBS_H
+
+#include <sys/types.h>
+#include <sys/resource.h>
+
+#include "respbuf.h"
+
+/*
+ * Tabla de los procesos lanzados con START: comando, inicio y, cuando
+ * terminan, estado de salida, consumo de CPU y memoria (de wait4) y fin.
+ * Tiene capacidad fija; al llenarse se reemplaza el registro terminado
+ * más antiguo. Las consultas van por un índice hash por PID y no hacen
+ * llamadas al sistema: todo se guarda al ocurrir el evento.
+ */
+
+#define JOBS_CAPACITY     1024
+#define JOBS_COMMAND_SIZE 128
+
+typedef struct {
+    pid_t pid;
+    int running;                /* 1 mientras no llegue la salida */
+    int group;                  /* Lidera su propio grupo (START --group) */
+    int status;                 /* Estado de waitpid (si terminó) */
+    long long started_ms;       /* Tiempo real (epoch) en ms */
+    long long ended_ms;
+    long long utime_us;         /* CPU de usuario y de sistema */
+    long long stime_us;
+    long maxrss_kb;             /* Memoria residente máxima */
+    char command[JOBS_COMMAND_SIZE];
+} JobInfo;
+
+/* Registra un proceso recién lanzado; group si lidera su propio grupo. */
+void jobs_started(pid_t pid, const char *command, int group);
+
+/* Registra la salida de un proceso (desde el hilo recolector). */
+void jobs_exited(pid_t pid, int status, const struct rusage *ru);
+
+/* Copia el registro del PID en info. Retorna 0 si existe, -1 si no. */
+int jobs_lookup(pid_t pid, JobInfo *info);
+
+/* Escribe una línea de estado de un registro (respuesta de STATUS). */
+void jobs_format_one(const JobInfo *info, RespBuf *out);
+
+/* Escribe la tabla completa, del más antiguo al más nuevo (JOBS). */
+void jobs_format(RespBuf *out);
+
+#endif /* JOBS_H */
@@ -1,98 +1,581 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <unistd.h>
-#include <pthread.h>
 #include <arpa/inet.h>
 #include <sys/socket.h>
 #include <signal.h>
 #include <sys/wait.h>
 #include <errno.h>
 #include <ctype.h>
+#include <limits.h>
+#include <pthread.h>
+
+#include "snapshot.h"
+#include "procevents.h"
+#include "respbuf.h"
+#include "proto.h"
+#include "reactor.h"
+#include "workers.h"
+#include "spawner.h"
+#include "jobs.h"
+#include "supervisor.h"
+#include "stopper.h"
+#include "timerwheel.h"
+#include "query.h"
+#include "wire.h"
+#include "compress.h"
 
 #define TCP_PORT 5002
-#define BUFFER_SIZE 65536
+#define RESPONSE_SIZE 4096
+#define WORKER_THREADS 4
+#define DEFAULT_BACKLOG SOMAXCONN
+#define EVENT_INTERVAL_MS 500   // Ventana en la que se agrupan los cambios para SUBSCRIBE
 
-// Función para listar procesos (estilo ps)
-void list_processes(char *buffer, size_t size) {
+// Reactores (uno por shard), para el reporte de STATS
+static Reactor *shards;
+static int shard_count;
+
+// Listado de respaldo con 'ps' (solo si /proc no está disponible)
+static void list_processes_ps(RespBuf *out) {
     FILE *fp;
     char path[1035];
 
     // Ejecuta 'ps' para obtener PID y comando
     fp = popen("ps -e -o pid,comm", "r");
     if (fp == NULL) {
-        snprintf(buffer, size, "Error: Failed to run ps command\n");
+        respbuf_puts(out, "Error: Failed to run ps command\n");
         return;
     }
 
-    strcpy(buffer, "");
     while (fgets(path, sizeof(path), fp) != NULL) {
-        if (strlen(buffer) + strlen(path) < size - 1) {
-            strcat(buffer, path);
-        } else {
+        if (respbuf_puts(out, path) != 0) {
             break;
         }
     }
     pclose(fp);
 }
 
-// Función para detener un proceso
-void stop_process(char *pid_str, char *buffer, size_t size) {
-    // Validar que pid_str no sea NULL o vacío
-    if (pid_str == NULL || strlen(pid_str) == 0) {
-        snprintf(buffer, size, "Error: PID no especificado.\n");
-        return;
+// Con COMPRESS, avisa al reactor si la respuesta compartida ya salió
+// comprimida de la caché o si va en claro (no vale la pena reintentarlo)
+static void mark_packed(Conn *conn, int res) {
+    if (conn->compress_min) {
+        conn->packed = res > 0 ? 1 : -1;
     }
+}
 
-    // Validar que pid_str contenga solo dígitos
-    for (int i = 0; pid_str[i] != '\0'; i++) {
-        if (!isdigit((unsigned char)pid_str[i])) {
-            snprintf(buffer, size, "Error: PID invalido '%s'. Debe ser un numero.\n", pid_str);
-            return;
+// Función para listar procesos (estilo ps): comparte la respuesta ya
+// formateada de la caché, sin copiarla
+void list_processes(Conn *conn, RespBuf *out) {
+    Snapshot *snap = snapshot_acquire();
+    if (snap == NULL) {
+        // Si solo faltaba escanear, el comando se repite desde un worker
+        if (!snapshot_missed()) {
+            list_processes_ps(out);
         }
+        return;
+    }
+    mark_packed(conn, snapshot_attach(snap, out, conn->compress_min));
+}
+
+// LIST y LIST LONG con ENCODING BINARY: la tabla codificada (wire.h), que
+// se comparte entre clientes igual que el texto
+static void list_processes_binary(Conn *conn, RespBuf *out, int metrics) {
+    Snapshot *snap = metrics ? snapshot_acquire_metrics() : snapshot_acquire();
+    if (snap == NULL) {
+        respbuf_puts(out, "Error: No se pudo leer /proc.\n");
+        return;
+    }
+    int res = snapshot_attach_binary(snap, out, conn->compress_min);
+    if (res < 0) {
+        snapshot_release(snap);
+        respbuf_puts(out, "Error: Sin memoria.\n");
+        return;
+    }
+    mark_packed(conn, res);
+}
+
+// Lee un número de generación. Retorna 0 si OK, -1 si es inválido
+static int parse_generation(const char *str, unsigned long *gen) {
+    char *end = NULL;
+
+    if (str == NULL || !isdigit((unsigned char)str[0])) {
+        return -1;
+    }
+    errno = 0;
+    *gen = strtoul(str, &end, 10);
+    return (errno != 0 || *end != '\0') ? -1 : 0;
+}
+
+// LIST LONG: todas las columnas (UID, estado, hilos, RSS, %CPU, inicio).
+// Las métricas se comparten igual que la lista simple: como mucho una
+// muestra por TTL para todos los clientes
+static void list_processes_long(Conn *conn, RespBuf *out) {
+    Snapshot *snap = snapshot_acquire_metrics();
+    if (snap == NULL) {
+        respbuf_puts(out, "Error: No se pudo leer /proc.\n");
+        return;
+    }
+    mark_packed(conn, snapshot_attach_long(snap, out, conn->compress_min));
+}
+
+// LIST SINCE <generacion>: solo los cambios desde esa generación
+static void list_processes_since(Conn *conn, char *arg, RespBuf *out) {
+    char *save;
+    char *word = strtok_r(arg, " ", &save);
+    char *gen_str = strtok_r(NULL, " ", &save);
+    unsigned long since;
+
+    if (word == NULL || strcasecmp(word, "SINCE") != 0 || gen_str == NULL ||
+        strtok_r(NULL, " ", &save) != NULL) {
+        respbuf_puts(out, "Error: Uso: LIST, LIST LONG, LIST SINCE <generacion> o LIST WHERE/SORT/LIMIT/FIELDS\n");
+        return;
+    }
+    if (parse_generation(gen_str, &since) != 0) {
+        respbuf_printf(out, "Error: Generacion invalida '%s'.\n", gen_str);
+        return;
+    }
+
+    Snapshot *snap = snapshot_acquire();
+    if (snap == NULL) {
+        respbuf_puts(out, "Error: No se pudo leer /proc.\n");
+        return;
+    }
+    mark_packed(conn, snapshot_attach_since(snap, since, out, conn->compress_min));
+}
+
+// LIST WHERE ... SORT ... OFFSET ... LIMIT ... FIELDS ... AT ...: filtra,
+// ordena y pagina en el servidor, sobre la tabla de la instantánea compartida
+static void list_processes_query(char *arg, int binary, RespBuf *out) {
+    Query query;
+    char err[128];
+
+    if (query_parse(arg, &query, err, sizeof(err)) != 0) {
+        respbuf_printf(out, "Error: %s.\n", err);
+        return;
+    }
+
+    // Con AT, la misma tabla de las páginas anteriores si sigue en la historia
+    int metrics = query_needs_metrics(&query);
+    Snapshot *snap = query.at ? snapshot_acquire_generation(query.at, metrics) : NULL;
+    if (snap == NULL) {
+        snap = metrics ? snapshot_acquire_metrics() : snapshot_acquire();
+    }
+    if (snap == NULL) {
+        respbuf_puts(out, "Error: No se pudo leer /proc.\n");
+        return;
     }
+    int res = binary && query_binary(&query)
+        ? query_run_binary(&query, &snap->table, snap->generation, out)
+        : query_run(&query, &snap->table, snap->pid_width, snap->generation, out);
+    if (res != 0) {
+        respbuf_puts(out, "Error: Sin memoria para la consulta.\n");
+    }
+    snapshot_release(snap);
+}
+
+// SUBSCRIBE [<generacion>]: responde como LIST SINCE y deja la conexión
+// recibiendo eventos con los cambios siguientes. Si la conexión saludó
+// sin PUSH no espera eventos: se rechaza en vez de intercalarlos
+static void subscribe(Conn *conn, char *arg, RespBuf *out) {
+    unsigned long since = 0;
 
-    int pid = atoi(pid_str);
-    
-    // Validar rango de PID
-    if (pid <= 0) {
-        snprintf(buffer, size, "Error: PID invalido %d. Debe ser mayor que 0.\n", pid);
+    if (!conn->push) {
+        respbuf_puts(out, "Error: SUBSCRIBE requiere la capacidad PUSH de HELLO.\n");
         return;
     }
 
+    if (arg && strlen(arg) > 0 && parse_generation(arg, &since) != 0) {
+        respbuf_printf(out, "Error: Generacion invalida '%s'.\n", arg);
+        return;
+    }
+
+    Snapshot *snap = snapshot_acquire();
+    if (snap == NULL) {
+        respbuf_puts(out, "Error: No se pudo leer /proc.\n");
+        return;
+    }
+    reactor_subscribe(conn, snap->generation);
+    mark_packed(conn, snapshot_attach_since(snap, since, out, conn->compress_min));
+}
+
+// Evento para un suscriptor: los cambios desde lo último que recibió.
+// Corre en el reactor: usa la generación publicada (el publicador ya la
+// escaneó) y, si salió de la historia, la vigente solo si no hay que escanear
+static int push_changes(Conn *conn, RespBuf *out) {
+    unsigned long published = __atomic_load_n(&conn->reactor->published, __ATOMIC_ACQUIRE);
+    Snapshot *snap = snapshot_acquire_generation(published, 0);
+    if (snap == NULL) {
+        snapshot_set_nonblocking(1);
+        snap = snapshot_acquire();
+    }
+    if (snap == NULL) {
+        return 0;
+    }
+    if (snap->generation == conn->sub_gen) {
+        snapshot_release(snap);
+        return 0;
+    }
+    unsigned long since = conn->sub_gen;
+    conn->sub_gen = snap->generation;
+    mark_packed(conn, snapshot_attach_since(snap, since, out, conn->compress_min));
+    return 1;
+}
+
+// Hilo que detecta cambios en la tabla y avisa a los reactores. Los
+// cambios de cada ventana de EVENT_INTERVAL_MS van en un solo evento
+static void *event_publisher(void *arg) {
+    unsigned long last = 0;
+    (void)arg;
+
+    for (;;) {
+        usleep(EVENT_INTERVAL_MS * 1000);
+
+        unsigned long subscribers = 0;
+        for (int i = 0; i < shard_count; i++) {
+            subscribers += __atomic_load_n(&shards[i].subscriptions, __ATOMIC_RELAXED);
+        }
+        if (subscribers == 0) {
+            continue; // Nadie escucha: no escanear
+        }
+
+        Snapshot *snap = snapshot_acquire();
+        if (snap == NULL) {
+            continue;
+        }
+        unsigned long gen = snap->generation;
+        snapshot_release(snap);
+
+        if (gen != last) {
+            last = gen;
+            for (int i = 0; i < shard_count; i++) {
+                reactor_publish(&shards[i], gen);
+            }
+        }
+    }
+    return NULL;
+}
+
+// PIDs que STOP nunca toca: init, el propio servidor y su auxiliar
+static int stop_protected(int pid, pid_t helper) {
+    return pid == 1 || pid == getpid() || (helper > 0 && pid == helper);
+}
+
+// Lista los PIDs cuyo resultado es `want` en una línea con título
+static void stop_report(RespBuf *out, const char *title, const int *pids,
+                        const int *errs, int count, int want) {
+    int shown = 0;
+    for (int i = 0; i < count; i++) {
+        if (errs[i] != want) {
+            continue;
+        }
+        if (shown++ == 0) {
+            respbuf_printf(out, "  %s:", title);
+        }
+        respbuf_printf(out, " %d", pids[i]);
+    }
+    if (shown > 0) {
+        respbuf_puts(out, "\n");
+    }
+}
+
+// Un proceso lanzado con START --group se detiene con todo su grupo, pero
+// solo mientras siga corriendo y liderando ese grupo: un registro de un
+// trabajo que ya terminó puede tener un PID que ahora es de otro proceso
+static int stop_is_group(int pid) {
+    JobInfo info;
+    return jobs_lookup(pid, &info) == 0 && info.group && info.running &&
+           stopper_leads_group(pid);
+}
+
+// Señales con las que STOP da por detenido a un trabajo supervisado. Con
+// las demás (HUP, USR1...) el proceso suele seguir y el trabajo sigue
+// supervisado, salvo que venza el plazo: el SIGKILL lo avisa el stopper
+static int stop_terminates(int sig) {
+    return sig == SIGTERM || sig == SIGINT || sig == SIGQUIT || sig == SIGKILL;
+}
+
+// Detiene un solo PID con la respuesta de siempre
+static void stop_single(int pid, int sig, long grace, pid_t helper, RespBuf *out) {
     // Proteger procesos críticos del sistema
     if (pid == 1) {
-        snprintf(buffer, size, "Error: No se puede detener el proceso init (PID 1).\n");
+        respbuf_puts(out, "Error: No se puede detener el proceso init (PID 1).\n");
         return;
     }
+    if (stop_protected(pid, helper)) {
+        respbuf_printf(out, "Error: No se puede detener el servidor ni su auxiliar (PID %d).\n", pid);
+        return;
+    }
+
+    // La señal va por pidfd (o por pgid al grupo): si ya no existe falla con ESRCH
+    int group = stop_is_group(pid);
+    int err = stopper_signal(pid, sig, (unsigned int)grace, group);
 
-    // Verificar si el proceso existe antes de intentar matarlo
-    if (kill(pid, 0) == -1) {
-        if (errno == ESRCH) {
-            snprintf(buffer, size, "Error: El proceso %d no existe.\n", pid);
-        } else if (errno == EPERM) {
-            snprintf(buffer, size, "Error: Sin permisos para detener el proceso %d.\n", pid);
+    // Si es un trabajo supervisado y la señal lo termina, que no se relance
+    if (err == 0 && stop_terminates(sig)) {
+        supervisor_stopping(pid);
+    }
+    if (err == ESRCH) {
+        respbuf_printf(out, "Error: El proceso %d no existe.\n", pid);
+    } else if (err == EPERM) {
+        respbuf_printf(out, "Error: Sin permisos para detener el proceso %d.\n", pid);
+    } else if (err != 0) {
+        respbuf_printf(out, "Error al detener proceso %d: %s\n", pid, strerror(err));
+    } else if (sig == SIGKILL) {
+        respbuf_printf(out, "%s %d detenido exitosamente.\n", group ? "Grupo" : "Proceso", pid);
+    } else {
+        const char *name = stopper_signal_name(sig);
+        const char *what = group ? "Grupo" : "Proceso";
+        if (name) {
+            respbuf_printf(out, "%s %d: enviada SIG%s", what, pid, name);
         } else {
-            snprintf(buffer, size, "Error: No se puede acceder al proceso %d: %s\n", 
-                     pid, strerror(errno));
+            respbuf_printf(out, "%s %d: enviada la senal %d", what, pid, sig);
         }
+        if (grace > 0) {
+            respbuf_printf(out, ", se enviara SIGKILL si no termina en %ld ms.\n", grace);
+        } else {
+            respbuf_puts(out, ".\n");
+        }
+    }
+}
+
+// STOP --job <n>: si el trabajo corre, detiene su proceso como un STOP
+// normal; si espera para relanzarse, lo deja detenido sin señales
+static void stop_job(const char *id_str, int sig, long grace, RespBuf *out) {
+    char *end;
+    long id = strtol(id_str, &end, 10);
+    pid_t pid;
+
+    if (end == id_str || *end != '\0' || id <= 0 || id > INT_MAX) {
+        respbuf_printf(out, "Error: Trabajo invalido '%s'.\n", id_str);
+        return;
+    }
+    int err = supervisor_stop_job((int)id, &pid);
+    if (err == ESRCH) {
+        respbuf_printf(out, "Error: No existe el trabajo %ld (ver SUPERVISED).\n", id);
+    } else if (err == EALREADY) {
+        respbuf_printf(out, "Error: El trabajo %ld ya no esta corriendo.\n", id);
+    } else if (err == EBUSY) {
+        respbuf_printf(out, "Error: El trabajo %ld se esta relanzando, intenta de nuevo.\n", id);
+    } else if (pid == 0) {
+        respbuf_printf(out, "Trabajo %ld detenido: no se relanzara.\n", id);
+    } else {
+        SpawnerStats spawn;
+        spawner_stats(&spawn);
+        stop_single(pid, sig, grace, spawn.helper_pid, out);
+    }
+}
+
+// Función para detener procesos.
+// Sintaxis: [--signal=<senal>] [--grace=<ms>] seguido de uno o más PIDs,
+// de --name <glob> (por comm) o de --tree <pid> (el proceso y todos sus
+// descendientes) o de --job <n> (un trabajo supervisado, también mientras
+// espera para relanzarse). Por defecto envía SIGTERM y, si no termina en
+// STOPPER_DEFAULT_GRACE_MS, SIGKILL; la espera la lleva la rueda de
+// temporizadores, no este hilo. --name y --tree resuelven los PIDs con
+// un solo recorrido de la tabla de procesos y responden con un resumen.
+void stop_process(char *args, RespBuf *out) {
+    int sig = SIGTERM;
+    long grace = STOPPER_DEFAULT_GRACE_MS;
+    const char *pattern = NULL, *tree = NULL, *job = NULL;
+    char *save;
+
+    // Como mucho un PID por cada dos caracteres ("1 2 3")
+    size_t max_pids = strlen(args) / 2 + 1;
+    char **pid_strs = malloc(max_pids * sizeof(char *));
+    int npids = 0;
+    int *pids = NULL;
+    int *errs = NULL;
+    int count = 0;
+    if (pid_strs == NULL) {
+        respbuf_puts(out, "Error: Sin memoria.\n");
         return;
     }
 
-    // Intentar detener el proceso
-    if (kill(pid, SIGKILL) == 0) {
-        snprintf(buffer, size, "Proceso %d detenido exitosamente.\n", pid);
+    for (char *tok = strtok_r(args, " ", &save); tok != NULL; tok = strtok_r(NULL, " ", &save)) {
+        if (strncasecmp(tok, "--signal=", 9) == 0) {
+            sig = stopper_parse_signal(tok + 9);
+            if (sig < 0) {
+                respbuf_printf(out, "Error: Senal invalida '%s'.\n", tok + 9);
+                goto done;
+            }
+        } else if (strncasecmp(tok, "--grace=", 8) == 0) {
+            char *end;
+            grace = strtol(tok + 8, &end, 10);
+            if (end == tok + 8 || *end != '\0' || grace < 0 || grace > 3600000) {
+                respbuf_printf(out, "Error: Plazo invalido '%s' (ms, de 0 a 3600000).\n", tok + 8);
+                goto done;
+            }
+        } else if (strcasecmp(tok, "--name") == 0 || strcasecmp(tok, "--tree") == 0 ||
+                   strcasecmp(tok, "--job") == 0) {
+            char *value = strtok_r(NULL, " ", &save);
+            if (value == NULL) {
+                respbuf_printf(out, "Error: %s requiere un valor.\n", tok);
+                goto done;
+            }
+            if (tolower((unsigned char)tok[2]) == 'n') {
+                pattern = value;
+            } else if (tolower((unsigned char)tok[2]) == 't') {
+                tree = value;
+            } else {
+                job = value;
+            }
+        } else {
+            pid_strs[npids++] = tok;
+        }
+    }
+
+    if ((pattern != NULL) + (tree != NULL) + (job != NULL) + (npids > 0) != 1) {
+        respbuf_puts(out, pattern || tree || job || npids > 0
+                     ? "Error: Usa PIDs, --name, --tree o --job, uno solo por pedido.\n"
+                     : "Error: PID no especificado.\n");
+        goto done;
+    }
+    if (job) {
+        stop_job(job, sig, grace, out);
+        goto done;
+    }
+
+    // Validar los PIDs antes de enviar ninguna señal
+    for (int i = 0; i < npids || (tree && i == 0); i++) {
+        const char *pid_str = tree ? tree : pid_strs[i];
+        for (int j = 0; pid_str[j] != '\0'; j++) {
+            if (!isdigit((unsigned char)pid_str[j])) {
+                respbuf_printf(out, "Error: PID invalido '%s'. Debe ser un numero.\n", pid_str);
+                goto done;
+            }
+        }
+        if (atoi(pid_str) <= 0) {
+            respbuf_printf(out, "Error: PID invalido %d. Debe ser mayor que 0.\n", atoi(pid_str));
+            goto done;
+        }
+    }
+
+    SpawnerStats spawn;
+    spawner_stats(&spawn);
+
+    if (npids == 1) {
+        stop_single(atoi(pid_strs[0]), sig, grace, spawn.helper_pid, out);
+        goto done;
+    }
+
+    if (npids > 0) {
+        pids = malloc((size_t)npids * sizeof(int));
+        if (pids != NULL) {
+            for (int i = 0; i < npids; i++) {
+                pids[i] = atoi(pid_strs[i]);
+            }
+            count = npids;
+        }
     } else {
-        if (errno == EPERM) {
-            snprintf(buffer, size, "Error: Sin permisos para detener el proceso %d.\n", pid);
+        if (tree && atoi(tree) == 1) {
+            respbuf_puts(out, "Error: No se puede detener el arbol de init (PID 1).\n");
+            goto done;
+        }
+        // Tabla al día: la caché puede tener hasta un TTL de antigüedad
+        snapshot_invalidate();
+        Snapshot *snap = snapshot_acquire();
+        if (snap == NULL) {
+            respbuf_puts(out, "Error: No se pudo leer la tabla de procesos.\n");
+            goto done;
+        }
+        pids = malloc((size_t)(snap->table.count + 1) * sizeof(int));
+        if (pids != NULL) {
+            count = pattern ? proctable_match(&snap->table, pattern, pids)
+                            : proctable_descendants(&snap->table, atoi(tree), pids);
+        }
+        snapshot_release(snap);
+    }
+    errs = malloc((size_t)(count + 1) * sizeof(int));
+    if (pids == NULL || errs == NULL || count < 0) {
+        respbuf_puts(out, "Error: Sin memoria.\n");
+        goto done;
+    }
+    if (count == 0) {
+        if (pattern) {
+            respbuf_printf(out, "Error: Ningun proceso coincide con '%s'.\n", pattern);
         } else {
-            snprintf(buffer, size, "Error al detener proceso %d: %s\n", pid, strerror(errno));
+            respbuf_printf(out, "Error: El proceso %s no existe.\n", tree);
         }
+        goto done;
     }
+
+    int sent = 0;
+    for (int i = 0; i < count; i++) {
+        if (stop_protected(pids[i], spawn.helper_pid)) {
+            errs[i] = -1;
+            continue;
+        }
+        errs[i] = stopper_signal(pids[i], sig, (unsigned int)grace, stop_is_group(pids[i]));
+        if (errs[i] == 0) {
+            if (stop_terminates(sig)) {
+                supervisor_stopping(pids[i]);
+            }
+            sent++;
+        }
+    }
+
+    const char *name = stopper_signal_name(sig);
+    if (name) {
+        respbuf_printf(out, "STOP: enviada SIG%s a %d de %d procesos", name, sent, count);
+    } else {
+        respbuf_printf(out, "STOP: enviada la senal %d a %d de %d procesos", sig, sent, count);
+    }
+    if (sig != SIGKILL && grace > 0 && sent > 0) {
+        respbuf_printf(out, ", SIGKILL a los que no terminen en %ld ms", grace);
+    }
+    respbuf_puts(out, ".\n");
+    stop_report(out, "Detenidos", pids, errs, count, 0);
+    stop_report(out, "No existen", pids, errs, count, ESRCH);
+    stop_report(out, "Sin permisos", pids, errs, count, EPERM);
+    stop_report(out, "Protegidos", pids, errs, count, -1);
+    for (int i = 0; i < count; i++) {
+        if (errs[i] > 0 && errs[i] != ESRCH && errs[i] != EPERM) {
+            respbuf_printf(out, "  Error en %d: %s\n", pids[i], strerror(errs[i]));
+        }
+    }
+
+done:
+    free(pid_strs);
+    free(pids);
+    free(errs);
 }
 
-// Función para iniciar un proceso en segundo plano
+// Función para iniciar un proceso en segundo plano.
+// spawner_run() retorna cuando el exec terminó, con su error si falló, así
+// que la respuesta no depende de esperar un tiempo fijo.
+// Con "--restart=<politica>" delante queda como trabajo supervisado; con
+// "--group", en una sesión propia para que STOP detenga a todo el grupo.
 void start_process(char *command, char *buffer, size_t size) {
+    int policy = -1;
+    int flags = 0;
+
+    while (command != NULL && strncmp(command, "--", 2) == 0) {
+        char *option = command;
+        char *rest = strchr(option, ' ');
+        if (rest != NULL) {
+            *rest++ = '\0';
+            while (*rest == ' ') {
+                rest++;
+            }
+        }
+        if (strncasecmp(option, "--restart=", 10) == 0) {
+            policy = supervisor_parse_policy(option + 10);
+            if (policy < 0) {
+                snprintf(buffer, size, "Error: Politica de reinicio desconocida '%s' "
+                         "(never, on-failure, always).\n", option + 10);
+                return;
+            }
+        } else if (strcasecmp(option, "--group") == 0) {
+            flags |= SPAWNER_NEW_GROUP;
+        } else {
+            snprintf(buffer, size, "Error: Opcion desconocida '%s' (--restart=, --group).\n", option);
+            return;
+        }
+        command = rest;
+    }
+
     // Validar que el comando no sea NULL o vacío
     if (command == NULL || strlen(command) == 0) {
         snprintf(buffer, size, "Error: Comando vacio.\n");
@@ -119,67 +602,42 @@ void start_process(char *command, char *buffer, size_t size) {
         }
     }
 
-    pid_t pid = fork();
+    char cmd_copy[1025];
+    char *args[SPAWNER_MAX_ARGS];
+    if (spawner_split(command, cmd_copy, sizeof(cmd_copy), args) == 0) {
+        snprintf(buffer, size, "Error: Comando vacio.\n");
+        return;
+    }
 
-    if (pid < 0) {
-        snprintf(buffer, size, "Error: fork() fallo: %s\n", strerror(errno));
-    } else if (pid == 0) {
-        // Proceso hijo
-        char *args[16];
-        int i = 0;
-        
-        // Crear copia del comando para tokenizar
-        char cmd_copy[1024];
-        strncpy(cmd_copy, command, sizeof(cmd_copy) - 1);
-        cmd_copy[sizeof(cmd_copy) - 1] = '\0';
-        
-        char *token = strtok(cmd_copy, " ");
-        while (token != NULL && i < 15) {
-            args[i++] = token;
-            token = strtok(NULL, " ");
-        }
-        args[i] = NULL;
-
-        if (i == 0) {
-            exit(1); // No hay comando
-        }
-
-        // Redirigir stdout/stderr a /dev/null
-        freopen("/dev/null", "w", stdout);
-        freopen("/dev/null", "w", stderr);
-
-        execvp(args[0], args);
-        
-        // Si execvp retorna, hubo un error
-        exit(1); 
+    pid_t pid;
+    int job_id = 0;
+    int err;
+    if (policy >= 0) {
+        err = supervisor_launch(command, policy, flags, &pid, &job_id);
     } else {
-        // Proceso padre
-        // Esperar un momento para verificar si el proceso se inició correctamente
-        usleep(100000); // 100ms
-        
-        // Verificar si el proceso hijo sigue vivo
-        int status;
-        pid_t result = waitpid(pid, &status, WNOHANG);
-        
-        if (result == 0) {
-            // Proceso sigue corriendo
-            snprintf(buffer, size, "Proceso '%s' iniciado con PID %d\n", command, pid);
-        } else if (result == pid) {
-            // Proceso terminó inmediatamente
-            if (WIFEXITED(status)) {
-                snprintf(buffer, size, 
-                         "Error: El proceso termino inmediatamente (codigo %d).\n"
-                         "Verifica que el comando '%s' sea valido.\n", 
-                         WEXITSTATUS(status), command);
-            } else {
-                snprintf(buffer, size, 
-                         "Error: El proceso termino inesperadamente.\n"
-                         "Verifica que el comando '%s' sea valido.\n", command);
-            }
-        } else {
-            // Error en waitpid, pero asumimos que el proceso se inició
-            snprintf(buffer, size, "Proceso '%s' iniciado con PID %d\n", command, pid);
-        }
+        err = spawner_run(args, flags, &pid);
+    }
+    if (err == ENOSPC && policy >= 0) {
+        snprintf(buffer, size, "Error: No hay lugar para mas trabajos supervisados (max %d).\n",
+                 SUPERVISOR_MAX_JOBS);
+        return;
+    }
+    if (err != 0) {
+        snprintf(buffer, size,
+                 "Error: No se pudo ejecutar '%s': %s\n"
+                 "Verifica que el comando '%s' sea valido.\n",
+                 args[0], strerror(err), command);
+        return;
+    }
+
+    const char *group = (flags & SPAWNER_NEW_GROUP) ? ", grupo propio" : "";
+    if (policy >= 0) {
+        snprintf(buffer, size, "Proceso '%s' iniciado con PID %d (trabajo %d, reinicio %s%s)\n",
+                 command, pid, job_id, supervisor_policy_name(policy), group);
+    } else {
+        jobs_started(pid, command, (flags & SPAWNER_NEW_GROUP) != 0);
+        snprintf(buffer, size, "Proceso '%s' iniciado con PID %d%s\n", command, pid,
+                 *group ? " (grupo propio)" : "");
     }
 }
 
@@ -249,139 +707,599 @@ void normalize_command(char *cmd, char *normalized, size_t size) {
     normalized[size - 1] = '\0';
 }
 
-// Manejador del cliente TCP
-void *handle_client(void *socket_desc) {
-    int sock = *(int*)socket_desc;
-    free(socket_desc);
-    char buffer[BUFFER_SIZE];
-    char response[BUFFER_SIZE];
-    int read_size;
+// Ejecuta START en un worker: espera la respuesta del auxiliar sin frenar al reactor
+static void start_job(void *arg, RespBuf *out) {
+    char response[RESPONSE_SIZE];
+    start_process(arg, response, sizeof(response));
+    snapshot_invalidate();
+    respbuf_puts(out, response);
+    free(arg);
+}
 
-    struct sockaddr_in addr;
-    socklen_t addr_size = sizeof(struct sockaddr_in);
-    getpeername(sock, (struct sockaddr*)&addr, &addr_size);
-    printf("[TCP] Connection from %s\n", inet_ntoa(addr.sin_addr));
+// Aviso del recolector: un proceso iniciado con START terminó
+static void on_process_exit(pid_t pid, int status, const struct rusage *ru) {
+    jobs_exited(pid, status, ru);
+    supervisor_exited(pid, status);
+    if (WIFEXITED(status)) {
+        printf("[PROC] PID %d termino (codigo %d)\n", pid, WEXITSTATUS(status));
+    } else if (WIFSIGNALED(status)) {
+        printf("[PROC] PID %d termino por la senal %d\n", pid, WTERMSIG(status));
+    }
+}
+
+// STATUS <pid>: estado de un proceso lanzado con START, desde la tabla
+static void job_status(char *arg, RespBuf *out) {
+    char *end;
+    long pid = arg ? strtol(arg, &end, 10) : 0;
+    JobInfo info;
+
+    if (arg == NULL || end == arg || *end != '\0' || pid <= 0) {
+        respbuf_puts(out, "Error: STATUS requiere un PID.\nEjemplo: STATUS 1234\n");
+        return;
+    }
+    if (jobs_lookup((pid_t)pid, &info) != 0) {
+        respbuf_printf(out, "Error: El proceso %ld no fue iniciado por el servidor "
+                       "(o ya salio de la tabla).\n", pid);
+        return;
+    }
+    jobs_format_one(&info, out);
+}
+
+// Lee el umbral de COMPRESS. Retorna 0 si OK, -1 si es inválido
+static int parse_compress_min(const char *str, size_t *min) {
+    char *end = NULL;
+    long value;
+
+    if (str == NULL || !isdigit((unsigned char)str[0])) {
+        return -1;
+    }
+    errno = 0;
+    value = strtol(str, &end, 10);
+    if (errno != 0 || *end != '\0') {
+        return -1;
+    }
+    *min = value < COMPRESS_MIN_FLOOR ? COMPRESS_MIN_FLOOR : (size_t)value;
+    return 0;
+}
+
+// COMPRESS LZ [<umbral>] | COMPRESS OFF: comprime las respuestas de al
+// menos <umbral> bytes. Los frames comprimidos llevan FRAME_F_COMPRESSED
+static void set_compression(Conn *conn, char *arg, RespBuf *out) {
+    char *save = NULL;
+    char *mode = arg ? strtok_r(arg, " ", &save) : NULL;
+    char *min_str = mode ? strtok_r(NULL, " ", &save) : NULL;
+    size_t min = COMPRESS_MIN_DEFAULT;
+
+    if (mode && strcasecmp(mode, "OFF") == 0 && min_str == NULL) {
+        conn->compress_min = 0;
+        respbuf_puts(out, "OK COMPRESS OFF\n");
+        return;
+    }
+    if (mode == NULL || strcasecmp(mode, "LZ") != 0 || strtok_r(NULL, " ", &save) != NULL) {
+        respbuf_puts(out, "Error: Uso: COMPRESS LZ [<bytes>] o COMPRESS OFF\n");
+        return;
+    }
+    if (min_str && parse_compress_min(min_str, &min) != 0) {
+        respbuf_printf(out, "Error: Umbral invalido '%s'.\n", min_str);
+        return;
+    }
+    if (!conn->framed) {
+        respbuf_puts(out, "Error: COMPRESS requiere el modo FRAMED.\n");
+        return;
+    }
+    conn->compress_min = min;
+    respbuf_printf(out, "OK COMPRESS LZ %zu\n", min);
+}
+
+// HELLO <version> [<capacidad>,...]: el cliente propone la versión del
+// protocolo y lo que entiende; el servidor activa en la conexión lo que
+// conoce y responde en texto "OK HELLO <version> <aceptadas>". Capacidades:
+// FRAMED, BINARY (tablas en binario), LZ[=<bytes>] (compresión) y PUSH
+// (cambios de SUBSCRIBE como eventos; sin ella SUBSCRIBE se rechaza). Las
+// desconocidas se ignoran, así un cliente más nuevo funciona igual; las que
+// no son FRAMED lo requieren. Los clientes que no saludan siguen con los
+// comandos de siempre
+static int hello(Conn *conn, char *arg, RespBuf *out) {
+    char *save_args = NULL;
+    char *ver_str = arg ? strtok_r(arg, " ", &save_args) : NULL;
+    char *caps = ver_str ? strtok_r(NULL, " ", &save_args) : NULL;
+    char *end = NULL;
+    long version = ver_str ? strtol(ver_str, &end, 10) : 0;
+
+    if (ver_str == NULL || *end != '\0' || version < 1 ||
+        strtok_r(NULL, " ", &save_args) != NULL) {
+        respbuf_puts(out, "Error: Uso: HELLO <version> [FRAMED,BINARY,LZ[=<bytes>],PUSH]\n");
+        return CMD_CONTINUE;
+    }
+    if (version > PROTO_VERSION) {
+        version = PROTO_VERSION;
+    }
+
+    int framed = conn->framed, binary = 0, push = 0;
+    size_t lz = 0;
+    char *save = NULL;
+    for (char *cap = caps ? strtok_r(caps, ",", &save) : NULL; cap;
+         cap = strtok_r(NULL, ",", &save)) {
+        if (strcasecmp(cap, "FRAMED") == 0) {
+            framed = 1;
+        } else if (strcasecmp(cap, "BINARY") == 0) {
+            binary = 1;
+        } else if (strcasecmp(cap, "PUSH") == 0) {
+            push = 1;
+        } else if (strcasecmp(cap, "LZ") == 0) {
+            lz = COMPRESS_MIN_DEFAULT;
+        } else if (strncasecmp(cap, "LZ=", 3) == 0) {
+            // Con un umbral inválido, el del servidor
+            if (parse_compress_min(cap + 3, &lz) != 0) {
+                lz = COMPRESS_MIN_DEFAULT;
+            }
+        }
+    }
+
+    // Todo lo demás viaja en frames: sin FRAMED queda en texto, como antes
+    if (!framed) {
+        binary = push = 0;
+        lz = 0;
+    }
+    conn->binary = binary;
+    conn->compress_min = lz;
+    conn->push = push;
+    if (!push) {
+        reactor_unsubscribe(conn);
+    }
+
+    respbuf_printf(out, "OK HELLO %ld", version);
+    if (framed) {
+        respbuf_puts(out, " FRAMED");
+        if (binary) {
+            respbuf_printf(out, ",BINARY=%d", WIRE_VERSION);
+        }
+        if (lz) {
+            respbuf_printf(out, ",LZ=%zu", lz);
+        }
+        if (push) {
+            respbuf_puts(out, ",PUSH");
+        }
+    }
+    respbuf_puts(out, "\n");
+    return framed && !conn->framed ? CMD_FRAMED : CMD_CONTINUE;
+}
+
+// Reporta los contadores de cada shard y de la caché de LIST
+static void report_stats(RespBuf *out) {
+    unsigned long total_conn = 0, total_acc = 0, total_req = 0, total_sub = 0, total_snd = 0;
+    unsigned long total_thr = 0;
+
+    respbuf_printf(out, "%5s %4s %11s %10s %10s %10s %12s\n",
+                   "SHARD", "CPU", "CONEXIONES", "ACEPTADAS", "COMANDOS", "ENVIOS", "SUSCRIPTORES");
+    for (int i = 0; i < shard_count; i++) {
+        unsigned long conn = __atomic_load_n(&shards[i].connections, __ATOMIC_RELAXED);
+        unsigned long acc  = __atomic_load_n(&shards[i].accepted, __ATOMIC_RELAXED);
+        unsigned long req  = __atomic_load_n(&shards[i].requests, __ATOMIC_RELAXED);
+        unsigned long snd  = __atomic_load_n(&shards[i].flushes, __ATOMIC_RELAXED);
+        unsigned long sub  = __atomic_load_n(&shards[i].subscriptions, __ATOMIC_RELAXED);
+        respbuf_printf(out, "%5d %4d %11lu %10lu %10lu %10lu %12lu\n",
+                       i, shards[i].cpu, conn, acc, req, snd, sub);
+        total_conn += conn;
+        total_acc  += acc;
+        total_req  += req;
+        total_snd  += snd;
+        total_thr  += __atomic_load_n(&shards[i].throttles, __ATOMIC_RELAXED);
+        total_sub  += sub;
+    }
+    respbuf_printf(out, "%5s %4s %11lu %10lu %10lu %10lu %12lu\n",
+                   "TOTAL", "", total_conn, total_acc, total_req, total_snd, total_sub);
+    respbuf_printf(out, "CONTRAPRESION: %lu pausas por clientes que no leen (umbral %u KB)\n",
+                   total_thr, REACTOR_OUT_HIGH_WATER >> 10);
+
+    SnapshotStats cache;
+    snapshot_stats(&cache);
+    respbuf_printf(out, "CACHE LIST: ttl %d ms, aciertos %lu, fallos %lu, coalescidos %lu, "
+                   "historia %d generaciones (%zu KB)\n",
+                   cache.ttl_ms, cache.hits, cache.misses, cache.coalesced,
+                   cache.history, cache.history_bytes / 1024);
+
+    CompressStats zip;
+    compress_stats(&zip);
+    respbuf_printf(out, "COMPRESION: %lu comprimidos (%llu -> %llu bytes, %.3f ms), "
+                   "%lu sin ganancia; %lu enviados, %llu bytes ahorrados (%.0f%%)\n",
+                   zip.packed, zip.bytes_in, zip.bytes_out, zip.nanos / 1e6, zip.skipped,
+                   zip.sent, zip.sent_raw - zip.sent_wire,
+                   zip.sent_raw ? 100.0 * (zip.sent_raw - zip.sent_wire) / zip.sent_raw : 0.0);
+
+    ProcEventsStats events;
+    procevents_stats(&events);
+    if (events.active) {
+        respbuf_printf(out, "FUENTE: proc connector, %d procesos, %lu eventos, %lu desbordes\n",
+                       events.count, events.events, events.overflows);
+    } else {
+        respbuf_puts(out, "FUENTE: escaneo de /proc\n");
+    }
+
+    StopperStats stop;
+    stopper_stats(&stop);
+    respbuf_printf(out, "STOP: %lu en plazo, %lu terminaron a tiempo, %lu forzados con SIGKILL\n",
+                   stop.waiting, stop.graceful, stop.escalated);
+
+    SpawnerStats spawn;
+    spawner_stats(&spawn);
+    if (spawn.helper_pid) {
+        respbuf_printf(out, "LANZADOR: auxiliar PID %d, %lu lanzados, %lu terminados\n",
+                       spawn.helper_pid, spawn.spawned, spawn.exited);
+    } else {
+        respbuf_printf(out, "LANZADOR: en linea, %lu lanzados\n", spawn.spawned);
+    }
+}
 
-    while ((read_size = recv(sock, buffer, BUFFER_SIZE - 1, 0)) > 0) {
-        buffer[read_size] = '\0';
-        buffer[strcspn(buffer, "\r\n")] = 0;
+// Ejecuta un comando y escribe la respuesta en out
+static int execute_command(Conn *conn, char *line, RespBuf *out) {
+    char response[RESPONSE_SIZE];
 
-        printf("[CMD from %s]: %s\n", inet_ntoa(addr.sin_addr), buffer);
+    // strtok_r: los shards atienden comandos a la vez
+    char *save;
+    char *cmd = strtok_r(line, " ", &save);
+    char *arg = strtok_r(NULL, "", &save);
 
-        // Guardar copia del buffer original para extraer argumentos
-        char buffer_copy[BUFFER_SIZE];
-        strncpy(buffer_copy, buffer, sizeof(buffer_copy) - 1);
-        buffer_copy[sizeof(buffer_copy) - 1] = '\0';
+    if (cmd == NULL || strlen(cmd) == 0) {
+        respbuf_puts(out, "Error: Comando vacio. Usa LIST, START <comando>, STOP <pid>, o EXIT\n");
+        return CMD_CONTINUE;
+    }
 
-        char *cmd = strtok(buffer, " ");
-        char *arg = strtok(NULL, ""); 
+    // Normalizar el comando
+    char normalized[64];
+    normalize_command(cmd, normalized, sizeof(normalized));
 
-        if (cmd == NULL || strlen(cmd) == 0) {
-            strcpy(response, "Error: Comando vacio. Usa LIST, START <comando>, STOP <pid>, o EXIT\n");
+    if (strcmp(normalized, "LIST") == 0) {
+        int list_long = arg && strcasecmp(arg, "LONG") == 0;
+        if (conn->binary && (list_long || arg == NULL || strlen(arg) == 0)) {
+            list_processes_binary(conn, out, list_long);
+        } else if (list_long) {
+            list_processes_long(conn, out);
+        } else if (arg && strncasecmp(arg, "SINCE", 5) == 0) {
+            list_processes_since(conn, arg, out);
+        } else if (arg && strlen(arg) > 0) {
+            list_processes_query(arg, conn->binary, out);
         } else {
-            // Normalizar el comando
-            char normalized[64];
-            normalize_command(cmd, normalized, sizeof(normalized));
-
-            if (strcmp(normalized, "LIST") == 0) {
-                list_processes(response, sizeof(response));
-            } else if (strcmp(normalized, "START") == 0) {
-                if (arg && strlen(arg) > 0) {
-                    start_process(arg, response, sizeof(response));
-                } else {
-                    strcpy(response, "Error: START requiere un comando.\nEjemplo: START sleep 30\n");
-                }
-            } else if (strcmp(normalized, "STOP") == 0) {
-                if (arg && strlen(arg) > 0) {
-                    stop_process(arg, response, sizeof(response));
-                } else {
-                    strcpy(response, "Error: STOP requiere un PID.\nEjemplo: STOP 1234\n");
-                }
-            } else if (strcmp(normalized, "EXIT") == 0) {
-                strcpy(response, "Adios! Cerrando conexion...\n");
-                send(sock, response, strlen(response), 0);
-                break;
-            } else {
-                snprintf(response, sizeof(response), 
-                         "Error: Comando desconocido '%s'.\n"
-                         "Comandos disponibles:\n"
-                         "  LIST/LISTAR - Ver procesos\n"
-                         "  START/INICIAR <cmd> - Crear proceso\n"
-                         "  STOP/MATAR <pid> - Detener proceso\n"
-                         "  EXIT/SALIR - Desconectar\n", cmd);
+            list_processes(conn, out);
+        }
+        return CMD_CONTINUE;
+    } else if (strcmp(normalized, "FRAMED") == 0) {
+        // La confirmación va en texto; desde el siguiente mensaje todo
+        // viaja enmarcado
+        if (conn->framed) {
+            respbuf_puts(out, "Error: El modo FRAMED ya esta activo.\n");
+            return CMD_CONTINUE;
+        }
+        respbuf_printf(out, "OK FRAMED %d\n", PROTO_VERSION);
+        return CMD_FRAMED;
+    } else if (strcmp(normalized, "ENCODING") == 0) {
+        // Las tablas en binario solo viajan enmarcadas: llevan bytes '\0'
+        if (arg && strcasecmp(arg, "TEXT") == 0) {
+            conn->binary = 0;
+            respbuf_puts(out, "OK ENCODING TEXT\n");
+        } else if (arg && strcasecmp(arg, "BINARY") == 0 && conn->framed) {
+            conn->binary = 1;
+            respbuf_printf(out, "OK ENCODING BINARY %d\n", WIRE_VERSION);
+        } else if (arg && strcasecmp(arg, "BINARY") == 0) {
+            respbuf_puts(out, "Error: ENCODING BINARY requiere el modo FRAMED.\n");
+        } else {
+            respbuf_puts(out, "Error: Uso: ENCODING TEXT o ENCODING BINARY\n");
+        }
+        return CMD_CONTINUE;
+    } else if (strcmp(normalized, "COMPRESS") == 0) {
+        set_compression(conn, arg, out);
+        return CMD_CONTINUE;
+    } else if (strcmp(normalized, "HELLO") == 0) {
+        // Como FRAMED, la respuesta va en texto aunque active el modo enmarcado
+        return hello(conn, arg, out);
+    } else if (strcmp(normalized, "START") == 0) {
+        if (arg && strlen(arg) > 0) {
+            char *command = strdup(arg);
+            if (command == NULL) {
+                respbuf_puts(out, "Error: Sin memoria.\n");
+                return CMD_CONTINUE;
             }
+            return reactor_defer(conn, start_job, command, out);
+        } else {
+            strcpy(response, "Error: START requiere un comando.\nEjemplo: START sleep 30\n");
         }
+    } else if (strcmp(normalized, "STOP") == 0) {
+        if (arg && strlen(arg) > 0) {
+            stop_process(arg, out);
+            snapshot_invalidate();
+            return CMD_CONTINUE;
+        } else {
+            strcpy(response, "Error: STOP requiere un PID.\n"
+                             "Ejemplo: STOP 1234, STOP --signal=INT --grace=2000 1234,\n"
+                             "         STOP 101 102 103, STOP --name worker*, STOP --tree 1234\n");
+        }
+    } else if (strcmp(normalized, "SUBSCRIBE") == 0) {
+        subscribe(conn, arg, out);
+        return CMD_CONTINUE;
+    } else if (strcmp(normalized, "UNSUBSCRIBE") == 0) {
+        reactor_unsubscribe(conn);
+        respbuf_puts(out, "OK UNSUBSCRIBE\n");
+        return CMD_CONTINUE;
+    } else if (strcmp(normalized, "JOBS") == 0) {
+        jobs_format(out);
+        return CMD_CONTINUE;
+    } else if (strcmp(normalized, "SUPERVISED") == 0) {
+        supervisor_format(out);
+        return CMD_CONTINUE;
+    } else if (strcmp(normalized, "STATUS") == 0) {
+        job_status(arg, out);
+        return CMD_CONTINUE;
+    } else if (strcmp(normalized, "STATS") == 0) {
+        report_stats(out);
+        return CMD_CONTINUE;
+    } else if (strcmp(normalized, "EXIT") == 0) {
+        respbuf_puts(out, "Adios! Cerrando conexion...\n");
+        return CMD_CLOSE;
+    } else {
+        snprintf(response, sizeof(response),
+                 "Error: Comando desconocido '%s'.\n"
+                 "Comandos disponibles:\n"
+                 "  LIST/LISTAR - Ver procesos\n"
+                 "  LIST LONG - Procesos con UID, estado, hilos, RSS, %%CPU e inicio\n"
+                 "  LIST SINCE <gen> - Cambios desde una generacion\n"
+                 "  LIST [WHERE c AND c] [SORT campo [DESC]] [OFFSET n] [LIMIT n]\n"
+                 "       [FIELDS a,b] [AT gen]\n"
+                 "       - Consulta (ej. LIST WHERE name~nginx SORT rss DESC LIMIT 10)\n"
+                 "  SUBSCRIBE [<gen>] - Recibir los cambios al ocurrir\n"
+                 "  HELLO <ver> FRAMED,BINARY,LZ,PUSH - Negociar version y capacidades\n"
+                 "  ENCODING BINARY|TEXT - Tablas en binario (solo en modo FRAMED)\n"
+                 "  COMPRESS LZ [<bytes>]|OFF - Comprimir respuestas grandes (solo en modo FRAMED)\n"
+                 "  START/INICIAR <cmd> - Crear proceso\n"
+                 "  START --restart=<never|on-failure|always> <cmd> - Proceso supervisado\n"
+                 "  START --group <cmd> - Proceso en su propio grupo (STOP detiene a todo el grupo)\n"
+                 "  STOP/MATAR [--signal=<sig>] [--grace=<ms>] <pid>... - Detener procesos\n"
+                 "  STOP --name <glob> | --tree <pid> - Detener por nombre o arbol\n"
+                 "  STOP --job <n> - Detener un trabajo supervisado (tambien si espera)\n"
+                 "  JOBS - Procesos iniciados y su estado de salida\n"
+                 "  STATUS <pid> - Estado de un proceso iniciado\n"
+                 "  SUPERVISED - Trabajos supervisados y sus reinicios\n"
+                 "  STATS - Contadores del servidor\n"
+                 "  EXIT/SALIR - Desconectar\n", cmd);
+    }
 
-        send(sock, response, strlen(response), 0);
+    respbuf_puts(out, response);
+    return CMD_CONTINUE;
+}
+
+// Comprueba que ningún otro proceso escuche en el puerto. Los shards usan
+// SO_REUSEPORT, así que una segunda instancia se uniría en silencio y se
+// quedaría con parte de las conexiones: un bind sin SO_REUSEPORT falla
+// con EADDRINUSE si el puerto ya tiene dueño
+static int port_available(int port) {
+    struct sockaddr_in addr;
+    int sock = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (sock == -1) {
+        perror("Could not create TCP socket");
+        return 0;
     }
 
+    int opt = 1;
+    setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = INADDR_ANY;
+    addr.sin_port = htons(port);
+
+    int ok = bind(sock, (struct sockaddr *)&addr, sizeof(addr)) == 0;
+    if (!ok && errno == EADDRINUSE) {
+        fprintf(stderr, "El puerto %d ya esta en uso (¿otra instancia del servidor?)\n", port);
+    } else if (!ok) {
+        perror("TCP Bind failed");
+    }
     close(sock);
-    printf("[TCP] Client %s disconnected\n", inet_ntoa(addr.sin_addr));
-    return NULL;
+    return ok;
 }
 
-// Limpiar procesos zombies
-void sigchld_handler(int s) {
-    (void)s;
-    while(waitpid(-1, NULL, WNOHANG) > 0);
+// Comando que necesitaba escanear /proc: un worker obtiene la instantánea
+// y el reactor repite el comando con ella
+typedef struct {
+    char *line;
+    int metrics;
+    Snapshot *snap;
+} Rescan;
+
+static void rescan_snapshot(void *arg, RespBuf *out) {
+    Rescan *rescan = arg;
+    (void)out;
+    rescan->snap = rescan->metrics ? snapshot_acquire_metrics() : snapshot_acquire();
 }
 
-int main() {
-    int server_sock, *new_sock;
-    struct sockaddr_in server, client;
-    socklen_t c = sizeof(struct sockaddr_in);
+static void rescan_resume(Conn *conn, void *arg, RespBuf *out) {
+    Rescan *rescan = arg;
 
-    struct sigaction sa;
-    sa.sa_handler = sigchld_handler; 
-    sigemptyset(&sa.sa_mask);
-    sa.sa_flags = SA_RESTART | SA_NOCLDSTOP;
-    if (sigaction(SIGCHLD, &sa, 0) == -1) {
-        perror("sigaction");
-        exit(1);
+    if (conn && rescan->snap == NULL) {
+        respbuf_puts(out, "Error: No se pudo leer /proc.\n");
+    } else if (conn) {
+        snapshot_set_nonblocking(1);
+        snapshot_pin(rescan->snap);
+        execute_command(conn, rescan->line, out);
+        snapshot_pin(NULL);
+    }
+    if (rescan->snap) {
+        snapshot_release(rescan->snap);
     }
+    free(rescan->line);
+    free(rescan);
+}
 
-    server_sock = socket(AF_INET, SOCK_STREAM, 0);
-    if (server_sock == -1) {
-        printf("Could not create TCP socket");
-        return 1;
+// Punto de entrada de los reactores. Nada de lo que corre acá escanea
+// /proc ni espera a otro escaneo: si el comando necesita una instantánea
+// que no está en la caché, se descarta lo que escribió y se repite cuando
+// un worker la tenga, como START
+int process_command(Conn *conn, char *line, RespBuf *out) {
+    printf("[CMD from %s]: %s\n", conn->ip, line);
+
+    char *copy = strdup(line);
+    size_t len = out->len;
+    int nrefs = out->nrefs;
+
+    snapshot_set_nonblocking(1);
+    int res = execute_command(conn, line, out);
+    int missed = snapshot_missed();
+    if (missed == 0 || copy == NULL) {
+        free(copy);
+        return res;
+    }
+
+    Rescan *rescan = calloc(1, sizeof(Rescan));
+    if (rescan == NULL) {
+        free(copy);
+        return res;
+    }
+    respbuf_truncate(out, len, nrefs);
+    rescan->line = copy;
+    rescan->metrics = missed > 1;
+    return reactor_defer_resume(conn, rescan_snapshot, rescan_resume, rescan, out);
+}
+
+// Abre un socket de escucha con SO_REUSEPORT para que cada shard tenga
+// el suyo y el kernel reparta las conexiones entre ellos
+static int open_listener(int port, int backlog) {
+    struct sockaddr_in server;
+    int sock = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (sock == -1) {
+        perror("Could not create TCP socket");
+        return -1;
     }
 
     int opt = 1;
-    setsockopt(server_sock, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+    setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+    if (setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0) {
+        perror("SO_REUSEPORT");
+        close(sock);
+        return -1;
+    }
 
     server.sin_family = AF_INET;
     server.sin_addr.s_addr = INADDR_ANY;
-    server.sin_port = htons(TCP_PORT);
+    server.sin_port = htons(port);
 
-    if (bind(server_sock, (struct sockaddr *)&server, sizeof(server)) < 0) {
+    if (bind(sock, (struct sockaddr *)&server, sizeof(server)) < 0) {
         perror("TCP Bind failed");
+        close(sock);
+        return -1;
+    }
+
+    if (listen(sock, backlog) < 0) {
+        perror("listen");
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Uso: %s [-p puerto] [-s shards] [-b backlog] [-w workers] [-t ttl_ms] [-n]\n"
+            "  -p  Puerto TCP (default %d)\n"
+            "  -s  Reactores con su propio socket SO_REUSEPORT (default: una por CPU)\n"
+            "  -b  Backlog de listen() por shard (default %d)\n"
+            "  -w  Hilos del pool para trabajo bloqueante (default %d)\n"
+            "  -t  Vigencia de la caché de LIST en ms, 0 = sin caché (default %d)\n"
+            "  -n  Mantener la tabla con eventos del kernel (proc connector)\n",
+            prog, TCP_PORT, DEFAULT_BACKLOG, WORKER_THREADS, SNAPSHOT_DEFAULT_TTL_MS);
+}
+
+int main(int argc, char **argv) {
+    int port = TCP_PORT;
+    int backlog = DEFAULT_BACKLOG;
+    int workers = WORKER_THREADS;
+    int ttl = SNAPSHOT_DEFAULT_TTL_MS;
+    int use_events = 0;
+    int ncpu = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    int opt;
+
+    if (ncpu < 1) {
+        ncpu = 1;
+    }
+    shard_count = ncpu;
+
+    while ((opt = getopt(argc, argv, "p:s:b:w:t:nh")) != -1) {
+        switch (opt) {
+            case 'p': port = atoi(optarg); break;
+            case 's': shard_count = atoi(optarg); break;
+            case 'b': backlog = atoi(optarg); break;
+            case 'w': workers = atoi(optarg); break;
+            case 't': ttl = atoi(optarg); break;
+            case 'n': use_events = 1; break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (port <= 0 || port > 65535 || shard_count < 1 || backlog < 1 || workers < 1 || ttl < 0) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (!port_available(port)) {
         return 1;
     }
 
-    listen(server_sock, 3);
-    printf("=== Process Manager Server (TCP Only) ===\n");
-    printf("[INFO] Listening on 0.0.0.0:%d\n", TCP_PORT);
-    printf("[INFO] Ready for external connections...\n");
+    // El auxiliar de lanzamiento se crea antes que cualquier hilo o socket.
+    // Su hilo recolector recoge a cada hijo por separado (sin waitpid(-1))
+    if (spawner_start(on_process_exit) != 0) {
+        perror("[WARN] Auxiliar de lanzamiento no disponible, se lanza en linea");
+    }
+    if (timerwheel_start() != 0) {
+        return 1;
+    }
+    // Un trabajo que recibe el SIGKILL de un plazo vencido no se relanza
+    stopper_on_kill(supervisor_stopping);
 
-    while (1) {
-        int client_sock = accept(server_sock, (struct sockaddr *)&client, &c);
-        if (client_sock < 0) {
-            perror("Accept failed");
-            continue;
+    printf("=== Process Manager Server (TCP Only) ===\n");
+    snapshot_set_ttl(ttl);
+    if (use_events) {
+        if (procevents_start() == 0) {
+            printf("[INFO] Tabla de procesos mantenida por el proc connector\n");
+        } else {
+            perror("[WARN] Proc connector no disponible, se escanea /proc");
         }
+    }
 
-        pthread_t tcp_thread;
-        new_sock = malloc(sizeof(int));
-        *new_sock = client_sock;
-        
-        if (pthread_create(&tcp_thread, NULL, handle_client, (void*)new_sock) < 0) {
-            perror("Could not create TCP thread");
-            free(new_sock);
-            continue;
+    // Pool para trabajo bloqueante (START); los reactores atienden todo lo demás
+    if (workers_start(workers) != 0) {
+        return 1;
+    }
+
+    shards = calloc((size_t)shard_count, sizeof(Reactor));
+    if (shards == NULL) {
+        perror("calloc");
+        return 1;
+    }
+
+    // Un socket de escucha y un reactor por shard, cada uno en su CPU
+    for (int i = 0; i < shard_count; i++) {
+        int listen_fd = open_listener(port, backlog);
+        if (listen_fd < 0) {
+            return 1;
+        }
+        if (reactor_init(&shards[i], listen_fd, process_command) != 0) {
+            return 1;
+        }
+        shards[i].id = i;
+        shards[i].push = push_changes;
+        if (reactor_spawn(&shards[i], i % ncpu) != 0) {
+            return 1;
         }
-        
-        pthread_detach(tcp_thread);
     }
 
-    return 0;
-}
\ No newline at end of file
+    pthread_t publisher;
+    if (pthread_create(&publisher, NULL, event_publisher, NULL) != 0) {
+        perror("Could not create event thread");
+        return 1;
+    }
+    pthread_detach(publisher);
+
+    printf("[INFO] Listening on 0.0.0.0:%d (%d shards, backlog %d)\n",
+           port, shard_count, backlog);
+    printf("[INFO] Ready for external connections...\n");
+
+    for (int i = 0; i < shard_count; i++) {
+        pthread_join(shards[i].thread, NULL);
+    }
+    return 1;
+}
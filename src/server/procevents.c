@@ -0,0 +1,412 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/connector.h>
+#include <linux/cn_proc.h>
+
+#include "procevents.h"
+
+#define RECV_BUF_SIZE     65536
+#define SOCKET_RCVBUF     (8 * 1024 * 1024)
+#define ACK_TIMEOUT_MS    500
+#define INITIAL_CAPACITY  256
+#define MIN_COMPACT       64        /* Lápidas mínimas antes de compactar */
+#define DEAD              (-1)      /* ppid de una entrada dada de baja */
+
+/*
+ * La tabla queda ordenada por PID. Un proceso que termina se marca como
+ * lápida (ppid = DEAD) en vez de mover el resto del arreglo; si el PID se
+ * reutiliza la entrada revive en su lugar. Las lápidas se compactan
+ * cuando son la mitad de la tabla.
+ */
+static pthread_mutex_t ev_lock = PTHREAD_MUTEX_INITIALIZER;
+static ProcTable table;
+static int tombstones;
+static unsigned long version;
+static int active;
+static unsigned long event_count;
+static unsigned long overflows;
+
+/* Solo los usa el hilo de eventos (y procevents_start antes de crearlo) */
+static int nl_fd = -1;
+static ProcScanner scanner;
+
+/* Primer índice con pid >= el buscado. Requiere el lock. */
+static int lower_bound(int pid)
+{
+    int lo = 0, hi = table.count;
+
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (table.entries[mid].pid < pid)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+/* Entrada viva de un PID o NULL. Requiere el lock. */
+static ProcInfo *find_live(int pid)
+{
+    int i = lower_bound(pid);
+    if (i < table.count && table.entries[i].pid == pid &&
+        table.entries[i].ppid != DEAD)
+        return &table.entries[i];
+    return NULL;
+}
+
+static void compact(void)
+{
+    int w = 0;
+    for (int r = 0; r < table.count; r++) {
+        if (table.entries[r].ppid != DEAD)
+            table.entries[w++] = table.entries[r];
+    }
+    table.count = w;
+    tombstones = 0;
+}
+
+/* Agrega o reemplaza un proceso. Requiere el lock. */
+static void table_upsert(const ProcInfo *info)
+{
+    int i = lower_bound(info->pid);
+
+    if (i < table.count && table.entries[i].pid == info->pid) {
+        if (table.entries[i].ppid == DEAD)
+            tombstones--;
+        table.entries[i] = *info;
+    } else {
+        if (table.count >= table.capacity) {
+            int new_cap = table.capacity ? table.capacity * 2 : INITIAL_CAPACITY;
+            ProcInfo *tmp = realloc(table.entries, (size_t)new_cap * sizeof(ProcInfo));
+            if (!tmp)
+                return;
+            table.entries  = tmp;
+            table.capacity = new_cap;
+        }
+        /* Los PID nuevos casi siempre son los mayores: se agregan al final */
+        if (i < table.count)
+            memmove(&table.entries[i + 1], &table.entries[i],
+                    (size_t)(table.count - i) * sizeof(ProcInfo));
+        table.entries[i] = *info;
+        table.count++;
+    }
+    version++;
+}
+
+/* Da de baja un proceso. Requiere el lock. */
+static void table_remove(int pid)
+{
+    ProcInfo *e = find_live(pid);
+    if (!e)
+        return;
+    e->ppid = DEAD;
+    tombstones++;
+    if (tombstones >= MIN_COMPACT && tombstones * 2 >= table.count)
+        compact();
+    version++;
+}
+
+/* Reemplaza la tabla con un escaneo completo de /proc. */
+static int rescan(void)
+{
+    ProcTable fresh = {0};
+
+    if (procscan_read(&scanner, &fresh) < 0) {
+        proctable_free(&fresh);
+        return -1;
+    }
+
+    pthread_mutex_lock(&ev_lock);
+    proctable_free(&table);
+    table = fresh;
+    tombstones = 0;
+    version++;
+    pthread_mutex_unlock(&ev_lock);
+    return 0;
+}
+
+/* Lee el proceso de /proc (tras exec) y lo guarda. */
+static void refresh_pid(int pid)
+{
+    ProcInfo info;
+
+    if (procscan_read_pid(&scanner, pid, &info) != 0)
+        return; /* Ya terminó: llegará su exit */
+
+    pthread_mutex_lock(&ev_lock);
+    table_upsert(&info);
+    pthread_mutex_unlock(&ev_lock);
+}
+
+static void handle_fork(const struct proc_event *ev)
+{
+    int pid  = ev->event_data.fork.child_pid;
+    int tgid = ev->event_data.fork.child_tgid;
+    ProcInfo info;
+
+    if (pid != tgid)
+        return; /* Un hilo nuevo, no un proceso */
+
+    /* El hijo hereda el nombre del padre hasta que haga exec */
+    pthread_mutex_lock(&ev_lock);
+    ProcInfo *parent = find_live(ev->event_data.fork.parent_tgid);
+    if (parent) {
+        memset(&info, 0, sizeof(info));
+        info.pid   = tgid;
+        info.ppid  = ev->event_data.fork.parent_tgid;
+        info.state = parent->state;
+        info.uid   = parent->uid;
+        memcpy(info.comm, parent->comm, sizeof(info.comm));
+        table_upsert(&info);
+    }
+    pthread_mutex_unlock(&ev_lock);
+
+    if (!parent)
+        refresh_pid(tgid);
+}
+
+static void handle_comm(const struct proc_event *ev)
+{
+    if (ev->event_data.comm.process_pid != ev->event_data.comm.process_tgid)
+        return; /* Renombre de un hilo secundario */
+
+    pthread_mutex_lock(&ev_lock);
+    ProcInfo *e = find_live(ev->event_data.comm.process_tgid);
+    if (e) {
+        size_t len = strnlen(ev->event_data.comm.comm, sizeof(ev->event_data.comm.comm));
+        memcpy(e->comm, ev->event_data.comm.comm, len);
+        e->comm[len] = '\0';
+        version++;
+    }
+    pthread_mutex_unlock(&ev_lock);
+}
+
+static void handle_event(const struct proc_event *ev)
+{
+    switch (ev->what) {
+    case PROC_EVENT_FORK:
+        handle_fork(ev);
+        break;
+    case PROC_EVENT_EXEC:
+        refresh_pid(ev->event_data.exec.process_tgid);
+        break;
+    case PROC_EVENT_COMM:
+        handle_comm(ev);
+        break;
+    case PROC_EVENT_EXIT:
+        if (ev->event_data.exit.process_pid == ev->event_data.exit.process_tgid) {
+            pthread_mutex_lock(&ev_lock);
+            table_remove(ev->event_data.exit.process_tgid);
+            pthread_mutex_unlock(&ev_lock);
+        }
+        break;
+    default:
+        return;
+    }
+    __atomic_fetch_add(&event_count, 1, __ATOMIC_RELAXED);
+}
+
+/*
+ * Recorre un datagrama de netlink y llama a fn con cada evento.
+ * Retorna el número de eventos.
+ */
+static int for_each_event(char *buf, ssize_t len, void (*fn)(const struct proc_event *))
+{
+    int n = 0;
+
+    for (struct nlmsghdr *nh = (struct nlmsghdr *)buf; NLMSG_OK(nh, (size_t)len);
+         nh = NLMSG_NEXT(nh, len)) {
+        if (nh->nlmsg_type == NLMSG_NOOP || nh->nlmsg_type == NLMSG_ERROR)
+            continue;
+        struct cn_msg *cn = NLMSG_DATA(nh);
+        if (cn->id.idx != CN_IDX_PROC || cn->id.val != CN_VAL_PROC)
+            continue;
+        fn((const struct proc_event *)cn->data);
+        n++;
+    }
+    return n;
+}
+
+static void *event_thread(void *arg)
+{
+    char *buf = malloc(RECV_BUF_SIZE);
+    (void)arg;
+
+    while (buf) {
+        ssize_t n = recv(nl_fd, buf, RECV_BUF_SIZE, 0);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno == ENOBUFS) {
+                /* Se perdieron eventos: reconstruir desde /proc */
+                __atomic_fetch_add(&overflows, 1, __ATOMIC_RELAXED);
+                if (rescan() == 0)
+                    continue;
+            }
+            perror("proc connector recv");
+            break;
+        }
+        if (n == 0)
+            break;
+        for_each_event(buf, n, handle_event);
+    }
+
+    /* Sin eventos: el servidor vuelve a escanear /proc */
+    fprintf(stderr, "[WARN] Proc connector detenido, se usa /proc\n");
+    __atomic_store_n(&active, 0, __ATOMIC_RELEASE);
+    free(buf);
+    return NULL;
+}
+
+static int ack_error;
+
+/* Guarda el error de la confirmación de PROC_CN_MCAST_LISTEN. */
+static void check_ack(const struct proc_event *ev)
+{
+    if (ev->what == PROC_EVENT_NONE && ev->event_data.ack.err != 0)
+        ack_error = (int)ev->event_data.ack.err;
+}
+
+/* Envía PROC_CN_MCAST_LISTEN y espera la confirmación del kernel. */
+static int subscribe(void)
+{
+    char msg[NLMSG_SPACE(sizeof(struct cn_msg) + sizeof(enum proc_cn_mcast_op))];
+    struct nlmsghdr *nh = (struct nlmsghdr *)msg;
+    struct cn_msg *cn = NLMSG_DATA(nh);
+
+    memset(msg, 0, sizeof(msg));
+    nh->nlmsg_len  = sizeof(msg);
+    nh->nlmsg_type = NLMSG_DONE;
+    nh->nlmsg_pid  = (unsigned)getpid();
+    cn->id.idx = CN_IDX_PROC;
+    cn->id.val = CN_VAL_PROC;
+    cn->len    = sizeof(enum proc_cn_mcast_op);
+    *(enum proc_cn_mcast_op *)cn->data = PROC_CN_MCAST_LISTEN;
+
+    if (send(nl_fd, msg, sizeof(msg), 0) < 0)
+        return -1;
+
+    /*
+     * Fuera del namespace de red inicial el kernel acepta la suscripción
+     * pero nunca entrega nada: sin respuesta no hay connector
+     */
+    struct pollfd pfd = { .fd = nl_fd, .events = POLLIN };
+    if (poll(&pfd, 1, ACK_TIMEOUT_MS) <= 0)
+        return -1;
+
+    char buf[4096];
+    ssize_t n = recv(nl_fd, buf, sizeof(buf), MSG_DONTWAIT);
+    ack_error = 0;
+    if (n <= 0 || for_each_event(buf, n, check_ack) == 0)
+        return -1;
+    if (ack_error != 0) {
+        errno = ack_error; /* Por ejemplo EPERM sin CAP_NET_ADMIN */
+        return -1;
+    }
+    return 0;
+}
+
+int procevents_start(void)
+{
+    struct sockaddr_nl addr = {0};
+    int size = SOCKET_RCVBUF;
+    pthread_t thread;
+
+    if (procscan_init(&scanner) != 0)
+        return -1;
+
+    nl_fd = socket(PF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_CONNECTOR);
+    if (nl_fd < 0)
+        goto fail;
+
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = CN_IDX_PROC;
+    addr.nl_pid    = (unsigned)getpid();
+    if (bind(nl_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+        goto fail;
+
+    /* Buffer grande para absorber ráfagas de fork/exit */
+    if (setsockopt(nl_fd, SOL_SOCKET, SO_RCVBUFFORCE, &size, sizeof(size)) < 0)
+        setsockopt(nl_fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+
+    if (subscribe() != 0 || rescan() != 0)
+        goto fail;
+
+    active = 1;
+    if (pthread_create(&thread, NULL, event_thread, NULL) != 0) {
+        active = 0;
+        goto fail;
+    }
+    pthread_detach(thread);
+    return 0;
+
+fail:
+    if (nl_fd >= 0)
+        close(nl_fd);
+    nl_fd = -1;
+    procscan_destroy(&scanner);
+    return -1;
+}
+
+int procevents_active(void)
+{
+    return __atomic_load_n(&active, __ATOMIC_ACQUIRE);
+}
+
+unsigned long procevents_version(void)
+{
+    pthread_mutex_lock(&ev_lock);
+    unsigned long v = version;
+    pthread_mutex_unlock(&ev_lock);
+    return v;
+}
+
+int procevents_copy(ProcTable *out, unsigned long *ver)
+{
+    pthread_mutex_lock(&ev_lock);
+
+    int live = table.count - tombstones;
+    if (live > out->capacity) {
+        ProcInfo *tmp = realloc(out->entries, (size_t)live * sizeof(ProcInfo));
+        if (!tmp) {
+            pthread_mutex_unlock(&ev_lock);
+            return -1;
+        }
+        out->entries  = tmp;
+        out->capacity = live;
+    }
+
+    if (tombstones == 0) {
+        memcpy(out->entries, table.entries, (size_t)live * sizeof(ProcInfo));
+    } else {
+        int w = 0;
+        for (int i = 0; i < table.count; i++) {
+            if (table.entries[i].ppid != DEAD)
+                out->entries[w++] = table.entries[i];
+        }
+    }
+    out->count = live;
+    *ver = version;
+
+    pthread_mutex_unlock(&ev_lock);
+    return live;
+}
+
+void procevents_stats(ProcEventsStats *stats)
+{
+    pthread_mutex_lock(&ev_lock);
+    stats->count = table.count - tombstones;
+    pthread_mutex_unlock(&ev_lock);
+    stats->active    = procevents_active();
+    stats->events    = __atomic_load_n(&event_count, __ATOMIC_RELAXED);
+    stats->overflows = __atomic_load_n(&overflows, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,45 @@
+#ifndef PROCEVENTS_H
+#define PROCEVENTS_H
+
+#include "procscan.h"
+
+/*
+ * Tabla de procesos mantenida con los eventos del kernel (proc connector
+ * de netlink: fork, exec, cambio de nombre y exit), para servir LIST sin
+ * recorrer /proc. Requiere CAP_NET_ADMIN y el namespace de red inicial;
+ * si el connector no responde no se activa y el servidor sigue
+ * escaneando /proc. Si el socket de eventos se desborda (ENOBUFS) la
+ * tabla se reconstruye con un escaneo completo.
+ */
+
+typedef struct {
+    int active;                 /* 1 si el connector está entregando eventos */
+    unsigned long events;       /* Eventos aplicados */
+    unsigned long overflows;    /* Desbordes del socket (cada uno = un rescan) */
+    int count;                  /* Procesos en la tabla */
+} ProcEventsStats;
+
+/*
+ * Se suscribe al connector, carga la tabla con un escaneo de /proc y
+ * lanza el hilo que aplica los eventos. Retorna 0 si OK, -1 si el
+ * connector no está disponible.
+ */
+int procevents_start(void);
+
+/* 1 si la tabla está siendo mantenida por eventos. */
+int procevents_active(void);
+
+/* Versión de la tabla: cambia con cada modificación. */
+unsigned long procevents_version(void);
+
+/*
+ * Copia la tabla (ordenada por PID) en out, reutilizando su memoria, sin
+ * acceder a /proc. Guarda en *version la versión copiada. Retorna el
+ * número de procesos o -1 en error.
+ */
+int procevents_copy(ProcTable *out, unsigned long *version);
+
+/* Copia los contadores. */
+void procevents_stats(ProcEventsStats *stats);
+
+#endif /* PROCEVENTS_H */
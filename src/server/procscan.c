@@ -0,0 +1,456 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <fnmatch.h>
+#include <time.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+#include "procscan.h"
+
+#define DIRENT_BUF_SIZE   32768
+#define READ_BUF_SIZE     4096
+#define INITIAL_CAPACITY  256
+
+/* Formato de registro que devuelve getdents64 (no lo expone glibc). */
+struct linux_dirent64 {
+    unsigned long long d_ino;
+    long long          d_off;
+    unsigned short     d_reclen;
+    unsigned char      d_type;
+    char               d_name[];
+};
+
+/*
+ * Calcula el ancho de la columna PID igual que procps: número de dígitos
+ * de /proc/sys/kernel/pid_max, con un mínimo de 5.
+ */
+static int pid_column_width(void)
+{
+    int width = 5;
+    FILE *fp = fopen("/proc/sys/kernel/pid_max", "r");
+    if (fp) {
+        long pid_max;
+        if (fscanf(fp, "%ld", &pid_max) == 1) {
+            int digits = 0;
+            for (long v = pid_max - 1; v > 0; v /= 10)
+                digits++;
+            if (digits > width)
+                width = digits;
+        }
+        fclose(fp);
+    }
+    return width;
+}
+
+static long long clock_ms(clockid_t clock)
+{
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+int procscan_init(ProcScanner *sc)
+{
+    if (!sc)
+        return -1;
+
+    memset(sc, 0, sizeof(*sc));
+    sc->proc_fd = open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (sc->proc_fd < 0)
+        return -1;
+
+    sc->dirent_size = DIRENT_BUF_SIZE;
+    sc->read_size   = READ_BUF_SIZE;
+    sc->dirent_buf  = malloc(sc->dirent_size);
+    sc->read_buf    = malloc(sc->read_size);
+    if (!sc->dirent_buf || !sc->read_buf) {
+        procscan_destroy(sc);
+        return -1;
+    }
+
+    sc->pid_width = pid_column_width();
+    sc->ticks_per_sec = sysconf(_SC_CLK_TCK);
+    if (sc->ticks_per_sec <= 0)
+        sc->ticks_per_sec = 100;
+    sc->page_kb = sysconf(_SC_PAGESIZE) / 1024;
+    sc->boot_epoch_ms = clock_ms(CLOCK_REALTIME) - clock_ms(CLOCK_BOOTTIME);
+    return 0;
+}
+
+void procscan_destroy(ProcScanner *sc)
+{
+    if (!sc)
+        return;
+    if (sc->proc_fd >= 0)
+        close(sc->proc_fd);
+    free(sc->dirent_buf);
+    free(sc->read_buf);
+    free(sc->prev);
+    sc->proc_fd    = -1;
+    sc->dirent_buf = NULL;
+    sc->read_buf   = NULL;
+    sc->prev       = NULL;
+    sc->prev_count = sc->prev_capacity = 0;
+}
+
+void proctable_free(ProcTable *table)
+{
+    if (!table)
+        return;
+    free(table->entries);
+    table->entries  = NULL;
+    table->count    = 0;
+    table->capacity = 0;
+}
+
+/* Posición de pid en el índice (direccionamiento abierto), o -1. */
+static int index_find(const int *slots, size_t mask, const ProcTable *table, int pid)
+{
+    for (size_t h = ((unsigned int)pid * 2654435761u) & mask; slots[h]; h = (h + 1) & mask) {
+        if (table->entries[slots[h] - 1].pid == pid)
+            return slots[h] - 1;
+    }
+    return -1;
+}
+
+int proctable_descendants(const ProcTable *table, int root, int *out)
+{
+    int n = table->count;
+    size_t buckets = 16;
+    while (buckets < (size_t)n * 2)
+        buckets <<= 1;
+
+    int *slots = calloc(buckets, sizeof(int));      /* Posición + 1, 0 = libre */
+    int *first = malloc((size_t)(n + 1) * sizeof(int));
+    int *next  = malloc((size_t)(n + 1) * sizeof(int));
+    int *queue = malloc((size_t)(n + 1) * sizeof(int));
+    unsigned char *seen = calloc((size_t)n + 1, 1);   /* Ya encolado */
+    if (!slots || !first || !next || !queue || !seen) {
+        free(slots); free(first); free(next); free(queue); free(seen);
+        return -1;
+    }
+
+    size_t mask = buckets - 1;
+    for (int i = 0; i < n; i++) {
+        size_t h = ((unsigned int)table->entries[i].pid * 2654435761u) & mask;
+        while (slots[h])
+            h = (h + 1) & mask;
+        slots[h] = i + 1;
+        first[i] = -1;
+    }
+    /* Lista de hijos de cada proceso */
+    for (int i = 0; i < n; i++) {
+        const ProcInfo *e = &table->entries[i];
+        int parent = e->ppid != e->pid ? index_find(slots, mask, table, e->ppid) : -1;
+        if (parent >= 0) {
+            next[i] = first[parent];
+            first[parent] = i;
+        }
+    }
+
+    /*
+     * Recorrido en anchura desde root. Con PIDs reciclados entre lecturas
+     * la tabla puede tener ciclos: cada entrada se encola una sola vez, así
+     * la cola (y out) nunca pasan de n.
+     */
+    int count = 0, head = 0;
+    int r = index_find(slots, mask, table, root);
+    if (r >= 0) {
+        queue[count++] = r;
+        seen[r] = 1;
+    }
+    while (head < count) {
+        int i = queue[head++];
+        out[head - 1] = table->entries[i].pid;
+        for (int c = first[i]; c >= 0; c = next[c]) {
+            if (!seen[c]) {
+                seen[c] = 1;
+                queue[count++] = c;
+            }
+        }
+    }
+
+    free(slots);
+    free(first);
+    free(next);
+    free(queue);
+    free(seen);
+    return count;
+}
+
+int proctable_match(const ProcTable *table, const char *pattern, int *out)
+{
+    int count = 0;
+    for (int i = 0; i < table->count; i++) {
+        if (fnmatch(pattern, table->entries[i].comm, 0) == 0)
+            out[count++] = table->entries[i].pid;
+    }
+    return count;
+}
+
+static int cmp_pid(const void *a, const void *b)
+{
+    const ProcInfo *pa = a, *pb = b;
+    return (pa->pid > pb->pid) - (pa->pid < pb->pid);
+}
+
+/*
+ * Lee /proc/<pid>/stat en el buffer del escáner y extrae comm, ppid y
+ * las métricas (el UID y el %CPU los completa sample_finish). El comm va
+ * entre el primer '(' y el último ')', porque puede contener espacios y
+ * paréntesis. Retorna 0 si OK, -1 si el proceso ya no existe.
+ */
+static int read_stat(ProcScanner *sc, const char *pid_name, ProcInfo *info)
+{
+    char path[32];
+    snprintf(path, sizeof(path), "%s/stat", pid_name);
+
+    int fd = openat(sc->proc_fd, path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return -1;
+
+    ssize_t n = read(fd, sc->read_buf, sc->read_size - 1);
+    close(fd);
+    if (n <= 0)
+        return -1;
+    sc->read_buf[n] = '\0';
+
+    char *open_paren  = strchr(sc->read_buf, '(');
+    char *close_paren = strrchr(sc->read_buf, ')');
+    if (!open_paren || !close_paren || close_paren < open_paren)
+        return -1;
+
+    size_t comm_len = (size_t)(close_paren - open_paren - 1);
+    if (comm_len >= PROCSCAN_COMM_SIZE)
+        comm_len = PROCSCAN_COMM_SIZE - 1;
+    memcpy(info->comm, open_paren + 1, comm_len);
+    info->comm[comm_len] = '\0';
+
+    /*
+     * Después de ") " vienen el estado (campo 3) y los numéricos: ppid
+     * (4), utime (14), stime (15), num_threads (20), starttime (22) y
+     * rss en páginas (24).
+     */
+    unsigned long long field[25] = {0};
+    info->state = 'X';
+    if (close_paren[1] == ' ' && close_paren[2] != '\0') {
+        char *p = close_paren + 3;
+        info->state = close_paren[2];
+        for (int f = 4; f <= 24 && *p; f++)
+            field[f] = strtoull(p, &p, 10);
+    }
+    info->ppid        = (int)field[4];
+    info->cpu_ticks   = field[14] + field[15];
+    info->threads     = (int)field[20];
+    info->start_ticks = field[22];
+    info->rss_kb      = (long)field[24] * sc->page_kb;
+    info->start_time  = (sc->boot_epoch_ms +
+                         (long long)(field[22] * 1000 / (unsigned long long)sc->ticks_per_sec)) / 1000;
+    info->uid         = -1;
+    info->cpu_tenths  = 0;
+    return 0;
+}
+
+/* Dueño de /proc/<pid> (el UID efectivo del proceso), o -1. */
+static int read_uid(ProcScanner *sc, int pid)
+{
+    char name[16];
+    struct stat st;
+
+    snprintf(name, sizeof(name), "%d", pid);
+    if (fstatat(sc->proc_fd, name, &st, 0) != 0)
+        return -1;
+    return (int)st.st_uid;
+}
+
+/*
+ * Completa UID y %CPU cruzando la tabla con la muestra anterior (ambas
+ * ordenadas por PID) y la guarda como nueva muestra. Un proceso es el
+ * mismo si coinciden PID e inicio; el UID se reutiliza si además no
+ * cambió el comm (un exec de un setuid cambia ambos).
+ */
+static int sample_finish(ProcScanner *sc, ProcTable *table)
+{
+    long long now = clock_ms(CLOCK_BOOTTIME);
+    long long elapsed = now - sc->prev_ms;
+    unsigned long long tps = (unsigned long long)sc->ticks_per_sec;
+    int j = 0;
+
+    for (int i = 0; i < table->count; i++) {
+        ProcInfo *e = &table->entries[i];
+        const ProcInfo *p = NULL;
+
+        if (e->state == 'X')
+            continue;
+        while (j < sc->prev_count && sc->prev[j].pid < e->pid)
+            j++;
+        if (j < sc->prev_count && sc->prev[j].pid == e->pid &&
+            sc->prev[j].start_ticks == e->start_ticks)
+            p = &sc->prev[j];
+
+        if (p && p->uid >= 0 && strcmp(p->comm, e->comm) == 0)
+            e->uid = p->uid;
+        else
+            e->uid = read_uid(sc, e->pid);
+
+        /* Sin muestra anterior: promedio desde que arrancó, como ps */
+        unsigned long long ticks = e->cpu_ticks;
+        long long window = now - (long long)(e->start_ticks * 1000 / tps);
+        if (p && elapsed > 0 && e->cpu_ticks >= p->cpu_ticks) {
+            ticks = e->cpu_ticks - p->cpu_ticks;
+            window = elapsed;
+        }
+        e->cpu_tenths = window > 0 ? (int)(ticks * 1000000ULL / (tps * (unsigned long long)window)) : 0;
+    }
+
+    if (table->count > sc->prev_capacity) {
+        ProcInfo *tmp = realloc(sc->prev, (size_t)table->count * sizeof(ProcInfo));
+        if (!tmp)
+            return -1;
+        sc->prev = tmp;
+        sc->prev_capacity = table->count;
+    }
+    if (table->count > 0)
+        memcpy(sc->prev, table->entries, (size_t)table->count * sizeof(ProcInfo));
+    sc->prev_count = table->count;
+    sc->prev_ms = now;
+    return 0;
+}
+
+int procscan_read(ProcScanner *sc, ProcTable *table)
+{
+    if (!sc || !table || sc->proc_fd < 0)
+        return -1;
+
+    if (lseek(sc->proc_fd, 0, SEEK_SET) < 0)
+        return -1;
+
+    table->count = 0;
+    int sorted = 1;
+
+    for (;;) {
+        long nread = syscall(SYS_getdents64, sc->proc_fd,
+                             sc->dirent_buf, sc->dirent_size);
+        if (nread < 0) {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        if (nread == 0)
+            break;
+
+        for (long off = 0; off < nread; ) {
+            struct linux_dirent64 *d =
+                (struct linux_dirent64 *)(sc->dirent_buf + off);
+            off += d->d_reclen;
+
+            /* Solo directorios con nombre numérico (un PID) */
+            const char *name = d->d_name;
+            if (name[0] < '1' || name[0] > '9')
+                continue;
+            int pid = 0;
+            const char *s = name;
+            while (*s >= '0' && *s <= '9')
+                pid = pid * 10 + (*s++ - '0');
+            if (*s != '\0')
+                continue;
+
+            if (table->count >= table->capacity) {
+                int new_cap = table->capacity ? table->capacity * 2
+                                              : INITIAL_CAPACITY;
+                ProcInfo *tmp = realloc(table->entries,
+                                        (size_t)new_cap * sizeof(ProcInfo));
+                if (!tmp)
+                    return -1;
+                table->entries  = tmp;
+                table->capacity = new_cap;
+            }
+
+            ProcInfo *info = &table->entries[table->count];
+            info->pid = pid;
+            if (read_stat(sc, name, info) != 0)
+                continue; /* Terminó mientras lo leíamos */
+
+            if (table->count > 0 && table->entries[table->count - 1].pid > pid)
+                sorted = 0;
+            table->count++;
+        }
+    }
+
+    if (!sorted)
+        qsort(table->entries, (size_t)table->count, sizeof(ProcInfo), cmp_pid);
+
+    if (sample_finish(sc, table) != 0)
+        return -1;
+    return table->count;
+}
+
+int procscan_sample(ProcScanner *sc, ProcTable *table)
+{
+    char name[16];
+
+    if (!sc || !table || sc->proc_fd < 0)
+        return -1;
+
+    for (int i = 0; i < table->count; i++) {
+        ProcInfo *e = &table->entries[i];
+        snprintf(name, sizeof(name), "%d", e->pid);
+        if (read_stat(sc, name, e) != 0) {
+            /* Terminó y el evento todavía no llegó */
+            e->state = 'X';
+            e->threads = 0;
+            e->rss_kb = 0;
+            e->cpu_tenths = 0;
+        }
+    }
+    return sample_finish(sc, table);
+}
+
+int procscan_read_pid(ProcScanner *sc, int pid, ProcInfo *info)
+{
+    char name[16];
+
+    if (!sc || sc->proc_fd < 0)
+        return -1;
+    snprintf(name, sizeof(name), "%d", pid);
+    info->pid = pid;
+    if (read_stat(sc, name, info) != 0)
+        return -1;
+    info->uid = read_uid(sc, pid);
+    return 0;
+}
+
+int procscan_format_ps(const ProcTable *table, int pid_width, RespBuf *out)
+{
+    if (respbuf_printf(out, "%*s COMMAND\n", pid_width, "PID") != 0)
+        return -1;
+
+    for (int i = 0; table && i < table->count; i++) {
+        const ProcInfo *e = &table->entries[i];
+        if (respbuf_printf(out, "%*d %s\n", pid_width, e->pid, e->comm) != 0)
+            return -1;
+    }
+    return 0;
+}
+
+int procscan_format_long(const ProcTable *table, int pid_width, RespBuf *out)
+{
+    if (respbuf_printf(out, "%*s %5s S %3s %9s %5s %10s COMMAND\n", pid_width, "PID",
+                       "UID", "THR", "RSS_KB", "%CPU", "START") != 0)
+        return -1;
+
+    for (int i = 0; table && i < table->count; i++) {
+        const ProcInfo *e = &table->entries[i];
+        if (respbuf_printf(out, "%*d %5d %c %3d %9ld %3d.%d %10lld %s\n", pid_width,
+                           e->pid, e->uid, e->state, e->threads, e->rss_kb,
+                           e->cpu_tenths / 10, e->cpu_tenths % 10, e->start_time,
+                           e->comm) != 0)
+            return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,115 @@
+#ifndef PROCSCAN_H
+#define PROCSCAN_H
+
+#include <stddef.h>
+
+#include "respbuf.h"
+
+#define PROCSCAN_COMM_SIZE 64
+
+/* Una entrada de la tabla de procesos leída de /proc/<pid>/stat. */
+typedef struct {
+    int pid;
+    int ppid;
+    char comm[PROCSCAN_COMM_SIZE];
+    char state;                     /* R, S, D, Z... ('X' si no se pudo leer) */
+    int threads;
+    int uid;                        /* Dueño de /proc/<pid>, -1 si no se sabe */
+    long rss_kb;
+    long long start_time;           /* Inicio, en segundos desde la época */
+    unsigned long long start_ticks; /* Inicio en ticks desde el arranque */
+    unsigned long long cpu_ticks;   /* utime + stime */
+    int cpu_tenths;                 /* %CPU x 10 desde la muestra anterior */
+} ProcInfo;
+
+/* Tabla de procesos ordenada por PID ascendente. */
+typedef struct {
+    ProcInfo *entries;
+    int count;
+    int capacity;
+} ProcTable;
+
+/*
+ * Estado reutilizable del escáner: descriptor de /proc y buffers de
+ * getdents64 y de lectura de stat. Un escáner por hilo; no es thread-safe.
+ */
+typedef struct {
+    int proc_fd;
+    char *dirent_buf;
+    size_t dirent_size;
+    char *read_buf;
+    size_t read_size;
+    int pid_width;          /* Ancho de la columna PID (igual que ps) */
+    long ticks_per_sec;     /* sysconf(_SC_CLK_TCK) */
+    long page_kb;
+    long long boot_epoch_ms; /* Momento del arranque del sistema */
+    ProcInfo *prev;         /* Muestra anterior, ordenada por PID */
+    int prev_count;
+    int prev_capacity;
+    long long prev_ms;      /* CLOCK_BOOTTIME de la muestra anterior */
+} ProcScanner;
+
+/* Abre /proc y reserva los buffers. Retorna 0 si OK, -1 en error. */
+int procscan_init(ProcScanner *sc);
+
+/* Cierra /proc y libera los buffers. */
+void procscan_destroy(ProcScanner *sc);
+
+/*
+ * Recorre /proc con getdents64 y llena la tabla (reutiliza su memoria).
+ * Los procesos que desaparecen durante el recorrido se omiten.
+ * Retorna el número de procesos leídos o -1 en error.
+ *
+ * Todo sale del mismo /proc/<pid>/stat que ya se leía (estado, hilos,
+ * RSS, inicio, CPU); el %CPU se calcula contra la muestra anterior que
+ * guarda el escáner, y el UID (un fstatat) solo se consulta para los
+ * procesos nuevos o que hicieron exec desde la muestra anterior.
+ */
+int procscan_read(ProcScanner *sc, ProcTable *table);
+
+/*
+ * Vuelve a leer las métricas de los procesos que ya están en la tabla
+ * (por ejemplo la que mantienen los eventos del kernel), sin recorrer
+ * /proc. Los que ya no existen quedan en estado 'X'. Retorna 0 o -1.
+ */
+int procscan_sample(ProcScanner *sc, ProcTable *table);
+
+/*
+ * Lee /proc/<pid>/stat de un solo proceso. Retorna 0 si OK, -1 si ya
+ * no existe.
+ */
+int procscan_read_pid(ProcScanner *sc, int pid, ProcInfo *info);
+
+/* Libera la memoria de la tabla. */
+void proctable_free(ProcTable *table);
+
+/*
+ * Escribe en out (con lugar para table->count PIDs) el PID root y todos
+ * sus descendientes, padres antes que hijos. El índice de padres se arma
+ * en una pasada, así que el costo es lineal. Retorna cuántos escribió
+ * (0 si root no está en la tabla) o -1 sin memoria.
+ */
+int proctable_descendants(const ProcTable *table, int root, int *out);
+
+/*
+ * Escribe en out los PIDs cuyo comm coincide con el patrón glob
+ * (fnmatch). Retorna cuántos escribió.
+ */
+int proctable_match(const ProcTable *table, const char *pattern, int *out);
+
+/*
+ * Agrega la tabla al constructor de respuestas en el formato de
+ * `ps -e -o pid,comm` (encabezado incluido). Costo lineal en el número
+ * de procesos. Retorna 0 si OK, -1 en error.
+ */
+int procscan_format_ps(const ProcTable *table, int pid_width, RespBuf *out);
+
+/*
+ * Como procscan_format_ps pero con todas las columnas (LIST LONG):
+ *   PID UID S THR RSS_KB %CPU START COMMAND
+ * START en segundos desde la época; COMMAND al final porque puede tener
+ * espacios.
+ */
+int procscan_format_long(const ProcTable *table, int pid_width, RespBuf *out);
+
+#endif /* PROCSCAN_H */
@@ -0,0 +1,141 @@
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/socket.h>
+
+#include "proto.h"
+
+#define INBUF_INITIAL   4096
+#define INBUF_MIN_FREE  1024
+
+void frame_header_encode(unsigned char *out, uint32_t len,
+                         uint8_t type, uint8_t flags)
+{
+    out[0] = (unsigned char)(len >> 24);
+    out[1] = (unsigned char)(len >> 16);
+    out[2] = (unsigned char)(len >> 8);
+    out[3] = (unsigned char)len;
+    out[4] = type;
+    out[5] = flags;
+    out[6] = 0;
+    out[7] = 0;
+}
+
+int frame_header_decode(const unsigned char *in, FrameHeader *hdr)
+{
+    hdr->len = ((uint32_t)in[0] << 24) | ((uint32_t)in[1] << 16) |
+               ((uint32_t)in[2] << 8) | (uint32_t)in[3];
+    hdr->type  = in[4];
+    hdr->flags = in[5];
+
+    if (hdr->len > FRAME_MAX_PAYLOAD || hdr->type == 0 ||
+        in[6] != 0 || in[7] != 0)
+        return -1;
+    return 0;
+}
+
+void inbuf_init(InBuf *ib)
+{
+    ib->data  = NULL;
+    ib->start = 0;
+    ib->len   = 0;
+    ib->cap   = 0;
+}
+
+void inbuf_free(InBuf *ib)
+{
+    free(ib->data);
+    inbuf_init(ib);
+}
+
+void inbuf_release(InBuf *ib)
+{
+    if (ib->start == ib->len)
+        inbuf_free(ib);
+}
+
+long inbuf_recv(InBuf *ib, int fd)
+{
+    /* Compactar lo ya consumido antes de crecer */
+    if (ib->start > 0) {
+        memmove(ib->data, ib->data + ib->start, ib->len - ib->start);
+        ib->len  -= ib->start;
+        ib->start = 0;
+    }
+
+    if (ib->len >= INBUF_MAX) {
+        errno = EMSGSIZE;
+        return -1;
+    }
+
+    /* Dejar un mínimo de espacio libre más el '\0' final, hasta el tope */
+    if (ib->cap - ib->len < INBUF_MIN_FREE + 1 && ib->cap < INBUF_MAX + 1) {
+        size_t new_cap = ib->cap ? ib->cap * 2 : INBUF_INITIAL;
+        if (new_cap > INBUF_MAX + 1)
+            new_cap = INBUF_MAX + 1;
+        char *tmp = realloc(ib->data, new_cap);
+        if (!tmp) {
+            errno = ENOMEM;
+            return -1;
+        }
+        ib->data = tmp;
+        ib->cap  = new_cap;
+    }
+
+    size_t room = ib->cap - ib->len - 1;
+    if (room > INBUF_MAX - ib->len)
+        room = INBUF_MAX - ib->len;
+    ssize_t n = recv(fd, ib->data + ib->len, room, 0);
+    if (n > 0)
+        ib->len += (size_t)n;
+    return (long)n;
+}
+
+int inbuf_full(const InBuf *ib)
+{
+    return ib->len - ib->start >= INBUF_MAX;
+}
+
+int inbuf_next_line(InBuf *ib, char **line, size_t *len)
+{
+    char *begin = ib->data + ib->start;
+    char *nl = memchr(begin, '\n', ib->len - ib->start);
+    if (!nl)
+        return 0;
+
+    ib->start = (size_t)(nl - ib->data) + 1;
+    if (nl > begin && nl[-1] == '\r')
+        nl--;
+    *nl = '\0';
+
+    *line = begin;
+    *len  = (size_t)(nl - begin);
+    return 1;
+}
+
+int inbuf_next_frame(InBuf *ib, FrameHeader *hdr, char **payload)
+{
+    size_t avail = ib->len - ib->start;
+    if (avail < FRAME_HEADER_SIZE)
+        return 0;
+
+    unsigned char *p = (unsigned char *)ib->data + ib->start;
+    if (frame_header_decode(p, hdr) != 0)
+        return -1;
+    if (hdr->len > CMD_MAX_SIZE)
+        return -2;
+    if (avail < FRAME_HEADER_SIZE + hdr->len)
+        return 0;
+
+    /*
+     * Terminar el payload en '\0' sin pisar el siguiente frame: se mueve
+     * el payload sobre la cabecera ya consumida.
+     */
+    char *dst = ib->data + ib->start;
+    memmove(dst, dst + FRAME_HEADER_SIZE, hdr->len);
+    dst[hdr->len] = '\0';
+
+    ib->start += FRAME_HEADER_SIZE + hdr->len;
+    *payload = dst;
+    return 1;
+}
@@ -0,0 +1,110 @@
+#ifndef PROTO_H
+#define PROTO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Protocolo enmarcado (modo FRAMED).
+ *
+ * El cliente lo negocia enviando la línea de texto "FRAMED"; el servidor
+ * responde "OK FRAMED <versión>\n" en texto y a partir de ahí cada mensaje
+ * en ambos sentidos lleva una cabecera de 8 bytes:
+ *
+ *   bytes 0-3  longitud del payload (big-endian)
+ *   byte  4    tipo de mensaje (FRAME_*)
+ *   byte  5    flags (FRAME_F_*)
+ *   bytes 6-7  reservados (0)
+ *
+ * Cada mensaje va en un solo frame, de cualquier tamaño hasta
+ * FRAME_MAX_PAYLOAD (los comandos, hasta CMD_MAX_SIZE). Con COMPRESS, un
+ * mensaje comprimido (compress.h) lleva FRAME_F_COMPRESSED y el receptor
+ * lo descomprime al recibir el frame completo. FRAME_F_MORE (mensaje
+ * partido en varios frames) está reservado: el servidor nunca lo envía y
+ * responde un error y cierra la conexión si un comando lo trae.
+ */
+
+#define PROTO_VERSION       1
+#define FRAME_HEADER_SIZE   8
+#define FRAME_MAX_PAYLOAD   (64u * 1024 * 1024)
+
+/*
+ * Comando más largo que se acepta (línea de texto o payload de un
+ * FRAME_CMD). La entrada pendiente de una conexión nunca pasa de un
+ * comando más su cabecera: lo que no entra se rechaza con un error y
+ * la conexión se cierra.
+ */
+#define CMD_MAX_SIZE        (64u * 1024)
+#define INBUF_MAX           (CMD_MAX_SIZE + FRAME_HEADER_SIZE)
+
+#define FRAME_CMD   1   /* Comando del cliente */
+#define FRAME_RESP  2   /* Respuesta del servidor */
+#define FRAME_EVENT 3   /* Cambios enviados por el servidor sin pedido (SUBSCRIBE) */
+
+#define FRAME_F_MORE       0x01 /* Reservado: mensaje en varios frames */
+#define FRAME_F_COMPRESSED 0x02 /* El mensaje va comprimido (compress.h) */
+
+typedef struct {
+    uint32_t len;
+    uint8_t type;
+    uint8_t flags;
+} FrameHeader;
+
+/* Codifica una cabecera en out (FRAME_HEADER_SIZE bytes). */
+void frame_header_encode(unsigned char *out, uint32_t len,
+                         uint8_t type, uint8_t flags);
+
+/* Decodifica una cabecera. Retorna 0 si es válida, -1 si no. */
+int frame_header_decode(const unsigned char *in, FrameHeader *hdr);
+
+/*
+ * Buffer de entrada de una conexión: acumula lo que llega por recv()
+ * y permite extraer mensajes completos (líneas o frames) de forma
+ * incremental, sin importar cómo los fragmente TCP.
+ */
+typedef struct {
+    char *data;
+    size_t start;   /* Inicio de los bytes aún no consumidos */
+    size_t len;     /* Fin de los bytes válidos */
+    size_t cap;
+} InBuf;
+
+void inbuf_init(InBuf *ib);
+void inbuf_free(InBuf *ib);
+
+/*
+ * Libera la memoria si no quedan bytes pendientes, para que una conexión
+ * inactiva no retenga buffers.
+ */
+void inbuf_release(InBuf *ib);
+
+/*
+ * Hace un recv() sobre fd y agrega lo leído, sin pasar de INBUF_MAX bytes
+ * pendientes. Retorna los bytes leídos, 0 si el peer cerró, -1 en error
+ * (errno indica la causa; EMSGSIZE si el buffer está lleno y hay que
+ * extraer comandos antes de seguir leyendo).
+ */
+long inbuf_recv(InBuf *ib, int fd);
+
+/*
+ * 1 si el buffer está lleno: si tampoco se puede extraer un comando, el
+ * que está en curso supera CMD_MAX_SIZE.
+ */
+int inbuf_full(const InBuf *ib);
+
+/*
+ * Extrae la siguiente línea completa (sin "\r\n") terminada en '\0'.
+ * Retorna 1 si hay línea, 0 si falta data.
+ */
+int inbuf_next_line(InBuf *ib, char **line, size_t *len);
+
+/*
+ * Extrae el siguiente frame completo. El payload queda terminado en '\0'
+ * dentro del buffer y es válido hasta la siguiente llamada a inbuf_recv.
+ * Retorna 1 si hay frame, 0 si falta data, -1 si la cabecera es inválida,
+ * -2 si el payload supera CMD_MAX_SIZE (se detecta con la cabecera, sin
+ * esperar el resto).
+ */
+int inbuf_next_frame(InBuf *ib, FrameHeader *hdr, char **payload);
+
+#endif /* PROTO_H */
@@ -0,0 +1,474 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <errno.h>
+
+#include "query.h"
+#include "wire.h"
+
+/* Operadores */
+#define OP_EQ   0
+#define OP_NE   1
+#define OP_LT   2
+#define OP_LE   3
+#define OP_GT   4
+#define OP_GE   5
+#define OP_HAS  6
+
+static const struct {
+    const char *name;
+    const char *header;
+    int width;                  /* 0 = ancho de PID */
+} fields[QF_COUNT] = {
+    [QF_PID]     = { "pid",     "PID",     0 },
+    [QF_PPID]    = { "ppid",    "PPID",    0 },
+    [QF_UID]     = { "uid",     "UID",     5 },
+    [QF_STATE]   = { "state",   "S",       1 },
+    [QF_THREADS] = { "threads", "THR",     3 },
+    [QF_RSS]     = { "rss",     "RSS_KB",  9 },
+    [QF_CPU]     = { "cpu",     "%CPU",    5 },
+    [QF_START]   = { "start",   "START",  10 },
+    [QF_NAME]    = { "name",    "COMMAND", 0 },
+};
+
+/* Columnas de LIST LONG, para cuando no hay FIELDS */
+static const int long_fields[] = {
+    QF_PID, QF_UID, QF_STATE, QF_THREADS, QF_RSS, QF_CPU, QF_START, QF_NAME
+};
+
+static int field_by_name(const char *name, size_t len)
+{
+    for (int i = 0; i < QF_COUNT; i++) {
+        if (strlen(fields[i].name) == len && strncasecmp(name, fields[i].name, len) == 0)
+            return i;
+    }
+    /* Sinónimos con los nombres de las columnas */
+    if (len == 4 && strncasecmp(name, "comm", 4) == 0)
+        return QF_NAME;
+    return -1;
+}
+
+static long long field_value(const ProcInfo *e, int field)
+{
+    switch (field) {
+    case QF_PID:     return e->pid;
+    case QF_PPID:    return e->ppid;
+    case QF_UID:     return e->uid;
+    case QF_STATE:   return e->state;
+    case QF_THREADS: return e->threads;
+    case QF_RSS:     return e->rss_kb;
+    case QF_CPU:     return e->cpu_tenths;
+    case QF_START:   return e->start_time;
+    default:         return 0;
+    }
+}
+
+static int is_keyword(const char *tok)
+{
+    return strcasecmp(tok, "WHERE") == 0 || strcasecmp(tok, "SORT") == 0 ||
+           strcasecmp(tok, "OFFSET") == 0 || strcasecmp(tok, "LIMIT") == 0 ||
+           strcasecmp(tok, "FIELDS") == 0 || strcasecmp(tok, "AT") == 0;
+}
+
+/* Parsea "campo<op>valor". Retorna 0 o -1 con el motivo en err. */
+static int parse_cond(const char *tok, QueryCond *c, char *err, size_t err_size)
+{
+    static const struct { const char *text; int op; } ops[] = {
+        { "!=", OP_NE }, { "<=", OP_LE }, { ">=", OP_GE },
+        { "=", OP_EQ }, { "<", OP_LT }, { ">", OP_GT }, { "~", OP_HAS }, { NULL, 0 }
+    };
+    size_t at = strcspn(tok, "=!<>~");
+    const char *value = NULL;
+
+    for (int i = 0; ops[i].text; i++) {
+        if (strncmp(tok + at, ops[i].text, strlen(ops[i].text)) == 0) {
+            c->op = ops[i].op;
+            value = tok + at + strlen(ops[i].text);
+            break;
+        }
+    }
+    c->field = field_by_name(tok, at);
+    if (at == 0 || c->field < 0 || value == NULL || *value == '\0') {
+        snprintf(err, err_size, "Condicion invalida '%s' (ej. name~nginx, rss>1000)", tok);
+        return -1;
+    }
+
+    if (c->field == QF_NAME) {
+        if (c->op != OP_EQ && c->op != OP_NE && c->op != OP_HAS) {
+            snprintf(err, err_size, "name solo admite =, != y ~");
+            return -1;
+        }
+        snprintf(c->text, sizeof(c->text), "%s", value);
+        return 0;
+    }
+    if (c->op == OP_HAS) {
+        snprintf(err, err_size, "~ solo se aplica a name");
+        return -1;
+    }
+    if (c->field == QF_STATE) {
+        if (value[1] != '\0' || (c->op != OP_EQ && c->op != OP_NE)) {
+            snprintf(err, err_size, "state se compara con = o != y una letra (ej. state=R)");
+            return -1;
+        }
+        c->num = toupper((unsigned char)value[0]);
+        return 0;
+    }
+
+    char *end;
+    errno = 0;
+    if (c->field == QF_CPU) {
+        double pct = strtod(value, &end);
+        c->num = (long long)(pct * 10 + (pct >= 0 ? 0.5 : -0.5));
+    } else {
+        c->num = strtoll(value, &end, 10);
+    }
+    if (errno != 0 || *end != '\0') {
+        snprintf(err, err_size, "Valor invalido '%s' en '%s'", value, tok);
+        return -1;
+    }
+    return 0;
+}
+
+/* Parsea "campo,campo,..." sin repetir. */
+static int parse_fields(char *list, Query *q, char *err, size_t err_size)
+{
+    char *save;
+
+    for (char *name = strtok_r(list, ",", &save); name; name = strtok_r(NULL, ",", &save)) {
+        int f = field_by_name(name, strlen(name));
+        if (f < 0) {
+            snprintf(err, err_size, "Campo desconocido '%s'", name);
+            return -1;
+        }
+        int seen = 0;
+        for (int i = 0; i < q->nfields; i++)
+            seen |= q->fields[i] == f;
+        if (!seen)
+            q->fields[q->nfields++] = f;
+    }
+    if (q->nfields == 0) {
+        snprintf(err, err_size, "FIELDS requiere al menos un campo");
+        return -1;
+    }
+    return 0;
+}
+
+int query_parse(char *args, Query *q, char *err, size_t err_size)
+{
+    char *save;
+    char *tok = strtok_r(args, " ", &save);
+
+    memset(q, 0, sizeof(*q));
+    q->sort_field = -1;
+    q->limit = -1;
+
+    while (tok) {
+        if (strcasecmp(tok, "WHERE") == 0) {
+            while ((tok = strtok_r(NULL, " ", &save)) && !is_keyword(tok)) {
+                if (strcasecmp(tok, "AND") == 0)
+                    continue;
+                if (q->nconds == QUERY_MAX_CONDS) {
+                    snprintf(err, err_size, "Demasiadas condiciones (max %d)", QUERY_MAX_CONDS);
+                    return -1;
+                }
+                if (parse_cond(tok, &q->conds[q->nconds++], err, err_size) != 0)
+                    return -1;
+            }
+            continue;
+        } else if (strcasecmp(tok, "SORT") == 0) {
+            char *name = strtok_r(NULL, " ", &save);
+            q->sort_field = name ? field_by_name(name, strlen(name)) : -1;
+            if (q->sort_field < 0) {
+                snprintf(err, err_size, "SORT requiere un campo (pid, name, rss, cpu...)");
+                return -1;
+            }
+            tok = strtok_r(NULL, " ", &save);
+            if (tok && (strcasecmp(tok, "DESC") == 0 || strcasecmp(tok, "ASC") == 0)) {
+                q->desc = strcasecmp(tok, "DESC") == 0;
+                tok = strtok_r(NULL, " ", &save);
+            }
+            continue;
+        } else if (strcasecmp(tok, "LIMIT") == 0 || strcasecmp(tok, "OFFSET") == 0) {
+            char *value = strtok_r(NULL, " ", &save);
+            char *end = NULL;
+            long n = value ? strtol(value, &end, 10) : -1;
+            if (!value || *end != '\0' || n < 0) {
+                snprintf(err, err_size, "%s requiere un numero >= 0", tok);
+                return -1;
+            }
+            if (strcasecmp(tok, "LIMIT") == 0)
+                q->limit = n;
+            else
+                q->offset = n;
+        } else if (strcasecmp(tok, "AT") == 0) {
+            char *value = strtok_r(NULL, " ", &save);
+            char *end = NULL;
+            if (value && isdigit((unsigned char)value[0]))
+                q->at = strtoul(value, &end, 10);
+            if (end == NULL || *end != '\0' || q->at == 0) {
+                snprintf(err, err_size, "AT requiere una generacion");
+                return -1;
+            }
+        } else if (strcasecmp(tok, "FIELDS") == 0) {
+            char *list = strtok_r(NULL, " ", &save);
+            if (!list) {
+                snprintf(err, err_size, "FIELDS requiere una lista (ej. pid,name,rss)");
+                return -1;
+            }
+            if (parse_fields(list, q, err, err_size) != 0)
+                return -1;
+        } else {
+            snprintf(err, err_size, "Clausula desconocida '%s'", tok);
+            return -1;
+        }
+        tok = strtok_r(NULL, " ", &save);
+    }
+    return 0;
+}
+
+int query_needs_metrics(const Query *q)
+{
+    int needs = q->nfields == 0 || (q->sort_field > QF_PPID && q->sort_field != QF_NAME);
+
+    for (int i = 0; i < q->nconds; i++)
+        needs |= q->conds[i].field > QF_PPID && q->conds[i].field != QF_NAME;
+    for (int i = 0; i < q->nfields; i++)
+        needs |= q->fields[i] > QF_PPID && q->fields[i] != QF_NAME;
+    return needs;
+}
+
+static int matches(const Query *q, const ProcInfo *e)
+{
+    for (int i = 0; i < q->nconds; i++) {
+        const QueryCond *c = &q->conds[i];
+        int ok;
+
+        if (c->field == QF_NAME) {
+            if (c->op == OP_HAS)
+                ok = strcasestr(e->comm, c->text) != NULL;
+            else
+                ok = (strcmp(e->comm, c->text) == 0) == (c->op == OP_EQ);
+        } else {
+            long long v = field_value(e, c->field);
+            switch (c->op) {
+            case OP_EQ: ok = v == c->num; break;
+            case OP_NE: ok = v != c->num; break;
+            case OP_LT: ok = v <  c->num; break;
+            case OP_LE: ok = v <= c->num; break;
+            case OP_GT: ok = v >  c->num; break;
+            default:    ok = v >= c->num; break;
+            }
+        }
+        if (!ok)
+            return 0;
+    }
+    return 1;
+}
+
+/* Orden de salida: el campo de SORT y, a igualdad, el PID. */
+static int compare(const void *pa, const void *pb, void *arg)
+{
+    const Query *q = arg;
+    const ProcInfo *a = *(const ProcInfo *const *)pa;
+    const ProcInfo *b = *(const ProcInfo *const *)pb;
+    int res = 0;
+
+    if (q->sort_field == QF_NAME) {
+        res = strcmp(a->comm, b->comm);
+    } else if (q->sort_field >= 0) {
+        long long x = field_value(a, q->sort_field), y = field_value(b, q->sort_field);
+        res = (x > y) - (x < y);
+    }
+    if (q->desc)
+        res = -res;
+    if (res == 0)
+        res = (a->pid > b->pid) - (a->pid < b->pid);
+    return res;
+}
+
+/* Hunde heap[i] en un heap donde la raíz es la peor fila (la última en salir). */
+static void sift_down(const ProcInfo **heap, int size, int i, const Query *q)
+{
+    for (;;) {
+        int worst = i, l = 2 * i + 1, r = l + 1;
+        if (l < size && compare(&heap[l], &heap[worst], (void *)q) > 0)
+            worst = l;
+        if (r < size && compare(&heap[r], &heap[worst], (void *)q) > 0)
+            worst = r;
+        if (worst == i)
+            return;
+        const ProcInfo *tmp = heap[i];
+        heap[i] = heap[worst];
+        heap[worst] = tmp;
+        i = worst;
+    }
+}
+
+static void sift_up(const ProcInfo **heap, int i, const Query *q)
+{
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (compare(&heap[i], &heap[parent], (void *)q) <= 0)
+            return;
+        const ProcInfo *tmp = heap[i];
+        heap[i] = heap[parent];
+        heap[parent] = tmp;
+        i = parent;
+    }
+}
+
+static int format_header(const int *cols, int ncols, int pid_width, RespBuf *out)
+{
+    for (int i = 0; i < ncols; i++) {
+        int f = cols[i];
+        int width = fields[f].width ? fields[f].width : pid_width;
+        int res = f == QF_NAME ? respbuf_puts(out, fields[f].header)
+                               : respbuf_printf(out, "%*s%s", f == QF_STATE ? 0 : width,
+                                                fields[f].header, i + 1 < ncols ? " " : "");
+        if (res != 0)
+            return -1;
+    }
+    return respbuf_puts(out, "\n");
+}
+
+static int format_row(const ProcInfo *e, const int *cols, int ncols, int pid_width, RespBuf *out)
+{
+    for (int i = 0; i < ncols; i++) {
+        int f = cols[i];
+        int width = fields[f].width ? fields[f].width : pid_width;
+        const char *sep = i + 1 < ncols ? " " : "";
+        int res;
+
+        switch (f) {
+        case QF_NAME:
+            res = respbuf_puts(out, e->comm);
+            break;
+        case QF_STATE:
+            res = respbuf_printf(out, "%c%s", e->state, sep);
+            break;
+        case QF_CPU:
+            res = respbuf_printf(out, "%3d.%d%s", e->cpu_tenths / 10, e->cpu_tenths % 10, sep);
+            break;
+        default:
+            res = respbuf_printf(out, "%*lld%s", width, field_value(e, f), sep);
+            break;
+        }
+        if (res != 0)
+            return -1;
+    }
+    return respbuf_puts(out, "\n");
+}
+
+/*
+ * Deja en *rows las filas que cumplen el WHERE, ordenadas, hasta
+ * OFFSET + LIMIT (las primeras OFFSET incluidas), y en *total cuántas
+ * cumplen. El llamador libera *rows. Retorna 0 si OK, -1 sin memoria.
+ */
+static int select_rows(const Query *q, const ProcTable *table,
+                       const ProcInfo ***out_rows, int *out_count, int *out_total)
+{
+    long k = q->limit;
+
+    /* Hacen falta las primeras OFFSET + LIMIT; las de OFFSET no se envían */
+    if (k < 0 || k > table->count)
+        k = table->count;
+    k = q->offset < table->count - k ? k + q->offset : table->count;
+    const ProcInfo **rows = malloc((size_t)(k + 1) * sizeof(*rows));
+    if (!rows)
+        return -1;
+
+    /*
+     * Sin SORT la tabla ya está en orden de PID: alcanza con las primeras
+     * k que cumplan. Con SORT, un heap con las k mejores hasta ahora.
+     */
+    int total = 0, count = 0;
+    for (int i = 0; i < table->count; i++) {
+        const ProcInfo *e = &table->entries[i];
+        if (!matches(q, e))
+            continue;
+        total++;
+        if (k == 0)
+            continue;
+        if (q->sort_field < 0) {
+            if (count < k)
+                rows[count++] = e;
+        } else if (count < k) {
+            rows[count] = e;
+            sift_up(rows, count++, q);
+        } else if (compare(&e, &rows[0], (void *)q) < 0) {
+            rows[0] = e;
+            sift_down(rows, count, 0, q);
+        }
+    }
+    if (q->sort_field >= 0)
+        qsort_r(rows, (size_t)count, sizeof(*rows), compare, (void *)q);
+
+    *out_rows  = rows;
+    *out_count = count;
+    *out_total = total;
+    return 0;
+}
+
+int query_run(const Query *q, const ProcTable *table, int pid_width,
+              unsigned long generation, RespBuf *out)
+{
+    int cols[QF_COUNT], ncols = 0, has_name = 0;
+
+    /* Columnas en el orden pedido, con el nombre al final */
+    const int *want = q->nfields ? q->fields : long_fields;
+    int nwant = q->nfields ? q->nfields : (int)(sizeof(long_fields) / sizeof(long_fields[0]));
+    for (int i = 0; i < nwant; i++) {
+        if (want[i] == QF_NAME)
+            has_name = 1;
+        else
+            cols[ncols++] = want[i];
+    }
+    if (has_name)
+        cols[ncols++] = QF_NAME;
+
+    const ProcInfo **rows;
+    int count, total;
+    if (select_rows(q, table, &rows, &count, &total) != 0)
+        return -1;
+
+    int res = respbuf_printf(out, "ROWS %lu %ld %d\n", generation, q->offset, total);
+    if (res == 0)
+        res = format_header(cols, ncols, pid_width, out);
+    for (long i = q->offset; i < count && res == 0; i++)
+        res = format_row(rows[i], cols, ncols, pid_width, out);
+
+    free(rows);
+    return res;
+}
+
+int query_binary(const Query *q)
+{
+    return q->nfields == 0 && q->sort_field < 0;
+}
+
+int query_run_binary(const Query *q, const ProcTable *table,
+                     unsigned long generation, RespBuf *out)
+{
+    const ProcInfo **rows;
+    int count, total;
+    if (select_rows(q, table, &rows, &count, &total) != 0)
+        return -1;
+
+    WireHeader hdr = {
+        .generation = generation,
+        .offset     = q->offset,
+        .total      = total,
+        .metrics    = 1,
+    };
+    int skip = q->offset < count ? (int)q->offset : count;
+    char *data;
+    size_t len;
+    int res = wire_encode(&hdr, rows + skip, count - skip, &data, &len);
+    free(rows);
+    if (res != 0)
+        return -1;
+    return respbuf_attach(out, data, len, free, data);
+}
@@ -0,0 +1,92 @@
+#ifndef QUERY_H
+#define QUERY_H
+
+#include <stddef.h>
+
+#include "procscan.h"
+#include "respbuf.h"
+
+/*
+ * Consultas sobre la tabla de procesos en memoria (LIST con cláusulas):
+ *
+ *   LIST [WHERE <cond> [AND <cond>...]] [SORT <campo> [ASC|DESC]]
+ *        [OFFSET <n>] [LIMIT <n>] [FIELDS <campo>,<campo>...] [AT <gen>]
+ *
+ * Campos: pid, ppid, name, uid, state, threads, rss (KB), cpu (%),
+ * start (segundos desde la época). Condiciones: campo, operador
+ * (=, !=, <, <=, >, >=, y ~ para "contiene" sin distinguir mayúsculas)
+ * y valor, sin espacios: `name~nginx`, `rss>100000`, `cpu>=2.5`.
+ *
+ * La respuesta empieza con "ROWS <generación> <desde> <total>" (total =
+ * filas que cumplen el WHERE, antes del LIMIT), sigue el encabezado y
+ * una fila por proceso con las columnas pedidas, o las de LIST LONG si
+ * no hay FIELDS. El nombre va siempre al final porque puede tener
+ * espacios. Con SORT y LIMIT se ordena parcialmente con un heap de
+ * tamaño OFFSET + LIMIT: el costo es O(n log k), no O(n log n).
+ *
+ * OFFSET y AT sirven para paginar: AT fija la generación de la tabla,
+ * así las páginas de un mismo recorrido no se corren si entre una y
+ * otra aparecen o terminan procesos. Si esa generación ya salió de la
+ * historia se responde con la actual y el cliente lo ve en ROWS.
+ */
+
+#define QUERY_MAX_CONDS  8
+
+/* Campos de la tabla */
+#define QF_PID      0
+#define QF_PPID     1
+#define QF_UID      2
+#define QF_STATE    3
+#define QF_THREADS  4
+#define QF_RSS      5
+#define QF_CPU      6
+#define QF_START    7
+#define QF_NAME     8
+#define QF_COUNT    9
+
+typedef struct {
+    int field;
+    int op;
+    long long num;              /* Valor numérico (cpu en décimas) */
+    char text[PROCSCAN_COMM_SIZE];
+} QueryCond;
+
+typedef struct {
+    QueryCond conds[QUERY_MAX_CONDS];
+    int nconds;
+    int sort_field;             /* -1 = por PID, como LIST */
+    int desc;
+    long offset;                /* Filas a saltear */
+    long limit;                 /* -1 = sin límite */
+    unsigned long at;           /* Generación pedida, 0 = la actual */
+    int fields[QF_COUNT];       /* Columnas pedidas, en orden */
+    int nfields;                /* 0 = las de LIST LONG */
+} Query;
+
+/*
+ * Parsea las cláusulas (modifica args). Retorna 0 si OK, o -1 y deja el
+ * motivo en err.
+ */
+int query_parse(char *args, Query *q, char *err, size_t err_size);
+
+/* Indica si la consulta usa columnas que requieren métricas. */
+int query_needs_metrics(const Query *q);
+
+/*
+ * Evalúa la consulta sobre la tabla (ordenada por PID) y escribe la
+ * respuesta. Retorna 0 si OK, -1 sin memoria.
+ */
+int query_run(const Query *q, const ProcTable *table, int pid_width,
+              unsigned long generation, RespBuf *out);
+
+/*
+ * Indica si la respuesta puede ir en binario (wire.h): sin FIELDS ni
+ * SORT, es decir las columnas de LIST LONG en orden de PID.
+ */
+int query_binary(const Query *q);
+
+/* Como query_run, pero codificada en binario. */
+int query_run_binary(const Query *q, const ProcTable *table,
+                     unsigned long generation, RespBuf *out);
+
+#endif /* QUERY_H */
@@ -0,0 +1,643 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stdint.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sched.h>
+
+#include "reactor.h"
+#include "workers.h"
+#include "compress.h"
+
+#define MAX_EVENTS      256
+#define READS_PER_EVENT 16      /* Lecturas máximas por evento (equidad) */
+#define FLUSH_IOV       64      /* Segmentos por llamada a sendmsg */
+
+struct Job {
+    Conn *conn;
+    DeferredFn fn;
+    ResumeFn resume;        /* Opcional: continúa en el reactor */
+    void *arg;
+    RespBuf out;
+    Job *next;
+};
+
+static void conn_process_input(Conn *c);
+
+static void conn_free(Conn *c)
+{
+    inbuf_free(&c->in);
+    respbuf_free(&c->out);
+    free(c);
+}
+
+/* Cierra el socket. Si hay un worker en curso, la memoria se libera al terminar. */
+static void conn_close(Conn *c)
+{
+    Reactor *r = c->reactor;
+
+    reactor_unsubscribe(c);
+    epoll_ctl(r->epfd, EPOLL_CTL_DEL, c->fd, NULL);
+    close(c->fd);
+    c->fd = -1;
+    __atomic_fetch_sub(&r->connections, 1, __ATOMIC_RELAXED);
+    printf("[TCP] Client %s disconnected\n", c->ip);
+
+    if (c->state == CONN_WAITING)
+        c->dead = 1;
+    else
+        conn_free(c);
+}
+
+/* 1 si la salida pendiente llegó al umbral: no ejecutar más comandos. */
+static int conn_backlogged(const Conn *c)
+{
+    return respbuf_total(&c->out) - c->out_sent >= REACTOR_OUT_HIGH_WATER;
+}
+
+/* El cliente cerró su lado: cerrar cuando no queden comandos por ejecutar. */
+static void conn_check_eof(Conn *c)
+{
+    if (c->eof && c->state == CONN_READING && !c->throttled)
+        c->state = CONN_CLOSING;
+}
+
+/*
+ * Ajusta los eventos de epoll al estado: EPOLLIN solo mientras se
+ * aceptan comandos y EPOLLOUT solo si hay salida pendiente.
+ */
+static void conn_update_events(Conn *c)
+{
+    unsigned int want = 0;
+    if (c->state == CONN_READING && !c->throttled)
+        want |= EPOLLIN | EPOLLRDHUP;
+    if (c->out_sent < respbuf_total(&c->out))
+        want |= EPOLLOUT;
+
+    if (want != c->events) {
+        struct epoll_event ev;
+        ev.events = want;
+        ev.data.ptr = c;
+        epoll_ctl(c->reactor->epfd, EPOLL_CTL_MOD, c->fd, &ev);
+        c->events = want;
+    }
+}
+
+/*
+ * Comprime el payload del mensaje que empieza en el byte `base` de la
+ * salida (contando los compartidos): lo reemplaza por la versión
+ * comprimida, que queda a cargo de la respuesta. Retorna 0 si lo
+ * comprimió, -1 si no supera el umbral, no se achica o falta memoria.
+ */
+static int conn_compress(Conn *c, size_t start, size_t base, int mark)
+{
+    size_t from = base + FRAME_HEADER_SIZE;
+    size_t raw = respbuf_total(&c->out) - from;
+    struct iovec iov[FLUSH_IOV];
+    char *data;
+    size_t len;
+
+    if (raw < c->compress_min)
+        return -1;
+    int n = respbuf_iov(&c->out, from, iov, FLUSH_IOV);
+    size_t got = 0;
+    for (int i = 0; i < n; i++)
+        got += iov[i].iov_len;
+    if (got != raw || compress_message(iov, n, &data, &len) != 0)
+        return -1;
+
+    /* Sin memoria para la referencia, respbuf_attach lo copia */
+    respbuf_truncate(&c->out, start + FRAME_HEADER_SIZE, mark);
+    respbuf_attach(&c->out, data, len, free, data);
+    compress_note_sent(raw, len);
+    return 0;
+}
+
+/*
+ * Cierra el mensaje abierto en `start` (`base` y `mark`: tamaño total y
+ * referencias de la salida antes de abrirlo). Las respuestas compartidas
+ * llegan ya comprimidas (conn->packed); las demás se comprimen acá si la
+ * conexión negoció COMPRESS.
+ */
+static void conn_frame_end(Conn *c, size_t start, size_t base, int mark, int type)
+{
+    int flags = 0;
+
+    if (c->packed > 0 ||
+        (c->packed == 0 && c->compress_min && conn_compress(c, start, base, mark) == 0))
+        flags = FRAME_F_COMPRESSED;
+    c->packed = 0;
+    respbuf_frame_end(&c->out, start, type, flags);
+}
+
+/*
+ * Agrega un evento si el suscriptor está atrasado. Solo se llama con la
+ * salida vacía, así un evento nunca queda en medio de una respuesta y
+ * un cliente lento recibe un único evento con todo lo acumulado.
+ * Retorna 1 si agregó algo.
+ */
+static int conn_push(Conn *c)
+{
+    Reactor *r = c->reactor;
+
+    if (!c->subscribed || !c->push || c->state == CONN_CLOSING || !r->push ||
+        c->sub_gen >= __atomic_load_n(&r->published, __ATOMIC_ACQUIRE))
+        return 0;
+
+    int mark = c->out.nrefs;
+    size_t base = respbuf_total(&c->out);
+    size_t start = c->framed ? respbuf_frame_begin(&c->out) : c->out.len;
+    if (!r->push(c, &c->out)) {
+        respbuf_truncate(&c->out, start, mark);
+        c->packed = 0;
+        return 0;
+    }
+    if (c->framed)
+        conn_frame_end(c, start, base, mark, FRAME_EVENT);
+    return 1;
+}
+
+/* Envía lo que acepte el socket. Retorna -1 si la conexión se cerró. */
+static int conn_flush(Conn *c)
+{
+    for (;;) {
+        size_t total = respbuf_total(&c->out);
+
+        while (c->out_sent < total) {
+            struct iovec iov[FLUSH_IOV];
+            struct msghdr msg = {0};
+
+            msg.msg_iov    = iov;
+            msg.msg_iovlen = (size_t)respbuf_iov(&c->out, c->out_sent, iov, FLUSH_IOV);
+
+            ssize_t n = sendmsg(c->fd, &msg, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EINTR)
+                    continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK)
+                    break;
+                conn_close(c);
+                return -1;
+            }
+            __atomic_fetch_add(&c->reactor->flushes, 1, __ATOMIC_RELAXED);
+            c->out_sent += (size_t)n;
+        }
+
+        /* El cliente leyó: ejecutar los comandos que quedaron frenados */
+        if (c->throttled && c->state == CONN_READING && !conn_backlogged(c)) {
+            c->throttled = 0;
+            conn_process_input(c);
+            conn_check_eof(c);
+            continue;
+        }
+
+        if (c->out_sent < total)
+            break;
+
+        /* Todo enviado: liberar para que una conexión inactiva no ocupe memoria */
+        respbuf_free(&c->out);
+        c->out_sent = 0;
+        if (c->state == CONN_CLOSING) {
+            conn_close(c);
+            return -1;
+        }
+        /* Cambios publicados mientras se enviaba: mandarlos ahora */
+        if (!conn_push(c))
+            break;
+    }
+
+    conn_update_events(c);
+    return 0;
+}
+
+/*
+ * Responde un error de protocolo y cierra la conexión cuando termine de
+ * enviarlo. Lo que quede en la entrada se descarta.
+ */
+static void conn_reject(Conn *c, const char *reason)
+{
+    int mark = c->out.nrefs;
+    size_t base = respbuf_total(&c->out);
+    size_t start = c->framed ? respbuf_frame_begin(&c->out) : c->out.len;
+
+    printf("[TCP] %s de %s\n", reason, c->ip);
+    respbuf_printf(&c->out, "Error: %s.\n", reason);
+    if (c->framed)
+        conn_frame_end(c, start, base, mark, FRAME_RESP);
+    c->state = CONN_CLOSING;
+}
+
+/* El comando en curso supera CMD_MAX_SIZE. */
+static void conn_too_long(Conn *c)
+{
+    char reason[64];
+    snprintf(reason, sizeof(reason), "Comando demasiado largo (maximo %u bytes)", CMD_MAX_SIZE);
+    conn_reject(c, reason);
+}
+
+/*
+ * Extrae y ejecuta los comandos completos del buffer de entrada, en orden.
+ * Las respuestas se acumulan en out y conn_flush las envía juntas, así un
+ * cliente que encadena varios comandos en un envío recibe todas las
+ * respuestas en una sola llamada a sendmsg.
+ */
+static void conn_process_input(Conn *c)
+{
+    Reactor *r = c->reactor;
+
+    while (c->state == CONN_READING) {
+        char *msg;
+        size_t len;
+        FrameHeader hdr;
+
+        if (conn_backlogged(c)) {
+            /* Lo que falta espera en el buffer de entrada (y en el socket) */
+            c->throttled = 1;
+            __atomic_fetch_add(&r->throttles, 1, __ATOMIC_RELAXED);
+            break;
+        }
+
+        if (c->framed) {
+            int res = inbuf_next_frame(&c->in, &hdr, &msg);
+            if (res == -2) {
+                conn_too_long(c);
+                break;
+            }
+            if (res < 0) {
+                printf("[TCP] Frame invalido de %s\n", c->ip);
+                c->state = CONN_CLOSING;
+                break;
+            }
+            if (res == 0)
+                break;
+            /* Cada comando va en un solo frame: uno partido no se ejecuta a pedazos */
+            if (hdr.flags & FRAME_F_MORE) {
+                conn_reject(c, "Comando partido en varios frames (FRAME_F_MORE)");
+                break;
+            }
+            if (hdr.type != FRAME_CMD)
+                continue;
+            msg[strcspn(msg, "\r\n")] = 0;
+        } else if (!inbuf_next_line(&c->in, &msg, &len)) {
+            /* Buffer lleno sin un '\n': la línea no entra */
+            if (inbuf_full(&c->in))
+                conn_too_long(c);
+            break;
+        }
+
+        int mark = c->out.nrefs;
+        size_t base = respbuf_total(&c->out);
+        size_t start = c->framed ? respbuf_frame_begin(&c->out) : c->out.len;
+        int action = r->handler(c, msg, &c->out);
+        __atomic_fetch_add(&r->requests, 1, __ATOMIC_RELAXED);
+
+        if (action == CMD_ASYNC) {
+            /* La respuesta llegará del worker */
+            respbuf_truncate(&c->out, start, mark);
+            c->packed = 0;
+            break;
+        }
+        if (c->framed)
+            conn_frame_end(c, start, base, mark, FRAME_RESP);
+
+        if (action == CMD_FRAMED)
+            c->framed = 1;
+        else if (action == CMD_CLOSE)
+            c->state = CONN_CLOSING;
+    }
+
+    inbuf_release(&c->in);
+}
+
+static void reactor_accept(Reactor *r)
+{
+    for (;;) {
+        struct sockaddr_in addr;
+        socklen_t addr_len = sizeof(addr);
+        int fd = accept4(r->listen_fd, (struct sockaddr *)&addr, &addr_len,
+                         SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                perror("Accept failed");
+            return;
+        }
+
+        Conn *c = calloc(1, sizeof(Conn));
+        if (!c) {
+            close(fd);
+            continue;
+        }
+        c->ev.kind = EV_CONN;
+        c->fd = fd;
+        c->reactor = r;
+        c->state = CONN_READING;
+        c->push = 1;
+        inbuf_init(&c->in);
+        respbuf_init(&c->out);
+        inet_ntop(AF_INET, &addr.sin_addr, c->ip, sizeof(c->ip));
+
+        struct epoll_event ev;
+        ev.events = EPOLLIN | EPOLLRDHUP;
+        ev.data.ptr = c;
+        if (epoll_ctl(r->epfd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+            perror("epoll_ctl");
+            close(fd);
+            conn_free(c);
+            continue;
+        }
+        c->events = ev.events;
+        __atomic_fetch_add(&r->connections, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&r->accepted, 1, __ATOMIC_RELAXED);
+        printf("[TCP] Connection from %s\n", c->ip);
+    }
+}
+
+static void conn_on_event(Conn *c, unsigned int events)
+{
+    if (events & (EPOLLERR | EPOLLHUP)) {
+        conn_close(c);
+        return;
+    }
+
+    if (events & EPOLLIN) {
+        for (int i = 0; i < READS_PER_EVENT; i++) {
+            long n = inbuf_recv(&c->in, c->fd);
+            if (n > 0)
+                continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                break;
+            if (n < 0 && errno == EMSGSIZE)
+                break; /* Buffer lleno: ejecutar lo recibido antes de seguir */
+            if (n < 0 && errno == EINTR)
+                continue;
+            /*
+             * Cierre del cliente (o medio cierre): responder lo ya recibido
+             * y cerrar cuando no quede nada pendiente
+             */
+            c->eof = 1;
+            break;
+        }
+        if (c->state == CONN_READING)
+            conn_process_input(c);
+        conn_check_eof(c);
+    }
+
+    conn_flush(c);
+}
+
+/*
+ * Entrega las respuestas de los trabajos delegados que ya terminaron y
+ * los eventos de una generación publicada.
+ */
+static void reactor_drain_done(Reactor *r)
+{
+    uint64_t value;
+    if (read(r->wake_fd, &value, sizeof(value)) < 0 && errno != EAGAIN)
+        perror("eventfd read");
+
+    pthread_mutex_lock(&r->done_lock);
+    Job *job = r->done_head;
+    r->done_head = r->done_tail = NULL;
+    pthread_mutex_unlock(&r->done_lock);
+
+    while (job) {
+        Job *next = job->next;
+        Conn *c = job->conn;
+
+        if (job->resume)
+            job->resume(c->dead ? NULL : c, job->arg, &job->out);
+
+        if (c->dead) {
+            conn_free(c);
+        } else {
+            int mark = c->out.nrefs;
+            size_t base = respbuf_total(&c->out);
+            size_t start = c->framed ? respbuf_frame_begin(&c->out) : c->out.len;
+            respbuf_move(&c->out, &job->out);
+            if (c->framed)
+                conn_frame_end(c, start, base, mark, FRAME_RESP);
+
+            c->state = CONN_READING;
+            conn_process_input(c); /* Comandos que llegaron mientras tanto */
+            conn_check_eof(c);
+            /*
+             * Si un comando encadenado ya pasó a otro worker, su respuesta
+             * sale junto con esta cuando termine (EPOLLOUT sigue activo si
+             * el socket estaba lleno)
+             */
+            if (c->state != CONN_WAITING)
+                conn_flush(c);
+        }
+
+        respbuf_free(&job->out);
+        free(job);
+        job = next;
+    }
+
+    /* Eventos para los suscriptores que no tienen salida pendiente */
+    for (Conn *c = r->subscribers, *next; c; c = next) {
+        next = c->sub_next;
+        if (respbuf_total(&c->out) == 0 && conn_push(c))
+            conn_flush(c);
+    }
+}
+
+/* Corre en un worker: ejecuta el trabajo y lo devuelve al reactor. */
+static void job_run(void *arg)
+{
+    Job *job = arg;
+    Reactor *r = job->conn->reactor;
+    uint64_t one = 1;
+
+    job->fn(job->arg, &job->out);
+
+    pthread_mutex_lock(&r->done_lock);
+    job->next = NULL;
+    if (r->done_tail)
+        r->done_tail->next = job;
+    else
+        r->done_head = job;
+    r->done_tail = job;
+    pthread_mutex_unlock(&r->done_lock);
+
+    if (write(r->wake_fd, &one, sizeof(one)) < 0)
+        perror("eventfd write");
+}
+
+int reactor_defer_resume(Conn *conn, DeferredFn fn, ResumeFn resume, void *arg,
+                         RespBuf *out)
+{
+    Job *job = calloc(1, sizeof(Job));
+    if (job) {
+        job->conn   = conn;
+        job->fn     = fn;
+        job->resume = resume;
+        job->arg    = arg;
+        respbuf_init(&job->out);
+
+        conn->state = CONN_WAITING;
+        if (workers_submit(job_run, job) == 0)
+            return CMD_ASYNC;
+        conn->state = CONN_READING;
+        free(job);
+    }
+
+    /* No se pudo delegar: todo en línea */
+    fn(arg, out);
+    if (resume)
+        resume(conn, arg, out);
+    return CMD_CONTINUE;
+}
+
+int reactor_defer(Conn *conn, DeferredFn fn, void *arg, RespBuf *out)
+{
+    return reactor_defer_resume(conn, fn, NULL, arg, out);
+}
+
+void reactor_subscribe(Conn *c, unsigned long gen)
+{
+    Reactor *r = c->reactor;
+
+    c->sub_gen = gen;
+    if (c->subscribed)
+        return;
+    c->subscribed = 1;
+    c->sub_prev = NULL;
+    c->sub_next = r->subscribers;
+    if (r->subscribers)
+        r->subscribers->sub_prev = c;
+    r->subscribers = c;
+    __atomic_fetch_add(&r->subscriptions, 1, __ATOMIC_RELAXED);
+}
+
+void reactor_unsubscribe(Conn *c)
+{
+    Reactor *r = c->reactor;
+
+    if (!c->subscribed)
+        return;
+    if (c->sub_prev)
+        c->sub_prev->sub_next = c->sub_next;
+    else
+        r->subscribers = c->sub_next;
+    if (c->sub_next)
+        c->sub_next->sub_prev = c->sub_prev;
+    c->subscribed = 0;
+    c->sub_prev = c->sub_next = NULL;
+    __atomic_fetch_sub(&r->subscriptions, 1, __ATOMIC_RELAXED);
+}
+
+void reactor_publish(Reactor *r, unsigned long gen)
+{
+    uint64_t one = 1;
+
+    __atomic_store_n(&r->published, gen, __ATOMIC_RELEASE);
+    if (write(r->wake_fd, &one, sizeof(one)) < 0)
+        perror("eventfd write");
+}
+
+int reactor_init(Reactor *r, int listen_fd, CommandHandler handler)
+{
+    struct epoll_event ev;
+
+    memset(r, 0, sizeof(*r));
+    r->cpu = -1;
+    r->listen_fd = listen_fd;
+    r->handler = handler;
+    r->listen_ev.kind = EV_LISTEN;
+    r->wake_ev.kind = EV_WAKE;
+    pthread_mutex_init(&r->done_lock, NULL);
+
+    r->epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (r->epfd < 0) {
+        perror("epoll_create1");
+        return -1;
+    }
+
+    r->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (r->wake_fd < 0) {
+        perror("eventfd");
+        return -1;
+    }
+
+    ev.events = EPOLLIN;
+    ev.data.ptr = &r->listen_ev;
+    if (epoll_ctl(r->epfd, EPOLL_CTL_ADD, listen_fd, &ev) < 0) {
+        perror("epoll_ctl listen");
+        return -1;
+    }
+
+    ev.events = EPOLLIN;
+    ev.data.ptr = &r->wake_ev;
+    if (epoll_ctl(r->epfd, EPOLL_CTL_ADD, r->wake_fd, &ev) < 0) {
+        perror("epoll_ctl eventfd");
+        return -1;
+    }
+    return 0;
+}
+
+void reactor_run(Reactor *r)
+{
+    struct epoll_event events[MAX_EVENTS];
+
+    for (;;) {
+        int n = epoll_wait(r->epfd, events, MAX_EVENTS, -1);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue; /* SIGCHLD */
+            perror("epoll_wait");
+            return;
+        }
+
+        for (int i = 0; i < n; i++) {
+            EvSource *src = events[i].data.ptr;
+            switch (src->kind) {
+            case EV_LISTEN:
+                reactor_accept(r);
+                break;
+            case EV_WAKE:
+                reactor_drain_done(r);
+                break;
+            case EV_CONN:
+                conn_on_event((Conn *)src, events[i].events);
+                break;
+            }
+        }
+    }
+}
+
+static void *reactor_thread(void *arg)
+{
+    Reactor *r = arg;
+    reactor_run(r);
+    fprintf(stderr, "[ERROR] Shard %d detenido\n", r->id);
+    return NULL;
+}
+
+int reactor_spawn(Reactor *r, int cpu)
+{
+    if (pthread_create(&r->thread, NULL, reactor_thread, r) != 0) {
+        perror("Could not create reactor thread");
+        return -1;
+    }
+
+    if (cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        if (pthread_setaffinity_np(r->thread, sizeof(set), &set) == 0)
+            r->cpu = cpu;
+        else
+            fprintf(stderr, "[WARN] No se pudo fijar el shard %d a la CPU %d\n",
+                    r->id, cpu);
+    }
+    return 0;
+}
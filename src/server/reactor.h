@@ -0,0 +1,161 @@
+#ifndef REACTOR_H
+#define REACTOR_H
+
+#include <pthread.h>
+#include <arpa/inet.h>
+
+#include "proto.h"
+#include "respbuf.h"
+
+/*
+ * Reactor epoll no bloqueante: un solo hilo atiende accept, lectura,
+ * parseo y escritura de todas las conexiones. El trabajo bloqueante se
+ * delega al pool de workers con reactor_defer().
+ */
+
+/* Tipo de cada objeto registrado en epoll (primer campo de su struct). */
+#define EV_LISTEN  1
+#define EV_CONN    2
+#define EV_WAKE    3
+
+typedef struct {
+    int kind;
+} EvSource;
+
+/*
+ * Salida pendiente (bytes, con los compartidos) a partir de la cual una
+ * conexión deja de ejecutar comandos y de leer el socket hasta que el
+ * cliente lea: las respuestas de un cliente que encadena pedidos sin
+ * leerlas no pasan de este umbral más la respuesta en curso, que se
+ * completa siempre. Solo acota la salida; la entrada tiene su propio
+ * tope (INBUF_MAX, proto.h).
+ */
+#define REACTOR_OUT_HIGH_WATER  (4u << 20)
+
+/* Estados de una conexión */
+#define CONN_READING  0   /* Leyendo y ejecutando comandos */
+#define CONN_WAITING  1   /* Un comando delegado a un worker está en curso */
+#define CONN_CLOSING  2   /* Vaciar la salida pendiente y cerrar */
+
+typedef struct Reactor Reactor;
+
+typedef struct Conn {
+    EvSource ev;            /* Debe ser el primer campo */
+    int fd;
+    Reactor *reactor;
+    char ip[INET_ADDRSTRLEN];
+    int state;
+    int framed;             /* 1 si se negoció el modo FRAMED */
+    int binary;             /* 1 si las tablas van codificadas en binario (wire.h) */
+    size_t compress_min;    /* Umbral de COMPRESS en bytes (0 = sin comprimir) */
+    int packed;             /* Mensaje en curso: 1 ya comprimido, -1 dejarlo en claro */
+    int dead;               /* Socket cerrado con un worker aún en curso */
+    int eof;                /* El cliente ya no enviará más datos */
+    int throttled;          /* Comandos frenados por salida pendiente */
+    unsigned int events;    /* Eventos registrados en epoll */
+    InBuf in;               /* Entrada pendiente de parsear */
+    RespBuf out;            /* Salida pendiente de enviar */
+    size_t out_sent;        /* Bytes de out ya enviados (con los compartidos) */
+    int push;               /* 1 si acepta eventos: sin HELLO, o HELLO con PUSH */
+    int subscribed;         /* 1 si recibe eventos (SUBSCRIBE) */
+    unsigned long sub_gen;  /* Última generación enviada al suscriptor */
+    struct Conn *sub_prev;  /* Lista de suscriptores del reactor */
+    struct Conn *sub_next;
+} Conn;
+
+/* Resultado del manejador de comandos */
+#define CMD_CONTINUE  0
+#define CMD_CLOSE     1
+#define CMD_FRAMED    2   /* Cambiar la conexión a modo enmarcado */
+#define CMD_ASYNC     3   /* La respuesta llegará desde un worker */
+
+/* Ejecuta un comando de texto y escribe la respuesta en out. */
+typedef int (*CommandHandler)(Conn *conn, char *line, RespBuf *out);
+
+/*
+ * Escribe en out los cambios pendientes de un suscriptor (y actualiza
+ * conn->sub_gen). Retorna 1 si escribió un evento, 0 si no había nada.
+ */
+typedef int (*PushHandler)(Conn *conn, RespBuf *out);
+
+/* Trabajo bloqueante: corre en un worker y escribe la respuesta en out. */
+typedef void (*DeferredFn)(void *arg, RespBuf *out);
+
+/*
+ * Continuación de un trabajo delegado: corre en el reactor después de fn,
+ * con la misma salida. conn es NULL si la conexión ya se cerró (solo
+ * queda liberar arg).
+ */
+typedef void (*ResumeFn)(Conn *conn, void *arg, RespBuf *out);
+
+typedef struct Job Job;
+
+struct Reactor {
+    int epfd;
+    EvSource listen_ev;
+    int listen_fd;
+    EvSource wake_ev;
+    int wake_fd;            /* eventfd para completar trabajos delegados */
+    CommandHandler handler;
+    PushHandler push;           /* Genera los eventos de los suscriptores */
+    Conn *subscribers;
+    unsigned long published;    /* Última generación publicada (atómico) */
+    pthread_mutex_t done_lock;
+    Job *done_head;
+    Job *done_tail;
+    int id;                     /* Número de shard */
+    int cpu;                    /* CPU a la que está fijado (-1 = ninguna) */
+    pthread_t thread;
+    /* Contadores, leídos por otros hilos con __atomic_load_n */
+    unsigned long connections;  /* Conexiones abiertas */
+    unsigned long accepted;     /* Conexiones aceptadas en total */
+    unsigned long requests;     /* Comandos ejecutados */
+    unsigned long flushes;      /* Llamadas a sendmsg (varias respuestas por llamada) */
+    unsigned long subscriptions; /* Suscriptores activos */
+    unsigned long throttles;    /* Veces que una conexión frenó por salida pendiente */
+};
+
+/* Prepara el reactor sobre un socket de escucha ya enlazado. */
+int reactor_init(Reactor *r, int listen_fd, CommandHandler handler);
+
+/* Ejecuta el bucle de eventos. Solo retorna en error fatal. */
+void reactor_run(Reactor *r);
+
+/*
+ * Lanza el bucle de eventos en un hilo propio, fijado a `cpu` si es >= 0.
+ * Retorna 0 si OK, -1 en error.
+ */
+int reactor_spawn(Reactor *r, int cpu);
+
+/*
+ * Delega fn(arg) a un worker. La conexión deja de leer comandos hasta
+ * que llega la respuesta, para conservar el orden. Retorna CMD_ASYNC
+ * (o CMD_CONTINUE si no se pudo delegar y fn ya corrió en línea).
+ */
+int reactor_defer(Conn *conn, DeferredFn fn, void *arg, RespBuf *out);
+
+/*
+ * Como reactor_defer, pero al terminar fn corre resume(conn, arg, out) en
+ * el hilo del reactor, donde se puede tocar la conexión (por ejemplo,
+ * repetir el comando con lo que preparó el worker).
+ */
+int reactor_defer_resume(Conn *conn, DeferredFn fn, ResumeFn resume, void *arg,
+                         RespBuf *out);
+
+/*
+ * Suscribe la conexión a los eventos, a partir de la generación `gen`
+ * que ya recibió. Se llama desde el manejador de comandos.
+ */
+void reactor_subscribe(Conn *conn, unsigned long gen);
+
+/* Cancela la suscripción (no hace nada si no estaba suscrita). */
+void reactor_unsubscribe(Conn *conn);
+
+/*
+ * Avisa al reactor que hay una generación nueva. Se puede llamar desde
+ * cualquier hilo. Cada suscriptor recibe un evento cuando termina de
+ * enviar lo pendiente: si es lento, los cambios se acumulan en uno solo.
+ */
+void reactor_publish(Reactor *r, unsigned long gen);
+
+#endif /* REACTOR_H */
@@ -0,0 +1,245 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+
+#include "respbuf.h"
+#include "proto.h"
+
+void respbuf_init(RespBuf *rb)
+{
+    rb->data  = NULL;
+    rb->len   = 0;
+    rb->cap   = 0;
+    rb->error = 0;
+    rb->refs  = NULL;
+    rb->nrefs = 0;
+    rb->ref_cap = 0;
+    rb->ref_len = 0;
+}
+
+static void release_refs(RespBuf *rb, int from)
+{
+    for (int i = from; i < rb->nrefs; i++) {
+        rb->ref_len -= rb->refs[i].len;
+        if (rb->refs[i].release)
+            rb->refs[i].release(rb->refs[i].owner);
+    }
+    if (rb->nrefs > from)
+        rb->nrefs = from;
+}
+
+/* Asegura espacio para `extra` bytes más (y el '\0' final). */
+static int respbuf_reserve(RespBuf *rb, size_t extra)
+{
+    size_t need = rb->len + extra + 1;
+    if (need <= rb->cap)
+        return 0;
+
+    size_t new_cap = rb->cap ? rb->cap * 2 : RESPBUF_CHUNK;
+    while (new_cap < need)
+        new_cap += RESPBUF_CHUNK;
+
+    char *tmp = realloc(rb->data, new_cap);
+    if (!tmp) {
+        rb->error = 1;
+        return -1;
+    }
+    rb->data = tmp;
+    rb->cap  = new_cap;
+    return 0;
+}
+
+int respbuf_append(RespBuf *rb, const char *data, size_t len)
+{
+    if (rb->error || respbuf_reserve(rb, len) != 0)
+        return -1;
+    memcpy(rb->data + rb->len, data, len);
+    rb->len += len;
+    rb->data[rb->len] = '\0';
+    return 0;
+}
+
+int respbuf_puts(RespBuf *rb, const char *str)
+{
+    return respbuf_append(rb, str, strlen(str));
+}
+
+int respbuf_printf(RespBuf *rb, const char *fmt, ...)
+{
+    va_list ap;
+    int n;
+
+    if (rb->error || respbuf_reserve(rb, 128) != 0)
+        return -1;
+
+    va_start(ap, fmt);
+    n = vsnprintf(rb->data + rb->len, rb->cap - rb->len, fmt, ap);
+    va_end(ap);
+    if (n < 0) {
+        rb->error = 1;
+        return -1;
+    }
+
+    if ((size_t)n >= rb->cap - rb->len) {
+        /* No cupo: crecer una vez y formatear de nuevo */
+        if (respbuf_reserve(rb, (size_t)n) != 0)
+            return -1;
+        va_start(ap, fmt);
+        vsnprintf(rb->data + rb->len, rb->cap - rb->len, fmt, ap);
+        va_end(ap);
+    }
+    rb->len += (size_t)n;
+    return 0;
+}
+
+/* Asegura espacio para `extra` referencias más. */
+static int respbuf_reserve_refs(RespBuf *rb, int extra)
+{
+    if (rb->nrefs + extra <= rb->ref_cap)
+        return 0;
+
+    int new_cap = rb->ref_cap ? rb->ref_cap * 2 : 4;
+    while (new_cap < rb->nrefs + extra)
+        new_cap *= 2;
+
+    RespRef *tmp = realloc(rb->refs, (size_t)new_cap * sizeof(RespRef));
+    if (!tmp)
+        return -1;
+    rb->refs    = tmp;
+    rb->ref_cap = new_cap;
+    return 0;
+}
+
+int respbuf_attach(RespBuf *rb, const char *data, size_t len,
+                   RespRelease release, void *owner)
+{
+    if (rb->error || respbuf_reserve_refs(rb, 1) != 0) {
+        /* Sin memoria para la referencia: copiar y soltarla ya */
+        int res = respbuf_append(rb, data, len);
+        if (release)
+            release(owner);
+        return res;
+    }
+
+    RespRef *ref = &rb->refs[rb->nrefs++];
+    ref->at      = rb->len;
+    ref->data    = data;
+    ref->len     = len;
+    ref->release = release;
+    ref->owner   = owner;
+    rb->ref_len += len;
+    return 0;
+}
+
+size_t respbuf_total(const RespBuf *rb)
+{
+    return rb->len + rb->ref_len;
+}
+
+/* Agrega un segmento a iov saltando lo que ya se envió. */
+static int add_segment(struct iovec *iov, int n, const char *data, size_t len,
+                       size_t *skip)
+{
+    if (*skip >= len) {
+        *skip -= len;
+        return n;
+    }
+    iov[n].iov_base = (void *)(data + *skip);
+    iov[n].iov_len  = len - *skip;
+    *skip = 0;
+    return n + 1;
+}
+
+int respbuf_iov(const RespBuf *rb, size_t offset, struct iovec *iov, int max)
+{
+    size_t pos = 0, skip = offset;
+    int n = 0;
+
+    for (int i = 0; i < rb->nrefs && n < max; i++) {
+        const RespRef *ref = &rb->refs[i];
+        if (ref->at > pos) {
+            n = add_segment(iov, n, rb->data + pos, ref->at - pos, &skip);
+            pos = ref->at;
+            if (n == max)
+                break;
+        }
+        if (ref->len > 0)
+            n = add_segment(iov, n, ref->data, ref->len, &skip);
+    }
+    if (n < max && rb->len > pos)
+        n = add_segment(iov, n, rb->data + pos, rb->len - pos, &skip);
+    return n;
+}
+
+int respbuf_move(RespBuf *dst, RespBuf *src)
+{
+    size_t base = dst->len;
+
+    if (respbuf_reserve_refs(dst, src->nrefs) != 0 ||
+        respbuf_append(dst, src->data ? src->data : "", src->len) != 0) {
+        respbuf_reset(src);
+        return -1;
+    }
+
+    for (int i = 0; i < src->nrefs; i++) {
+        dst->refs[dst->nrefs] = src->refs[i];
+        dst->refs[dst->nrefs].at += base;
+        dst->nrefs++;
+    }
+    dst->ref_len += src->ref_len;
+
+    /* Las referencias ahora son de dst */
+    src->nrefs   = 0;
+    src->ref_len = 0;
+    respbuf_reset(src);
+    return 0;
+}
+
+void respbuf_truncate(RespBuf *rb, size_t len, int nrefs)
+{
+    release_refs(rb, nrefs);
+    if (len < rb->len) {
+        rb->len = len;
+        if (rb->data)
+            rb->data[len] = '\0';
+    }
+}
+
+size_t respbuf_frame_begin(RespBuf *rb)
+{
+    static const char zero_header[FRAME_HEADER_SIZE];
+    size_t start = rb->len;
+    respbuf_append(rb, zero_header, sizeof(zero_header));
+    return start;
+}
+
+void respbuf_frame_end(RespBuf *rb, size_t start, int type, int flags)
+{
+    if (rb->error || rb->len < start + FRAME_HEADER_SIZE)
+        return;
+    size_t payload = rb->len - start - FRAME_HEADER_SIZE;
+
+    /* Los bytes compartidos intercalados después de la cabecera */
+    for (int i = rb->nrefs - 1; i >= 0 && rb->refs[i].at >= start + FRAME_HEADER_SIZE; i--)
+        payload += rb->refs[i].len;
+    frame_header_encode((unsigned char *)rb->data + start, (uint32_t)payload,
+                        (uint8_t)type, (uint8_t)flags);
+}
+
+void respbuf_reset(RespBuf *rb)
+{
+    release_refs(rb, 0);
+    rb->len = 0;
+    rb->error = 0;
+    if (rb->data)
+        rb->data[0] = '\0';
+}
+
+void respbuf_free(RespBuf *rb)
+{
+    release_refs(rb, 0);
+    free(rb->data);
+    free(rb->refs);
+    respbuf_init(rb);
+}
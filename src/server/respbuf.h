@@ -0,0 +1,98 @@
+#ifndef RESPBUF_H
+#define RESPBUF_H
+
+#include <stddef.h>
+#include <sys/uio.h>
+
+#define RESPBUF_CHUNK       16384   /* Crecimiento mínimo del buffer */
+
+/* Libera la referencia que una respuesta tenía sobre bytes compartidos. */
+typedef void (*RespRelease)(void *owner);
+
+/*
+ * Bytes ajenos intercalados en la respuesta sin copiarlos: van justo
+ * antes de data[at]. El dueño se libera cuando la respuesta se descarta.
+ */
+typedef struct {
+    size_t at;
+    const char *data;
+    size_t len;
+    RespRelease release;
+    void *owner;
+} RespRef;
+
+/*
+ * Constructor de respuestas: buffer que lleva su offset de escritura,
+ * crece por bloques y nunca vuelve a recorrer lo ya escrito. El reactor
+ * lo usa como cola de salida de cada conexión.
+ */
+typedef struct {
+    char *data;
+    size_t len;
+    size_t cap;
+    int error;      /* 1 si falló malloc */
+    RespRef *refs;  /* Bytes compartidos, en orden de posición */
+    int nrefs;
+    int ref_cap;
+    size_t ref_len; /* Total de bytes compartidos */
+} RespBuf;
+
+/* Inicializa un buffer vacío (no reserva memoria). */
+void respbuf_init(RespBuf *rb);
+
+/* Agrega len bytes. Retorna 0 si OK, -1 en error. */
+int respbuf_append(RespBuf *rb, const char *data, size_t len);
+
+/* Agrega una cadena terminada en '\0'. */
+int respbuf_puts(RespBuf *rb, const char *str);
+
+/* Agrega texto con formato printf. */
+int respbuf_printf(RespBuf *rb, const char *fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+
+/*
+ * Intercala len bytes compartidos en la posición actual sin copiarlos.
+ * Toma la referencia del llamador: release(owner) se llama cuando la
+ * respuesta se descarta (o enseguida, si hubo que copiar por falta de
+ * memoria). Retorna 0 si OK, -1 en error.
+ */
+int respbuf_attach(RespBuf *rb, const char *data, size_t len,
+                   RespRelease release, void *owner);
+
+/* Tamaño total de la respuesta, incluyendo los bytes compartidos. */
+size_t respbuf_total(const RespBuf *rb);
+
+/*
+ * Llena iov con los segmentos de la respuesta a partir del byte `offset`
+ * (contando los compartidos). Retorna cuántos usó, hasta max.
+ */
+int respbuf_iov(const RespBuf *rb, size_t offset, struct iovec *iov, int max);
+
+/*
+ * Mueve el contenido de src (con sus referencias) al final de dst y
+ * deja src vacío. Retorna 0 si OK, -1 en error.
+ */
+int respbuf_move(RespBuf *dst, RespBuf *src);
+
+/*
+ * Descarta lo escrito desde el byte `len` de data y las referencias
+ * desde la número `nrefs` (valores tomados antes de escribir).
+ */
+void respbuf_truncate(RespBuf *rb, size_t len, int nrefs);
+
+/*
+ * Abre un mensaje enmarcado: reserva espacio para la cabecera (ver
+ * proto.h) y retorna su offset, que se pasa a respbuf_frame_end.
+ */
+size_t respbuf_frame_begin(RespBuf *rb);
+
+/* Cierra el mensaje abierto en `start` escribiendo su cabecera. */
+void respbuf_frame_end(RespBuf *rb, size_t start, int type, int flags);
+
+/* Descarta el contenido (y las referencias) sin liberar la memoria. */
+void respbuf_reset(RespBuf *rb);
+
+/* Libera la memoria y las referencias. */
+void respbuf_free(RespBuf *rb);
+
+#endif /* RESPBUF_H */
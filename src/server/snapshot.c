@@ -0,0 +1,561 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "snapshot.h"
+#include "respbuf.h"
+#include "procevents.h"
+#include "wire.h"
+#include "compress.h"
+
+static pthread_mutex_t snap_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t snap_ready = PTHREAD_COND_INITIALIZER;
+
+static Snapshot *current;           /* Última instantánea (la caché tiene una referencia) */
+static Snapshot *history[SNAPSHOT_HISTORY]; /* Generaciones anteriores, de la más vieja a la más nueva */
+static int history_count;
+static size_t history_bytes;
+static int refreshing;              /* Hay un escaneo en curso */
+static unsigned long flights;       /* Escaneos terminados */
+static unsigned long generation;
+static unsigned long invalidations; /* Llamadas a snapshot_invalidate */
+static int ttl_ms = SNAPSHOT_DEFAULT_TTL_MS;
+static unsigned long hits, misses, coalesced;
+
+/* Solo lo usa el hilo que hace el escaneo en curso */
+static ProcScanner scanner;
+static int scanner_ready;
+
+static long long now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static void snapshot_free(Snapshot *snap)
+{
+    proctable_free(&snap->table);
+    free(snap->text);
+    free(snap->long_text);
+    free(snap->bin);
+    for (int i = 0; i < SNAPSHOT_PACKED; i++)
+        free(snap->packed[i].data);
+    for (int i = 0; i < SNAPSHOT_DELTA_CACHE; i++) {
+        free(snap->deltas[i].text);
+        free(snap->deltas[i].packed.data);
+    }
+    free(snap);
+}
+
+/* Memoria de una instantánea: la tabla y las respuestas guardadas. Requiere el lock. */
+static size_t snapshot_bytes(const Snapshot *snap)
+{
+    size_t bytes = sizeof(*snap) + (size_t)snap->table.capacity * sizeof(ProcInfo) +
+                   snap->text_len + snap->long_len + snap->bin_len;
+
+    for (int i = 0; i < SNAPSHOT_PACKED; i++)
+        bytes += snap->packed[i].len;
+    for (int i = 0; i < snap->next_delta; i++)
+        bytes += snap->deltas[i].len + snap->deltas[i].packed.len;
+    return bytes;
+}
+
+/*
+ * Pasa prev a la historia y deja en evicted las que salen: las más viejas,
+ * hasta que queden SNAPSHOT_HISTORY y entren en SNAPSHOT_HISTORY_BYTES.
+ * Con 50000 procesos cada generación pesa varios MB, así que se guardan
+ * menos; la más reciente se queda siempre, es la de los deltas de cada
+ * refresco. Retorna cuántas salieron. Requiere el lock.
+ */
+static int history_push(Snapshot *prev, Snapshot **evicted)
+{
+    int out = 0;
+
+    if (history_count == SNAPSHOT_HISTORY)
+        evicted[out++] = history[0];
+    else
+        history_count++;
+    memmove(history, history + out, (size_t)(history_count - 1) * sizeof(*history));
+    history[history_count - 1] = prev;
+
+    history_bytes = 0;
+    for (int i = 0; i < history_count; i++)
+        history_bytes += snapshot_bytes(history[i]);
+    int drop = 0;
+    while (history_count - drop > 1 && history_bytes > SNAPSHOT_HISTORY_BYTES) {
+        history_bytes -= snapshot_bytes(history[drop]);
+        evicted[out++] = history[drop++];
+    }
+    history_count -= drop;
+    memmove(history, history + drop, (size_t)history_count * sizeof(*history));
+    return out;
+}
+
+/* Compara PID y nombre de dos tablas (lo que ve el cliente). */
+static int same_table(const ProcTable *a, const ProcTable *b)
+{
+    if (a->count != b->count)
+        return 0;
+    for (int i = 0; i < a->count; i++) {
+        if (a->entries[i].pid != b->entries[i].pid ||
+            strcmp(a->entries[i].comm, b->entries[i].comm) != 0)
+            return 0;
+    }
+    return 1;
+}
+
+/*
+ * Escanea /proc y formatea la respuesta. Con eventos del kernel las
+ * métricas se leen solo si se piden. Corre fuera del lock.
+ */
+static Snapshot *snapshot_build(int metrics)
+{
+    if (!scanner_ready) {
+        if (procscan_init(&scanner) != 0)
+            return NULL;
+        scanner_ready = 1;
+    }
+
+    Snapshot *snap = calloc(1, sizeof(Snapshot));
+    if (!snap)
+        return NULL;
+
+    /* Con eventos del kernel la tabla ya está en memoria: solo copiarla */
+    int res;
+    if (procevents_active()) {
+        res = procevents_copy(&snap->table, &snap->source_version);
+        if (res >= 0 && metrics)
+            res = procscan_sample(&scanner, &snap->table);
+        snap->has_metrics = metrics;
+    } else {
+        res = procscan_read(&scanner, &snap->table);
+        snap->has_metrics = 1;
+    }
+
+    RespBuf text, long_text;
+    respbuf_init(&text);
+    respbuf_init(&long_text);
+    if (res < 0 ||
+        procscan_format_ps(&snap->table, scanner.pid_width, &text) != 0 ||
+        (snap->has_metrics &&
+         procscan_format_long(&snap->table, scanner.pid_width, &long_text) != 0)) {
+        respbuf_free(&text);
+        respbuf_free(&long_text);
+        snapshot_free(snap);
+        return NULL;
+    }
+
+    snap->refs       = 1;
+    snap->pid_width  = scanner.pid_width;
+    snap->text       = text.data;
+    snap->text_len   = text.len;
+    snap->long_text  = long_text.data;
+    snap->long_len   = long_text.len;
+    snap->taken_ms   = now_ms();
+    snap->metrics_ms = snap->taken_ms;
+    return snap;
+}
+
+/*
+ * Con eventos la instantánea vale mientras la tabla no cambie; si no,
+ * durante el TTL. Las métricas valen siempre un TTL. Requiere el lock.
+ */
+static int is_fresh(const Snapshot *snap, int metrics)
+{
+    if (metrics && (!snap->has_metrics || now_ms() - snap->metrics_ms >= ttl_ms))
+        return 0;
+    if (procevents_active())
+        return snap->source_version == procevents_version();
+    return now_ms() - snap->taken_ms < ttl_ms;
+}
+
+void snapshot_set_ttl(int ttl)
+{
+    pthread_mutex_lock(&snap_lock);
+    ttl_ms = ttl < 0 ? 0 : ttl;
+    pthread_mutex_unlock(&snap_lock);
+}
+
+/*
+ * Estado por hilo para los reactores: sin bloqueo, un acquire que tendría
+ * que escanear o esperar retorna NULL y lo anota en missed (1, o 2 si
+ * pedía métricas); pinned es la instantánea que preparó un worker para
+ * repetir el comando.
+ */
+static __thread int nonblocking;
+static __thread int missed;
+static __thread Snapshot *pinned;
+
+void snapshot_set_nonblocking(int on)
+{
+    nonblocking = on;
+    missed = 0;
+}
+
+int snapshot_missed(void)
+{
+    return missed;
+}
+
+void snapshot_pin(Snapshot *snap)
+{
+    pinned = snap;
+}
+
+static Snapshot *acquire(int metrics)
+{
+    Snapshot *snap;
+
+    if (pinned && (!metrics || pinned->has_metrics)) {
+        __atomic_add_fetch(&pinned->refs, 1, __ATOMIC_RELAXED);
+        return pinned;
+    }
+
+    pthread_mutex_lock(&snap_lock);
+
+    if (current && is_fresh(current, metrics)) {
+        hits++;
+        snap = current;
+        __atomic_add_fetch(&snap->refs, 1, __ATOMIC_RELAXED);
+        pthread_mutex_unlock(&snap_lock);
+        return snap;
+    }
+
+    if (nonblocking) {
+        /* Escanear (o esperar al que escanea) le toca a un worker */
+        if (missed < 1 + metrics)
+            missed = 1 + metrics;
+        pthread_mutex_unlock(&snap_lock);
+        return NULL;
+    }
+
+    while (refreshing) {
+        /* Esperar el escaneo en curso y usar su resultado */
+        unsigned long flight = flights;
+        coalesced++;
+        while (refreshing && flights == flight)
+            pthread_cond_wait(&snap_ready, &snap_lock);
+        snap = current;
+        /* Un escaneo sin métricas no sirve a quien las pidió */
+        if (snap && metrics && !snap->has_metrics)
+            continue;
+        if (snap)
+            __atomic_add_fetch(&snap->refs, 1, __ATOMIC_RELAXED);
+        pthread_mutex_unlock(&snap_lock);
+        return snap;
+    }
+
+    misses++;
+    refreshing = 1;
+    unsigned long seen = invalidations;
+    pthread_mutex_unlock(&snap_lock);
+
+    Snapshot *fresh = snapshot_build(metrics);
+
+    pthread_mutex_lock(&snap_lock);
+    Snapshot *old = NULL;
+    Snapshot *evicted[SNAPSHOT_HISTORY];
+    int nevicted = 0;
+    if (fresh && current && fresh->has_metrics &&
+        same_table(&fresh->table, &current->table)) {
+        /* Mismos procesos con métricas nuevas: reemplazarla sin cambiar la generación */
+        fresh->generation = current->generation;
+        old = current;
+        current = fresh;
+    } else if (fresh && current && same_table(&fresh->table, &current->table)) {
+        /* Nada cambió: renovar la actual y conservar su generación */
+        current->taken_ms = fresh->taken_ms;
+        current->source_version = fresh->source_version;
+        old = fresh;
+        fresh = current;
+    } else if (fresh) {
+        fresh->generation = ++generation;
+        /* La anterior pasa a la historia; salen las más viejas */
+        if (current)
+            nevicted = history_push(current, evicted);
+        current = fresh;
+    }
+    if (fresh) {
+        if (invalidations != seen)
+            fresh->taken_ms -= ttl_ms;  /* Pudo no ver el último cambio */
+        __atomic_add_fetch(&fresh->refs, 1, __ATOMIC_RELAXED);
+    }
+    refreshing = 0;
+    flights++;
+    pthread_cond_broadcast(&snap_ready);
+    pthread_mutex_unlock(&snap_lock);
+
+    if (old)
+        snapshot_release(old);
+    for (int i = 0; i < nevicted; i++)
+        snapshot_release(evicted[i]);
+    return fresh;
+}
+
+Snapshot *snapshot_acquire(void)
+{
+    return acquire(0);
+}
+
+Snapshot *snapshot_acquire_metrics(void)
+{
+    return acquire(1);
+}
+
+void snapshot_release(Snapshot *snap)
+{
+    if (snap && __atomic_sub_fetch(&snap->refs, 1, __ATOMIC_ACQ_REL) == 0)
+        snapshot_free(snap);
+}
+
+static void release_ref(void *owner)
+{
+    snapshot_release(owner);
+}
+
+/*
+ * Agrega prefix y data comprimidos, con la variante guardada en *pk (se
+ * comprime la primera vez). La compresión corre fuera de snap_lock, así
+ * no frena al resto de la caché; si dos hilos comprimen a la vez queda
+ * el primero que publica. Retorna 1 si los agregó (la referencia pasa a
+ * la respuesta), 0 si no llegan al umbral o no se achican.
+ */
+static int attach_packed(Snapshot *snap, SnapshotPacked *pk, const char *prefix,
+                         const char *data, size_t len, RespBuf *out, size_t pack_min)
+{
+    size_t plen = prefix ? strlen(prefix) : 0;
+
+    if (pack_min == 0 || plen + len < pack_min)
+        return 0;
+
+    pthread_mutex_lock(&snap_lock);
+    int tried = pk->tried;
+    pthread_mutex_unlock(&snap_lock);
+
+    if (!tried) {
+        struct iovec iov[2] = {
+            { .iov_base = (char *)prefix, .iov_len = plen },
+            { .iov_base = (char *)data,   .iov_len = len  },
+        };
+        char *packed = NULL;
+        size_t packed_len = 0;
+        if (compress_message(plen ? iov : iov + 1, plen ? 2 : 1, &packed, &packed_len) != 0)
+            packed = NULL;
+
+        pthread_mutex_lock(&snap_lock);
+        if (!pk->tried) {
+            pk->tried = 1;
+            pk->data = packed;
+            pk->len = packed_len;
+            packed = NULL;
+        }
+        pthread_mutex_unlock(&snap_lock);
+        free(packed);   /* Otro hilo publicó antes */
+    }
+
+    if (pk->data == NULL)
+        return 0;
+    compress_note_sent(plen + len, pk->len);
+    respbuf_attach(out, pk->data, pk->len, release_ref, snap);
+    return 1;
+}
+
+int snapshot_attach(Snapshot *snap, RespBuf *out, size_t pack_min)
+{
+    if (attach_packed(snap, &snap->packed[SNAPSHOT_PACK_LIST], NULL,
+                      snap->text, snap->text_len, out, pack_min))
+        return 1;
+    respbuf_attach(out, snap->text, snap->text_len, release_ref, snap);
+    return 0;
+}
+
+int snapshot_attach_long(Snapshot *snap, RespBuf *out, size_t pack_min)
+{
+    char head[32];
+
+    snprintf(head, sizeof(head), "FULL %lu\n", snap->generation);
+    if (attach_packed(snap, &snap->packed[SNAPSHOT_PACK_LONG], head,
+                      snap->long_text, snap->long_len, out, pack_min))
+        return 1;
+    respbuf_puts(out, head);
+    respbuf_attach(out, snap->long_text, snap->long_len, release_ref, snap);
+    return 0;
+}
+
+int snapshot_attach_binary(Snapshot *snap, RespBuf *out, size_t pack_min)
+{
+    /* La instantánea no cambia: el lock solo evita codificarla dos veces */
+    pthread_mutex_lock(&snap_lock);
+    int res = 0;
+    if (snap->bin == NULL)
+        res = wire_encode_table(&snap->table, snap->generation, snap->has_metrics,
+                                &snap->bin, &snap->bin_len);
+    pthread_mutex_unlock(&snap_lock);
+
+    if (res != 0)
+        return -1;
+    if (attach_packed(snap, &snap->packed[SNAPSHOT_PACK_BIN], NULL,
+                      snap->bin, snap->bin_len, out, pack_min))
+        return 1;
+    respbuf_attach(out, snap->bin, snap->bin_len, release_ref, snap);
+    return 0;
+}
+
+/* Busca una generación en la historia. Requiere el lock. */
+static Snapshot *find_generation(unsigned long gen)
+{
+    for (int i = 0; i < history_count; i++) {
+        if (history[i]->generation == gen)
+            return history[i];
+    }
+    return NULL;
+}
+
+Snapshot *snapshot_acquire_generation(unsigned long gen, int metrics)
+{
+    pthread_mutex_lock(&snap_lock);
+    Snapshot *snap = current && current->generation == gen ? current : find_generation(gen);
+    if (snap && metrics && !snap->has_metrics)
+        snap = NULL;
+    if (snap)
+        __atomic_add_fetch(&snap->refs, 1, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&snap_lock);
+    return snap;
+}
+
+/* Recorre ambas tablas ordenadas por PID y escribe los cambios. */
+static int format_delta(const ProcTable *from, const ProcTable *to, RespBuf *out)
+{
+    int i = 0, j = 0;
+
+    while (i < from->count || j < to->count) {
+        const ProcInfo *a = i < from->count ? &from->entries[i] : NULL;
+        const ProcInfo *b = j < to->count ? &to->entries[j] : NULL;
+        int res = 0;
+
+        if (b == NULL || (a && a->pid < b->pid)) {
+            res = respbuf_printf(out, "- %d\n", a->pid);
+            i++;
+        } else if (a == NULL || b->pid < a->pid) {
+            res = respbuf_printf(out, "+ %d %s\n", b->pid, b->comm);
+            j++;
+        } else {
+            if (strcmp(a->comm, b->comm) != 0)
+                res = respbuf_printf(out, "~ %d %s\n", b->pid, b->comm);
+            i++;
+            j++;
+        }
+        if (res != 0)
+            return -1;
+    }
+    return 0;
+}
+
+/*
+ * Busca (o formatea y guarda) el delta desde `since`. Los deltas
+ * guardados viven lo mismo que la instantánea, porque las respuestas en
+ * vuelo los referencian. Retorna 1 si está en *delta, 0 si la caché de
+ * deltas está llena (hay que formatearlo aparte), -1 si `since` ya no
+ * está en la historia. Requiere el lock.
+ */
+static int get_delta(Snapshot *snap, unsigned long since, SnapshotDelta **delta)
+{
+    for (int i = 0; i < snap->next_delta; i++) {
+        if (snap->deltas[i].from == since) {
+            *delta = &snap->deltas[i];
+            return 1;
+        }
+    }
+
+    Snapshot *base = find_generation(since);
+    if (base == NULL)
+        return -1;
+    if (snap->next_delta == SNAPSHOT_DELTA_CACHE)
+        return 0;
+
+    RespBuf text;
+    respbuf_init(&text);
+    if (format_delta(&base->table, &snap->table, &text) != 0 ||
+        (text.data == NULL && respbuf_append(&text, "", 0) != 0)) {
+        respbuf_free(&text);
+        return -1;
+    }
+
+    SnapshotDelta *d = &snap->deltas[snap->next_delta++];
+    d->from = since;
+    d->text = text.data;
+    d->len  = text.len;
+    *delta = d;
+    return 1;
+}
+
+int snapshot_attach_since(Snapshot *snap, unsigned long since, RespBuf *out,
+                          size_t pack_min)
+{
+    SnapshotDelta *delta = NULL;
+    int found = -1;
+    char head[64];
+
+    if (since == snap->generation) {
+        respbuf_printf(out, "DELTA %lu %lu\n", since, snap->generation);
+        snapshot_release(snap);
+        return 0;
+    }
+
+    pthread_mutex_lock(&snap_lock);
+    if (since != 0 && since < snap->generation)
+        found = get_delta(snap, since, &delta);
+    if (found == 0) {
+        /* Sin lugar en la caché de deltas: formatearlo en la respuesta */
+        respbuf_printf(out, "DELTA %lu %lu\n", since, snap->generation);
+        format_delta(&find_generation(since)->table, &snap->table, out);
+    }
+    pthread_mutex_unlock(&snap_lock);
+
+    if (found == 0) {
+        snapshot_release(snap);
+        return 0;
+    }
+    if (found == 1 && delta->len < snap->text_len) {
+        snprintf(head, sizeof(head), "DELTA %lu %lu\n", since, snap->generation);
+        if (attach_packed(snap, &delta->packed, head, delta->text, delta->len, out, pack_min))
+            return 1;
+        respbuf_puts(out, head);
+        respbuf_attach(out, delta->text, delta->len, release_ref, snap);
+        return 0;
+    }
+
+    snprintf(head, sizeof(head), "FULL %lu\n", snap->generation);
+    if (attach_packed(snap, &snap->packed[SNAPSHOT_PACK_FULL], head,
+                      snap->text, snap->text_len, out, pack_min))
+        return 1;
+    respbuf_puts(out, head);
+    respbuf_attach(out, snap->text, snap->text_len, release_ref, snap);
+    return 0;
+}
+
+void snapshot_invalidate(void)
+{
+    pthread_mutex_lock(&snap_lock);
+    invalidations++;
+    if (current) {
+        current->taken_ms = now_ms() - ttl_ms;
+        current->metrics_ms = current->taken_ms;
+    }
+    pthread_mutex_unlock(&snap_lock);
+}
+
+void snapshot_stats(SnapshotStats *stats)
+{
+    pthread_mutex_lock(&snap_lock);
+    stats->hits      = hits;
+    stats->misses    = misses;
+    stats->coalesced = coalesced;
+    stats->ttl_ms    = ttl_ms;
+    stats->history   = history_count;
+    stats->history_bytes = history_bytes;
+    pthread_mutex_unlock(&snap_lock);
+}
@@ -0,0 +1,172 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stddef.h>
+
+#include "procscan.h"
+#include "respbuf.h"
+
+/*
+ * Caché de la tabla de procesos compartida por todos los reactores.
+ * Si la tabla la mantienen los eventos del kernel (procevents.h) se
+ * copia de ahí cuando cambia; si no, se escanea /proc como mucho una vez
+ * por TTL. Si varios LIST llegan
+ * mientras un escaneo está en curso esperan ese mismo resultado
+ * (single-flight) en vez de lanzar el suyo. La respuesta ya formateada
+ * se comparte por referencia: cada cliente envía los mismos bytes.
+ */
+
+#define SNAPSHOT_DEFAULT_TTL_MS 1000
+#define SNAPSHOT_HISTORY        32  /* Generaciones anteriores disponibles para deltas */
+#define SNAPSHOT_HISTORY_BYTES  (32u << 20) /* Tope de memoria de esa historia */
+#define SNAPSHOT_DELTA_CACHE    8   /* Deltas ya formateados por instantánea */
+
+/* Respuestas compartidas que se guardan comprimidas (COMPRESS, compress.h) */
+#define SNAPSHOT_PACK_LIST  0   /* LIST */
+#define SNAPSHOT_PACK_FULL  1   /* "FULL <gen>" y LIST (LIST SINCE sin delta) */
+#define SNAPSHOT_PACK_LONG  2   /* LIST LONG */
+#define SNAPSHOT_PACK_BIN   3   /* Tabla en binario */
+#define SNAPSHOT_PACKED     4
+
+/*
+ * Una respuesta comprimida, al primer pedido. Se comprime sin lock y se
+ * publica con el lock de la caché; una vez marcada tried ya no cambia.
+ */
+typedef struct {
+    int tried;                  /* Ya se intentó (data NULL: no se achicaba) */
+    char *data;
+    size_t len;
+} SnapshotPacked;
+
+/* Delta formateado desde una generación anterior hasta esta. */
+typedef struct {
+    unsigned long from;
+    char *text;
+    size_t len;
+    SnapshotPacked packed;      /* "DELTA <from> <gen>" y el delta, comprimidos */
+} SnapshotDelta;
+
+typedef struct {
+    int refs;                   /* Referencias (atómico) */
+    unsigned long generation;   /* Cambia solo cuando cambia la tabla */
+    long long taken_ms;         /* Momento del escaneo (CLOCK_MONOTONIC) */
+    unsigned long source_version; /* Versión de la tabla de eventos copiada */
+    ProcTable table;            /* Procesos, ordenados por PID */
+    int pid_width;              /* Ancho de la columna PID en las respuestas */
+    char *text;                 /* Respuesta de LIST formateada como ps */
+    size_t text_len;
+    int has_metrics;            /* La tabla trae %CPU, RSS, etc. al día */
+    long long metrics_ms;       /* Momento de esas métricas (CLOCK_MONOTONIC) */
+    char *long_text;            /* Respuesta de LIST LONG (si has_metrics) */
+    size_t long_len;
+    char *bin;                  /* Tabla codificada en binario (wire.h), al primer pedido */
+    size_t bin_len;
+    SnapshotPacked packed[SNAPSHOT_PACKED]; /* SNAPSHOT_PACK_* */
+    SnapshotDelta deltas[SNAPSHOT_DELTA_CACHE]; /* Protegidos por el lock de la caché */
+    int next_delta;             /* Deltas guardados */
+} Snapshot;
+
+typedef struct {
+    unsigned long hits;         /* Servidos desde la caché */
+    unsigned long misses;       /* Provocaron un escaneo */
+    unsigned long coalesced;    /* Esperaron un escaneo ya en curso */
+    int ttl_ms;
+    int history;                /* Generaciones anteriores guardadas */
+    size_t history_bytes;       /* Su memoria al entrar la última */
+} SnapshotStats;
+
+/* Fija el TTL en milisegundos (0 = escanear en cada LIST). */
+void snapshot_set_ttl(int ttl_ms);
+
+/*
+ * Retorna una instantánea vigente con una referencia para el llamador,
+ * que debe soltarla con snapshot_release(). Retorna NULL si /proc no
+ * se puede leer.
+ */
+Snapshot *snapshot_acquire(void);
+
+/*
+ * Como snapshot_acquire, pero con métricas (%CPU, RSS...) de como mucho
+ * un TTL de antigüedad. Escaneando /proc siempre las hay; con eventos
+ * del kernel se leen aparte solo cuando alguien las pide.
+ */
+Snapshot *snapshot_acquire_metrics(void);
+
+/*
+ * Retorna la instantánea de la generación gen (la actual o una de la
+ * historia) con una referencia, o NULL si ya no está o si se piden
+ * métricas y no las tiene. No escanea nunca.
+ */
+Snapshot *snapshot_acquire_generation(unsigned long gen, int metrics);
+
+/*
+ * Modo sin bloqueo para el hilo actual (los reactores): con on, las
+ * funciones snapshot_acquire* que tendrían que escanear /proc o esperar
+ * un escaneo en curso retornan NULL en vez de bloquear, y
+ * snapshot_missed() lo informa. Reinicia snapshot_missed().
+ */
+void snapshot_set_nonblocking(int on);
+
+/*
+ * Desde el último snapshot_set_nonblocking: 0 si no faltó ninguna
+ * instantánea, 1 si faltó una sin métricas, 2 si con métricas.
+ */
+int snapshot_missed(void);
+
+/*
+ * Fija para el hilo actual la instantánea que retornan snapshot_acquire
+ * y snapshot_acquire_metrics (si tiene las métricas pedidas), sin mirar
+ * si venció: la obtuvo un worker para repetir un comando. NULL la quita;
+ * la referencia sigue siendo del llamador.
+ */
+void snapshot_pin(Snapshot *snap);
+
+/* Suelta una referencia; la última libera la instantánea. */
+void snapshot_release(Snapshot *snap);
+
+/*
+ * Las funciones snapshot_attach* agregan una respuesta compartida. Con
+ * pack_min > 0 (la conexión negoció COMPRESS) y si la respuesta ocupa al
+ * menos pack_min bytes, la agregan comprimida: se comprime una sola vez
+ * por instantánea, así el costo no crece con la cantidad de clientes o
+ * suscriptores. Retornan 1 si la respuesta quedó comprimida y 0 si va en
+ * claro. La referencia del llamador pasa a la respuesta.
+ */
+
+/* LIST: la tabla en formato ps, sin copiarla. */
+int snapshot_attach(Snapshot *snap, RespBuf *out, size_t pack_min);
+
+/*
+ * LIST LONG: "FULL <gen>" y la tabla con todas las columnas, sin
+ * copiarla. La instantánea debe tener métricas.
+ */
+int snapshot_attach_long(Snapshot *snap, RespBuf *out, size_t pack_min);
+
+/*
+ * La tabla codificada en binario (wire.h), con métricas si la
+ * instantánea las tiene. Se codifica una sola vez por instantánea. Sin
+ * memoria retorna -1 y la referencia la conserva el llamador.
+ */
+int snapshot_attach_binary(Snapshot *snap, RespBuf *out, size_t pack_min);
+
+/*
+ * La respuesta de `LIST SINCE <since>`:
+ *   DELTA <since> <gen>     seguido de una línea por cambio:
+ *     + <pid> <comm>        proceso nuevo
+ *     - <pid>               proceso que terminó
+ *     ~ <pid> <comm>        cambió de nombre
+ *   FULL <gen>              seguido de la lista completa (formato ps),
+ *                           si `since` ya no está en la historia o el
+ *                           delta no sería más chico
+ * Los cambios van ordenados por PID.
+ */
+int snapshot_attach_since(Snapshot *snap, unsigned long since, RespBuf *out,
+                          size_t pack_min);
+
+/* Marca la instantánea actual como vencida (tras START/STOP). */
+void snapshot_invalidate(void);
+
+/* Copia los contadores. */
+void snapshot_stats(SnapshotStats *stats);
+
+#endif /* SNAPSHOT_H */
@@ -0,0 +1,536 @@
+#define _GNU_SOURCE
+#include <spawn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/signalfd.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+
+#include "spawner.h"
+
+#define SPAWN_MAX_CMD    1100    /* Argumentos separados por '\0' */
+#define SPAWN_BATCH      64      /* Mensajes por recvmmsg/sendmmsg */
+
+/* Mensajes del auxiliar al servidor */
+#define SPAWN_MSG_STARTED  1     /* value = errno (0 si OK) */
+#define SPAWN_MSG_EXITED   2     /* value = estado de waitpid */
+
+typedef struct {
+    uint32_t id;
+    uint32_t flags;         /* SPAWNER_* */
+    char args[SPAWN_MAX_CMD];
+} SpawnRequest;
+
+typedef struct {
+    uint32_t type;
+    uint32_t id;
+    int32_t pid;
+    int32_t value;
+    int64_t utime_us;       /* Solo en SPAWN_MSG_EXITED (de wait4) */
+    int64_t stime_us;
+    int64_t maxrss_kb;
+} SpawnReply;
+
+/* Petición en espera de respuesta (vive en la pila de quien la hizo). */
+typedef struct Pending {
+    uint32_t id;
+    int done;
+    int lost;               /* El auxiliar se perdió sin responder */
+    int err;
+    pid_t pid;
+    struct Pending *next;
+} Pending;
+
+extern char **environ;
+
+static int helper_fd = -1;
+static pid_t helper_pid;
+static int reaper_epfd = -1;
+static SpawnerExitFn exit_fn;
+
+static pthread_mutex_t pending_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  pending_cond = PTHREAD_COND_INITIALIZER;
+static Pending *pending;
+static uint32_t next_id;
+static int helper_alive;
+
+static unsigned long spawned;
+static unsigned long exited;
+
+/*
+ * posix_spawnp con stdout/stderr a /dev/null y sin señales bloqueadas;
+ * con SPAWNER_NEW_GROUP, en una sesión nueva.
+ */
+static int spawn_direct(char *const argv[], int flags, pid_t *pid)
+{
+    posix_spawn_file_actions_t actions;
+    posix_spawnattr_t attr;
+    sigset_t none;
+    int err;
+
+    if (posix_spawn_file_actions_init(&actions) != 0)
+        return ENOMEM;
+    if (posix_spawnattr_init(&attr) != 0) {
+        posix_spawn_file_actions_destroy(&actions);
+        return ENOMEM;
+    }
+
+    /* stdout a /dev/null y stderr como copia de stdout */
+    posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+    posix_spawn_file_actions_adddup2(&actions, STDOUT_FILENO, STDERR_FILENO);
+
+    /* Quien lanza puede tener señales bloqueadas; el hijo no las hereda */
+    sigemptyset(&none);
+    posix_spawnattr_setsigmask(&attr, &none);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK |
+                             ((flags & SPAWNER_NEW_GROUP) ? POSIX_SPAWN_SETSID : 0));
+
+    err = posix_spawnp(pid, argv[0], &actions, &attr, argv, environ);
+
+    posix_spawnattr_destroy(&attr);
+    posix_spawn_file_actions_destroy(&actions);
+    if (err == 0)
+        __atomic_fetch_add(&spawned, 1, __ATOMIC_RELAXED);
+    return err;
+}
+
+/* ---- Proceso auxiliar ---- */
+
+/* Separa los argumentos de una petición (terminados en '\0'). */
+static int request_argv(SpawnRequest *req, size_t len, char **argv)
+{
+    size_t end = len - offsetof(SpawnRequest, args);
+    int argc = 0;
+
+    if (end == 0 || req->args[end - 1] != '\0')
+        return 0;
+    for (size_t off = 0; off < end && argc < SPAWNER_MAX_ARGS - 1; ) {
+        argv[argc++] = req->args + off;
+        off += strlen(req->args + off) + 1;
+    }
+    argv[argc] = NULL;
+    return argc;
+}
+
+static void helper_send(int fd, SpawnReply *replies, int count)
+{
+    struct mmsghdr msgs[SPAWN_BATCH];
+    struct iovec iov[SPAWN_BATCH];
+
+    for (int i = 0; i < count; i++) {
+        iov[i].iov_base = &replies[i];
+        iov[i].iov_len = sizeof(SpawnReply);
+        memset(&msgs[i], 0, sizeof(msgs[i]));
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    for (int sent = 0; sent < count; ) {
+        int n = sendmmsg(fd, msgs + sent, (unsigned int)(count - sent), MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            _exit(1); /* El servidor cerró su extremo */
+        }
+        sent += n;
+    }
+}
+
+/* Atiende un lote de peticiones: las lanza todas y responde de una vez. */
+static int helper_spawn_batch(int fd)
+{
+    static SpawnRequest reqs[SPAWN_BATCH];
+    struct mmsghdr msgs[SPAWN_BATCH];
+    struct iovec iov[SPAWN_BATCH];
+    SpawnReply replies[SPAWN_BATCH];
+
+    for (int i = 0; i < SPAWN_BATCH; i++) {
+        iov[i].iov_base = &reqs[i];
+        iov[i].iov_len = sizeof(SpawnRequest);
+        memset(&msgs[i], 0, sizeof(msgs[i]));
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int n = recvmmsg(fd, msgs, SPAWN_BATCH, MSG_DONTWAIT, NULL);
+    if (n < 0)
+        return (errno == EAGAIN || errno == EINTR) ? 0 : -1;
+    if (n == 0 || msgs[0].msg_len == 0)
+        return -1; /* EOF: el servidor terminó */
+
+    for (int i = 0; i < n; i++) {
+        char *argv[SPAWNER_MAX_ARGS];
+        pid_t pid = 0;
+
+        replies[i].type = SPAWN_MSG_STARTED;
+        replies[i].id = reqs[i].id;
+        if (msgs[i].msg_len <= offsetof(SpawnRequest, args) ||
+            request_argv(&reqs[i], msgs[i].msg_len, argv) == 0) {
+            replies[i].value = EINVAL;
+        } else {
+            replies[i].value = spawn_direct(argv, (int)reqs[i].flags, &pid);
+        }
+        replies[i].pid = pid;
+    }
+    helper_send(fd, replies, n);
+    return 0;
+}
+
+/* Recoge a los hijos que terminaron y reporta su estado. */
+static void helper_reap(int fd, int sfd)
+{
+    struct signalfd_siginfo si;
+    SpawnReply replies[SPAWN_BATCH];
+    struct rusage ru;
+    int count = 0, status;
+    pid_t pid;
+
+    while (read(sfd, &si, sizeof(si)) == sizeof(si))
+        ; /* Varios SIGCHLD pueden llegar como uno solo */
+
+    /* Todos los hijos del auxiliar son procesos lanzados con START */
+    while ((pid = wait4(-1, &status, WNOHANG, &ru)) > 0) {
+        replies[count].type = SPAWN_MSG_EXITED;
+        replies[count].id = 0;
+        replies[count].pid = pid;
+        replies[count].value = status;
+        replies[count].utime_us = ru.ru_utime.tv_sec * 1000000LL + ru.ru_utime.tv_usec;
+        replies[count].stime_us = ru.ru_stime.tv_sec * 1000000LL + ru.ru_stime.tv_usec;
+        replies[count].maxrss_kb = ru.ru_maxrss;
+        if (++count == SPAWN_BATCH) {
+            helper_send(fd, replies, count);
+            count = 0;
+        }
+    }
+    if (count > 0)
+        helper_send(fd, replies, count);
+}
+
+static void helper_main(int fd)
+{
+    sigset_t mask;
+    struct pollfd fds[2];
+
+    prctl(PR_SET_NAME, "spawn-helper");
+    prctl(PR_SET_PDEATHSIG, SIGTERM);
+
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGCHLD);
+    sigprocmask(SIG_BLOCK, &mask, NULL);
+    int sfd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (sfd < 0)
+        _exit(1);
+
+    fds[0].fd = fd;
+    fds[0].events = POLLIN;
+    fds[1].fd = sfd;
+    fds[1].events = POLLIN;
+
+    for (;;) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            _exit(1);
+        }
+        if (fds[0].revents & (POLLIN | POLLHUP | POLLERR)) {
+            if (helper_spawn_batch(fd) < 0)
+                _exit(0);
+        }
+        if (fds[1].revents & POLLIN)
+            helper_reap(fd, sfd);
+    }
+}
+
+/* ---- Lado del servidor ---- */
+
+/* Marca el auxiliar como caído y despierta a quienes esperaban. */
+static void helper_lost(void)
+{
+    pthread_mutex_lock(&pending_lock);
+    helper_alive = 0;
+    for (Pending *p = pending; p; p = p->next) {
+        p->done = 1;
+        p->lost = 1;
+    }
+    pending = NULL;
+    pthread_cond_broadcast(&pending_cond);
+    pthread_mutex_unlock(&pending_lock);
+    fprintf(stderr, "[WARN] El auxiliar de lanzamiento termino; se lanza en linea\n");
+}
+
+static void report_exit(pid_t pid, int status, const struct rusage *ru)
+{
+    __atomic_fetch_add(&exited, 1, __ATOMIC_RELAXED);
+    if (exit_fn)
+        exit_fn(pid, status, ru);
+}
+
+/* Reparte un lote de respuestas del auxiliar. Retorna -1 si se cerró. */
+static int read_replies(void)
+{
+    static SpawnReply replies[SPAWN_BATCH];
+    struct mmsghdr msgs[SPAWN_BATCH];
+    struct iovec iov[SPAWN_BATCH];
+
+    for (int i = 0; i < SPAWN_BATCH; i++) {
+        iov[i].iov_base = &replies[i];
+        iov[i].iov_len = sizeof(SpawnReply);
+        memset(&msgs[i], 0, sizeof(msgs[i]));
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int n = recvmmsg(helper_fd, msgs, SPAWN_BATCH, MSG_DONTWAIT, NULL);
+    if (n < 0)
+        return (errno == EAGAIN || errno == EINTR) ? 0 : -1;
+    if (n == 0 || msgs[0].msg_len == 0)
+        return -1;
+
+    int woke = 0;
+    pthread_mutex_lock(&pending_lock);
+    for (int i = 0; i < n; i++) {
+        SpawnReply *r = &replies[i];
+        if (msgs[i].msg_len != sizeof(SpawnReply) || r->type != SPAWN_MSG_STARTED)
+            continue;
+        for (Pending **pp = &pending; *pp; pp = &(*pp)->next) {
+            if ((*pp)->id == r->id) {
+                (*pp)->done = 1;
+                (*pp)->err = r->value;
+                (*pp)->pid = r->pid;
+                *pp = (*pp)->next;
+                woke = 1;
+                break;
+            }
+        }
+    }
+    if (woke)
+        pthread_cond_broadcast(&pending_cond);
+    pthread_mutex_unlock(&pending_lock);
+
+    /* Las salidas se reportan sin el lock */
+    for (int i = 0; i < n; i++) {
+        SpawnReply *r = &replies[i];
+        if (msgs[i].msg_len == sizeof(SpawnReply) && r->type == SPAWN_MSG_EXITED) {
+            struct rusage ru;
+            memset(&ru, 0, sizeof(ru));
+            ru.ru_utime.tv_sec  = r->utime_us / 1000000;
+            ru.ru_utime.tv_usec = r->utime_us % 1000000;
+            ru.ru_stime.tv_sec  = r->stime_us / 1000000;
+            ru.ru_stime.tv_usec = r->stime_us % 1000000;
+            ru.ru_maxrss = r->maxrss_kb;
+            report_exit(r->pid, r->value, &ru);
+        }
+    }
+    return 0;
+}
+
+/*
+ * Hilo recolector del servidor: reparte las respuestas del auxiliar y
+ * recoge a los hijos lanzados en línea a través de su pidfd. No usa
+ * waitpid(-1), así que no le roba hijos a nadie (por ejemplo a pclose).
+ */
+static void *reaper_main(void *unused)
+{
+    struct epoll_event events[SPAWN_BATCH];
+
+    (void)unused;
+    for (;;) {
+        int n = epoll_wait(reaper_epfd, events, SPAWN_BATCH, -1);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            perror("epoll_wait reaper");
+            return NULL;
+        }
+        for (int i = 0; i < n; i++) {
+            uint64_t key = events[i].data.u64;
+            if (key == 0) {
+                if (read_replies() < 0) {
+                    epoll_ctl(reaper_epfd, EPOLL_CTL_DEL, helper_fd, NULL);
+                    waitpid(helper_pid, NULL, 0);
+                    helper_lost();
+                }
+                continue;
+            }
+
+            /* pidfd de un hijo lanzado en línea: ya terminó */
+            pid_t pid = (pid_t)(key >> 32);
+            int pidfd = (int)(key & 0xffffffff);
+            struct rusage ru;
+            int status;
+            epoll_ctl(reaper_epfd, EPOLL_CTL_DEL, pidfd, NULL);
+            close(pidfd);
+            if (wait4(pid, &status, WNOHANG, &ru) == pid)
+                report_exit(pid, status, &ru);
+        }
+    }
+}
+
+/* Lanza en el servidor y vigila al hijo con un pidfd para recogerlo. */
+static int spawn_inline(char *const argv[], int flags, pid_t *pid)
+{
+    int err = spawn_direct(argv, flags, pid);
+    if (err != 0)
+        return err;
+
+    int pidfd = (int)syscall(SYS_pidfd_open, *pid, 0);
+    if (pidfd >= 0) {
+        struct epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.u64 = ((uint64_t)(uint32_t)*pid << 32) | (uint32_t)pidfd;
+        if (epoll_ctl(reaper_epfd, EPOLL_CTL_ADD, pidfd, &ev) == 0)
+            return 0;
+        close(pidfd);
+    }
+    fprintf(stderr, "[WARN] No se puede vigilar el PID %d; quedara sin recoger\n", *pid);
+    return 0;
+}
+
+int spawner_start(SpawnerExitFn on_exit)
+{
+    struct epoll_event ev;
+    pthread_t tid;
+    int sv[2];
+
+    exit_fn = on_exit;
+    reaper_epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (reaper_epfd < 0)
+        return -1;
+
+    /* El auxiliar se crea antes que el hilo recolector: el hijo no hereda hilos */
+    pid_t pid = -1;
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sv) == 0) {
+        pid = fork();
+        if (pid == 0) {
+            close(sv[0]);
+            helper_main(sv[1]);
+            _exit(0);
+        }
+        close(sv[1]);
+        if (pid < 0)
+            close(sv[0]);
+    }
+
+    /* El recolector hace falta aunque no haya auxiliar (hijos en línea) */
+    if (pthread_create(&tid, NULL, reaper_main, NULL) != 0) {
+        if (pid > 0) {
+            kill(pid, SIGKILL);
+            waitpid(pid, NULL, 0);
+        }
+        close(reaper_epfd);
+        reaper_epfd = -1;
+        return -1;
+    }
+    pthread_detach(tid);
+    if (pid < 0)
+        return -1;
+
+    helper_fd = sv[0];
+    helper_pid = pid;
+
+    ev.events = EPOLLIN;
+    ev.data.u64 = 0;
+    if (epoll_ctl(reaper_epfd, EPOLL_CTL_ADD, helper_fd, &ev) < 0) {
+        close(helper_fd);
+        helper_fd = -1;
+        kill(pid, SIGKILL);
+        waitpid(pid, NULL, 0);
+        return -1;
+    }
+    pthread_mutex_lock(&pending_lock);
+    helper_alive = 1;
+    pthread_mutex_unlock(&pending_lock);
+    return 0;
+}
+
+int spawner_run(char *const argv[], int flags, pid_t *pid)
+{
+    SpawnRequest req;
+    Pending self = {0};
+    size_t len = 0;
+
+    for (int i = 0; argv[i]; i++) {
+        size_t n = strlen(argv[i]) + 1;
+        if (len + n > sizeof(req.args))
+            return E2BIG;
+        memcpy(req.args + len, argv[i], n);
+        len += n;
+    }
+    if (len == 0)
+        return EINVAL;
+
+    pthread_mutex_lock(&pending_lock);
+    if (!helper_alive) {
+        pthread_mutex_unlock(&pending_lock);
+        return spawn_inline(argv, flags, pid);
+    }
+    self.id = req.id = ++next_id;
+    req.flags = (uint32_t)flags;
+    self.next = pending;
+    pending = &self;
+    pthread_mutex_unlock(&pending_lock);
+
+    /* SOCK_SEQPACKET: cada send es un mensaje completo, sin mezclarse */
+    ssize_t sent;
+    do {
+        sent = send(helper_fd, &req, offsetof(SpawnRequest, args) + len, MSG_NOSIGNAL);
+    } while (sent < 0 && errno == EINTR);
+
+    pthread_mutex_lock(&pending_lock);
+    if (sent < 0 && !self.done) {
+        for (Pending **pp = &pending; *pp; pp = &(*pp)->next) {
+            if (*pp == &self) {
+                *pp = self.next;
+                break;
+            }
+        }
+        self.done = 1;
+        self.lost = 1;
+    }
+    while (!self.done)
+        pthread_cond_wait(&pending_cond, &pending_lock);
+    pthread_mutex_unlock(&pending_lock);
+
+    if (self.lost)
+        return spawn_inline(argv, flags, pid);
+    if (self.err == 0) {
+        *pid = self.pid;
+        __atomic_fetch_add(&spawned, 1, __ATOMIC_RELAXED);
+    }
+    return self.err;
+}
+
+int spawner_split(const char *command, char *copy, size_t size, char **args)
+{
+    char *save;
+    int i = 0;
+
+    snprintf(copy, size, "%s", command);
+    for (char *token = strtok_r(copy, " ", &save);
+         token != NULL && i < SPAWNER_MAX_ARGS - 1;
+         token = strtok_r(NULL, " ", &save))
+        args[i++] = token;
+    args[i] = NULL;
+    return i;
+}
+
+void spawner_stats(SpawnerStats *stats)
+{
+    pthread_mutex_lock(&pending_lock);
+    stats->helper_pid = helper_alive ? helper_pid : 0;
+    pthread_mutex_unlock(&pending_lock);
+    stats->spawned = __atomic_load_n(&spawned, __ATOMIC_RELAXED);
+    stats->exited  = __atomic_load_n(&exited, __ATOMIC_RELAXED);
+}
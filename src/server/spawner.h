@@ -0,0 +1,62 @@
+#ifndef SPAWNER_H
+#define SPAWNER_H
+
+#include <sys/types.h>
+#include <sys/resource.h>
+
+/*
+ * Lanzamiento de procesos. Al arrancar, el servidor crea un proceso
+ * auxiliar de un solo hilo (spawner_start) que recibe las peticiones por
+ * un socketpair y hace los posix_spawnp(): el costo de lanzar no depende
+ * de la memoria ni de los hilos del servidor, y los hijos son del
+ * auxiliar, que avisa el PID y luego el estado de salida de cada uno.
+ * Las peticiones que llegan juntas se atienden y responden en lote.
+ *
+ * Si el auxiliar no arrancó o terminó, se lanza directamente con
+ * posix_spawnp() desde el hilo que llama, y el hijo se recoge por su
+ * pidfd. Nunca se llama a waitpid(-1): solo se recogen procesos propios.
+ */
+
+#define SPAWNER_MAX_ARGS 16     /* Incluye el NULL final */
+
+/* Flags de spawner_run */
+#define SPAWNER_NEW_GROUP 0x1   /* Nueva sesión: el hijo lidera su grupo (pgid = pid) */
+
+typedef struct {
+    int helper_pid;             /* PID del auxiliar, 0 si no está activo */
+    unsigned long spawned;      /* Procesos lanzados */
+    unsigned long exited;       /* Salidas reportadas */
+} SpawnerStats;
+
+/*
+ * Avisa que un proceso lanzado terminó: status como el de waitpid y el
+ * consumo de recursos de wait4. Corre en el hilo recolector.
+ */
+typedef void (*SpawnerExitFn)(pid_t pid, int status, const struct rusage *ru);
+
+/*
+ * Crea el proceso auxiliar y el hilo recolector. Debe llamarse antes de
+ * crear hilos o abrir sockets, para que el auxiliar no herede nada.
+ * Retorna 0 si OK, -1 en error (se seguirá lanzando en línea).
+ */
+int spawner_start(SpawnerExitFn on_exit);
+
+/*
+ * Separa un comando en argumentos por espacios, sobre `copy` (de `size`
+ * bytes). args debe tener SPAWNER_MAX_ARGS lugares. Retorna la cantidad.
+ */
+int spawner_split(const char *command, char *copy, size_t size, char **args);
+
+/*
+ * Lanza argv[0] (buscándolo en PATH) con stdout y stderr en /dev/null.
+ * Con SPAWNER_NEW_GROUP el hijo abre una sesión propia (setsid), así
+ * todo lo que lance queda en su grupo y se puede señalar de una vez.
+ * Retorna cuando el exec terminó: 0 y el PID en *pid, o el errno del
+ * fallo (también si el exec falla, por ejemplo ENOENT).
+ */
+int spawner_run(char *const argv[], int flags, pid_t *pid);
+
+/* Copia los contadores. */
+void spawner_stats(SpawnerStats *stats);
+
+#endif /* SPAWNER_H */
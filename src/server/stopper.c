@@ -0,0 +1,179 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <errno.h>
+#include <signal.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#include "stopper.h"
+#include "timerwheel.h"
+
+/* Proceso con un plazo en curso */
+typedef struct {
+    Timer timer;
+    pid_t pid;
+    int pidfd;                  /* -1 si se detiene el grupo */
+    unsigned int grace_ms;
+} Escalation;
+
+static const struct {
+    const char *name;
+    int sig;
+} signals[] = {
+    { "HUP", SIGHUP }, { "INT", SIGINT }, { "QUIT", SIGQUIT }, { "KILL", SIGKILL },
+    { "USR1", SIGUSR1 }, { "USR2", SIGUSR2 }, { "TERM", SIGTERM }, { "CONT", SIGCONT },
+    { "STOP", SIGSTOP }, { NULL, 0 }
+};
+
+static unsigned long waiting, graceful, escalated;
+static void (*on_kill)(pid_t pid);
+
+static int sys_pidfd_open(pid_t pid)
+{
+    return (int)syscall(SYS_pidfd_open, pid, 0);
+}
+
+static int sys_pidfd_send_signal(int pidfd, int sig)
+{
+    return (int)syscall(SYS_pidfd_send_signal, pidfd, sig, NULL, 0);
+}
+
+/* Vence el plazo (hilo de la rueda): SIGKILL si el proceso sigue vivo. */
+static void escalate(void *arg)
+{
+    Escalation *e = arg;
+    struct pollfd pfd = { .fd = e->pidfd, .events = POLLIN };
+
+    if (e->pidfd < 0) {
+        /* Grupo: basta con que quede un miembro */
+        if (kill(-e->pid, SIGKILL) == 0) {
+            if (on_kill)
+                on_kill(e->pid);
+            __atomic_fetch_add(&escalated, 1, __ATOMIC_RELAXED);
+            printf("[STOP] Grupo %d no termino en %u ms, enviado SIGKILL\n", e->pid, e->grace_ms);
+        } else {
+            __atomic_fetch_add(&graceful, 1, __ATOMIC_RELAXED);
+        }
+    } else if (poll(&pfd, 1, 0) == 1) {
+        /* El pidfd queda legible cuando el proceso terminó */
+        __atomic_fetch_add(&graceful, 1, __ATOMIC_RELAXED);
+    } else if (sys_pidfd_send_signal(e->pidfd, SIGKILL) == 0) {
+        if (on_kill)
+            on_kill(e->pid);
+        __atomic_fetch_add(&escalated, 1, __ATOMIC_RELAXED);
+        printf("[STOP] PID %d no termino en %u ms, enviado SIGKILL\n", e->pid, e->grace_ms);
+    } else {
+        __atomic_fetch_add(&graceful, 1, __ATOMIC_RELAXED); /* Terminó justo ahora */
+    }
+
+    __atomic_fetch_sub(&waiting, 1, __ATOMIC_RELAXED);
+    if (e->pidfd >= 0)
+        close(e->pidfd);
+    free(e);
+}
+
+/* Envía sig por el pidfd, o al grupo entero si pidfd < 0. */
+static int send_signal(pid_t pid, int pidfd, int sig)
+{
+    return pidfd >= 0 ? sys_pidfd_send_signal(pidfd, sig) : kill(-pid, sig);
+}
+
+int stopper_leads_group(pid_t pid)
+{
+    int pidfd = sys_pidfd_open(pid);
+    if (pidfd < 0)
+        return 0;
+
+    /*
+     * getpgid() va por número: si el pidfd sigue sin ser legible después,
+     * el proceso no terminó en el medio y la respuesta es de él.
+     */
+    struct pollfd pfd = { .fd = pidfd, .events = POLLIN };
+    int leads = getpgid(pid) == pid && poll(&pfd, 1, 0) == 0;
+    close(pidfd);
+    return leads;
+}
+
+int stopper_signal(pid_t pid, int sig, unsigned int grace_ms, int group)
+{
+    /*
+     * El grupo sobrevive a su líder, así que se señala por pgid: el
+     * número no se reutiliza mientras el grupo tenga miembros.
+     */
+    int pidfd = -1;
+    if (!group) {
+        pidfd = sys_pidfd_open(pid);
+        if (pidfd < 0)
+            return errno;
+    }
+
+    if (send_signal(pid, pidfd, sig) < 0) {
+        int err = errno;
+        if (pidfd >= 0)
+            close(pidfd);
+        return err;
+    }
+    if (sig == SIGKILL || grace_ms == 0) {
+        if (pidfd >= 0)
+            close(pidfd);
+        return 0;
+    }
+
+    Escalation *e = malloc(sizeof(Escalation));
+    if (!e) {
+        /* Sin memoria no hay plazo: se fuerza ahora */
+        if (send_signal(pid, pidfd, SIGKILL) == 0 && on_kill)
+            on_kill(pid);
+        if (pidfd >= 0)
+            close(pidfd);
+        return 0;
+    }
+    e->pid = pid;
+    e->pidfd = pidfd;
+    e->grace_ms = grace_ms;
+    __atomic_fetch_add(&waiting, 1, __ATOMIC_RELAXED);
+    timerwheel_add(&e->timer, grace_ms, escalate, e);
+    return 0;
+}
+
+void stopper_on_kill(void (*fn)(pid_t pid))
+{
+    on_kill = fn;
+}
+
+int stopper_parse_signal(const char *name)
+{
+    if (isdigit((unsigned char)name[0])) {
+        char *end;
+        long sig = strtol(name, &end, 10);
+        return (*end == '\0' && sig > 0 && sig < NSIG) ? (int)sig : -1;
+    }
+    if (strncasecmp(name, "SIG", 3) == 0)
+        name += 3;
+    for (int i = 0; signals[i].name; i++) {
+        if (strcasecmp(name, signals[i].name) == 0)
+            return signals[i].sig;
+    }
+    return -1;
+}
+
+const char *stopper_signal_name(int sig)
+{
+    for (int i = 0; signals[i].name; i++) {
+        if (signals[i].sig == sig)
+            return signals[i].name;
+    }
+    return NULL;
+}
+
+void stopper_stats(StopperStats *stats)
+{
+    stats->waiting   = __atomic_load_n(&waiting, __ATOMIC_RELAXED);
+    stats->graceful  = __atomic_load_n(&graceful, __ATOMIC_RELAXED);
+    stats->escalated = __atomic_load_n(&escalated, __ATOMIC_RELAXED);
+}
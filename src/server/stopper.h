@@ -0,0 +1,58 @@
+#ifndef STOPPER_H
+#define STOPPER_H
+
+#include <sys/types.h>
+
+/*
+ * Detención de procesos por pidfd: la señal se envía con
+ * pidfd_send_signal(), así un PID reciclado nunca recibe una señal
+ * dirigida a otro proceso. Si la señal no es SIGKILL y hay plazo, se
+ * agenda un temporizador en la rueda compartida; al vencer se consulta
+ * el pidfd sin bloquear y, si el proceso sigue vivo, se envía SIGKILL.
+ * Nadie espera bloqueado: detener mil procesos son mil temporizadores.
+ *
+ * Un proceso que lidera su grupo (START --group) se detiene con todo su
+ * grupo: kill(-pgid) llega a todos los miembros en una sola llamada, y
+ * al vencer el plazo el SIGKILL va al grupo si queda alguno, aunque el
+ * líder ya haya terminado.
+ */
+
+#define STOPPER_DEFAULT_GRACE_MS  5000
+
+typedef struct {
+    unsigned long waiting;      /* Plazos en curso */
+    unsigned long graceful;     /* Terminaron dentro del plazo */
+    unsigned long escalated;    /* Recibieron SIGKILL al vencer el plazo */
+} StopperStats;
+
+/*
+ * Envía sig a pid (o a su grupo si group) y, si grace_ms > 0 y sig no
+ * es SIGKILL, agenda el SIGKILL para cuando venza el plazo. Retorna 0 o
+ * el errno (ESRCH si no existe, EPERM sin permisos).
+ */
+int stopper_signal(pid_t pid, int sig, unsigned int grace_ms, int group);
+
+/*
+ * 1 si pid está vivo y lidera su propio grupo (getpgid(pid) == pid),
+ * comprobado a través de su pidfd para no confundirlo con otro proceso
+ * que haya recibido el mismo número.
+ */
+int stopper_leads_group(pid_t pid);
+
+/*
+ * Registra a quién avisar cuando un plazo vence y el proceso (o su
+ * grupo) recibe SIGKILL. Se llama desde el hilo de la rueda; se registra
+ * una vez al arrancar.
+ */
+void stopper_on_kill(void (*fn)(pid_t pid));
+
+/* Traduce "TERM", "SIGTERM" o "15". Retorna -1 si no es válida. */
+int stopper_parse_signal(const char *name);
+
+/* Nombre corto de una señal ("TERM"), o NULL si no tiene. */
+const char *stopper_signal_name(int sig);
+
+/* Copia los contadores. */
+void stopper_stats(StopperStats *stats);
+
+#endif /* STOPPER_H */
@@ -0,0 +1,333 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/wait.h>
+
+#include "supervisor.h"
+#include "spawner.h"
+#include "jobs.h"
+#include "timerwheel.h"
+#include "workers.h"
+
+/* Estados de un trabajo */
+#define JOB_STARTING   0    /* Lanzándose (fuera del lock) */
+#define JOB_RUNNING    1
+#define JOB_BACKOFF    2    /* Esperando para relanzar */
+#define JOB_STOPPED    3    /* Detenido con STOP */
+#define JOB_DONE       4    /* Terminó y la política no lo relanza */
+#define JOB_CRASHLOOP  5    /* Demasiados relanzamientos seguidos */
+
+static const char *state_names[] = {
+    "lanzando", "corriendo", "esperando", "detenido", "terminado", "bucle"
+};
+static const char *policy_names[] = { "never", "on-failure", "always" };
+
+typedef struct {
+    int id;                     /* Número de trabajo, 0 = slot libre */
+    int state;
+    int policy;
+    int flags;                  /* Flags de spawner_run */
+    pid_t pid;                  /* PID actual (0 si no está corriendo) */
+    pid_t last_pid;             /* PID de la última salida */
+    int stopping;               /* STOP pedido: no relanzar */
+    int has_status;
+    int last_status;            /* Última salida (estado de waitpid) */
+    unsigned long restarts;
+    long long started_ms;       /* Reloj monotónico */
+    long long restart_at_ms;
+    long long backoff_ms;       /* Próxima espera */
+    long long recent[SUPERVISOR_LOOP_RESTARTS]; /* Últimos relanzamientos */
+    int recent_next;
+    Timer timer;                /* Relanzamiento agendado (JOB_BACKOFF) */
+    int timer_armed;            /* timer sigue en la rueda: el slot no se reusa */
+    char command[1025];
+} SupervisedJob;
+
+static pthread_mutex_t sup_lock = PTHREAD_MUTEX_INITIALIZER;
+static SupervisedJob table[SUPERVISOR_MAX_JOBS];
+static int next_id;
+
+static long long now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static int is_final(int state)
+{
+    return state == JOB_STOPPED || state == JOB_DONE || state == JOB_CRASHLOOP;
+}
+
+int supervisor_parse_policy(const char *name)
+{
+    for (int i = 0; i < 3; i++) {
+        if (strcasecmp(name, policy_names[i]) == 0)
+            return i;
+    }
+    return -1;
+}
+
+const char *supervisor_policy_name(int policy)
+{
+    return policy >= 0 && policy < 3 ? policy_names[policy] : "?";
+}
+
+static void restart_due(void *arg);
+
+/*
+ * Decide qué hacer con un trabajo que dejó de correr (con sup_lock).
+ * failed indica si la salida cuenta como fallo para la política.
+ */
+static void job_ended(SupervisedJob *job, int failed, long long now)
+{
+    job->last_pid = job->pid;
+    job->pid = 0;
+
+    if (job->stopping) {
+        job->state = JOB_STOPPED;
+        return;
+    }
+    if (job->policy == RESTART_NEVER || (job->policy == RESTART_ON_FAILURE && !failed)) {
+        job->state = JOB_DONE;
+        return;
+    }
+
+    /* Si corrió un buen rato, el fallo no es parte de una racha */
+    if (now - job->started_ms >= SUPERVISOR_STABLE_MS)
+        job->backoff_ms = SUPERVISOR_BACKOFF_MIN_MS;
+
+    /* El más viejo de los últimos relanzamientos, dentro de la ventana: bucle */
+    long long oldest = job->recent[job->recent_next];
+    if (job->restarts >= SUPERVISOR_LOOP_RESTARTS &&
+        now - oldest <= SUPERVISOR_LOOP_WINDOW_MS) {
+        job->state = JOB_CRASHLOOP;
+        fprintf(stderr, "[WARN] Trabajo %d '%s' en bucle de fallos, no se relanza\n",
+                job->id, job->command);
+        return;
+    }
+
+    job->state = JOB_BACKOFF;
+    job->restart_at_ms = now + job->backoff_ms;
+    job->timer_armed = 1;
+    timerwheel_add(&job->timer, (unsigned int)job->backoff_ms, restart_due, job);
+    job->backoff_ms *= 2;
+    if (job->backoff_ms > SUPERVISOR_BACKOFF_MAX_MS)
+        job->backoff_ms = SUPERVISOR_BACKOFF_MAX_MS;
+}
+
+/* Lanza el comando del trabajo (sin sup_lock). Retorna 0 o el errno. */
+static int job_spawn(SupervisedJob *job, pid_t *out_pid)
+{
+    char copy[sizeof(job->command)];
+    char *args[SPAWNER_MAX_ARGS];
+    JobInfo info;
+    pid_t pid;
+
+    /* El comando no cambia mientras el trabajo está en JOB_STARTING */
+    if (spawner_split(job->command, copy, sizeof(copy), args) == 0)
+        return EINVAL;
+    int err = spawner_run(args, job->flags, &pid);
+    if (err != 0)
+        return err;
+    jobs_started(pid, job->command, (job->flags & SPAWNER_NEW_GROUP) != 0);
+
+    pthread_mutex_lock(&sup_lock);
+    job->pid = pid;
+    job->state = JOB_RUNNING;
+    job->started_ms = now_ms();
+    pthread_mutex_unlock(&sup_lock);
+    *out_pid = pid;
+
+    /* La salida pudo llegar antes de conocer el PID: está en la tabla de jobs */
+    if (jobs_lookup(pid, &info) == 0 && !info.running)
+        supervisor_exited(pid, info.status);
+    return 0;
+}
+
+/* Relanza un trabajo cuya espera venció (en un worker). */
+static void job_restart(void *arg)
+{
+    SupervisedJob *job = arg;
+    long long now = now_ms();
+
+    pthread_mutex_lock(&sup_lock);
+    if (job->state != JOB_BACKOFF) {
+        pthread_mutex_unlock(&sup_lock);
+        return;
+    }
+    job->state = JOB_STARTING;
+    job->restarts++;
+    job->recent[job->recent_next] = now;
+    job->recent_next = (job->recent_next + 1) % SUPERVISOR_LOOP_RESTARTS;
+    pthread_mutex_unlock(&sup_lock);
+
+    pid_t pid;
+    int err = job_spawn(job, &pid);
+    if (err != 0) {
+        pthread_mutex_lock(&sup_lock);
+        fprintf(stderr, "[WARN] No se pudo relanzar el trabajo %d '%s': %s\n",
+                job->id, job->command, strerror(err));
+        job->started_ms = now_ms();
+        job_ended(job, 1, job->started_ms);
+        pthread_mutex_unlock(&sup_lock);
+    }
+}
+
+/*
+ * Vence la espera (hilo de la rueda): lanzar bloquea, así que va a un
+ * worker. Si el trabajo se detuvo mientras esperaba, no hay nada que hacer.
+ */
+static void restart_due(void *arg)
+{
+    SupervisedJob *job = arg;
+
+    pthread_mutex_lock(&sup_lock);
+    job->timer_armed = 0;
+    int due = job->state == JOB_BACKOFF;
+    pthread_mutex_unlock(&sup_lock);
+
+    if (due && workers_submit(job_restart, arg) != 0)
+        job_restart(arg);
+}
+
+int supervisor_launch(const char *command, int policy, int flags, pid_t *pid, int *job_id)
+{
+    SupervisedJob *job = NULL;
+
+    pthread_mutex_lock(&sup_lock);
+    /* Un slot libre o, si no hay, el de un trabajo que ya terminó */
+    for (int i = 0; i < SUPERVISOR_MAX_JOBS && !job; i++) {
+        if (table[i].id == 0)
+            job = &table[i];
+    }
+    for (int i = 0; i < SUPERVISOR_MAX_JOBS && !job; i++) {
+        if (is_final(table[i].state) && !table[i].timer_armed)
+            job = &table[i];
+    }
+    if (!job) {
+        pthread_mutex_unlock(&sup_lock);
+        return ENOSPC;
+    }
+    memset(job, 0, sizeof(*job));
+    job->id = ++next_id;
+    job->state = JOB_STARTING;
+    job->policy = policy;
+    job->flags = flags;
+    job->backoff_ms = SUPERVISOR_BACKOFF_MIN_MS;
+    snprintf(job->command, sizeof(job->command), "%s", command);
+    *job_id = job->id;
+    pthread_mutex_unlock(&sup_lock);
+
+    int err = job_spawn(job, pid);
+    if (err != 0) {
+        /* Si el primer lanzamiento falla no queda registro */
+        pthread_mutex_lock(&sup_lock);
+        job->id = 0;
+        pthread_mutex_unlock(&sup_lock);
+    }
+    return err;
+}
+
+void supervisor_exited(pid_t pid, int status)
+{
+    pthread_mutex_lock(&sup_lock);
+    for (int i = 0; i < SUPERVISOR_MAX_JOBS; i++) {
+        SupervisedJob *job = &table[i];
+        if (job->id != 0 && job->state == JOB_RUNNING && job->pid == pid) {
+            job->has_status = 1;
+            job->last_status = status;
+            job_ended(job, !WIFEXITED(status) || WEXITSTATUS(status) != 0, now_ms());
+            break;
+        }
+    }
+    pthread_mutex_unlock(&sup_lock);
+}
+
+void supervisor_stopping(pid_t pid)
+{
+    pthread_mutex_lock(&sup_lock);
+    for (int i = 0; i < SUPERVISOR_MAX_JOBS; i++) {
+        SupervisedJob *job = &table[i];
+        if (job->id == 0)
+            continue;
+        if (job->state == JOB_RUNNING && job->pid == pid) {
+            job->stopping = 1;
+            break;
+        }
+        /* La señal llegó y la salida se anotó antes que este aviso: el
+         * temporizador sigue en la rueda pero restart_due lo ignora */
+        if (job->state == JOB_BACKOFF && job->last_pid == pid) {
+            job->stopping = 1;
+            job->state = JOB_STOPPED;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&sup_lock);
+}
+
+int supervisor_stop_job(int job_id, pid_t *pid)
+{
+    int err = ESRCH;
+
+    *pid = 0;
+    pthread_mutex_lock(&sup_lock);
+    for (int i = 0; i < SUPERVISOR_MAX_JOBS; i++) {
+        SupervisedJob *job = &table[i];
+        if (job_id <= 0 || job->id != job_id)
+            continue;
+        if (is_final(job->state)) {
+            err = EALREADY;
+        } else if (job->state == JOB_STARTING) {
+            err = EBUSY;
+        } else if (job->state == JOB_RUNNING) {
+            /* Lo marca supervisor_stopping cuando la señal llegue */
+            *pid = job->pid;
+            err = 0;
+        } else {
+            /* Esperando: el temporizador sigue en la rueda pero
+             * restart_due lo ignora */
+            job->stopping = 1;
+            job->state = JOB_STOPPED;
+            err = 0;
+        }
+        break;
+    }
+    pthread_mutex_unlock(&sup_lock);
+    return err;
+}
+
+void supervisor_format(RespBuf *out)
+{
+    long long now = now_ms();
+
+    respbuf_printf(out, "%4s %7s %-10s %-10s %9s %7s %8s %s\n", "ID", "PID", "ESTADO",
+                   "POLITICA", "REINICIOS", "ULTIMA", "ESPERA", "COMANDO");
+
+    pthread_mutex_lock(&sup_lock);
+    for (int i = 0; i < SUPERVISOR_MAX_JOBS; i++) {
+        const SupervisedJob *job = &table[i];
+        char pid[16] = "-", last[16] = "-", wait[24] = "-";
+
+        if (job->id == 0)
+            continue;
+        if (job->pid > 0)
+            snprintf(pid, sizeof(pid), "%d", job->pid);
+        if (job->has_status && WIFSIGNALED(job->last_status))
+            snprintf(last, sizeof(last), "SIG%d", WTERMSIG(job->last_status));
+        else if (job->has_status)
+            snprintf(last, sizeof(last), "%d", WEXITSTATUS(job->last_status));
+        if (job->state == JOB_BACKOFF)
+            snprintf(wait, sizeof(wait), "%lldms",
+                     job->restart_at_ms > now ? job->restart_at_ms - now : 0);
+
+        respbuf_printf(out, "%4d %7s %-10s %-10s %9lu %7s %8s %s\n", job->id, pid,
+                       state_names[job->state], policy_names[job->policy],
+                       job->restarts, last, wait, job->command);
+    }
+    pthread_mutex_unlock(&sup_lock);
+}
@@ -0,0 +1,71 @@
+#ifndef SUPERVISOR_H
+#define SUPERVISOR_H
+
+#include <sys/types.h>
+
+#include "respbuf.h"
+
+/*
+ * Trabajos supervisados: procesos lanzados con START --restart=<política>
+ * que el servidor vuelve a lanzar cuando terminan, según la política:
+ *   never       no se relanza (solo queda el registro)
+ *   on-failure  se relanza si sale con código distinto de 0 o por señal
+ *   always      se relanza siempre
+ * Todo lo dispara el aviso de salida del recolector; el relanzamiento se
+ * agenda en la rueda de temporizadores con espera exponencial
+ * (SUPERVISOR_BACKOFF_MIN_MS, duplicando hasta SUPERVISOR_BACKOFF_MAX_MS,
+ * y se reinicia si el proceso duró más de SUPERVISOR_STABLE_MS). Si se relanza SUPERVISOR_LOOP_RESTARTS veces en
+ * SUPERVISOR_LOOP_WINDOW_MS el trabajo queda en bucle de fallos y ya no se
+ * relanza. STOP sobre el PID de un trabajo, o STOP --job con su número
+ * (que también sirve mientras espera para relanzarse), lo deja detenido.
+ */
+
+#define SUPERVISOR_MAX_JOBS        128
+#define SUPERVISOR_BACKOFF_MIN_MS  500
+#define SUPERVISOR_BACKOFF_MAX_MS  30000
+#define SUPERVISOR_STABLE_MS       10000
+#define SUPERVISOR_LOOP_RESTARTS   5
+#define SUPERVISOR_LOOP_WINDOW_MS  60000
+
+#define RESTART_NEVER       0
+#define RESTART_ON_FAILURE  1
+#define RESTART_ALWAYS      2
+
+/* Traduce el nombre de una política. Retorna -1 si no existe. */
+int supervisor_parse_policy(const char *name);
+
+/* Nombre de una política (RESTART_*). */
+const char *supervisor_policy_name(int policy);
+
+/*
+ * Lanza un comando ya validado como trabajo supervisado, con los flags
+ * de spawner_run (también en cada relanzamiento). Retorna 0 y guarda su
+ * PID y número de trabajo, o el errno del fallo (como spawner_run, o
+ * ENOSPC si no hay lugar en la tabla).
+ */
+int supervisor_launch(const char *command, int policy, int flags, pid_t *pid, int *job_id);
+
+/* Avisa que un proceso terminó (status como el de waitpid). */
+void supervisor_exited(pid_t pid, int status);
+
+/*
+ * Avisa que STOP ya le envió a ese PID una señal que lo termina: si es
+ * de un trabajo, no se relanza (aunque su salida se haya anotado antes
+ * que el aviso y esté esperando para relanzarse).
+ */
+void supervisor_stopping(pid_t pid);
+
+/*
+ * Detiene el trabajo job_id (STOP --job). Si está corriendo deja en pid
+ * el proceso al que hay que enviar la señal (y avisar con
+ * supervisor_stopping si llega); si estaba esperando para
+ * relanzarse queda detenido en el acto y pid queda en 0. Retorna 0, o
+ * ESRCH si no existe, EALREADY si ya no corre ni espera y EBUSY si se
+ * está lanzando.
+ */
+int supervisor_stop_job(int job_id, pid_t *pid);
+
+/* Escribe la tabla de trabajos supervisados (SUPERVISED). */
+void supervisor_format(RespBuf *out);
+
+#endif /* SUPERVISOR_H */
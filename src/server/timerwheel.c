@@ -0,0 +1,132 @@
+#include <stdio.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "timerwheel.h"
+
+static pthread_mutex_t wheel_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t wheel_cond;
+static Timer *slots[TIMERWHEEL_SLOTS];
+static unsigned long current_tick;  /* Último tick procesado */
+static long long base_ms;           /* Momento del tick 0 */
+static int pending;
+
+static long long now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/* Tick correspondiente al reloj actual. */
+static unsigned long tick_now(void)
+{
+    return (unsigned long)((now_ms() - base_ms) / TIMERWHEEL_TICK_MS);
+}
+
+/*
+ * Procesa el slot del tick current_tick: saca los vencidos a `fired`.
+ * Los de vueltas posteriores de la rueda se quedan en el slot.
+ */
+static Timer *collect_expired(void)
+{
+    Timer **link = &slots[current_tick % TIMERWHEEL_SLOTS];
+    Timer *fired = NULL;
+
+    while (*link) {
+        Timer *t = *link;
+        if (t->expires <= current_tick) {
+            *link = t->next;
+            t->next = fired;
+            fired = t;
+            pending--;
+        } else {
+            link = &t->next;
+        }
+    }
+    return fired;
+}
+
+static void *wheel_main(void *unused)
+{
+    (void)unused;
+    pthread_mutex_lock(&wheel_lock);
+    for (;;) {
+        if (pending == 0) {
+            pthread_cond_wait(&wheel_cond, &wheel_lock);
+            continue;
+        }
+
+        long long deadline = base_ms + (long long)(current_tick + 1) * TIMERWHEEL_TICK_MS;
+        if (now_ms() < deadline) {
+            struct timespec ts = {
+                .tv_sec = deadline / 1000,
+                .tv_nsec = (deadline % 1000) * 1000000
+            };
+            pthread_cond_timedwait(&wheel_cond, &wheel_lock, &ts);
+            continue;
+        }
+
+        current_tick++;
+        Timer *fired = collect_expired();
+
+        /* Los callbacks corren sin el lock: pueden volver a agendar */
+        pthread_mutex_unlock(&wheel_lock);
+        while (fired) {
+            Timer *t = fired;
+            fired = t->next;
+            t->next = NULL;
+            t->fn(t->arg);
+        }
+        pthread_mutex_lock(&wheel_lock);
+    }
+    return NULL;
+}
+
+int timerwheel_start(void)
+{
+    pthread_condattr_t attr;
+    pthread_t tid;
+
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&wheel_cond, &attr);
+    pthread_condattr_destroy(&attr);
+    base_ms = now_ms();
+
+    if (pthread_create(&tid, NULL, wheel_main, NULL) != 0) {
+        perror("Could not create timer thread");
+        return -1;
+    }
+    pthread_detach(tid);
+    return 0;
+}
+
+void timerwheel_add(Timer *t, unsigned int delay_ms, TimerFn fn, void *arg)
+{
+    unsigned long ticks = (delay_ms + TIMERWHEEL_TICK_MS - 1) / TIMERWHEEL_TICK_MS;
+
+    pthread_mutex_lock(&wheel_lock);
+    /* Con la rueda vacía el hilo no avanzó los ticks: ponerla al día */
+    if (pending == 0)
+        current_tick = tick_now();
+    if (ticks == 0)
+        ticks = 1;
+
+    t->expires = current_tick + ticks;
+    t->fn = fn;
+    t->arg = arg;
+    t->next = slots[t->expires % TIMERWHEEL_SLOTS];
+    slots[t->expires % TIMERWHEEL_SLOTS] = t;
+    if (pending++ == 0)
+        pthread_cond_signal(&wheel_cond);
+    pthread_mutex_unlock(&wheel_lock);
+}
+
+int timerwheel_pending(void)
+{
+    pthread_mutex_lock(&wheel_lock);
+    int count = pending;
+    pthread_mutex_unlock(&wheel_lock);
+    return count;
+}
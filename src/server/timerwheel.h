@@ -0,0 +1,41 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+/*
+ * Rueda de temporizadores compartida por todo el servidor: un solo hilo
+ * atiende cualquier cantidad de plazos (escalado de STOP, relanzamientos
+ * de trabajos supervisados). Cada tick de TIMERWHEEL_TICK_MS avanza un
+ * slot; agregar un temporizador es O(1). Sin temporizadores pendientes
+ * el hilo duerme sin despertarse.
+ *
+ * Los temporizadores son intrusivos: el Timer vive dentro de la
+ * estructura de quien lo usa y la rueda no reserva memoria. Los
+ * callbacks corren en el hilo de la rueda y deben ser breves (lo que
+ * bloquee se delega al pool de workers).
+ */
+
+#define TIMERWHEEL_TICK_MS  10
+#define TIMERWHEEL_SLOTS    256
+
+typedef void (*TimerFn)(void *arg);
+
+typedef struct Timer {
+    unsigned long expires;      /* Tick en el que vence */
+    TimerFn fn;
+    void *arg;
+    struct Timer *next;
+} Timer;
+
+/* Arranca el hilo de la rueda. Retorna 0 si OK, -1 en error. */
+int timerwheel_start(void);
+
+/*
+ * Agenda fn(arg) dentro de delay_ms (redondeado hacia arriba al tick).
+ * t no debe estar agendado; se puede volver a usar desde su callback.
+ */
+void timerwheel_add(Timer *t, unsigned int delay_ms, TimerFn fn, void *arg);
+
+/* Temporizadores pendientes. */
+int timerwheel_pending(void);
+
+#endif /* TIMERWHEEL_H */
@@ -0,0 +1,169 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "wire.h"
+
+#define VARINT_MAX  10
+#define METRICS_ROW 21          /* Bytes de las columnas fijas por fila */
+
+static unsigned char *put_varint(unsigned char *p, unsigned long long v)
+{
+    while (v >= 0x80) {
+        *p++ = (unsigned char)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (unsigned char)v;
+    return p;
+}
+
+static unsigned char *put_u32(unsigned char *p, uint32_t v)
+{
+    p[0] = (unsigned char)(v >> 24);
+    p[1] = (unsigned char)(v >> 16);
+    p[2] = (unsigned char)(v >> 8);
+    p[3] = (unsigned char)v;
+    return p + 4;
+}
+
+/* Recorta a u32: los valores que no entran quedan en el máximo. */
+static uint32_t clamp_u32(long long v)
+{
+    if (v < 0)
+        return 0;
+    return v > UINT32_MAX ? UINT32_MAX : (uint32_t)v;
+}
+
+static unsigned int hash_name(const char *s)
+{
+    unsigned int h = 2166136261u;       /* FNV-1a */
+    while (*s)
+        h = (h ^ (unsigned char)*s++) * 16777619u;
+    return h;
+}
+
+/*
+ * Asigna a cada fila el índice de su nombre en la tabla de nombres, en
+ * orden de primera aparición (hash abierto de tamaño potencia de 2).
+ * first[k] es la fila donde aparece el nombre k. Retorna la cantidad de
+ * nombres, o -1 sin memoria.
+ */
+static int build_names(const ProcInfo *const *rows, int count, int *index, int *first)
+{
+    size_t size = 16;
+    while (size < (size_t)count * 2)
+        size *= 2;
+    int *slots = malloc(size * sizeof(int));
+    if (!slots)
+        return -1;
+    memset(slots, -1, size * sizeof(int));
+
+    int names = 0;
+    for (int i = 0; i < count; i++) {
+        size_t s = hash_name(rows[i]->comm) & (size - 1);
+        while (slots[s] >= 0 && strcmp(rows[first[slots[s]]]->comm, rows[i]->comm) != 0)
+            s = (s + 1) & (size - 1);
+        if (slots[s] < 0) {
+            slots[s] = names;
+            first[names++] = i;
+        }
+        index[i] = slots[s];
+    }
+
+    free(slots);
+    return names;
+}
+
+int wire_encode(const WireHeader *hdr, const ProcInfo *const *rows, int count,
+                char **data, size_t *len)
+{
+    int *index = malloc((size_t)(count + 1) * 2 * sizeof(int));
+    if (!index)
+        return -1;
+    int *first = index + count + 1;
+    int names = build_names(rows, count, index, first);
+    if (names < 0) {
+        free(index);
+        return -1;
+    }
+
+    /* Cota: cabecera, nombres y cada fila con varints de largo máximo */
+    size_t cap = WIRE_MAGIC_LEN + 2 + 6 * VARINT_MAX;
+    for (int k = 0; k < names; k++)
+        cap += VARINT_MAX + strlen(rows[first[k]]->comm);
+    cap += (size_t)count * (2 * VARINT_MAX + (hdr->metrics ? METRICS_ROW : 0));
+
+    unsigned char *buf = malloc(cap);
+    if (!buf) {
+        free(index);
+        return -1;
+    }
+
+    unsigned char *p = buf;
+    memcpy(p, WIRE_MAGIC, WIRE_MAGIC_LEN);
+    p += WIRE_MAGIC_LEN;
+    *p++ = WIRE_VERSION;
+    *p++ = hdr->metrics ? WIRE_F_METRICS : 0;
+    p = put_varint(p, hdr->generation);
+    p = put_varint(p, (unsigned long long)hdr->offset);
+    p = put_varint(p, (unsigned long long)hdr->total);
+    p = put_varint(p, (unsigned long long)count);
+
+    p = put_varint(p, (unsigned long long)names);
+    for (int k = 0; k < names; k++) {
+        const char *name = rows[first[k]]->comm;
+        size_t n = strlen(name);
+        p = put_varint(p, n);
+        memcpy(p, name, n);
+        p += n;
+    }
+
+    /* Columnas: cada una contigua, así los valores parecidos quedan juntos */
+    int prev = 0;
+    for (int i = 0; i < count; i++) {
+        p = put_varint(p, (unsigned long long)(unsigned int)(rows[i]->pid - prev));
+        prev = rows[i]->pid;
+    }
+    for (int i = 0; i < count; i++)
+        p = put_varint(p, (unsigned long long)index[i]);
+
+    if (hdr->metrics) {
+        for (int i = 0; i < count; i++)
+            p = put_u32(p, rows[i]->uid < 0 ? UINT32_MAX : (uint32_t)rows[i]->uid);
+        for (int i = 0; i < count; i++)
+            *p++ = (unsigned char)rows[i]->state;
+        for (int i = 0; i < count; i++)
+            p = put_u32(p, clamp_u32(rows[i]->threads));
+        for (int i = 0; i < count; i++)
+            p = put_u32(p, clamp_u32(rows[i]->rss_kb));
+        for (int i = 0; i < count; i++)
+            p = put_u32(p, clamp_u32(rows[i]->cpu_tenths));
+        for (int i = 0; i < count; i++)
+            p = put_u32(p, clamp_u32(rows[i]->start_time));
+    }
+
+    free(index);
+    *data = (char *)buf;
+    *len  = (size_t)(p - buf);
+    return 0;
+}
+
+int wire_encode_table(const ProcTable *table, unsigned long generation, int metrics,
+                      char **data, size_t *len)
+{
+    const ProcInfo **rows = malloc((size_t)(table->count + 1) * sizeof(*rows));
+    if (!rows)
+        return -1;
+    for (int i = 0; i < table->count; i++)
+        rows[i] = &table->entries[i];
+
+    WireHeader hdr = {
+        .generation = generation,
+        .offset     = 0,
+        .total      = table->count,
+        .metrics    = metrics,
+    };
+    int res = wire_encode(&hdr, rows, table->count, data, len);
+    free(rows);
+    return res;
+}
@@ -0,0 +1,58 @@
+#ifndef WIRE_H
+#define WIRE_H
+
+#include <stddef.h>
+
+#include "procscan.h"
+
+/*
+ * Codificación binaria de la tabla de procesos (ENCODING BINARY, solo en
+ * modo FRAMED). Reemplaza al texto de LIST, LIST LONG y las páginas de
+ * LIST OFFSET/LIMIT sin SORT ni FIELDS; el resto sigue en texto. Los
+ * enteros "varint" son LEB128 sin signo y los fijos, big-endian como la
+ * cabecera de los frames:
+ *
+ *   "\0PSB"        magia: ninguna respuesta de texto empieza con '\0'
+ *   u8             versión (WIRE_VERSION)
+ *   u8             flags (WIRE_F_*)
+ *   varint         generación
+ *   varint         desde: índice de la primera fila en la lista completa
+ *   varint         total de filas de la lista completa
+ *   varint         filas en el mensaje (n)
+ *   varint         nombres distintos (m), seguidos de m × (varint largo, bytes)
+ *   n × varint     PID menos el PID anterior (el primero, desde 0)
+ *   n × varint     índice del nombre en la tabla
+ *   con WIRE_F_METRICS, columnas de ancho fijo:
+ *   n × u32 UID (0xffffffff = desconocido), n × u8 estado, n × u32 hilos,
+ *   n × u32 RSS en KB, n × u32 %CPU en décimas, n × u32 inicio (época)
+ *
+ * Las filas van ordenadas por PID, así las diferencias caben casi siempre
+ * en un byte, y los nombres repetidos (bash, sleep, nginx...) se envían
+ * una sola vez.
+ */
+
+#define WIRE_MAGIC      "\0PSB"
+#define WIRE_MAGIC_LEN  4
+#define WIRE_VERSION    1
+
+#define WIRE_F_METRICS  0x01    /* Incluye las columnas de LIST LONG */
+
+typedef struct {
+    unsigned long generation;
+    long offset;                /* Índice de la primera fila */
+    long total;                 /* Filas de la lista completa */
+    int metrics;
+} WireHeader;
+
+/*
+ * Codifica count filas (ordenadas por PID) en un buffer nuevo que el
+ * llamador libera con free(). Retorna 0 si OK, -1 sin memoria.
+ */
+int wire_encode(const WireHeader *hdr, const ProcInfo *const *rows, int count,
+                char **data, size_t *len);
+
+/* Codifica la tabla completa. */
+int wire_encode_table(const ProcTable *table, unsigned long generation, int metrics,
+                      char **data, size_t *len);
+
+#endif /* WIRE_H */
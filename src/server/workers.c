@@ -0,0 +1,68 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#include "workers.h"
+
+typedef struct WorkItem {
+    WorkFn fn;
+    void *arg;
+    struct WorkItem *next;
+} WorkItem;
+
+static pthread_mutex_t queue_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  queue_cond = PTHREAD_COND_INITIALIZER;
+static WorkItem *queue_head = NULL;
+static WorkItem *queue_tail = NULL;
+
+static void *worker_main(void *unused)
+{
+    (void)unused;
+    for (;;) {
+        pthread_mutex_lock(&queue_lock);
+        while (queue_head == NULL)
+            pthread_cond_wait(&queue_cond, &queue_lock);
+        WorkItem *item = queue_head;
+        queue_head = item->next;
+        if (queue_head == NULL)
+            queue_tail = NULL;
+        pthread_mutex_unlock(&queue_lock);
+
+        item->fn(item->arg);
+        free(item);
+    }
+    return NULL;
+}
+
+int workers_start(int nthreads)
+{
+    for (int i = 0; i < nthreads; i++) {
+        pthread_t tid;
+        if (pthread_create(&tid, NULL, worker_main, NULL) != 0) {
+            perror("Could not create worker thread");
+            return -1;
+        }
+        pthread_detach(tid);
+    }
+    return 0;
+}
+
+int workers_submit(WorkFn fn, void *arg)
+{
+    WorkItem *item = malloc(sizeof(WorkItem));
+    if (!item)
+        return -1;
+    item->fn   = fn;
+    item->arg  = arg;
+    item->next = NULL;
+
+    pthread_mutex_lock(&queue_lock);
+    if (queue_tail)
+        queue_tail->next = item;
+    else
+        queue_head = item;
+    queue_tail = item;
+    pthread_cond_signal(&queue_cond);
+    pthread_mutex_unlock(&queue_lock);
+    return 0;
+}
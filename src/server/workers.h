@@ -0,0 +1,17 @@
+#ifndef WORKERS_H
+#define WORKERS_H
+
+/*
+ * Pool de hilos para trabajo bloqueante (por ejemplo lanzar procesos),
+ * para que el reactor nunca se detenga esperando.
+ */
+
+typedef void (*WorkFn)(void *arg);
+
+/* Arranca nthreads hilos. Retorna 0 si OK, -1 en error. */
+int workers_start(int nthreads);
+
+/* Encola fn(arg) para ejecutarse en algún hilo del pool. */
+int workers_submit(WorkFn fn, void *arg);
+
+#endif /* WORKERS_H */
@@ -0,0 +1,144 @@
+/**
+ * Benchmark de COMPRESS LZ sobre las respuestas compartidas de la caché:
+ * LIST LONG en texto y la tabla en binario (ENCODING BINARY).
+ *
+ * Para cada tamaño de tabla (por defecto 1000, 10000 y 50000 procesos)
+ * arma la misma tabla sintética que tests/bench_wire.c y mide el tamaño
+ * comprimido, el tiempo de compresión (una vez por instantánea en el
+ * servidor) y el de descompresión (una vez por mensaje en el cliente).
+ *
+ * Compilar:
+ *   gcc -O2 -Wall -Isrc/server -Isrc/client -o tests/bench_compress tests/bench_compress.c \
+ *       src/server/procscan.c src/server/respbuf.c src/server/proto.c src/server/wire.c \
+ *       src/server/compress.c src/client/net.c
+ * Uso:
+ *   ./tests/bench_compress [iteraciones] [tamaño...]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "procscan.h"
+#include "wire.h"
+#include "compress.h"
+#include "net.h"
+
+static const char *common_names[] = {
+    "bash", "sleep", "nginx", "postgres", "sshd", "python3", "node", "java",
+    "systemd", "containerd-shim", "kthreadd", "rcu_preempt", "ksoftirqd/0",
+};
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+/* Tabla sintética de n procesos ordenada por PID. */
+static void build_table(ProcTable *table, int n)
+{
+    int pid = 1;
+
+    table->entries = calloc((size_t)n, sizeof(ProcInfo));
+    table->count = n;
+    table->capacity = n;
+    srand(1234);
+
+    for (int i = 0; i < n; i++) {
+        ProcInfo *e = &table->entries[i];
+
+        pid += 1 + (rand() % 8 == 0 ? rand() % 50 : 0);
+        e->pid = pid;
+        e->ppid = 1;
+        if (rand() % 3 == 0)
+            snprintf(e->comm, sizeof(e->comm), "kworker/%d:%d-events", rand() % 64, rand() % 4);
+        else
+            snprintf(e->comm, sizeof(e->comm), "%s",
+                     common_names[rand() % (sizeof(common_names) / sizeof(common_names[0]))]);
+        e->state = "SSSRDI"[rand() % 6];
+        e->threads = 1 + rand() % 16;
+        e->uid = rand() % 4 ? 0 : 1000 + rand() % 10;
+        e->rss_kb = rand() % 4 ? rand() % 200000 : 0;
+        e->start_time = 1700000000 + rand() % 86400;
+        e->cpu_tenths = rand() % 10 ? 0 : rand() % 1000;
+    }
+}
+
+/* Comprime y descomprime data; imprime una fila de resultados. */
+static void measure(const char *label, const char *data, size_t len, int iterations)
+{
+    struct iovec iov = { .iov_base = (char *)data, .iov_len = len };
+    char *packed = NULL;
+    size_t packed_len = 0;
+
+    double t0 = now_ms();
+    for (int i = 0; i < iterations; i++) {
+        free(packed);
+        packed = NULL;
+        if (compress_message(&iov, 1, &packed, &packed_len) != 0) {
+            printf("  %-8s %9zu B: no se achica\n", label, len);
+            return;
+        }
+    }
+    double pack_ms = (now_ms() - t0) / iterations;
+
+    unsigned char *raw = malloc(len + 1);
+    int ok = 1;
+    t0 = now_ms();
+    for (int i = 0; i < iterations; i++)
+        ok &= net_decompress_block((const unsigned char *)packed + COMPRESS_HEADER_SIZE,
+                                   packed_len - COMPRESS_HEADER_SIZE,
+                                   (unsigned char *)raw, len) == 0;
+    double unpack_ms = (now_ms() - t0) / iterations;
+    ok &= memcmp(raw, data, len) == 0;
+
+    printf("  %-8s %9zu B -> %8zu B (%4.1f%%)  comprimir %7.3f ms (%4.0f MB/s)"
+           "  descomprimir %6.3f ms (%5.0f MB/s)%s\n",
+           label, len, packed_len, 100.0 * packed_len / len,
+           pack_ms, len / 1e3 / pack_ms, unpack_ms, len / 1e3 / unpack_ms,
+           ok ? "" : "  ERROR: no coincide");
+    free(raw);
+    free(packed);
+}
+
+static void run(int n, int iterations)
+{
+    ProcTable table;
+    build_table(&table, n);
+
+    RespBuf text;
+    respbuf_init(&text);
+    procscan_format_long(&table, 7, &text);
+
+    char *bin = NULL;
+    size_t bin_len = 0;
+    wire_encode_table(&table, 1, 1, &bin, &bin_len);
+
+    printf("%d procesos:\n", n);
+    measure("texto", text.data, text.len, iterations);
+    measure("binario", bin, bin_len, iterations);
+
+    respbuf_free(&text);
+    free(bin);
+    free(table.entries);
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = argc > 1 ? atoi(argv[1]) : 20;
+    static const int default_sizes[] = { 1000, 10000, 50000 };
+
+    if (iterations < 1)
+        iterations = 1;
+    if (argc > 2) {
+        for (int i = 2; i < argc; i++)
+            run(atoi(argv[i]), iterations);
+    } else {
+        for (int i = 0; i < 3; i++)
+            run(default_sizes[i], iterations);
+    }
+    return 0;
+}
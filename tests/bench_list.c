@@ -0,0 +1,152 @@
+/**
+ * Benchmark de LIST: popen("ps -e -o pid,comm") vs escáner nativo de /proc.
+ *
+ * Para cada tamaño de tabla (por defecto 1000, 10000 y 50000 procesos)
+ * crea hijos dormidos hasta alcanzar ese total, y mide para ambos métodos
+ * la latencia media por LIST y el tiempo de CPU (usuario + sistema,
+ * incluyendo hijos como sh y ps) por LIST.
+ *
+ * Compilar:
+ *   gcc -O2 -Wall -Isrc/server -o tests/bench_list tests/bench_list.c \
+ *       src/server/procscan.c src/server/respbuf.c src/server/proto.c
+ * Uso:
+ *   ./tests/bench_list [iteraciones] [tamaño...]
+ *
+ * Nota: las tablas grandes requieren `ulimit -u` y kernel.pid_max
+ * suficientes; si fork() falla se reporta el tamaño alcanzado.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+#include "procscan.h"
+
+static pid_t *children;
+static int child_count;
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static double cpu_ms(void)
+{
+    struct rusage self, kids;
+    getrusage(RUSAGE_SELF, &self);
+    getrusage(RUSAGE_CHILDREN, &kids);
+    return (self.ru_utime.tv_sec + self.ru_stime.tv_sec +
+            kids.ru_utime.tv_sec + kids.ru_stime.tv_sec) * 1e3 +
+           (self.ru_utime.tv_usec + self.ru_stime.tv_usec +
+            kids.ru_utime.tv_usec + kids.ru_stime.tv_usec) / 1e3;
+}
+
+/* Crea hijos dormidos hasta que la tabla tenga `target` procesos. */
+static int grow_table(ProcScanner *sc, ProcTable *t, int target)
+{
+    int current = procscan_read(sc, t);
+    while (current < target) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            perror("fork");
+            break;
+        }
+        if (pid == 0) {
+            pause();
+            _exit(0);
+        }
+        children[child_count++] = pid;
+        current++;
+    }
+    return procscan_read(sc, t);
+}
+
+static void run_ps(RespBuf *out)
+{
+    char line[1035];
+    FILE *fp = popen("ps -e -o pid,comm", "r");
+    if (!fp)
+        return;
+    while (fgets(line, sizeof(line), fp))
+        respbuf_puts(out, line);
+    pclose(fp);
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = 20;
+    int sizes[16] = {1000, 10000, 50000};
+    int nsizes = 3;
+
+    if (argc > 1)
+        iterations = atoi(argv[1]);
+    if (argc > 2) {
+        nsizes = 0;
+        for (int i = 2; i < argc && nsizes < 16; i++)
+            sizes[nsizes++] = atoi(argv[i]);
+    }
+
+    ProcScanner sc;
+    ProcTable table = {0};
+    if (procscan_init(&sc) != 0) {
+        perror("procscan_init");
+        return 1;
+    }
+
+    children = calloc(200000, sizeof(pid_t));
+    RespBuf out;
+    respbuf_init(&out);
+    if (!children)
+        return 1;
+
+    printf("=== Benchmark LIST: ps vs /proc nativo (%d iteraciones) ===\n",
+           iterations);
+    printf("%10s  %14s %14s  %14s %14s\n", "procesos",
+           "ps ms/LIST", "ps cpu ms", "nativo ms/LIST", "nativo cpu ms");
+
+    for (int s = 0; s < nsizes; s++) {
+        int procs = grow_table(&sc, &table, sizes[s]);
+
+        double t0 = now_ms(), c0 = cpu_ms();
+        for (int i = 0; i < iterations; i++) {
+            respbuf_reset(&out);
+            run_ps(&out);
+        }
+        double ps_ms = (now_ms() - t0) / iterations;
+        double ps_cpu = (cpu_ms() - c0) / iterations;
+
+        t0 = now_ms();
+        c0 = cpu_ms();
+        for (int i = 0; i < iterations; i++) {
+            procscan_read(&sc, &table);
+            respbuf_reset(&out);
+            procscan_format_ps(&table, sc.pid_width, &out);
+        }
+        double native_ms = (now_ms() - t0) / iterations;
+        double native_cpu = (cpu_ms() - c0) / iterations;
+
+        printf("%10d  %14.3f %14.3f  %14.3f %14.3f\n",
+               procs, ps_ms, ps_cpu, native_ms, native_cpu);
+
+        if (procs < sizes[s])
+            break; /* No se pudieron crear más procesos */
+    }
+
+    for (int i = 0; i < child_count; i++)
+        kill(children[i], SIGKILL);
+    for (int i = 0; i < child_count; i++)
+        waitpid(children[i], NULL, 0);
+
+    procscan_destroy(&sc);
+    proctable_free(&table);
+    free(children);
+    respbuf_free(&out);
+    return 0;
+}
@@ -0,0 +1,230 @@
+/**
+ * Benchmark de comandos encadenados: N comandos uno por uno contra los
+ * mismos N enviados juntos.
+ *
+ * Abre una conexión en modo FRAMED y envía un lote de comandos de dos
+ * formas: secuencial (enviar, esperar la respuesta, siguiente), como
+ * hacía el cliente, y encadenada (todos los frames en un solo send y
+ * después las N respuestas, en orden). Reporta el tiempo del lote y
+ * cuántas llamadas a sendmsg hizo el servidor (columna ENVIOS de STATS)
+ * en cada caso.
+ *
+ * Compilar:
+ *   gcc -O2 -Wall -o tests/bench_pipeline tests/bench_pipeline.c
+ * Uso:
+ *   ./tests/bench_pipeline [-p puerto] [-n comandos] [-r repeticiones]
+ *                          [-c comando]
+ *
+ * El comando por defecto (STATUS 1) no cambia nada en el servidor; con
+ * -c "STOP 999999" o -c "START sleep 1" se mide el caso de un script que
+ * detiene o lanza un lote de procesos. Con la demora de 40 ms de Nagle y
+ * ACK retrasado en cada ida y vuelta, la diferencia crece aún más en una
+ * red real que en loopback.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#define HEADER_SIZE 8
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static int connect_to(int port)
+{
+    struct sockaddr_in addr;
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)
+        return -1;
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static int recv_all(int fd, void *buf, size_t len)
+{
+    for (size_t got = 0; got < len; ) {
+        ssize_t n = recv(fd, (char *)buf + got, len - got, 0);
+        if (n <= 0)
+            return -1;
+        got += (size_t)n;
+    }
+    return 0;
+}
+
+static int send_all(int fd, const void *buf, size_t len)
+{
+    for (size_t sent = 0; sent < len; ) {
+        ssize_t n = send(fd, (const char *)buf + sent, len - sent, 0);
+        if (n <= 0)
+            return -1;
+        sent += (size_t)n;
+    }
+    return 0;
+}
+
+/* Negocia FRAMED en modo bloqueante. */
+static int negotiate(int fd)
+{
+    char c;
+    if (send(fd, "FRAMED\n", 7, 0) != 7)
+        return -1;
+    do {
+        if (recv(fd, &c, 1, 0) != 1)
+            return -1;
+    } while (c != '\n');
+    return 0;
+}
+
+/* Escribe cmd como frame de comando en p. Retorna los bytes escritos. */
+static size_t put_frame(unsigned char *p, const char *cmd)
+{
+    size_t len = strlen(cmd);
+    p[0] = (unsigned char)(len >> 24);
+    p[1] = (unsigned char)(len >> 16);
+    p[2] = (unsigned char)(len >> 8);
+    p[3] = (unsigned char)len;
+    p[4] = 1;
+    p[5] = p[6] = p[7] = 0;
+    memcpy(p + HEADER_SIZE, cmd, len);
+    return HEADER_SIZE + len;
+}
+
+/*
+ * Lee una respuesta completa (saltando eventos). Si body no es NULL deja
+ * ahí el último frame, terminado en '\0'. Retorna 0 si OK.
+ */
+static int recv_reply(int fd, char *body, size_t cap)
+{
+    static char scratch[1 << 16];
+    unsigned char hdr[HEADER_SIZE];
+
+    for (;;) {
+        if (recv_all(fd, hdr, HEADER_SIZE) != 0)
+            return -1;
+        size_t blen = ((size_t)hdr[0] << 24) | ((size_t)hdr[1] << 16) |
+                      ((size_t)hdr[2] << 8) | hdr[3];
+        char *dst = body && blen < cap ? body : scratch;
+        if (blen >= sizeof(scratch) && dst == scratch)
+            return -1;
+        if (recv_all(fd, dst, blen) != 0)
+            return -1;
+        dst[blen] = '\0';
+        if (hdr[4] != 3 && !(hdr[5] & 1))
+            return 0;
+    }
+}
+
+/* Suma la columna ENVIOS de la fila TOTAL de STATS. */
+static long server_sends(int fd)
+{
+    unsigned char req[64];
+    char body[1 << 16];
+    unsigned long conn, acc, req_count, sends;
+
+    if (send_all(fd, req, put_frame(req, "STATS")) != 0 || recv_reply(fd, body, sizeof(body)) != 0)
+        return -1;
+    const char *total = strstr(body, "TOTAL");
+    if (!total || sscanf(total, "TOTAL %lu %lu %lu %lu", &conn, &acc, &req_count, &sends) != 4)
+        return -1;
+    return (long)sends;
+}
+
+/* N comandos de a uno. Retorna ms o -1 en error. */
+static double run_sequential(int fd, const char *cmd, int count)
+{
+    unsigned char req[HEADER_SIZE + 1100];
+    size_t len = put_frame(req, cmd);
+
+    double t0 = now_ms();
+    for (int i = 0; i < count; i++) {
+        if (send_all(fd, req, len) != 0 || recv_reply(fd, NULL, 0) != 0)
+            return -1;
+    }
+    return now_ms() - t0;
+}
+
+/* N comandos en un solo send, luego las N respuestas. Retorna ms o -1. */
+static double run_pipelined(int fd, const char *cmd, int count)
+{
+    size_t one = HEADER_SIZE + strlen(cmd);
+    unsigned char *batch = malloc(one * (size_t)count);
+    size_t len = 0;
+
+    for (int i = 0; i < count; i++)
+        len += put_frame(batch + len, cmd);
+
+    double t0 = now_ms();
+    int ok = send_all(fd, batch, len) == 0;
+    for (int i = 0; ok && i < count; i++)
+        ok = recv_reply(fd, NULL, 0) == 0;
+    double elapsed = now_ms() - t0;
+    free(batch);
+    return ok ? elapsed : -1;
+}
+
+int main(int argc, char **argv)
+{
+    int port = 5002, count = 100, rounds = 20, opt;
+    const char *cmd = "STATUS 1";
+
+    while ((opt = getopt(argc, argv, "p:n:r:c:")) != -1) {
+        switch (opt) {
+        case 'p': port = atoi(optarg); break;
+        case 'n': count = atoi(optarg); break;
+        case 'r': rounds = atoi(optarg); break;
+        case 'c': cmd = optarg; break;
+        default:
+            fprintf(stderr, "uso: %s [-p puerto] [-n comandos] [-r repeticiones] "
+                            "[-c comando]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (count < 1 || rounds < 1 || strlen(cmd) > 1000)
+        return 1;
+
+    int fd = connect_to(port);
+    if (fd < 0 || negotiate(fd) != 0) {
+        perror("connect");
+        return 1;
+    }
+
+    printf("=== Benchmark de encadenado: %d x '%s', %d repeticiones ===\n",
+           count, cmd, rounds);
+    printf("%-12s %10s %10s %12s %14s\n", "modo", "ms/lote", "ms/cmd", "cmd/s", "sendmsg/lote");
+
+    for (int mode = 0; mode < 2; mode++) {
+        long before = server_sends(fd);
+        double total = 0;
+        for (int r = 0; r < rounds; r++) {
+            double ms = mode ? run_pipelined(fd, cmd, count) : run_sequential(fd, cmd, count);
+            if (ms < 0) {
+                fprintf(stderr, "conexion cerrada por el servidor\n");
+                return 1;
+            }
+            total += ms;
+        }
+        /* La consulta de STATS también cuenta un envío */
+        long sends = server_sends(fd) - before - 1;
+        double per_batch = total / rounds;
+        printf("%-12s %10.3f %10.4f %12.0f %14.1f\n",
+               mode ? "encadenado" : "secuencial", per_batch, per_batch / count,
+               count * 1000.0 / per_batch, before < 0 ? -1.0 : (double)sends / rounds);
+    }
+    close(fd);
+    return 0;
+}
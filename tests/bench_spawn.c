@@ -0,0 +1,165 @@
+/**
+ * Benchmark de lanzamiento: fork()+execvp() vs spawner_run() (posix_spawnp).
+ *
+ * Para cada tamaño de memoria residente (por defecto 64, 512 y 2048 MB)
+ * reserva y toca esa memoria, y lanza `true` repetidas veces con ambos
+ * métodos. Los dos esperan a que el exec termine (fork usa el mismo pipe
+ * con O_CLOEXEC que tenía el servidor), así que miden lo mismo: el tiempo
+ * hasta poder responder al START. Reporta la latencia media y p99 por
+ * lanzamiento y los lanzamientos por segundo.
+ *
+ * Compilar:
+ *   gcc -O2 -Wall -Isrc/server -o tests/bench_spawn tests/bench_spawn.c \
+ *       src/server/spawner.c
+ * Uso:
+ *   ./tests/bench_spawn [iteraciones] [MB...]
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/wait.h>
+#include <sys/mman.h>
+
+#include "spawner.h"
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static long rss_kb(void)
+{
+    char line[256];
+    long kb = -1;
+    FILE *fp = fopen("/proc/self/status", "r");
+    if (!fp)
+        return -1;
+    while (fgets(line, sizeof(line), fp))
+        if (sscanf(line, "VmRSS: %ld", &kb) == 1)
+            break;
+    fclose(fp);
+    return kb;
+}
+
+/* Lo que hacía start_process() antes de spawner_run(). */
+static int fork_run(char *const argv[], pid_t *pid)
+{
+    int status_pipe[2], err = 0;
+    int devnull = open("/dev/null", O_WRONLY | O_CLOEXEC);
+
+    if (pipe2(status_pipe, O_CLOEXEC) < 0)
+        return errno;
+
+    *pid = fork();
+    if (*pid == 0) {
+        dup2(devnull, STDOUT_FILENO);
+        dup2(devnull, STDERR_FILENO);
+        execvp(argv[0], argv);
+        err = errno;
+        if (write(status_pipe[1], &err, sizeof(err)) < 0) {
+            /* El padre verá EOF */
+        }
+        _exit(127);
+    }
+    close(status_pipe[1]);
+    close(devnull);
+    if (*pid < 0) {
+        close(status_pipe[0]);
+        return errno;
+    }
+    if (read(status_pipe[0], &err, sizeof(err)) != (ssize_t)sizeof(err))
+        err = 0;
+    close(status_pipe[0]);
+    return err;
+}
+
+static int spawn_run(char *const argv[], pid_t *pid)
+{
+    return spawner_run(argv, 0, pid);
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/* Lanza `iterations` veces y escribe media y p99 en ms. Retorna lanzamientos/s. */
+static double measure(int (*run)(char *const[], pid_t *), int iterations,
+                      double *mean, double *p99)
+{
+    char *argv[] = {"true", NULL};
+    double *lat = malloc(sizeof(double) * (size_t)iterations);
+    double total = 0;
+    pid_t pid;
+
+    double t0 = now_ms();
+    for (int i = 0; i < iterations; i++) {
+        double s = now_ms();
+        if (run(argv, &pid) != 0) {
+            perror("spawn");
+            break;
+        }
+        lat[i] = now_ms() - s;
+        total += lat[i];
+        waitpid(pid, NULL, 0);
+    }
+    double elapsed = now_ms() - t0;
+
+    qsort(lat, (size_t)iterations, sizeof(double), cmp_double);
+    *mean = total / iterations;
+    *p99 = lat[(int)(iterations * 0.99)];
+    free(lat);
+    return iterations * 1000.0 / elapsed;
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = 200;
+    int sizes[16] = {64, 512, 2048};
+    int nsizes = 3;
+
+    if (argc > 1)
+        iterations = atoi(argv[1]);
+    if (argc > 2) {
+        nsizes = 0;
+        for (int i = 2; i < argc && nsizes < 16; i++)
+            sizes[nsizes++] = atoi(argv[i]);
+    }
+    if (iterations < 1)
+        return 1;
+
+    printf("=== Benchmark de lanzamiento: fork vs posix_spawn (%d iteraciones) ===\n",
+           iterations);
+    printf("%9s  %9s %9s %9s  %9s %9s %9s\n", "RSS MB",
+           "fork ms", "fork p99", "fork/s", "spawn ms", "spawn p99", "spawn/s");
+
+    for (int s = 0; s < nsizes; s++) {
+        size_t bytes = (size_t)sizes[s] << 20;
+        char *mem = mmap(NULL, bytes, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mem == MAP_FAILED) {
+            perror("mmap");
+            break;
+        }
+        memset(mem, 1, bytes); /* Tocar cada página para que cuente en el RSS */
+
+        double fork_mean, fork_p99, spawn_mean, spawn_p99;
+        double fork_rate = measure(fork_run, iterations, &fork_mean, &fork_p99);
+        double spawn_rate = measure(spawn_run, iterations, &spawn_mean, &spawn_p99);
+
+        printf("%9ld  %9.3f %9.3f %9.0f  %9.3f %9.3f %9.0f\n",
+               rss_kb() / 1024, fork_mean, fork_p99, fork_rate,
+               spawn_mean, spawn_p99, spawn_rate);
+        munmap(mem, bytes);
+    }
+    return 0;
+}
@@ -0,0 +1,229 @@
+/**
+ * Benchmark de START: latencia de lanzar procesos a través del servidor.
+ *
+ * Abre una o más conexiones en modo FRAMED y cada una envía START de
+ * forma secuencial, como haría un script que lanza un lote de trabajos,
+ * midiendo desde el envío hasta la respuesta completa. Reporta p50/p99/
+ * máxima y lanzamientos por segundo, primero con un comando válido y
+ * luego con uno inexistente (el error de exec debe llegar igual de rápido
+ * que el éxito). Con varias conexiones (-a) mide la tasa sostenida.
+ *
+ * Compilar:
+ *   gcc -O2 -Wall -pthread -o tests/bench_start tests/bench_start.c
+ * Uso:
+ *   ./tests/bench_start [-p puerto] [-a conexiones] [-n lanzamientos]
+ *                       [-c comando]
+ *
+ * Con la confirmación por sleep de 100 ms cada START tardaba al menos
+ * ese tiempo; para comparar basta con correr la prueba contra ese binario.
+ * El comando por defecto (sleep 1) sigue vivo al responder: uno que
+ * termina enseguida interrumpe ese sleep con SIGCHLD y falsea la medida.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#define HEADER_SIZE 8
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static int connect_to(int port)
+{
+    struct sockaddr_in addr;
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)
+        return -1;
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static int recv_all(int fd, void *buf, size_t len)
+{
+    for (size_t got = 0; got < len; ) {
+        ssize_t n = recv(fd, (char *)buf + got, len - got, 0);
+        if (n <= 0)
+            return -1;
+        got += (size_t)n;
+    }
+    return 0;
+}
+
+/* Negocia FRAMED en modo bloqueante. */
+static int negotiate(int fd)
+{
+    char c;
+    if (send(fd, "FRAMED\n", 7, 0) != 7)
+        return -1;
+    do {
+        if (recv(fd, &c, 1, 0) != 1)
+            return -1;
+    } while (c != '\n');
+    return 0;
+}
+
+/*
+ * Envía un comando y lee la respuesta completa. Guarda el PID si la
+ * respuesta es un éxito ("... con PID n"). Retorna 0 si OK.
+ */
+static int roundtrip(int fd, const char *cmd, int *pid)
+{
+    size_t len = strlen(cmd);
+    unsigned char hdr[HEADER_SIZE], req[HEADER_SIZE + 1100];
+    char body[4096];
+    int last = 0;
+
+    if (len > sizeof(req) - HEADER_SIZE)
+        return -1;
+    req[0] = (unsigned char)(len >> 24);
+    req[1] = (unsigned char)(len >> 16);
+    req[2] = (unsigned char)(len >> 8);
+    req[3] = (unsigned char)len;
+    req[4] = 1;
+    req[5] = req[6] = req[7] = 0;
+    memcpy(req + HEADER_SIZE, cmd, len);
+    /* En un solo send: con dos, Nagle retrasa el cuerpo hasta el ACK */
+    if (send(fd, req, HEADER_SIZE + len, 0) != (ssize_t)(HEADER_SIZE + len))
+        return -1;
+
+    *pid = 0;
+    while (!last) {
+        if (recv_all(fd, hdr, HEADER_SIZE) != 0)
+            return -1;
+        size_t blen = ((size_t)hdr[0] << 24) | ((size_t)hdr[1] << 16) |
+                      ((size_t)hdr[2] << 8) | hdr[3];
+        last = !(hdr[5] & 1);
+        if (blen >= sizeof(body))
+            return -1;
+        if (recv_all(fd, body, blen) != 0)
+            return -1;
+        body[blen] = '\0';
+        const char *p = strstr(body, "con PID ");
+        if (p)
+            *pid = atoi(p + 8);
+    }
+    return 0;
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+typedef struct {
+    int port;
+    const char *cmd;
+    int count;
+    double *lat;            /* count latencias de esta conexión */
+    int done;
+    int started;
+} Worker;
+
+static void *worker_run(void *arg)
+{
+    Worker *w = arg;
+    int pid;
+
+    int fd = connect_to(w->port);
+    if (fd < 0 || negotiate(fd) != 0) {
+        perror("connect");
+        return NULL;
+    }
+    for (; w->done < w->count; w->done++) {
+        double s = now_ms();
+        if (roundtrip(fd, w->cmd, &pid) != 0) {
+            fprintf(stderr, "conexion cerrada por el servidor\n");
+            break;
+        }
+        w->lat[w->done] = now_ms() - s;
+        if (pid > 0)
+            w->started++;
+    }
+    close(fd);
+    return NULL;
+}
+
+static void run(int port, int active, const char *label, const char *cmd, int count)
+{
+    Worker *workers = calloc((size_t)active, sizeof(Worker));
+    pthread_t *threads = calloc((size_t)active, sizeof(pthread_t));
+    double *lat = malloc(sizeof(double) * (size_t)active * (size_t)count);
+    int done = 0, started = 0;
+
+    double t0 = now_ms();
+    for (int i = 0; i < active; i++) {
+        workers[i].port = port;
+        workers[i].cmd = cmd;
+        workers[i].count = count;
+        workers[i].lat = lat + (size_t)i * (size_t)count;
+        pthread_create(&threads[i], NULL, worker_run, &workers[i]);
+    }
+    for (int i = 0; i < active; i++) {
+        pthread_join(threads[i], NULL);
+        /* Compactar las latencias medidas al principio del arreglo */
+        memmove(lat + done, workers[i].lat, sizeof(double) * (size_t)workers[i].done);
+        done += workers[i].done;
+        started += workers[i].started;
+    }
+    double elapsed = now_ms() - t0;
+
+    qsort(lat, (size_t)done, sizeof(double), cmp_double);
+    printf("%-10s %8d %8d %9.3f %9.3f %9.3f %9.0f\n", label, done, started,
+           done ? lat[done / 2] : 0.0,
+           done ? lat[(int)(done * 0.99)] : 0.0,
+           done ? lat[done - 1] : 0.0,
+           elapsed > 0 ? done * 1000.0 / elapsed : 0.0);
+    free(lat);
+    free(threads);
+    free(workers);
+}
+
+int main(int argc, char **argv)
+{
+    int port = 5002, active = 1, count = 200, opt;
+    const char *command = "sleep 1";
+    char cmd[1100];
+
+    while ((opt = getopt(argc, argv, "p:a:n:c:")) != -1) {
+        switch (opt) {
+        case 'p': port = atoi(optarg); break;
+        case 'a': active = atoi(optarg); break;
+        case 'n': count = atoi(optarg); break;
+        case 'c': command = optarg; break;
+        default:
+            fprintf(stderr, "uso: %s [-p puerto] [-a conexiones] [-n lanzamientos] "
+                            "[-c comando]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (active < 1 || count < 1)
+        return 1;
+
+    printf("=== Benchmark START: %d conexiones x %d lanzamientos secuenciales ===\n",
+           active, count);
+    printf("%-10s %8s %8s %9s %9s %9s %9s\n", "caso", "START", "exitos",
+           "p50 ms", "p99 ms", "max ms", "START/s");
+
+    snprintf(cmd, sizeof(cmd), "START %s", command);
+    run(port, active, "valido", cmd, count);
+    run(port, active, "invalido", "START comando_que_no_existe", count);
+    return 0;
+}
@@ -0,0 +1,166 @@
+/**
+ * Benchmark de la codificación de tablas: texto de LIST LONG vs binario
+ * (ENCODING BINARY, ver src/server/wire.h).
+ *
+ * Para cada tamaño de tabla (por defecto 1000, 10000 y 50000 procesos)
+ * arma una tabla sintética con nombres como los de un host real (muchos
+ * kworker, bash, sleep, nginx...) y PIDs crecientes con huecos, y mide:
+ * bytes por proceso de cada formato, tiempo de formateo/codificación en
+ * el servidor y tiempo de parseo/decodificación en el cliente.
+ *
+ * Compilar:
+ *   gcc -O2 -Wall -Isrc/server -Isrc/client -o tests/bench_wire tests/bench_wire.c \
+ *       src/server/procscan.c src/server/respbuf.c src/server/proto.c src/server/wire.c \
+ *       src/client/process.c src/client/panels.c src/client/colors.c -lncurses
+ * Uso:
+ *   ./tests/bench_wire [iteraciones] [tamaño...]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "procscan.h"
+#include "wire.h"
+#include "process.h"
+
+static const char *common_names[] = {
+    "bash", "sleep", "nginx", "postgres", "sshd", "python3", "node", "java",
+    "systemd", "containerd-shim", "kthreadd", "rcu_preempt", "ksoftirqd/0",
+};
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+/* Tabla sintética de n procesos ordenada por PID. */
+static void build_table(ProcTable *table, int n)
+{
+    int pid = 1;
+
+    table->entries = calloc((size_t)n, sizeof(ProcInfo));
+    table->count = n;
+    table->capacity = n;
+    srand(1234);
+
+    for (int i = 0; i < n; i++) {
+        ProcInfo *e = &table->entries[i];
+
+        pid += 1 + (rand() % 8 == 0 ? rand() % 50 : 0);
+        e->pid = pid;
+        e->ppid = 1;
+        if (rand() % 3 == 0)
+            snprintf(e->comm, sizeof(e->comm), "kworker/%d:%d-events", rand() % 64, rand() % 4);
+        else
+            snprintf(e->comm, sizeof(e->comm), "%s",
+                     common_names[rand() % (sizeof(common_names) / sizeof(common_names[0]))]);
+        e->state = "SSSRDI"[rand() % 6];
+        e->threads = 1 + rand() % 16;
+        e->uid = rand() % 4 ? 0 : 1000 + rand() % 10;
+        e->rss_kb = rand() % 4 ? rand() % 200000 : 0;
+        e->start_time = 1700000000 + rand() % 86400;
+        e->cpu_tenths = rand() % 10 ? 0 : rand() % 1000;
+    }
+}
+
+/* Copia lineal de la respuesta (con los bytes compartidos) terminada en '\0'. */
+static char *flatten(RespBuf *rb, size_t *len)
+{
+    struct iovec iov[64];
+    size_t total = respbuf_total(rb), off = 0;
+    char *out = malloc(total + 1);
+
+    while (off < total) {
+        int n = respbuf_iov(rb, off, iov, 64);
+        for (int i = 0; i < n; i++) {
+            memcpy(out + off, iov[i].iov_base, iov[i].iov_len);
+            off += iov[i].iov_len;
+        }
+    }
+    out[total] = '\0';
+    *len = total;
+    return out;
+}
+
+static void run(int n, int iterations)
+{
+    ProcTable table;
+    build_table(&table, n);
+
+    /* Servidor: formatear texto y codificar binario */
+    double t0 = now_ms();
+    size_t text_len = 0;
+    char *text = NULL;
+    for (int i = 0; i < iterations; i++) {
+        RespBuf rb;
+        respbuf_init(&rb);
+        procscan_format_long(&table, 7, &rb);
+        free(text);
+        text = flatten(&rb, &text_len);
+        respbuf_free(&rb);
+    }
+    double format_ms = (now_ms() - t0) / iterations;
+
+    t0 = now_ms();
+    size_t bin_len = 0;
+    char *bin = NULL;
+    for (int i = 0; i < iterations; i++) {
+        free(bin);
+        wire_encode_table(&table, 1, 1, &bin, &bin_len);
+    }
+    double encode_ms = (now_ms() - t0) / iterations;
+
+    /* Cliente: parsear texto y decodificar binario */
+    t0 = now_ms();
+    for (int i = 0; i < iterations; i++) {
+        ProcessList list;
+        process_list_parse(text, &list);
+        process_list_free(&list);
+    }
+    double parse_ms = (now_ms() - t0) / iterations;
+
+    t0 = now_ms();
+    int decoded = 0;
+    for (int i = 0; i < iterations; i++) {
+        ProcessList list;
+        unsigned long gen;
+        int offset, total;
+        if (process_list_decode(bin, bin_len, &list, &gen, &offset, &total) == 0)
+            decoded = list.count;
+        process_list_free(&list);
+    }
+    double decode_ms = (now_ms() - t0) / iterations;
+
+    printf("%7d procesos | texto %8zu B (%5.1f B/proc) formato %7.3f ms parseo %7.3f ms\n"
+           "                | binario %6zu B (%5.1f B/proc) codif. %7.3f ms decodif. %6.3f ms"
+           "  (%.0f%% del tamaño, parseo x%.1f)%s\n",
+           n, text_len, (double)text_len / n, format_ms, parse_ms,
+           bin_len, (double)bin_len / n, encode_ms, decode_ms,
+           100.0 * bin_len / text_len, parse_ms / decode_ms,
+           decoded == n ? "" : "  ERROR: decodificacion incompleta");
+
+    free(text);
+    free(bin);
+    free(table.entries);
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = argc > 1 ? atoi(argv[1]) : 20;
+    static const int default_sizes[] = { 1000, 10000, 50000 };
+
+    if (iterations < 1)
+        iterations = 1;
+    if (argc > 2) {
+        for (int i = 2; i < argc; i++)
+            run(atoi(argv[i]), iterations);
+    } else {
+        for (int i = 0; i < 3; i++)
+            run(default_sizes[i], iterations);
+    }
+    return 0;
+}
@@ -0,0 +1,278 @@
+/**
+ * Prueba de carga del servidor: conexiones inactivas + conexiones activas.
+ *
+ * Para cada cantidad de conexiones inactivas (por defecto 1000 y 10000)
+ * abre ese número de sockets que no envían nada, y luego un grupo de
+ * conexiones activas en modo FRAMED que envían comandos en bucle. Reporta
+ * la memoria residente del servidor en KB (VmRSS) antes, con las conexiones
+ * inactivas abiertas y bajo carga, y la latencia p50/p99/máxima y el
+ * throughput de los comandos.
+ *
+ * Compilar:
+ *   gcc -O2 -Wall -o tests/load_test tests/load_test.c
+ * Uso:
+ *   ./tests/load_test -s <pid_servidor> [-p puerto] [-a activas]
+ *                     [-n comandos_por_conexion] [-c comando] [inactivas...]
+ *
+ * Para comparar con el servidor de un hilo por cliente basta con correr
+ * la misma prueba contra ese binario.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+
+#define HEADER_SIZE 8
+
+typedef struct {
+    int fd;
+    int remaining;          /* Comandos que faltan por enviar */
+    double sent_at;         /* Momento del envío en curso (ms) */
+    unsigned char hdr[HEADER_SIZE];
+    size_t hdr_got;
+    size_t body_left;
+    int last_frame;
+} Client;
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static long server_rss_kb(int pid)
+{
+    char path[64], line[256];
+    long kb = -1;
+    snprintf(path, sizeof(path), "/proc/%d/status", pid);
+    FILE *fp = fopen(path, "r");
+    if (!fp)
+        return -1;
+    while (fgets(line, sizeof(line), fp))
+        if (sscanf(line, "VmRSS: %ld", &kb) == 1)
+            break;
+    fclose(fp);
+    return kb;
+}
+
+static int connect_to(int port)
+{
+    struct sockaddr_in addr;
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)
+        return -1;
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/* Negocia FRAMED en modo bloqueante. */
+static int negotiate(int fd)
+{
+    char c;
+    if (send(fd, "FRAMED\n", 7, 0) != 7)
+        return -1;
+    do {
+        if (recv(fd, &c, 1, 0) != 1)
+            return -1;
+    } while (c != '\n');
+    return 0;
+}
+
+static void send_cmd(Client *cl, const char *cmd)
+{
+    size_t len = strlen(cmd);
+    unsigned char buf[HEADER_SIZE + 512];
+    buf[0] = (unsigned char)(len >> 24);
+    buf[1] = (unsigned char)(len >> 16);
+    buf[2] = (unsigned char)(len >> 8);
+    buf[3] = (unsigned char)len;
+    buf[4] = 1;
+    buf[5] = buf[6] = buf[7] = 0;
+    memcpy(buf + HEADER_SIZE, cmd, len);
+    cl->sent_at = now_ms();
+    cl->hdr_got = 0;
+    cl->body_left = 0;
+    cl->last_frame = 0;
+    if (send(cl->fd, buf, HEADER_SIZE + len, 0) < 0)
+        perror("send");
+}
+
+/* Consume bytes de la respuesta. Retorna 1 cuando llegó el último frame. */
+static int consume(Client *cl)
+{
+    char buf[65536];
+    ssize_t n = recv(cl->fd, buf, sizeof(buf), 0);
+    if (n < 0 && errno == EAGAIN)
+        return 0;
+    if (n <= 0)
+        return -1;
+
+    for (ssize_t off = 0; off < n; ) {
+        if (cl->hdr_got < HEADER_SIZE) {
+            cl->hdr[cl->hdr_got++] = (unsigned char)buf[off++];
+            if (cl->hdr_got == HEADER_SIZE) {
+                cl->body_left = ((size_t)cl->hdr[0] << 24) | ((size_t)cl->hdr[1] << 16) |
+                                ((size_t)cl->hdr[2] << 8) | cl->hdr[3];
+                cl->last_frame = !(cl->hdr[5] & 1);
+            }
+        } else {
+            size_t take = (size_t)(n - off) < cl->body_left ? (size_t)(n - off)
+                                                            : cl->body_left;
+            off += (ssize_t)take;
+            cl->body_left -= take;
+        }
+        if (cl->hdr_got == HEADER_SIZE && cl->body_left == 0) {
+            if (cl->last_frame)
+                return 1;
+            cl->hdr_got = 0;
+        }
+    }
+    return 0;
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+int main(int argc, char **argv)
+{
+    int port = 5002, server_pid = 0, active = 50, per_conn = 200;
+    const char *cmd = "LIST";
+    int idle_sizes[16] = {1000, 10000};
+    int nsizes = 2;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "p:s:a:n:c:")) != -1) {
+        switch (opt) {
+        case 'p': port = atoi(optarg); break;
+        case 's': server_pid = atoi(optarg); break;
+        case 'a': active = atoi(optarg); break;
+        case 'n': per_conn = atoi(optarg); break;
+        case 'c': cmd = optarg; break;
+        default:
+            fprintf(stderr, "uso: %s -s pid [-p puerto] [-a activas] "
+                            "[-n comandos] [-c comando] [inactivas...]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (optind < argc) {
+        nsizes = 0;
+        for (int i = optind; i < argc && nsizes < 16; i++)
+            idle_sizes[nsizes++] = atoi(argv[i]);
+    }
+
+    struct rlimit rl;
+    getrlimit(RLIMIT_NOFILE, &rl);
+    rl.rlim_cur = rl.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &rl);
+
+    printf("=== Prueba de carga: %d activas x %d comandos '%s' ===\n",
+           active, per_conn, cmd);
+    printf("%9s %11s %11s %11s %9s %9s %9s %9s\n", "inactivas", "RSS base",
+           "RSS inact.", "RSS carga", "p50 ms", "p99 ms", "max ms", "req/s");
+
+    for (int s = 0; s < nsizes; s++) {
+        int idle = idle_sizes[s];
+        long rss_base = server_pid ? server_rss_kb(server_pid) : -1;
+
+        int *idle_fds = malloc(sizeof(int) * (size_t)idle);
+        int opened = 0;
+        for (; opened < idle; opened++) {
+            idle_fds[opened] = connect_to(port);
+            if (idle_fds[opened] < 0) {
+                perror("connect (inactiva)");
+                break;
+            }
+        }
+
+        usleep(200000); /* Dar tiempo al servidor para aceptarlas todas */
+        long rss_idle = server_pid ? server_rss_kb(server_pid) : -1;
+
+        Client *clients = calloc((size_t)active, sizeof(Client));
+        int ep = epoll_create1(0);
+        for (int i = 0; i < active; i++) {
+            clients[i].fd = connect_to(port);
+            if (clients[i].fd < 0 || negotiate(clients[i].fd) != 0) {
+                perror("connect (activa)");
+                return 1;
+            }
+            fcntl(clients[i].fd, F_SETFL, O_NONBLOCK);
+            struct epoll_event ev = { .events = EPOLLIN, .data.ptr = &clients[i] };
+            epoll_ctl(ep, EPOLL_CTL_ADD, clients[i].fd, &ev);
+            clients[i].remaining = per_conn;
+        }
+
+        size_t total = (size_t)active * (size_t)per_conn, done = 0;
+        double *lat = malloc(sizeof(double) * total);
+        double t0 = now_ms();
+
+        for (int i = 0; i < active; i++) {
+            clients[i].remaining--;
+            send_cmd(&clients[i], cmd);
+        }
+
+        struct epoll_event events[256];
+        while (done < total) {
+            int n = epoll_wait(ep, events, 256, 5000);
+            if (n <= 0) {
+                fprintf(stderr, "timeout esperando respuestas\n");
+                break;
+            }
+            for (int i = 0; i < n; i++) {
+                Client *cl = events[i].data.ptr;
+                int r = consume(cl);
+                if (r < 0) {
+                    fprintf(stderr, "conexion cerrada por el servidor\n");
+                    done = total;
+                    break;
+                }
+                if (r == 1) {
+                    lat[done++] = now_ms() - cl->sent_at;
+                    if (cl->remaining > 0) {
+                        cl->remaining--;
+                        send_cmd(cl, cmd);
+                    }
+                }
+            }
+        }
+        double elapsed = now_ms() - t0;
+        long rss_load = server_pid ? server_rss_kb(server_pid) : -1;
+
+        qsort(lat, done, sizeof(double), cmp_double);
+        printf("%9d %11ld %11ld %11ld %9.3f %9.3f %9.3f %9.0f\n",
+               opened, rss_base, rss_idle, rss_load,
+               done ? lat[done / 2] : 0.0,
+               done ? lat[(size_t)(done * 0.99)] : 0.0,
+               done ? lat[done - 1] : 0.0,
+               done * 1000.0 / elapsed);
+
+        for (int i = 0; i < active; i++)
+            close(clients[i].fd);
+        for (int i = 0; i < opened; i++)
+            close(idle_fds[i]);
+        close(ep);
+        free(clients);
+        free(idle_fds);
+        free(lat);
+        sleep(1); /* Dejar que el servidor cierre las conexiones */
+    }
+    return 0;
+}
@@ -0,0 +1,337 @@
+/**
+ * Property-based test for the LZ codec of COMPRESS (Property 8).
+ *
+ * **Validates: Requirements 4.1**
+ *
+ * Property 8: Compresion de mensajes (COMPRESS LZ)
+ *   - For any input (random bytes, process listings, long runs, empty),
+ *     net_decompress_block(compress_block(x)) == x and the compressed
+ *     block never exceeds compress_bound(len).
+ *   - Repetitive tables (the LIST case) shrink.
+ *   - A truncated block is rejected (unless only the empty final token
+ *     was cut), and a block with corrupted bytes is rejected or decoded
+ *     without writing outside the destination buffer.
+ *
+ * The test embeds the encoder (src/server/compress.c) and the decoder
+ * (src/client/net.c) directly so it builds without the server or ncurses.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+/* ── Embedded encoder (src/server/compress.c) ──────────────────────── */
+
+#define HASH_BITS   13
+#define MIN_MATCH   4
+#define MAX_OFFSET  65535
+
+static uint32_t read32(const unsigned char *p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static unsigned int hash4(uint32_t v)
+{
+    return (v * 2654435761u) >> (32 - HASH_BITS);
+}
+
+/* Resto de un largo cuyo nibble quedó en 15. */
+static unsigned char *put_length(unsigned char *p, size_t n)
+{
+    while (n >= 255) {
+        *p++ = 255;
+        n -= 255;
+    }
+    *p++ = (unsigned char)n;
+    return p;
+}
+
+/* Escribe una secuencia: literales y, si match_len > 0, el match. */
+static unsigned char *put_sequence(unsigned char *p, const unsigned char *lit, size_t nlit,
+                                   size_t match_len, size_t offset)
+{
+    size_t extra = match_len ? match_len - MIN_MATCH : 0;
+    unsigned char *token = p++;
+
+    *token = (unsigned char)((nlit < 15 ? nlit : 15) << 4 | (extra < 15 ? extra : 15));
+    if (nlit >= 15)
+        p = put_length(p, nlit - 15);
+    memcpy(p, lit, nlit);
+    p += nlit;
+    if (match_len == 0)
+        return p;
+
+    *p++ = (unsigned char)offset;
+    *p++ = (unsigned char)(offset >> 8);
+    if (extra >= 15)
+        p = put_length(p, extra - 15);
+    return p;
+}
+
+static size_t compress_bound(size_t len)
+{
+    return len + len / 255 + 16;
+}
+
+static size_t compress_block(const unsigned char *src, size_t len, unsigned char *dst)
+{
+    uint32_t table[1 << HASH_BITS];
+    unsigned char *p = dst;
+    size_t anchor = 0, i = 0;
+
+    memset(table, 0, sizeof(table));
+    while (i + MIN_MATCH <= len) {
+        uint32_t v = read32(src + i);
+        unsigned int h = hash4(v);
+        size_t cand = table[h];
+
+        table[h] = (uint32_t)i;
+        if (cand < i && i - cand <= MAX_OFFSET && read32(src + cand) == v) {
+            size_t n = MIN_MATCH;
+            while (i + n < len && src[cand + n] == src[i + n])
+                n++;
+            p = put_sequence(p, src + anchor, i - anchor, n, i - cand);
+            i += n;
+            anchor = i;
+        } else {
+            /* Sin matches hace tiempo: saltar más rápido sobre lo incompresible */
+            i += 1 + ((i - anchor) >> 6);
+        }
+    }
+    return (size_t)(put_sequence(p, src + anchor, len - anchor, 0, 0) - dst);
+}
+
+/* ── Embedded decoder (src/client/net.c) ───────────────────────────── */
+
+/* Lee el resto de un largo cuyo nibble quedó en 15. -1 si se corta. */
+static int lz_length(const unsigned char **p, const unsigned char *end, size_t *n) {
+    unsigned char b;
+    do {
+        if (*p >= end) {
+            return -1;
+        }
+        b = *(*p)++;
+        *n += b;
+    } while (b == 255);
+    return 0;
+}
+
+static int net_decompress_block(const unsigned char *src, size_t len,
+                         unsigned char *dst, size_t raw) {
+    const unsigned char *end = src + len;
+    size_t out = 0;
+
+    while (src < end) {
+        unsigned char token = *src++;
+        size_t nlit = token >> 4;
+        size_t mlen = token & 15;
+
+        if (nlit == 15 && lz_length(&src, end, &nlit) != 0) {
+            return -1;
+        }
+        if ((size_t)(end - src) < nlit || raw - out < nlit) {
+            return -1;
+        }
+        memcpy(dst + out, src, nlit);
+        src += nlit;
+        out += nlit;
+        if (src == end) {
+            break; /* La última secuencia solo lleva literales */
+        }
+
+        if (end - src < 2) {
+            return -1;
+        }
+        size_t offset = (size_t)src[0] | ((size_t)src[1] << 8);
+        src += 2;
+        if (mlen == 15 && lz_length(&src, end, &mlen) != 0) {
+            return -1;
+        }
+        mlen += 4;
+        if (offset == 0 || offset > out || raw - out < mlen) {
+            return -1;
+        }
+        if (offset >= mlen) {
+            memcpy(dst + out, dst + out - offset, mlen);
+        } else {
+            /* Byte a byte: el match se solapa con lo que copia (rachas) */
+            for (size_t i = 0; i < mlen; i++) {
+                dst[out + i] = dst[out - offset + i];
+            }
+        }
+        out += mlen;
+    }
+    return out == raw ? 0 : -1;
+}
+
+/* ── Test helpers ───────────────────────────────────────────────────── */
+
+static int tests_run    = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+static int cur_iter = 0;  /* Current iteration for CHECK context */
+
+#define CHECK(cond, fmt, ...)                                       \
+    do {                                                            \
+        tests_run++;                                                \
+        if (cond) {                                                 \
+            tests_passed++;                                         \
+        } else {                                                    \
+            tests_failed++;                                         \
+            fprintf(stderr, "  FAIL [iter=%d]: " fmt "\n",          \
+                    cur_iter, ##__VA_ARGS__);                        \
+        }                                                           \
+    } while (0)
+
+#define NUM_ITERATIONS 300
+#define MAX_INPUT      (200 * 1024)
+
+/* Random int in [lo, hi] inclusive */
+static int rand_range(int lo, int hi)
+{
+    return lo + rand() % (hi - lo + 1);
+}
+
+/* Listado como el de LIST LONG: columnas alineadas y nombres repetidos */
+static size_t gen_listing(unsigned char *buf, size_t max)
+{
+    static const char *names[] = { "bash", "sleep", "nginx", "kworker/0:1-events", "sshd" };
+    size_t len = 0;
+    int pid = 1;
+
+    while (len + 128 < max && rand() % 2000) {
+        pid += rand_range(1, 40);
+        len += (size_t)snprintf((char *)buf + len, max - len,
+                                "%5d %5d %c %3d %9d %5.1f %10d %s\n",
+                                pid, rand() % 4 ? 0 : 1000, "SRDI"[rand() % 4],
+                                rand_range(1, 16), rand() % 200000, (rand() % 100) / 10.0,
+                                1700000000 + rand() % 86400, names[rand() % 5]);
+    }
+    return len;
+}
+
+/* Entradas variadas: azar puro, listados, rachas y mezclas */
+static size_t gen_input(unsigned char *buf, int kind)
+{
+    size_t len = (size_t)rand_range(0, kind == 3 ? 300000 : MAX_INPUT);
+    if (len > MAX_INPUT)
+        len = MAX_INPUT;
+
+    switch (kind) {
+    case 0:
+        for (size_t i = 0; i < len; i++)
+            buf[i] = (unsigned char)rand();
+        return len;
+    case 1:
+        return gen_listing(buf, len + 1);
+    case 2:
+        for (size_t i = 0; i < len; i++)
+            buf[i] = (unsigned char)(rand() % 3 ? 'a' : rand() % 4);
+        return len;
+    default:
+        /* Rachas largas (offsets cercanos y lejanos, largos > 15 + 255) */
+        for (size_t i = 0; i < len; ) {
+            size_t run = (size_t)rand_range(1, 2000);
+            unsigned char c = (unsigned char)rand();
+            for (size_t k = 0; k < run && i < len; k++)
+                buf[i++] = c;
+        }
+        return len;
+    }
+}
+
+/* ── Properties ─────────────────────────────────────────────────────── */
+
+static unsigned char input[MAX_INPUT + 1];
+static unsigned char packed[MAX_INPUT + MAX_INPUT / 255 + 16];
+
+static void test_roundtrip(void)
+{
+    printf("  Property 8a: descomprimir lo comprimido da la entrada\n");
+    for (cur_iter = 0; cur_iter < NUM_ITERATIONS; cur_iter++) {
+        size_t len = gen_input(input, cur_iter % 4);
+        size_t n = compress_block(input, len, packed);
+        unsigned char *out = malloc(len + 1);
+
+        CHECK(n <= compress_bound(len), "%zu bytes -> %zu > bound", len, n);
+        CHECK(net_decompress_block(packed, n, out, len) == 0, "kind %d len %zu: decode failed",
+              cur_iter % 4, len);
+        CHECK(memcmp(out, input, len) == 0, "kind %d len %zu: content differs", cur_iter % 4, len);
+        if (cur_iter % 4 == 1 && len > 1024)
+            CHECK(n < len * 3 / 4, "listing of %zu bytes only compressed to %zu", len, n);
+        free(out);
+    }
+}
+
+static void test_truncated(void)
+{
+    printf("  Property 8b: un bloque truncado se rechaza\n");
+    for (cur_iter = 0; cur_iter < NUM_ITERATIONS; cur_iter++) {
+        size_t len = gen_listing(input, (size_t)rand_range(1, 4096));
+        size_t n = compress_block(input, len, packed);
+        size_t cut = n > 0 ? (size_t)rand() % n : 0;
+        unsigned char *copy = malloc(cut + 1);
+        unsigned char *out = malloc(len + 1);
+
+        /* Copias exactas en el heap: un acceso fuera de rango salta con ASan */
+        memcpy(copy, packed, cut);
+        int res = len == 0 ? -1 : net_decompress_block(copy, cut, out, len);
+        /* Solo puede sobrar el token vacío final, que no agrega bytes */
+        CHECK(res == -1 || (cut == n - 1 && memcmp(out, input, len) == 0),
+              "prefix %zu/%zu accepted", cut, n);
+        CHECK(net_decompress_block(packed, n, out, len + 1) == -1,
+              "accepted with a wrong raw length");
+        free(copy);
+        free(out);
+    }
+}
+
+static void test_corrupted(void)
+{
+    printf("  Property 8c: bytes corruptos no escriben fuera del destino\n");
+    for (cur_iter = 0; cur_iter < NUM_ITERATIONS * 10; cur_iter++) {
+        size_t len = gen_listing(input, (size_t)rand_range(64, 4096));
+        size_t n = compress_block(input, len, packed);
+        unsigned char *out = malloc(len + 1);
+
+        for (int k = rand_range(1, 4); k > 0 && n > 0; k--)
+            packed[rand() % n] = (unsigned char)rand();
+        int res = net_decompress_block(packed, n, out, len);
+        CHECK(res == 0 || res == -1, "unexpected result %d", res);
+        free(out);
+    }
+}
+
+int main(void)
+{
+    unsigned int seed = (unsigned int)time(NULL);
+    srand(seed);
+
+    printf("=== Property 8: Compresion de mensajes ===\n");
+    printf("    Validates: Requirements 4.1\n");
+    printf("    Seed: %u\n\n", seed);
+
+    test_roundtrip();
+    test_truncated();
+    test_corrupted();
+
+    printf("\nResults: %d/%d checks passed", tests_passed, tests_run);
+    if (tests_failed > 0) {
+        printf(" (%d failed)", tests_failed);
+    }
+    printf("\n");
+
+    if (tests_failed == 0) {
+        printf("PASS\n");
+        return 0;
+    } else {
+        printf("FAIL\n");
+        return 1;
+    }
+}
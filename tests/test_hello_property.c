@@ -0,0 +1,360 @@
+/**
+ * Property-based test for HELLO and SUBSCRIBE (Property 17).
+ *
+ * **Validates: Requirements 4.1**
+ *
+ * Property 17: Capacidades negociadas con HELLO
+ *   - For any sequence of HELLO, SUBSCRIBE and UNSUBSCRIBE, the server
+ *     answers with the lower of both versions and exactly the
+ *     capabilities it turned on, FRAMED stays on once negotiated, and
+ *     BINARY, LZ and PUSH only hold in framed mode.
+ *   - SUBSCRIBE is refused unless the last valid HELLO included PUSH, and
+ *     a HELLO without PUSH (for example a downgrade to an older version)
+ *     drops an active subscription; an invalid HELLO changes nothing.
+ *
+ * The test embeds hello() and the capability check of subscribe()
+ * (src/server/main.c) over a minimal connection and response buffer, and
+ * compares them with a model of the negotiation.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <stdarg.h>
+#include <ctype.h>
+#include <errno.h>
+#include <time.h>
+
+/* ── Embedded constants and minimal types ───────────────────────────── */
+
+#define PROTO_VERSION           1       /* src/server/proto.h */
+#define WIRE_VERSION            1       /* src/server/wire.h */
+#define COMPRESS_MIN_DEFAULT    1024    /* src/server/compress.h */
+#define COMPRESS_MIN_FLOOR      64
+
+#define CMD_CONTINUE  0
+#define CMD_FRAMED    2
+
+typedef struct {
+    char data[512];
+    size_t len;
+} RespBuf;
+
+static int respbuf_puts(RespBuf *rb, const char *str)
+{
+    rb->len += (size_t)snprintf(rb->data + rb->len, sizeof(rb->data) - rb->len, "%s", str);
+    return 0;
+}
+
+static int respbuf_printf(RespBuf *rb, const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    rb->len += (size_t)vsnprintf(rb->data + rb->len, sizeof(rb->data) - rb->len, fmt, ap);
+    va_end(ap);
+    return 0;
+}
+
+typedef struct {
+    int framed;
+    int binary;
+    int push;
+    size_t compress_min;
+    int subscribed;
+    unsigned long sub_gen;
+} Conn;
+
+static void reactor_subscribe(Conn *c, unsigned long gen)
+{
+    c->sub_gen = gen;
+    c->subscribed = 1;
+}
+
+static void reactor_unsubscribe(Conn *c)
+{
+    c->subscribed = 0;
+}
+
+/* ── Embedded HELLO and SUBSCRIBE (src/server/main.c) ───────────────── */
+
+static int parse_compress_min(const char *str, size_t *min) {
+    char *end = NULL;
+    long value;
+
+    if (str == NULL || !isdigit((unsigned char)str[0])) {
+        return -1;
+    }
+    errno = 0;
+    value = strtol(str, &end, 10);
+    if (errno != 0 || *end != '\0') {
+        return -1;
+    }
+    *min = value < COMPRESS_MIN_FLOOR ? COMPRESS_MIN_FLOOR : (size_t)value;
+    return 0;
+}
+
+static int hello(Conn *conn, char *arg, RespBuf *out) {
+    char *save_args = NULL;
+    char *ver_str = arg ? strtok_r(arg, " ", &save_args) : NULL;
+    char *caps = ver_str ? strtok_r(NULL, " ", &save_args) : NULL;
+    char *end = NULL;
+    long version = ver_str ? strtol(ver_str, &end, 10) : 0;
+
+    if (ver_str == NULL || *end != '\0' || version < 1 ||
+        strtok_r(NULL, " ", &save_args) != NULL) {
+        respbuf_puts(out, "Error: Uso: HELLO <version> [FRAMED,BINARY,LZ[=<bytes>],PUSH]\n");
+        return CMD_CONTINUE;
+    }
+    if (version > PROTO_VERSION) {
+        version = PROTO_VERSION;
+    }
+
+    int framed = conn->framed, binary = 0, push = 0;
+    size_t lz = 0;
+    char *save = NULL;
+    for (char *cap = caps ? strtok_r(caps, ",", &save) : NULL; cap;
+         cap = strtok_r(NULL, ",", &save)) {
+        if (strcasecmp(cap, "FRAMED") == 0) {
+            framed = 1;
+        } else if (strcasecmp(cap, "BINARY") == 0) {
+            binary = 1;
+        } else if (strcasecmp(cap, "PUSH") == 0) {
+            push = 1;
+        } else if (strcasecmp(cap, "LZ") == 0) {
+            lz = COMPRESS_MIN_DEFAULT;
+        } else if (strncasecmp(cap, "LZ=", 3) == 0) {
+            // Con un umbral inválido, el del servidor
+            if (parse_compress_min(cap + 3, &lz) != 0) {
+                lz = COMPRESS_MIN_DEFAULT;
+            }
+        }
+    }
+
+    // Todo lo demás viaja en frames: sin FRAMED queda en texto, como antes
+    if (!framed) {
+        binary = push = 0;
+        lz = 0;
+    }
+    conn->binary = binary;
+    conn->compress_min = lz;
+    conn->push = push;
+    if (!push) {
+        reactor_unsubscribe(conn);
+    }
+
+    respbuf_printf(out, "OK HELLO %ld", version);
+    if (framed) {
+        respbuf_puts(out, " FRAMED");
+        if (binary) {
+            respbuf_printf(out, ",BINARY=%d", WIRE_VERSION);
+        }
+        if (lz) {
+            respbuf_printf(out, ",LZ=%zu", lz);
+        }
+        if (push) {
+            respbuf_puts(out, ",PUSH");
+        }
+    }
+    respbuf_puts(out, "\n");
+    return framed && !conn->framed ? CMD_FRAMED : CMD_CONTINUE;
+}
+
+/* subscribe() hasta suscribir: la instantánea es la generación 7 */
+static void subscribe(Conn *conn, char *arg, RespBuf *out) {
+    (void)arg;
+
+    if (!conn->push) {
+        respbuf_puts(out, "Error: SUBSCRIBE requiere la capacidad PUSH de HELLO.\n");
+        return;
+    }
+    reactor_subscribe(conn, 7);
+    respbuf_puts(out, "DELTA 0 7\n");
+}
+
+/* ── Test harness ───────────────────────────────────────────────────── */
+
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+static int cur_iter = 0;  /* Current iteration for CHECK context */
+
+#define CHECK(cond, fmt, ...)                                       \
+    do {                                                            \
+        tests_run++;                                                \
+        if (cond) {                                                 \
+            tests_passed++;                                         \
+        } else {                                                    \
+            tests_failed++;                                         \
+            fprintf(stderr, "  FAIL [iter=%d]: " fmt "\n",          \
+                    cur_iter, ##__VA_ARGS__);                        \
+        }                                                           \
+    } while (0)
+
+#define NUM_ITERATIONS 500
+#define MAX_STEPS      12
+
+/* Lo que debería quedar activo en la conexión */
+typedef struct {
+    int framed, binary, push, subscribed;
+    size_t lz;
+} Model;
+
+/* Arma un HELLO al azar y deja en *valid si el servidor debe aceptarlo. */
+static void random_hello(char *line, size_t size, int *valid, long *version,
+                         int *framed, int *binary, int *push, size_t *lz)
+{
+    static const char *bad[] = { "", "0", "-1", "x", "1.5", "1 FRAMED extra" };
+    int len;
+
+    if (rand() % 6 == 0) {
+        snprintf(line, size, "%s", bad[rand() % 6]);
+        *valid = 0;
+        return;
+    }
+    *valid = 1;
+    *version = 1 + rand() % 3;
+    *framed = *binary = *push = 0;
+    *lz = 0;
+    len = snprintf(line, size, "%ld", *version);
+
+    int ncaps = rand() % 5;
+    for (int i = 0; i < ncaps; i++) {
+        const char *cap;
+        char lzbuf[24];
+        switch (rand() % 7) {
+        case 0: cap = rand() % 2 ? "FRAMED" : "framed"; *framed = 1; break;
+        case 1: cap = "BINARY"; *binary = 1; break;
+        case 2: cap = rand() % 2 ? "PUSH" : "push"; *push = 1; break;
+        case 3: cap = "LZ"; *lz = COMPRESS_MIN_DEFAULT; break;
+        case 4:
+            snprintf(lzbuf, sizeof(lzbuf), "LZ=%d", rand() % 3000);
+            parse_compress_min(lzbuf + 3, lz);
+            cap = lzbuf;
+            break;
+        case 5: cap = "LZ=abc"; *lz = COMPRESS_MIN_DEFAULT; break;
+        default: cap = "FUTURE"; break;
+        }
+        len += snprintf(line + len, size - len, "%s%s", i ? "," : " ", cap);
+    }
+}
+
+/* Property 17: secuencias de HELLO, SUBSCRIBE y UNSUBSCRIBE */
+static void test_sequences(void)
+{
+    for (cur_iter = 0; cur_iter < NUM_ITERATIONS; cur_iter++) {
+        Conn conn = { 0 };
+        Model m = { 0 };
+        int steps = 1 + rand() % MAX_STEPS;
+
+        for (int s = 0; s < steps; s++) {
+            RespBuf out = { .len = 0 };
+            char line[128], shown[128];
+            int what = rand() % 4;
+
+            if (what == 0) {
+                subscribe(&conn, NULL, &out);
+                int refused = strncmp(out.data, "Error:", 6) == 0;
+                CHECK(refused == !m.push, "SUBSCRIBE %s con PUSH=%d",
+                      refused ? "rechazado" : "aceptado", m.push);
+                if (m.push)
+                    m.subscribed = 1;
+            } else if (what == 1) {
+                reactor_unsubscribe(&conn);
+                m.subscribed = 0;
+            } else {
+                int valid, framed, binary, push;
+                long version = 0;
+                size_t lz;
+                random_hello(line, sizeof(line), &valid, &version, &framed, &binary, &push, &lz);
+                snprintf(shown, sizeof(shown), "%s", line);
+                int res = hello(&conn, line[0] ? line : NULL, &out);
+
+                if (!valid) {
+                    CHECK(strncmp(out.data, "Error:", 6) == 0 && res == CMD_CONTINUE,
+                          "HELLO invalido '%s' aceptado", shown);
+                } else {
+                    int was_framed = m.framed;
+                    m.framed |= framed;
+                    m.binary = m.framed && binary;
+                    m.push = m.framed && push;
+                    m.lz = m.framed ? lz : 0;
+                    if (!m.push)
+                        m.subscribed = 0;
+
+                    char expect[128];
+                    int len = snprintf(expect, sizeof(expect), "OK HELLO %ld",
+                                       version < PROTO_VERSION ? version : PROTO_VERSION);
+                    if (m.framed) {
+                        len += snprintf(expect + len, sizeof(expect) - len, " FRAMED");
+                        if (m.binary)
+                            len += snprintf(expect + len, sizeof(expect) - len, ",BINARY=%d", WIRE_VERSION);
+                        if (m.lz)
+                            len += snprintf(expect + len, sizeof(expect) - len, ",LZ=%zu", m.lz);
+                        if (m.push)
+                            len += snprintf(expect + len, sizeof(expect) - len, ",PUSH");
+                    }
+                    snprintf(expect + len, sizeof(expect) - len, "\n");
+                    CHECK(strcmp(out.data, expect) == 0, "HELLO '%s' respondio '%.*s', esperado '%.*s'",
+                          shown, (int)strcspn(out.data, "\n"), out.data,
+                          (int)strcspn(expect, "\n"), expect);
+                    CHECK(res == (m.framed && !was_framed ? CMD_FRAMED : CMD_CONTINUE),
+                          "HELLO '%s' retorno %d", shown, res);
+                    /* El reactor pasa a FRAMED cuando el comando lo pide */
+                    conn.framed = m.framed;
+                }
+            }
+            CHECK(conn.binary == m.binary && conn.push == m.push &&
+                  conn.compress_min == m.lz && conn.subscribed == m.subscribed,
+                  "paso %d: conexion binary=%d push=%d lz=%zu sub=%d, modelo %d %d %zu %d", s,
+                  conn.binary, conn.push, conn.compress_min, conn.subscribed,
+                  m.binary, m.push, m.lz, m.subscribed);
+        }
+    }
+
+    /* El caso del cliente viejo: HELLO sin PUSH después de suscribirse */
+    cur_iter = 0;
+    Conn conn = { 0 };
+    RespBuf out = { .len = 0 };
+    char l1[] = "2 FRAMED,PUSH", l2[] = "1 FRAMED";
+    hello(&conn, l1, &out);
+    conn.framed = 1;
+    subscribe(&conn, NULL, &out);
+    CHECK(conn.subscribed, "SUBSCRIBE con PUSH no suscribio");
+    out.len = 0;
+    hello(&conn, l2, &out);
+    CHECK(strcmp(out.data, "OK HELLO 1 FRAMED\n") == 0 && !conn.subscribed,
+          "HELLO sin PUSH respondio '%s' y dejo sub=%d", out.data, conn.subscribed);
+    out.len = 0;
+    subscribe(&conn, NULL, &out);
+    CHECK(strncmp(out.data, "Error:", 6) == 0 && !conn.subscribed,
+          "SUBSCRIBE despues de HELLO sin PUSH no se rechazo");
+}
+
+int main(void)
+{
+    unsigned int seed = (unsigned int)time(NULL);
+    srand(seed);
+
+    printf("=== Property 17: Capacidades negociadas con HELLO ===\n");
+    printf("    Validates: Requirements 4.1\n");
+    printf("    Seed: %u\n\n", seed);
+
+    test_sequences();
+
+    printf("\nResults: %d/%d checks passed", tests_passed, tests_run);
+    if (tests_failed > 0) {
+        printf(" (%d failed)", tests_failed);
+    }
+    printf("\n");
+
+    if (tests_failed == 0) {
+        printf("PASS\n");
+        return 0;
+    } else {
+        printf("FAIL\n");
+        return 1;
+    }
+}
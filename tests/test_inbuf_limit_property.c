@@ -0,0 +1,390 @@
+/**
+ * Property-based test for the server input limit (Property 11).
+ *
+ * **Validates: Requirements 4.1**
+ *
+ * Property 11: Entrada acotada por conexión
+ *   a) For any stream of text without '\n' (or with lines longer than
+ *      CMD_MAX_SIZE), the input buffer never holds more than INBUF_MAX
+ *      bytes: inbuf_recv stops with EMSGSIZE and inbuf_full reports the
+ *      oversized command, however much the peer sends.
+ *   b) Lines up to CMD_MAX_SIZE are extracted intact, in order, even
+ *      when many of them arrive together.
+ *   c) A FRAME_CMD header announcing more than CMD_MAX_SIZE bytes is
+ *      rejected as soon as the header arrives (-2), and frames up to the
+ *      limit are extracted intact.
+ *
+ * The test embeds the InBuf logic of src/server/proto.c and feeds it
+ * through a socketpair, so it builds without the rest of the server.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+/* ── Embedded copy of src/server/proto.c (input side) ──────────────── */
+
+#define FRAME_HEADER_SIZE   8
+#define FRAME_MAX_PAYLOAD   (64u * 1024 * 1024)
+#define CMD_MAX_SIZE        (64u * 1024)
+#define INBUF_MAX           (CMD_MAX_SIZE + FRAME_HEADER_SIZE)
+#define FRAME_CMD           1
+
+#define INBUF_INITIAL   4096
+#define INBUF_MIN_FREE  1024
+
+typedef struct {
+    uint32_t len;
+    uint8_t type;
+    uint8_t flags;
+} FrameHeader;
+
+typedef struct {
+    char *data;
+    size_t start;
+    size_t len;
+    size_t cap;
+} InBuf;
+
+static void frame_header_encode(unsigned char *out, uint32_t len,
+                                uint8_t type, uint8_t flags)
+{
+    out[0] = (unsigned char)(len >> 24);
+    out[1] = (unsigned char)(len >> 16);
+    out[2] = (unsigned char)(len >> 8);
+    out[3] = (unsigned char)len;
+    out[4] = type;
+    out[5] = flags;
+    out[6] = 0;
+    out[7] = 0;
+}
+
+static int frame_header_decode(const unsigned char *in, FrameHeader *hdr)
+{
+    hdr->len = ((uint32_t)in[0] << 24) | ((uint32_t)in[1] << 16) |
+               ((uint32_t)in[2] << 8) | (uint32_t)in[3];
+    hdr->type  = in[4];
+    hdr->flags = in[5];
+
+    if (hdr->len > FRAME_MAX_PAYLOAD || hdr->type == 0 ||
+        in[6] != 0 || in[7] != 0)
+        return -1;
+    return 0;
+}
+
+static void inbuf_init(InBuf *ib)
+{
+    ib->data  = NULL;
+    ib->start = 0;
+    ib->len   = 0;
+    ib->cap   = 0;
+}
+
+static void inbuf_free(InBuf *ib)
+{
+    free(ib->data);
+    inbuf_init(ib);
+}
+
+static long inbuf_recv(InBuf *ib, int fd)
+{
+    if (ib->start > 0) {
+        memmove(ib->data, ib->data + ib->start, ib->len - ib->start);
+        ib->len  -= ib->start;
+        ib->start = 0;
+    }
+
+    if (ib->len >= INBUF_MAX) {
+        errno = EMSGSIZE;
+        return -1;
+    }
+
+    if (ib->cap - ib->len < INBUF_MIN_FREE + 1 && ib->cap < INBUF_MAX + 1) {
+        size_t new_cap = ib->cap ? ib->cap * 2 : INBUF_INITIAL;
+        if (new_cap > INBUF_MAX + 1)
+            new_cap = INBUF_MAX + 1;
+        char *tmp = realloc(ib->data, new_cap);
+        if (!tmp) {
+            errno = ENOMEM;
+            return -1;
+        }
+        ib->data = tmp;
+        ib->cap  = new_cap;
+    }
+
+    size_t room = ib->cap - ib->len - 1;
+    if (room > INBUF_MAX - ib->len)
+        room = INBUF_MAX - ib->len;
+    ssize_t n = recv(fd, ib->data + ib->len, room, MSG_DONTWAIT);
+    if (n > 0)
+        ib->len += (size_t)n;
+    return (long)n;
+}
+
+static int inbuf_full(const InBuf *ib)
+{
+    return ib->len - ib->start >= INBUF_MAX;
+}
+
+static int inbuf_next_line(InBuf *ib, char **line, size_t *len)
+{
+    char *begin = ib->data + ib->start;
+    char *nl = memchr(begin, '\n', ib->len - ib->start);
+    if (!nl)
+        return 0;
+
+    ib->start = (size_t)(nl - ib->data) + 1;
+    if (nl > begin && nl[-1] == '\r')
+        nl--;
+    *nl = '\0';
+
+    *line = begin;
+    *len  = (size_t)(nl - begin);
+    return 1;
+}
+
+static int inbuf_next_frame(InBuf *ib, FrameHeader *hdr, char **payload)
+{
+    size_t avail = ib->len - ib->start;
+    if (avail < FRAME_HEADER_SIZE)
+        return 0;
+
+    unsigned char *p = (unsigned char *)ib->data + ib->start;
+    if (frame_header_decode(p, hdr) != 0)
+        return -1;
+    if (hdr->len > CMD_MAX_SIZE)
+        return -2;
+    if (avail < FRAME_HEADER_SIZE + hdr->len)
+        return 0;
+
+    char *dst = ib->data + ib->start;
+    memmove(dst, dst + FRAME_HEADER_SIZE, hdr->len);
+    dst[hdr->len] = '\0';
+
+    ib->start += FRAME_HEADER_SIZE + hdr->len;
+    *payload = dst;
+    return 1;
+}
+
+/* ── Test harness ───────────────────────────────────────────────────── */
+
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+static int cur_iter = 0;  /* Current iteration for CHECK context */
+
+#define CHECK(cond, fmt, ...)                                       \
+    do {                                                            \
+        tests_run++;                                                \
+        if (cond) {                                                 \
+            tests_passed++;                                         \
+        } else {                                                    \
+            tests_failed++;                                         \
+            fprintf(stderr, "  FAIL [iter=%d]: " fmt "\n",          \
+                    cur_iter, ##__VA_ARGS__);                        \
+        }                                                           \
+    } while (0)
+
+#define NUM_ITERATIONS 100
+
+/* Random int in [lo, hi] inclusive */
+static int rand_range(int lo, int hi)
+{
+    return lo + rand() % (hi - lo + 1);
+}
+
+/*
+ * Escribe lo que acepte el socket sin bloquear. Retorna los bytes
+ * escritos (0 si el peer no lee: el buffer del kernel está lleno).
+ */
+static size_t push(int fd, const char *data, size_t len)
+{
+    ssize_t n = send(fd, data, len, MSG_DONTWAIT);
+    return n > 0 ? (size_t)n : 0;
+}
+
+/* Property 11a: texto sin '\n' (o líneas demasiado largas) */
+static void test_oversized_text(void)
+{
+    static char chunk[1 << 16];
+    memset(chunk, 'A', sizeof(chunk));
+
+    for (cur_iter = 0; cur_iter < NUM_ITERATIONS; cur_iter++) {
+        int sv[2];
+        InBuf ib;
+        size_t total = (size_t)rand_range(INBUF_MAX, 4 * 1024 * 1024);
+        size_t sent = 0, max_cap = 0;
+        int full = 0, lines = 0;
+
+        socketpair(AF_UNIX, SOCK_STREAM, 0, sv);
+        inbuf_init(&ib);
+
+        /* Algunas líneas cortas antes de la larga no cambian el resultado */
+        int before = rand_range(0, 5);
+        for (int i = 0; i < before; i++)
+            push(sv[0], "STATUS 1\n", 9);
+
+        for (int rounds = 0; !full && rounds < 10000; rounds++) {
+            size_t n = total - sent < sizeof(chunk) ? total - sent : sizeof(chunk);
+            sent += n ? push(sv[0], chunk, n) : 0;
+
+            long r = inbuf_recv(&ib, sv[1]);
+            if (ib.cap > max_cap)
+                max_cap = ib.cap;
+            char *line;
+            size_t len;
+            while (inbuf_next_line(&ib, &line, &len))
+                lines++;
+            if (r < 0 && errno == EMSGSIZE)
+                full = inbuf_full(&ib);
+            else if (r < 0 && errno != EAGAIN)
+                break;
+        }
+
+        CHECK(full, "%zu bytes sin '\\n' no llenaron el buffer", total);
+        CHECK(max_cap <= INBUF_MAX + 1 && ib.len - ib.start <= INBUF_MAX,
+              "buffer de %zu bytes (%zu pendientes) con tope %u",
+              max_cap, ib.len - ib.start, INBUF_MAX);
+        CHECK(lines == before, "%d lineas cortas extraidas, se enviaron %d", lines, before);
+
+        inbuf_free(&ib);
+        close(sv[0]);
+        close(sv[1]);
+    }
+}
+
+/* Property 11b: líneas hasta el tope se extraen enteras y en orden */
+static void test_lines(void)
+{
+    for (cur_iter = 0; cur_iter < NUM_ITERATIONS; cur_iter++) {
+        int sv[2];
+        InBuf ib;
+        int count = rand_range(1, 50);
+        size_t *lens = malloc(sizeof(size_t) * (size_t)count);
+        size_t total = 0;
+
+        for (int i = 0; i < count; i++) {
+            lens[i] = rand() % 8 ? (size_t)rand_range(0, 200) : CMD_MAX_SIZE;
+            total += lens[i] + 1;
+        }
+        char *stream = malloc(total);
+        size_t off = 0;
+        for (int i = 0; i < count; i++) {
+            for (size_t k = 0; k < lens[i]; k++)
+                stream[off++] = (char)('a' + (i + (int)k) % 26);
+            stream[off++] = '\n';
+        }
+
+        socketpair(AF_UNIX, SOCK_STREAM, 0, sv);
+        inbuf_init(&ib);
+
+        size_t sent = 0;
+        int got = 0, ok = 1, full = 0;
+        while (got < count && !full) {
+            if (sent < total)
+                sent += push(sv[0], stream + sent, total - sent);
+            inbuf_recv(&ib, sv[1]);
+
+            char *line;
+            size_t len;
+            while (inbuf_next_line(&ib, &line, &len)) {
+                size_t expected = 0;
+                for (int i = 0; i < got; i++)
+                    expected += lens[i] + 1;
+                if (len != lens[got] || memcmp(line, stream + expected, len) != 0)
+                    ok = 0;
+                got++;
+            }
+            full = inbuf_full(&ib);
+        }
+
+        CHECK(ok && got == count && !full, "%d de %d lineas (ok=%d, lleno=%d)",
+              got, count, ok, full);
+
+        inbuf_free(&ib);
+        close(sv[0]);
+        close(sv[1]);
+        free(stream);
+        free(lens);
+    }
+}
+
+/* Property 11c: frames de comando */
+static void test_frames(void)
+{
+    static char payload[CMD_MAX_SIZE + 1];
+    memset(payload, 'x', sizeof(payload));
+
+    for (cur_iter = 0; cur_iter < NUM_ITERATIONS; cur_iter++) {
+        int sv[2];
+        InBuf ib;
+        unsigned char hdr[FRAME_HEADER_SIZE];
+        FrameHeader fh;
+        char *msg;
+
+        socketpair(AF_UNIX, SOCK_STREAM, 0, sv);
+        inbuf_init(&ib);
+
+        /* Un frame válido de hasta CMD_MAX_SIZE */
+        uint32_t ok_len = rand() % 4 ? (uint32_t)rand_range(0, 500) : CMD_MAX_SIZE;
+        frame_header_encode(hdr, ok_len, FRAME_CMD, 0);
+        push(sv[0], (const char *)hdr, sizeof(hdr));
+        size_t sent = 0;
+        int res = 0;
+        while (res == 0) {
+            if (sent < ok_len)
+                sent += push(sv[0], payload, ok_len - sent);
+            inbuf_recv(&ib, sv[1]);
+            res = inbuf_next_frame(&ib, &fh, &msg);
+        }
+        CHECK(res == 1 && fh.len == ok_len && strspn(msg, "x") == ok_len,
+              "frame de %u bytes: res %d, largo %u", ok_len, res, fh.len);
+
+        /* Uno que anuncia más del tope: se rechaza con solo la cabecera */
+        uint32_t big = (uint32_t)rand_range(CMD_MAX_SIZE + 1, FRAME_MAX_PAYLOAD);
+        frame_header_encode(hdr, big, FRAME_CMD, 0);
+        push(sv[0], (const char *)hdr, sizeof(hdr));
+        inbuf_recv(&ib, sv[1]);
+        res = inbuf_next_frame(&ib, &fh, &msg);
+        CHECK(res == -2, "frame de %u bytes: res %d, se esperaba -2", big, res);
+        CHECK(ib.cap <= INBUF_MAX + 1, "buffer de %zu bytes", ib.cap);
+
+        inbuf_free(&ib);
+        close(sv[0]);
+        close(sv[1]);
+    }
+}
+
+int main(void)
+{
+    unsigned int seed = (unsigned int)time(NULL);
+    srand(seed);
+
+    printf("=== Property 11: Entrada acotada por conexion ===\n");
+    printf("    Validates: Requirements 4.1\n");
+    printf("    Seed: %u\n\n", seed);
+
+    test_oversized_text();
+    test_lines();
+    test_frames();
+
+    printf("\nResults: %d/%d checks passed", tests_passed, tests_run);
+    if (tests_failed > 0) {
+        printf(" (%d failed)", tests_failed);
+    }
+    printf("\n");
+
+    if (tests_failed == 0) {
+        printf("PASS\n");
+        return 0;
+    } else {
+        printf("FAIL\n");
+        return 1;
+    }
+}
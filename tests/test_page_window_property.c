@@ -0,0 +1,218 @@
+/**
+ * Property-based test for page_window() in Panel_Procesos (Property 6).
+ *
+ * **Validates: Requirements 4.2, 8.3**
+ *
+ * Property 6: Paginado de la lista
+ *   - For N entries, visible height H and any valid scroll offset, the
+ *     window returned by page_window covers every visible row.
+ *   - Once that window is loaded (as the server returns it, cut at N),
+ *     page_window must not ask for it again: no request loops.
+ *   - If the whole list is loaded, it never asks for anything.
+ *   - The window is bounded by 3*H rows, independent of N.
+ *
+ * The test embeds the page_window logic directly to avoid
+ * linking against ncurses. The function is a pure computation.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* ── Embedded copy of page_window ───────────────────────────────────────── */
+
+static int page_window(int scroll_offset, int visible_height, int total_entries,
+                       int loaded_offset, int loaded_count, int *offset, int *limit)
+{
+    int margin;
+    int want_from;
+    int want_to;
+
+    if (visible_height < 1) {
+        visible_height = 1;
+    }
+    margin = (visible_height + 1) / 2;
+
+    *offset = scroll_offset - visible_height;
+    if (*offset < 0) {
+        *offset = 0;
+    }
+    *limit = 3 * visible_height;
+
+    want_from = scroll_offset - margin;
+    if (want_from < 0) {
+        want_from = 0;
+    }
+    want_to = scroll_offset + visible_height + margin;
+    if (want_to > total_entries) {
+        want_to = total_entries;
+    }
+    if (want_from >= want_to) {
+        return 0;
+    }
+
+    return want_from < loaded_offset || want_to > loaded_offset + loaded_count;
+}
+
+/* ── Test helpers ───────────────────────────────────────────────────────── */
+
+static int tests_run    = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+static int cur_n = 0;  /* Current N (total entries) for CHECK context */
+static int cur_h = 0;  /* Current H (visible height) for CHECK context */
+
+#define CHECK(cond, fmt, ...)                                       \
+    do {                                                            \
+        tests_run++;                                                \
+        if (cond) {                                                 \
+            tests_passed++;                                         \
+        } else {                                                    \
+            tests_failed++;                                         \
+            fprintf(stderr, "  FAIL [N=%d, H=%d]: " fmt "\n",      \
+                    cur_n, cur_h, ##__VA_ARGS__);                   \
+        }                                                           \
+    } while (0)
+
+/* Filas que el servidor devuelve para OFFSET/LIMIT sobre N entradas */
+static int rows_returned(int n, int offset, int limit) {
+    if (offset >= n) return 0;
+    return (n - offset < limit) ? n - offset : limit;
+}
+
+/* ── Property 6a: Window covers the visible rows and is bounded ─────────── */
+
+static void test_window_covers_visible(void) {
+    int n, h, scroll, offset, limit, max_off, last;
+
+    printf("[Property 6a] Window covers the visible rows, at most 3*H\n");
+
+    for (n = 0; n <= 300; n += 7) {
+        for (h = 1; h <= 60; h += 4) {
+            cur_n = n;
+            cur_h = h;
+
+            max_off = n - h;
+            if (max_off < 0) max_off = 0;
+
+            for (scroll = 0; scroll <= max_off; scroll++) {
+                page_window(scroll, h, n, 0, 0, &offset, &limit);
+                last = scroll + h < n ? scroll + h : n;
+
+                CHECK(offset >= 0 && offset <= scroll && offset + limit >= last,
+                      "scroll=%d: window [%d, %d) misses [%d, %d)",
+                      scroll, offset, offset + limit, scroll, last);
+                CHECK(limit <= 3 * h, "scroll=%d: limit %d > 3*H", scroll, limit);
+            }
+        }
+    }
+}
+
+/* ── Property 6b: A loaded window is not requested again ────────────────── */
+
+static void test_no_request_loop(void) {
+    int n, h, scroll, offset, limit, max_off, o2, l2, got;
+
+    printf("[Property 6b] A loaded window is not requested again\n");
+
+    for (n = 0; n <= 300; n += 7) {
+        for (h = 1; h <= 60; h += 4) {
+            cur_n = n;
+            cur_h = h;
+
+            max_off = n - h;
+            if (max_off < 0) max_off = 0;
+
+            for (scroll = 0; scroll <= max_off; scroll++) {
+                page_window(scroll, h, n, 0, 0, &offset, &limit);
+                got = rows_returned(n, offset, limit);
+
+                CHECK(page_window(scroll, h, n, offset, got, &o2, &l2) == 0,
+                      "scroll=%d: loaded [%d, %d) requested again",
+                      scroll, offset, offset + got);
+            }
+        }
+    }
+}
+
+/* ── Property 6c: Scrolling one row asks at most every half page ────────── */
+
+static void test_prefetch_spacing(void) {
+    int n, h, scroll, offset, limit, max_off, loaded_off, loaded_n, requests;
+
+    printf("[Property 6c] Scrolling row by row refetches at most every H/2 rows\n");
+
+    for (n = 0; n <= 300; n += 7) {
+        for (h = 1; h <= 60; h += 4) {
+            cur_n = n;
+            cur_h = h;
+
+            max_off = n - h;
+            if (max_off < 0) max_off = 0;
+
+            page_window(0, h, n, 0, 0, &loaded_off, &limit);
+            loaded_n = rows_returned(n, loaded_off, limit);
+            requests = 0;
+
+            for (scroll = 0; scroll <= max_off; scroll++) {
+                if (page_window(scroll, h, n, loaded_off, loaded_n, &offset, &limit)) {
+                    requests++;
+                    loaded_off = offset;
+                    loaded_n = rows_returned(n, offset, limit);
+                }
+            }
+
+            CHECK(requests <= max_off / ((h + 1) / 2) + 1,
+                  "%d requests scrolling %d rows", requests, max_off);
+        }
+    }
+}
+
+/* ── Property 6d: Whole list loaded never requests ──────────────────────── */
+
+static void test_whole_list_loaded(void) {
+    int n, h, scroll, offset, limit, max_off;
+
+    printf("[Property 6d] With the whole list loaded nothing is requested\n");
+
+    for (n = 0; n <= 200; n++) {
+        for (h = 1; h <= 60; h += 3) {
+            cur_n = n;
+            cur_h = h;
+
+            max_off = n - h;
+            if (max_off < 0) max_off = 0;
+
+            for (scroll = 0; scroll <= max_off; scroll += 3) {
+                CHECK(page_window(scroll, h, n, 0, n, &offset, &limit) == 0,
+                      "scroll=%d: requested with everything loaded", scroll);
+            }
+        }
+    }
+}
+
+/* ── Main ───────────────────────────────────────────────────────────────── */
+
+int main(void) {
+    printf("=== Property 6: Paginado de la lista ===\n");
+    printf("    Validates: Requirements 4.2, 8.3\n\n");
+
+    test_window_covers_visible();
+    test_no_request_loop();
+    test_prefetch_spacing();
+    test_whole_list_loaded();
+
+    printf("\nResults: %d/%d checks passed", tests_passed, tests_run);
+    if (tests_failed > 0) {
+        printf(" (%d failed)", tests_failed);
+    }
+    printf("\n");
+
+    if (tests_failed == 0) {
+        printf("PASS\n");
+        return 0;
+    } else {
+        printf("FAIL\n");
+        return 1;
+    }
+}
@@ -0,0 +1,266 @@
+/**
+ * Property-based test for chained commands (Property 9).
+ *
+ * **Validates: Requirements 4.1**
+ *
+ * Property 9: Comandos encadenados con ';'
+ *   a) For any line made of commands joined by ';' with random spaces
+ *      and empty segments, input_split_commands returns the non-empty
+ *      commands, trimmed and in their original order (at most max).
+ *   b) The batch that net_send_cmds writes (frames in FRAMED mode, lines
+ *      in text mode) parses back into the same commands, in order, so
+ *      the server sees them as separate requests.
+ *
+ * The test embeds the pure logic of src/client/input.c and the batch
+ * encoder of src/client/net.c so it builds without ncurses or sockets.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* ── Embedded copy of input_split_commands (src/client/input.c) ─────── */
+
+#define INPUT_BUF_SIZE 256
+
+static int input_split_commands(char *line, char **cmds, int max)
+{
+    int count = 0;
+    char *p = line;
+
+    if (!line || !cmds) {
+        return 0;
+    }
+    while (p) {
+        char *sep = strchr(p, ';');
+        if (sep) {
+            *sep = '\0';
+        }
+        while (*p == ' ') {
+            p++;
+        }
+        size_t len = strlen(p);
+        while (len > 0 && p[len - 1] == ' ') {
+            p[--len] = '\0';
+        }
+        if (len > 0 && count < max) {
+            cmds[count++] = p;
+        }
+        p = sep ? sep + 1 : NULL;
+    }
+    return count;
+}
+
+/* ── Embedded batch encoder (src/client/net.c) ──────────────────────── */
+
+#define NET_FRAME_HEADER_SIZE 8
+#define NET_FRAME_CMD         1
+
+static size_t put_cmd(char *p, int framed, const char *cmd, size_t len) {
+    if (!framed) {
+        memcpy(p, cmd, len);
+        p[len] = '\n';
+        return len + 1;
+    }
+    unsigned char *hdr = (unsigned char *)p;
+    hdr[0] = (unsigned char)(len >> 24);
+    hdr[1] = (unsigned char)(len >> 16);
+    hdr[2] = (unsigned char)(len >> 8);
+    hdr[3] = (unsigned char)len;
+    hdr[4] = NET_FRAME_CMD;
+    hdr[5] = 0;
+    hdr[6] = 0;
+    hdr[7] = 0;
+    memcpy(p + NET_FRAME_HEADER_SIZE, cmd, len);
+    return NET_FRAME_HEADER_SIZE + len;
+}
+
+/* ── Test harness ───────────────────────────────────────────────────── */
+
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+static int cur_iter = 0;  /* Current iteration for CHECK context */
+
+#define CHECK(cond, fmt, ...)                                       \
+    do {                                                            \
+        tests_run++;                                                \
+        if (cond) {                                                 \
+            tests_passed++;                                         \
+        } else {                                                    \
+            tests_failed++;                                         \
+            fprintf(stderr, "  FAIL [iter=%d]: " fmt "\n",          \
+                    cur_iter, ##__VA_ARGS__);                        \
+        }                                                           \
+    } while (0)
+
+#define NUM_ITERATIONS 500
+#define MAX_CMDS       (INPUT_BUF_SIZE / 2)
+
+/* Random int in [lo, hi] inclusive */
+static int rand_range(int lo, int hi)
+{
+    return lo + rand() % (hi - lo + 1);
+}
+
+/* Comando al azar sin ';' ni espacios en los extremos ("STOP 12", "RUN sleep 5") */
+static void gen_command(char *buf, int max)
+{
+    static const char *verbs[] = { "STOP", "START", "RUN", "LIST", "STATUS", "JOBS" };
+    int len = snprintf(buf, (size_t)max, "%s", verbs[rand() % 6]);
+
+    while (len < max - 8 && rand() % 3) {
+        buf[len++] = ' ';
+        if (rand() % 4 == 0)
+            buf[len++] = ' ';
+        int word = rand_range(1, 5);
+        for (int i = 0; i < word && len < max - 2; i++)
+            buf[len++] = "abcxyz0123456789-_*/"[rand() % 20];
+    }
+    buf[len] = '\0';
+}
+
+/* Espacios al azar */
+static int put_spaces(char *p)
+{
+    int n = rand_range(0, 3);
+    memset(p, ' ', (size_t)n);
+    return n;
+}
+
+/* Property 9a: separar la línea devuelve los comandos recortados y en orden */
+static void test_split(void)
+{
+    for (cur_iter = 0; cur_iter < NUM_ITERATIONS; cur_iter++) {
+        char expected[MAX_CMDS][INPUT_BUF_SIZE];
+        char line[INPUT_BUF_SIZE * 4];
+        char *cmds[MAX_CMDS];
+        int n = 0, len = 0;
+        int segments = rand_range(0, 12);
+
+        for (int s = 0; s < segments; s++) {
+            if (s > 0)
+                line[len++] = ';';
+            len += put_spaces(line + len);
+            if (rand() % 5) {
+                gen_command(expected[n], 24);
+                len += sprintf(line + len, "%s", expected[n]);
+                n++;
+            }
+            len += put_spaces(line + len);
+        }
+        if (rand() % 4 == 0)
+            line[len++] = ';';
+        line[len] = '\0';
+
+        char original[INPUT_BUF_SIZE * 4];
+        memcpy(original, line, (size_t)len + 1);
+
+        int max = rand() % 4 ? MAX_CMDS : rand_range(0, n);
+        int count = input_split_commands(line, cmds, max);
+        int want = n < max ? n : max;
+
+        CHECK(count == want, "'%s': %d comandos, se esperaban %d", original, count, want);
+        for (int i = 0; i < count && i < want; i++) {
+            CHECK(strcmp(cmds[i], expected[i]) == 0,
+                  "'%s': comando %d es '%s', se esperaba '%s'",
+                  original, i, cmds[i], expected[i]);
+        }
+    }
+
+    /* Casos fijos */
+    char empty[] = "";
+    char only_seps[] = " ; ;; ";
+    char single[] = "  LIST  ";
+    char *cmds[4];
+    CHECK(input_split_commands(empty, cmds, 4) == 0, "linea vacia");
+    CHECK(input_split_commands(only_seps, cmds, 4) == 0, "solo separadores");
+    CHECK(input_split_commands(single, cmds, 4) == 1 && strcmp(cmds[0], "LIST") == 0,
+          "un solo comando recortado");
+    CHECK(input_split_commands(NULL, cmds, 4) == 0, "linea NULL");
+}
+
+/* Property 9b: el lote de net_send_cmds se vuelve a separar en los mismos comandos */
+static void test_batch(void)
+{
+    for (cur_iter = 0; cur_iter < NUM_ITERATIONS; cur_iter++) {
+        char cmds[MAX_CMDS][INPUT_BUF_SIZE];
+        int count = rand_range(1, MAX_CMDS);
+        int framed = rand() % 2;
+        size_t total = 0;
+
+        for (int i = 0; i < count; i++) {
+            gen_command(cmds[i], rand_range(6, INPUT_BUF_SIZE));
+            total += strlen(cmds[i]) + (framed ? NET_FRAME_HEADER_SIZE : 1);
+        }
+
+        char *out = malloc(total);
+        size_t used = 0;
+        for (int i = 0; i < count; i++)
+            used += put_cmd(out + used, framed, cmds[i], strlen(cmds[i]));
+        CHECK(used == total, "lote de %zu bytes, se calcularon %zu", used, total);
+
+        /* Separarlo como el servidor: frames o líneas, en orden */
+        size_t off = 0;
+        int parsed = 0, match = 1;
+        while (off < used && parsed < count) {
+            const char *cmd;
+            size_t len;
+            if (framed) {
+                const unsigned char *h = (const unsigned char *)out + off;
+                len = (size_t)h[0] << 24 | (size_t)h[1] << 16 | (size_t)h[2] << 8 | h[3];
+                if (h[4] != NET_FRAME_CMD || off + NET_FRAME_HEADER_SIZE + len > used) {
+                    match = 0;
+                    break;
+                }
+                cmd = out + off + NET_FRAME_HEADER_SIZE;
+                off += NET_FRAME_HEADER_SIZE + len;
+            } else {
+                const char *nl = memchr(out + off, '\n', used - off);
+                if (!nl) {
+                    match = 0;
+                    break;
+                }
+                cmd = out + off;
+                len = (size_t)(nl - cmd);
+                off += len + 1;
+            }
+            if (len != strlen(cmds[parsed]) || memcmp(cmd, cmds[parsed], len) != 0)
+                match = 0;
+            parsed++;
+        }
+        CHECK(match && parsed == count && off == used,
+              "%s: %d de %d comandos recuperados en orden",
+              framed ? "FRAMED" : "texto", parsed, count);
+        free(out);
+    }
+}
+
+int main(void)
+{
+    unsigned int seed = (unsigned int)time(NULL);
+    srand(seed);
+
+    printf("=== Property 9: Comandos encadenados ===\n");
+    printf("    Validates: Requirements 4.1\n");
+    printf("    Seed: %u\n\n", seed);
+
+    test_split();
+    test_batch();
+
+    printf("\nResults: %d/%d checks passed", tests_passed, tests_run);
+    if (tests_failed > 0) {
+        printf(" (%d failed)", tests_failed);
+    }
+    printf("\n");
+
+    if (tests_failed == 0) {
+        printf("PASS\n");
+        return 0;
+    } else {
+        printf("FAIL\n");
+        return 1;
+    }
+}
@@ -0,0 +1,571 @@
+/**
+ * Property-based test for process_list_apply_delta() (Property 4).
+ *
+ * **Validates: Requirements 4.1**
+ *
+ * Property 4: Aplicar deltas de LIST SINCE
+ *   - For any two sorted process tables A and B, parsing A and applying
+ *     the delta A -> B (as the server formats it: "+ pid name",
+ *     "- pid", "~ pid name", sorted by PID) must yield exactly B.
+ *   - A delta that does not match the list (removing or renaming an
+ *     unknown PID, adding an existing one) must return -1.
+ *
+ * The test embeds the parse and delta logic directly to avoid linking
+ * against ncurses.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+
+/* ── Embedded types and parse logic (no ncurses dependency) ─────────── */
+
+#define PROC_NAME_SIZE 256
+#define INITIAL_CAPACITY 32
+
+typedef struct {
+    int pid;
+    char name[PROC_NAME_SIZE];
+} ProcessEntry;
+
+typedef struct {
+    ProcessEntry *entries;
+    int count;
+    int capacity;
+} ProcessList;
+
+int process_list_parse(const char *raw_response, ProcessList *list)
+{
+    const char *line_start;
+    const char *p;
+    int is_first_line;
+
+    if (!list)
+        return -1;
+
+    list->entries  = NULL;
+    list->count    = 0;
+    list->capacity = 0;
+
+    if (!raw_response || raw_response[0] == '\0')
+        return 0;
+
+    list->entries = malloc(INITIAL_CAPACITY * sizeof(ProcessEntry));
+    if (!list->entries)
+        return -1;
+    list->capacity = INITIAL_CAPACITY;
+
+    is_first_line = 1;
+    line_start = raw_response;
+
+    while (*line_start != '\0') {
+        p = line_start;
+        while (*p != '\0' && *p != '\n')
+            p++;
+
+        int line_len = (int)(p - line_start);
+
+        if (is_first_line) {
+            is_first_line = 0;
+        } else if (line_len > 0) {
+            const char *s = line_start;
+
+            while (s < line_start + line_len && isspace((unsigned char)*s))
+                s++;
+
+            if (s < line_start + line_len) {
+                int pid = 0;
+                int has_digit = 0;
+                while (s < line_start + line_len && isdigit((unsigned char)*s)) {
+                    pid = pid * 10 + (*s - '0');
+                    has_digit = 1;
+                    s++;
+                }
+
+                if (has_digit) {
+                    while (s < line_start + line_len && isspace((unsigned char)*s))
+                        s++;
+
+                    int name_len = (int)(line_start + line_len - s);
+
+                    if (list->count >= list->capacity) {
+                        int new_cap = list->capacity * 2;
+                        ProcessEntry *tmp = realloc(list->entries,
+                                                    (size_t)new_cap * sizeof(ProcessEntry));
+                        if (!tmp)
+                            return -1;
+                        list->entries  = tmp;
+                        list->capacity = new_cap;
+                    }
+
+                    ProcessEntry *entry = &list->entries[list->count];
+                    entry->pid = pid;
+
+                    if (name_len > 0 && name_len < PROC_NAME_SIZE) {
+                        memcpy(entry->name, s, (size_t)name_len);
+                        entry->name[name_len] = '\0';
+                    } else if (name_len >= PROC_NAME_SIZE) {
+                        memcpy(entry->name, s, PROC_NAME_SIZE - 1);
+                        entry->name[PROC_NAME_SIZE - 1] = '\0';
+                    } else {
+                        entry->name[0] = '\0';
+                    }
+
+                    list->count++;
+                }
+            }
+        }
+
+        if (*p == '\n')
+            line_start = p + 1;
+        else
+            break;
+    }
+
+    return 0;
+}
+
+void process_list_free(ProcessList *list)
+{
+    if (!list)
+        return;
+    if (list->entries) {
+        free(list->entries);
+        list->entries = NULL;
+    }
+    list->count    = 0;
+    list->capacity = 0;
+}
+
+/* Copia un nombre de proceso truncándolo a PROC_NAME_SIZE - 1. */
+static void copy_name(char *dst, const char *src, int len)
+{
+    if (len >= PROC_NAME_SIZE)
+        len = PROC_NAME_SIZE - 1;
+    if (len < 0)
+        len = 0;
+    memcpy(dst, src, (size_t)len);
+    dst[len] = '\0';
+}
+
+/* Busca un PID en la lista ordenada. Retorna su índice o -1. */
+static int find_pid(const ProcessList *list, int pid)
+{
+    int lo = 0, hi = list->count - 1;
+
+    while (lo <= hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (list->entries[mid].pid == pid)
+            return mid;
+        if (list->entries[mid].pid < pid)
+            lo = mid + 1;
+        else
+            hi = mid - 1;
+    }
+    return -1;
+}
+
+/*
+ * Parsea una línea de delta: operación, PID y (para + y ~) el nombre.
+ * Retorna 0 si OK, -1 si la línea está mal formada.
+ */
+static int parse_delta_line(const char *s, const char *end, char *op, int *pid,
+                            const char **name, int *name_len)
+{
+    if (end - s < 3 || (s[0] != '+' && s[0] != '-' && s[0] != '~') || s[1] != ' ')
+        return -1;
+    *op = s[0];
+    s += 2;
+
+    if (s >= end || !isdigit((unsigned char)*s))
+        return -1;
+    *pid = 0;
+    while (s < end && isdigit((unsigned char)*s))
+        *pid = *pid * 10 + (*s++ - '0');
+
+    if (*op == '-') {
+        *name = NULL;
+        *name_len = 0;
+        return s == end ? 0 : -1;
+    }
+    if (s >= end || *s != ' ')
+        return -1;
+    *name = s + 1;
+    *name_len = (int)(end - s - 1);
+    return 0;
+}
+
+/*
+ * Aplica un delta en tres pasos sin reparsear la lista: renombres y
+ * bajas por búsqueda binaria (las bajas se marcan con PID 0 y se
+ * compactan en una pasada), y las altas, que llegan ordenadas, se
+ * mezclan desde el final del arreglo.
+ */
+int process_list_apply_delta(ProcessList *list, const char *delta)
+{
+    ProcessEntry *adds = NULL;
+    int add_count = 0, add_cap = 0;
+    int removed = 0;
+    const char *line_start;
+
+    if (!list || !delta)
+        return -1;
+
+    /* Paso 1: renombres y bajas; las altas se juntan aparte */
+    line_start = delta;
+    while (*line_start != '\0') {
+        const char *p = line_start;
+        while (*p != '\0' && *p != '\n')
+            p++;
+
+        if (p > line_start) {
+            char op;
+            int pid, name_len, idx;
+            const char *name;
+
+            if (parse_delta_line(line_start, p, &op, &pid, &name, &name_len) != 0)
+                goto fail;
+            idx = find_pid(list, pid);
+
+            if (op == '+') {
+                if (idx >= 0 || (add_count > 0 && adds[add_count - 1].pid >= pid))
+                    goto fail;
+                if (add_count >= add_cap) {
+                    int new_cap = add_cap ? add_cap * 2 : INITIAL_CAPACITY;
+                    ProcessEntry *tmp = realloc(adds, (size_t)new_cap * sizeof(ProcessEntry));
+                    if (!tmp)
+                        goto fail;
+                    adds    = tmp;
+                    add_cap = new_cap;
+                }
+                adds[add_count].pid = pid;
+                copy_name(adds[add_count].name, name, name_len);
+                add_count++;
+            } else if (idx < 0) {
+                goto fail;
+            } else if (op == '-') {
+                list->entries[idx].pid = 0;
+                removed++;
+            } else {
+                copy_name(list->entries[idx].name, name, name_len);
+            }
+        }
+
+        if (*p == '\n')
+            line_start = p + 1;
+        else
+            break;
+    }
+
+    /* Paso 2: compactar las bajas */
+    if (removed > 0) {
+        int w = 0;
+        for (int r = 0; r < list->count; r++) {
+            if (list->entries[r].pid != 0) {
+                if (w != r)
+                    list->entries[w] = list->entries[r];
+                w++;
+            }
+        }
+        list->count = w;
+    }
+
+    /* Paso 3: mezclar las altas desde el final */
+    if (add_count > 0) {
+        int total = list->count + add_count;
+        if (total > list->capacity) {
+            int new_cap = list->capacity ? list->capacity : INITIAL_CAPACITY;
+            while (new_cap < total)
+                new_cap *= 2;
+            ProcessEntry *tmp = realloc(list->entries, (size_t)new_cap * sizeof(ProcessEntry));
+            if (!tmp)
+                goto fail;
+            list->entries  = tmp;
+            list->capacity = new_cap;
+        }
+
+        int i = list->count - 1, j = add_count - 1;
+        for (int w = total - 1; j >= 0; w--) {
+            if (i >= 0 && list->entries[i].pid > adds[j].pid)
+                list->entries[w] = list->entries[i--];
+            else
+                list->entries[w] = adds[j--];
+        }
+        list->count = total;
+    }
+
+    free(adds);
+    return 0;
+
+fail:
+    free(adds);
+    return -1;
+}
+
+/* ── Test helpers ───────────────────────────────────────────────────── */
+
+static int tests_run    = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+static int cur_iter = 0;  /* Current iteration for CHECK context */
+
+#define CHECK(cond, fmt, ...)                                       \
+    do {                                                            \
+        tests_run++;                                                \
+        if (cond) {                                                 \
+            tests_passed++;                                         \
+        } else {                                                    \
+            tests_failed++;                                         \
+            fprintf(stderr, "  FAIL [iter=%d]: " fmt "\n",          \
+                    cur_iter, ##__VA_ARGS__);                        \
+        }                                                           \
+    } while (0)
+
+/* ── Random generators ──────────────────────────────────────────────── */
+
+/* Random int in [lo, hi] inclusive */
+static int rand_range(int lo, int hi)
+{
+    return lo + rand() % (hi - lo + 1);
+}
+
+/* Generate a random process name (lowercase letters, 1..max_len chars) */
+static void rand_proc_name(char *buf, int max_len)
+{
+    int len = rand_range(1, max_len);
+    int i;
+    for (i = 0; i < len; i++)
+        buf[i] = 'a' + (rand() % 26);
+    buf[len] = '\0';
+}
+
+#define MAX_PID        400
+#define MAX_NAME_LEN   30
+
+/* Table indexed by PID: present[pid] and names[pid] */
+typedef struct {
+    int present[MAX_PID + 1];
+    char names[MAX_PID + 1][MAX_NAME_LEN + 1];
+} Table;
+
+static void random_table(Table *t)
+{
+    int pid;
+    int density = rand_range(0, 100);
+    memset(t, 0, sizeof(*t));
+    for (pid = 1; pid <= MAX_PID; pid++) {
+        if (rand() % 100 < density) {
+            t->present[pid] = 1;
+            rand_proc_name(t->names[pid], MAX_NAME_LEN);
+        }
+    }
+}
+
+/* Derive B from A: remove, add and rename some entries */
+static void mutate_table(const Table *a, Table *b)
+{
+    int pid;
+    int churn = rand_range(0, 30);
+    *b = *a;
+    for (pid = 1; pid <= MAX_PID; pid++) {
+        if (rand() % 100 >= churn)
+            continue;
+        if (b->present[pid] && rand() % 2) {
+            b->present[pid] = 0;
+        } else {
+            b->present[pid] = 1;
+            rand_proc_name(b->names[pid], MAX_NAME_LEN);
+        }
+    }
+}
+
+/* Format a table like `ps -e -o pid,comm` */
+static char *format_table(const Table *t)
+{
+    char *text = malloc((size_t)(MAX_PID + 1) * (MAX_NAME_LEN + 16) + 32);
+    char *w = text;
+    int pid;
+    w += sprintf(w, "  PID COMMAND\n");
+    for (pid = 1; pid <= MAX_PID; pid++)
+        if (t->present[pid])
+            w += sprintf(w, "%5d %s\n", pid, t->names[pid]);
+    return text;
+}
+
+/* Format the delta A -> B like the server does */
+static char *format_delta(const Table *a, const Table *b)
+{
+    char *text = malloc((size_t)(MAX_PID + 1) * (MAX_NAME_LEN + 16) + 1);
+    char *w = text;
+    int pid;
+    *w = '\0';
+    for (pid = 1; pid <= MAX_PID; pid++) {
+        if (a->present[pid] && !b->present[pid])
+            w += sprintf(w, "- %d\n", pid);
+        else if (!a->present[pid] && b->present[pid])
+            w += sprintf(w, "+ %d %s\n", pid, b->names[pid]);
+        else if (a->present[pid] && strcmp(a->names[pid], b->names[pid]) != 0)
+            w += sprintf(w, "~ %d %s\n", pid, b->names[pid]);
+    }
+    return text;
+}
+
+/* ── Property 4a: parse(A) + delta(A, B) == parse(B) ────────────────── */
+
+static void test_delta_yields_new_table(void)
+{
+    int iter;
+    int num_iterations = 500;
+
+    printf("[Property 4a] parse(A) + delta(A->B) == B\n");
+
+    for (iter = 0; iter < num_iterations; iter++) {
+        Table a, b;
+        ProcessList list, expected;
+        char *text_a, *text_b, *delta;
+        int rc, i;
+
+        cur_iter = iter;
+        random_table(&a);
+        mutate_table(&a, &b);
+        text_a = format_table(&a);
+        text_b = format_table(&b);
+        delta  = format_delta(&a, &b);
+
+        process_list_parse(text_a, &list);
+        process_list_parse(text_b, &expected);
+        rc = process_list_apply_delta(&list, delta);
+
+        CHECK(rc == 0, "apply returned %d, expected 0", rc);
+        CHECK(list.count == expected.count,
+              "count=%d, expected %d", list.count, expected.count);
+        if (rc == 0 && list.count == expected.count) {
+            for (i = 0; i < list.count; i++) {
+                CHECK(list.entries[i].pid == expected.entries[i].pid &&
+                      strcmp(list.entries[i].name, expected.entries[i].name) == 0,
+                      "entry[%d]=(%d,'%s'), expected (%d,'%s')", i,
+                      list.entries[i].pid, list.entries[i].name,
+                      expected.entries[i].pid, expected.entries[i].name);
+            }
+        }
+
+        process_list_free(&list);
+        process_list_free(&expected);
+        free(text_a);
+        free(text_b);
+        free(delta);
+    }
+}
+
+/* ── Property 4b: mismatched deltas are rejected ────────────────────── */
+
+static void test_mismatched_delta_rejected(void)
+{
+    int iter;
+    int num_iterations = 200;
+
+    printf("[Property 4b] Mismatched deltas return -1\n");
+
+    for (iter = 0; iter < num_iterations; iter++) {
+        Table a;
+        ProcessList list;
+        char *text_a;
+        char delta[128];
+        int pid, present_pid = 0, absent_pid = 0;
+
+        cur_iter = iter;
+        random_table(&a);
+        for (pid = 1; pid <= MAX_PID; pid++) {
+            if (a.present[pid] && !present_pid)
+                present_pid = pid;
+            if (!a.present[pid] && !absent_pid)
+                absent_pid = pid;
+        }
+        text_a = format_table(&a);
+
+        if (absent_pid) {
+            process_list_parse(text_a, &list);
+            snprintf(delta, sizeof(delta), "- %d\n", absent_pid);
+            CHECK(process_list_apply_delta(&list, delta) == -1,
+                  "removing unknown pid %d accepted", absent_pid);
+            process_list_free(&list);
+
+            process_list_parse(text_a, &list);
+            snprintf(delta, sizeof(delta), "~ %d x\n", absent_pid);
+            CHECK(process_list_apply_delta(&list, delta) == -1,
+                  "renaming unknown pid %d accepted", absent_pid);
+            process_list_free(&list);
+        }
+        if (present_pid) {
+            process_list_parse(text_a, &list);
+            snprintf(delta, sizeof(delta), "+ %d x\n", present_pid);
+            CHECK(process_list_apply_delta(&list, delta) == -1,
+                  "adding existing pid %d accepted", present_pid);
+            process_list_free(&list);
+        }
+
+        process_list_parse(text_a, &list);
+        CHECK(process_list_apply_delta(&list, "garbage\n") == -1,
+              "malformed line accepted");
+        process_list_free(&list);
+        free(text_a);
+    }
+}
+
+/* ── Property 4c: empty delta leaves the list unchanged ─────────────── */
+
+static void test_empty_delta_is_noop(void)
+{
+    ProcessList list;
+    int rc;
+
+    printf("[Property 4c] Empty delta is a no-op\n");
+
+    cur_iter = 0;
+    process_list_parse("  PID COMMAND\n    1 init\n   42 sh\n", &list);
+    rc = process_list_apply_delta(&list, "");
+    CHECK(rc == 0 && list.count == 2 && list.entries[1].pid == 42,
+          "rc=%d count=%d", rc, list.count);
+    process_list_free(&list);
+
+    /* Adding to an empty list must allocate */
+    process_list_parse("", &list);
+    rc = process_list_apply_delta(&list, "+ 7 nuevo\n+ 9 otro\n");
+    CHECK(rc == 0 && list.count == 2 && list.entries[0].pid == 7 &&
+          strcmp(list.entries[1].name, "otro") == 0,
+          "rc=%d count=%d", rc, list.count);
+    process_list_free(&list);
+}
+
+/* ── Main ───────────────────────────────────────────────────────────── */
+
+int main(void)
+{
+    unsigned int seed = (unsigned int)time(NULL);
+    srand(seed);
+
+    printf("=== Property 4: Deltas de LIST SINCE ===\n");
+    printf("    Validates: Requirements 4.1\n");
+    printf("    Seed: %u\n\n", seed);
+
+    test_delta_yields_new_table();
+    test_mismatched_delta_rejected();
+    test_empty_delta_is_noop();
+
+    printf("\nResults: %d/%d checks passed", tests_passed, tests_run);
+    if (tests_failed > 0) {
+        printf(" (%d failed)", tests_failed);
+    }
+    printf("\n");
+
+    if (tests_failed == 0) {
+        printf("PASS\n");
+        return 0;
+    } else {
+        printf("FAIL\n");
+        return 1;
+    }
+}
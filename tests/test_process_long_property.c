@@ -0,0 +1,417 @@
+/**
+ * Property-based test for process_list_parse() with LIST LONG (Property 5).
+ *
+ * **Validates: Requirements 4.1**
+ *
+ * Property 5: Parseo de LIST LONG
+ *   - For any table formatted as the server formats LIST LONG
+ *     ("PID UID S THR RSS_KB %CPU START COMMAND"), process_list_parse
+ *     must set has_metrics and recover every column of every row,
+ *     including names with spaces.
+ *   - Text in the plain `ps -e -o pid,comm` format must still parse with
+ *     has_metrics == 0.
+ *   - Malformed LONG rows are skipped without affecting the others.
+ *
+ * The test embeds the parse logic directly to avoid linking against ncurses.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+
+/* ── Embedded types and parse logic (no ncurses dependency) ─────────── */
+
+#define PROC_NAME_SIZE 256
+#define INITIAL_CAPACITY 32
+
+typedef struct {
+    int pid;
+    char name[PROC_NAME_SIZE];
+    int uid;
+    char state;
+    int threads;
+    long rss_kb;
+    int cpu_tenths;
+    time_t start_time;
+} ProcessEntry;
+
+typedef struct {
+    ProcessEntry *entries;
+    int count;
+    int capacity;
+    int has_metrics;
+} ProcessList;
+
+static void process_list_free(ProcessList *list)
+{
+    free(list->entries);
+    list->entries     = NULL;
+    list->count       = 0;
+    list->capacity    = 0;
+    list->has_metrics = 0;
+}
+
+/*
+ * Lee un entero con signo opcional entre *s y end, saltando espacios
+ * iniciales (sin pasar de la línea). Retorna 0 si OK, -1 si no hay número.
+ */
+static int read_number(const char **s, const char *end, long long *value)
+{
+    const char *p = *s;
+    long long v = 0;
+    int neg = 0;
+
+    while (p < end && *p == ' ')
+        p++;
+    if (p < end && *p == '-') {
+        neg = 1;
+        p++;
+    }
+    if (p >= end || !isdigit((unsigned char)*p))
+        return -1;
+    while (p < end && isdigit((unsigned char)*p))
+        v = v * 10 + (*p++ - '0');
+
+    *value = neg ? -v : v;
+    *s = p;
+    return 0;
+}
+
+/*
+ * Parsea las columnas de LIST LONG que van entre el PID y el nombre:
+ *   UID S THR RSS_KB %CPU START
+ * Retorna 0 si OK (y avanza *s), -1 si la línea está mal formada.
+ */
+static int parse_metrics(const char **s, const char *end, ProcessEntry *e)
+{
+    long long uid, threads, rss, cpu_int, cpu_dec, start;
+    const char *p = *s;
+
+    if (read_number(&p, end, &uid) != 0)
+        return -1;
+    while (p < end && *p == ' ')
+        p++;
+    if (p >= end)
+        return -1;
+    e->state = *p++;
+    if (read_number(&p, end, &threads) != 0 || read_number(&p, end, &rss) != 0 ||
+        read_number(&p, end, &cpu_int) != 0)
+        return -1;
+    if (p >= end || *p != '.')
+        return -1;
+    p++;
+    if (read_number(&p, end, &cpu_dec) != 0 || read_number(&p, end, &start) != 0)
+        return -1;
+
+    e->uid        = (int)uid;
+    e->threads    = (int)threads;
+    e->rss_kb     = (long)rss;
+    e->cpu_tenths = (int)(cpu_int * 10 + cpu_dec);
+    e->start_time = (time_t)start;
+    *s = p;
+    return 0;
+}
+
+/* Indica si el encabezado es el de LIST LONG (tiene la columna %CPU). */
+static int is_long_header(const char *line, int len)
+{
+    for (int i = 0; i + 4 <= len; i++) {
+        if (memcmp(line + i, "%CPU", 4) == 0)
+            return 1;
+    }
+    return 0;
+}
+
+/*
+ * Parsea la respuesta cruda del servidor (texto de `ps -e -o pid,comm`)
+ * en una ProcessList. La primera línea (encabezado "PID COMM") se omite.
+ *
+ * Formato esperado por línea (después del header):
+ *   "  1234 nginx"
+ *   "  5678 node"
+ * o, si el encabezado es el de LIST LONG:
+ *   "  1234  1000 S   4     20480  12.5 1700000000 nginx"
+ *
+ * Retorna 0 si OK, -1 en error de memoria.
+ */
+int process_list_parse(const char *raw_response, ProcessList *list)
+{
+    const char *line_start;
+    const char *p;
+    int is_first_line;
+
+    if (!list)
+        return -1;
+
+    list->entries     = NULL;
+    list->count       = 0;
+    list->capacity    = 0;
+    list->has_metrics = 0;
+
+    if (!raw_response || raw_response[0] == '\0')
+        return 0;
+
+    /* Asignar capacidad inicial */
+    list->entries = malloc(INITIAL_CAPACITY * sizeof(ProcessEntry));
+    if (!list->entries)
+        return -1;
+    list->capacity = INITIAL_CAPACITY;
+
+    is_first_line = 1;
+    line_start = raw_response;
+
+    while (*line_start != '\0') {
+        /* Encontrar el fin de la línea */
+        p = line_start;
+        while (*p != '\0' && *p != '\n')
+            p++;
+
+        /* Longitud de la línea */
+        int line_len = (int)(p - line_start);
+
+        if (is_first_line) {
+            /* Omitir la línea de encabezado */
+            is_first_line = 0;
+            list->has_metrics = is_long_header(line_start, line_len);
+        } else if (line_len > 0) {
+            /* Parsear PID y nombre */
+            const char *s = line_start;
+
+            /* Saltar espacios iniciales */
+            while (s < line_start + line_len && isspace((unsigned char)*s))
+                s++;
+
+            if (s < line_start + line_len) {
+                /* Leer PID */
+                int pid = 0;
+                int has_digit = 0;
+                while (s < line_start + line_len && isdigit((unsigned char)*s)) {
+                    pid = pid * 10 + (*s - '0');
+                    has_digit = 1;
+                    s++;
+                }
+
+                ProcessEntry metrics;
+                memset(&metrics, 0, sizeof(metrics));
+                metrics.uid = -1;
+                if (has_digit && list->has_metrics &&
+                    parse_metrics(&s, line_start + line_len, &metrics) != 0)
+                    has_digit = 0; /* Línea mal formada: se omite */
+
+                if (has_digit) {
+                    /* Saltar espacios entre PID y nombre */
+                    while (s < line_start + line_len && isspace((unsigned char)*s))
+                        s++;
+
+                    /* El resto es el nombre del proceso */
+                    int name_len = (int)(line_start + line_len - s);
+
+                    /* Crecer el array si es necesario */
+                    if (list->count >= list->capacity) {
+                        int new_cap = list->capacity * 2;
+                        ProcessEntry *tmp = realloc(list->entries,
+                                                    (size_t)new_cap * sizeof(ProcessEntry));
+                        if (!tmp)
+                            return -1;
+                        list->entries  = tmp;
+                        list->capacity = new_cap;
+                    }
+
+                    ProcessEntry *entry = &list->entries[list->count];
+                    *entry = metrics;
+                    entry->pid = pid;
+
+                    if (name_len > 0 && name_len < PROC_NAME_SIZE) {
+                        memcpy(entry->name, s, (size_t)name_len);
+                        entry->name[name_len] = '\0';
+                    } else if (name_len >= PROC_NAME_SIZE) {
+                        memcpy(entry->name, s, PROC_NAME_SIZE - 1);
+                        entry->name[PROC_NAME_SIZE - 1] = '\0';
+                    } else {
+                        entry->name[0] = '\0';
+                    }
+
+                    list->count++;
+                }
+            }
+        }
+
+        /* Avanzar a la siguiente línea */
+        if (*p == '\n')
+            line_start = p + 1;
+        else
+            break;
+    }
+
+    return 0;
+}
+
+/* ── Test helpers ───────────────────────────────────────────────────── */
+
+static int tests_run    = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+static int cur_iter = 0;  /* Current iteration for CHECK context */
+
+#define CHECK(cond, fmt, ...)                                       \
+    do {                                                            \
+        tests_run++;                                                \
+        if (cond) {                                                 \
+            tests_passed++;                                         \
+        } else {                                                    \
+            tests_failed++;                                         \
+            fprintf(stderr, "  FAIL [iter=%d]: " fmt "\n",          \
+                    cur_iter, ##__VA_ARGS__);                        \
+        }                                                           \
+    } while (0)
+
+/* ── Random generators ──────────────────────────────────────────────── */
+
+#define MAX_ROWS 64
+#define NUM_ITERATIONS 200
+
+/* Random int in [lo, hi] inclusive */
+static int rand_range(int lo, int hi)
+{
+    return lo + rand() % (hi - lo + 1);
+}
+
+/* Random process name: letters, digits, '/', ':' and inner spaces */
+static void rand_proc_name(char *buf, int max_len)
+{
+    static const char chars[] = "abcdefghijklmnopqrstuvwxyz0123456789/:-_ ";
+    int len = rand_range(1, max_len);
+    for (int i = 0; i < len; i++)
+        buf[i] = chars[rand() % (int)(sizeof(chars) - 1)];
+    buf[0] = 'a' + rand() % 26;           /* Sin espacios en los extremos */
+    buf[len - 1] = 'a' + rand() % 26;
+    buf[len] = '\0';
+}
+
+static void random_row(ProcessEntry *e, int pid)
+{
+    static const char states[] = "RSDZTIX";
+    memset(e, 0, sizeof(*e));
+    e->pid        = pid;
+    e->uid        = rand_range(-1, 70000);
+    e->state      = states[rand() % 7];
+    e->threads    = rand_range(0, 5000);
+    e->rss_kb     = (long)rand_range(0, 1 << 30);
+    e->cpu_tenths = rand_range(0, 64000);
+    e->start_time = (time_t)rand_range(1000000000, 2000000000);
+    rand_proc_name(e->name, 40);
+}
+
+/* Formatea como procscan_format_long() del servidor. */
+static int format_long(char *buf, size_t size, const ProcessEntry *rows, int count)
+{
+    int n = snprintf(buf, size, "%*s %5s S %3s %9s %5s %10s COMMAND\n", 7, "PID",
+                     "UID", "THR", "RSS_KB", "%CPU", "START");
+    for (int i = 0; i < count; i++) {
+        const ProcessEntry *e = &rows[i];
+        n += snprintf(buf + n, size - (size_t)n, "%*d %5d %c %3d %9ld %3d.%d %10lld %s\n",
+                      7, e->pid, e->uid, e->state, e->threads, e->rss_kb,
+                      e->cpu_tenths / 10, e->cpu_tenths % 10, (long long)e->start_time,
+                      e->name);
+    }
+    return n;
+}
+
+/* ── Properties ─────────────────────────────────────────────────────── */
+
+static void test_long_roundtrip(void)
+{
+    static ProcessEntry rows[MAX_ROWS];
+    static char buf[MAX_ROWS * 128 + 128];
+
+    printf("  Property 5a: LIST LONG recupera todas las columnas\n");
+    for (cur_iter = 0; cur_iter < NUM_ITERATIONS; cur_iter++) {
+        int count = rand_range(0, MAX_ROWS);
+        int pid = 0;
+        for (int i = 0; i < count; i++) {
+            pid += rand_range(1, 5000);
+            random_row(&rows[i], pid);
+        }
+        format_long(buf, sizeof(buf), rows, count);
+
+        ProcessList list;
+        CHECK(process_list_parse(buf, &list) == 0, "parse failed");
+        CHECK(list.has_metrics == 1, "has_metrics not set");
+        CHECK(list.count == count, "count %d != %d", list.count, count);
+        for (int i = 0; i < count && i < list.count; i++) {
+            const ProcessEntry *a = &rows[i], *b = &list.entries[i];
+            CHECK(a->pid == b->pid && a->uid == b->uid && a->state == b->state &&
+                  a->threads == b->threads && a->rss_kb == b->rss_kb &&
+                  a->cpu_tenths == b->cpu_tenths && a->start_time == b->start_time,
+                  "row %d: columns differ (pid %d vs %d)", i, a->pid, b->pid);
+            CHECK(strcmp(a->name, b->name) == 0, "row %d: name '%s' != '%s'",
+                  i, b->name, a->name);
+        }
+        process_list_free(&list);
+    }
+}
+
+static void test_plain_format_has_no_metrics(void)
+{
+    const char *plain = "  PID COMMAND\n    1 init\n   42 sh\n";
+    ProcessList list;
+
+    printf("  Property 5b: el formato ps sigue sin metricas\n");
+    CHECK(process_list_parse(plain, &list) == 0, "parse failed");
+    CHECK(list.has_metrics == 0, "has_metrics set for plain format");
+    CHECK(list.count == 2 && list.entries[1].pid == 42 &&
+          strcmp(list.entries[1].name, "sh") == 0, "plain rows not parsed");
+    process_list_free(&list);
+}
+
+static void test_malformed_rows_skipped(void)
+{
+    const char *text =
+        "  PID   UID S THR    RSS_KB  %CPU      START COMMAND\n"
+        "    1     0 S   1       100   0.0 1700000000 init\n"
+        "    2     0 S\n"
+        "    3     0 S   1       100   1 1700000000 bad\n"
+        "    4  1000 R   2      2048  12.5 1700000001 good name\n";
+    ProcessList list;
+
+    printf("  Property 5c: filas mal formadas se omiten\n");
+    CHECK(process_list_parse(text, &list) == 0, "parse failed");
+    CHECK(list.count == 2, "count %d != 2", list.count);
+    if (list.count == 2) {
+        CHECK(list.entries[0].pid == 1 && list.entries[1].pid == 4, "wrong rows kept");
+        CHECK(list.entries[1].cpu_tenths == 125 && list.entries[1].uid == 1000 &&
+              strcmp(list.entries[1].name, "good name") == 0, "row 4 columns wrong");
+    }
+    process_list_free(&list);
+}
+
+int main(void)
+{
+    unsigned int seed = (unsigned int)time(NULL);
+    srand(seed);
+
+    printf("=== Property 5: Parseo de LIST LONG ===\n");
+    printf("    Validates: Requirements 4.1\n");
+    printf("    Seed: %u\n\n", seed);
+
+    test_long_roundtrip();
+    test_plain_format_has_no_metrics();
+    test_malformed_rows_skipped();
+
+    printf("\nResults: %d/%d checks passed", tests_passed, tests_run);
+    if (tests_failed > 0) {
+        printf(" (%d failed)", tests_failed);
+    }
+    printf("\n");
+
+    if (tests_failed == 0) {
+        printf("PASS\n");
+        return 0;
+    } else {
+        printf("FAIL\n");
+        return 1;
+    }
+}
@@ -0,0 +1,693 @@
+/**
+ * Property-based test for LIST WHERE/SORT/OFFSET/LIMIT (Property 13).
+ *
+ * **Validates: Requirements 4.1**
+ *
+ * Property 13: Consultas sobre la tabla de procesos
+ *   - For any table (with many ties in the sorted field) and any query,
+ *     the rows selected with the bounded heap (SORT ... LIMIT k) are
+ *     exactly the page of a full qsort of the rows that match the WHERE,
+ *     and the total counts every matching row.
+ *   - An OFFSET at or past the number of matching rows yields an empty
+ *     page with the same total, whether LIMIT is given or not.
+ *   - Invalid clauses (unknown fields or operators, missing or negative
+ *     numbers, too many conditions) are rejected with a reason, and any
+ *     sequence of clause words either parses into a query within bounds
+ *     or is rejected the same way.
+ *
+ * The test embeds the parser and row selection (src/server/query.c) and
+ * checks them against a reference built with qsort.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <errno.h>
+#include <time.h>
+
+/* ── Embedded types (src/server/procscan.h, src/server/query.h) ─────── */
+
+#define PROCSCAN_COMM_SIZE 64
+
+typedef struct {
+    int pid;
+    int ppid;
+    char comm[PROCSCAN_COMM_SIZE];
+    char state;
+    int threads;
+    int uid;
+    long rss_kb;
+    long long start_time;
+    unsigned long long start_ticks;
+    unsigned long long cpu_ticks;
+    int cpu_tenths;
+} ProcInfo;
+
+typedef struct {
+    ProcInfo *entries;
+    int count;
+    int capacity;
+} ProcTable;
+
+#define QUERY_MAX_CONDS  8
+
+#define QF_PID      0
+#define QF_PPID     1
+#define QF_UID      2
+#define QF_STATE    3
+#define QF_THREADS  4
+#define QF_RSS      5
+#define QF_CPU      6
+#define QF_START    7
+#define QF_NAME     8
+#define QF_COUNT    9
+
+typedef struct {
+    int field;
+    int op;
+    long long num;
+    char text[PROCSCAN_COMM_SIZE];
+} QueryCond;
+
+typedef struct {
+    QueryCond conds[QUERY_MAX_CONDS];
+    int nconds;
+    int sort_field;
+    int desc;
+    long offset;
+    long limit;
+    unsigned long at;
+    int fields[QF_COUNT];
+    int nfields;
+} Query;
+
+/* ── Embedded parser and row selection (src/server/query.c) ─────────── */
+
+/* Operadores */
+#define OP_EQ   0
+#define OP_NE   1
+#define OP_LT   2
+#define OP_LE   3
+#define OP_GT   4
+#define OP_GE   5
+#define OP_HAS  6
+
+static const struct {
+    const char *name;
+    const char *header;
+    int width;                  /* 0 = ancho de PID */
+} fields[QF_COUNT] = {
+    [QF_PID]     = { "pid",     "PID",     0 },
+    [QF_PPID]    = { "ppid",    "PPID",    0 },
+    [QF_UID]     = { "uid",     "UID",     5 },
+    [QF_STATE]   = { "state",   "S",       1 },
+    [QF_THREADS] = { "threads", "THR",     3 },
+    [QF_RSS]     = { "rss",     "RSS_KB",  9 },
+    [QF_CPU]     = { "cpu",     "%CPU",    5 },
+    [QF_START]   = { "start",   "START",  10 },
+    [QF_NAME]    = { "name",    "COMMAND", 0 },
+};
+
+static int field_by_name(const char *name, size_t len)
+{
+    for (int i = 0; i < QF_COUNT; i++) {
+        if (strlen(fields[i].name) == len && strncasecmp(name, fields[i].name, len) == 0)
+            return i;
+    }
+    /* Sinónimos con los nombres de las columnas */
+    if (len == 4 && strncasecmp(name, "comm", 4) == 0)
+        return QF_NAME;
+    return -1;
+}
+
+static long long field_value(const ProcInfo *e, int field)
+{
+    switch (field) {
+    case QF_PID:     return e->pid;
+    case QF_PPID:    return e->ppid;
+    case QF_UID:     return e->uid;
+    case QF_STATE:   return e->state;
+    case QF_THREADS: return e->threads;
+    case QF_RSS:     return e->rss_kb;
+    case QF_CPU:     return e->cpu_tenths;
+    case QF_START:   return e->start_time;
+    default:         return 0;
+    }
+}
+
+static int is_keyword(const char *tok)
+{
+    return strcasecmp(tok, "WHERE") == 0 || strcasecmp(tok, "SORT") == 0 ||
+           strcasecmp(tok, "OFFSET") == 0 || strcasecmp(tok, "LIMIT") == 0 ||
+           strcasecmp(tok, "FIELDS") == 0 || strcasecmp(tok, "AT") == 0;
+}
+
+/* Parsea "campo<op>valor". Retorna 0 o -1 con el motivo en err. */
+static int parse_cond(const char *tok, QueryCond *c, char *err, size_t err_size)
+{
+    static const struct { const char *text; int op; } ops[] = {
+        { "!=", OP_NE }, { "<=", OP_LE }, { ">=", OP_GE },
+        { "=", OP_EQ }, { "<", OP_LT }, { ">", OP_GT }, { "~", OP_HAS }, { NULL, 0 }
+    };
+    size_t at = strcspn(tok, "=!<>~");
+    const char *value = NULL;
+
+    for (int i = 0; ops[i].text; i++) {
+        if (strncmp(tok + at, ops[i].text, strlen(ops[i].text)) == 0) {
+            c->op = ops[i].op;
+            value = tok + at + strlen(ops[i].text);
+            break;
+        }
+    }
+    c->field = field_by_name(tok, at);
+    if (at == 0 || c->field < 0 || value == NULL || *value == '\0') {
+        snprintf(err, err_size, "Condicion invalida '%s' (ej. name~nginx, rss>1000)", tok);
+        return -1;
+    }
+
+    if (c->field == QF_NAME) {
+        if (c->op != OP_EQ && c->op != OP_NE && c->op != OP_HAS) {
+            snprintf(err, err_size, "name solo admite =, != y ~");
+            return -1;
+        }
+        snprintf(c->text, sizeof(c->text), "%s", value);
+        return 0;
+    }
+    if (c->op == OP_HAS) {
+        snprintf(err, err_size, "~ solo se aplica a name");
+        return -1;
+    }
+    if (c->field == QF_STATE) {
+        if (value[1] != '\0' || (c->op != OP_EQ && c->op != OP_NE)) {
+            snprintf(err, err_size, "state se compara con = o != y una letra (ej. state=R)");
+            return -1;
+        }
+        c->num = toupper((unsigned char)value[0]);
+        return 0;
+    }
+
+    char *end;
+    errno = 0;
+    if (c->field == QF_CPU) {
+        double pct = strtod(value, &end);
+        c->num = (long long)(pct * 10 + (pct >= 0 ? 0.5 : -0.5));
+    } else {
+        c->num = strtoll(value, &end, 10);
+    }
+    if (errno != 0 || *end != '\0') {
+        snprintf(err, err_size, "Valor invalido '%s' en '%s'", value, tok);
+        return -1;
+    }
+    return 0;
+}
+
+/* Parsea "campo,campo,..." sin repetir. */
+static int parse_fields(char *list, Query *q, char *err, size_t err_size)
+{
+    char *save;
+
+    for (char *name = strtok_r(list, ",", &save); name; name = strtok_r(NULL, ",", &save)) {
+        int f = field_by_name(name, strlen(name));
+        if (f < 0) {
+            snprintf(err, err_size, "Campo desconocido '%s'", name);
+            return -1;
+        }
+        int seen = 0;
+        for (int i = 0; i < q->nfields; i++)
+            seen |= q->fields[i] == f;
+        if (!seen)
+            q->fields[q->nfields++] = f;
+    }
+    if (q->nfields == 0) {
+        snprintf(err, err_size, "FIELDS requiere al menos un campo");
+        return -1;
+    }
+    return 0;
+}
+
+static int query_parse(char *args, Query *q, char *err, size_t err_size)
+{
+    char *save;
+    char *tok = strtok_r(args, " ", &save);
+
+    memset(q, 0, sizeof(*q));
+    q->sort_field = -1;
+    q->limit = -1;
+
+    while (tok) {
+        if (strcasecmp(tok, "WHERE") == 0) {
+            while ((tok = strtok_r(NULL, " ", &save)) && !is_keyword(tok)) {
+                if (strcasecmp(tok, "AND") == 0)
+                    continue;
+                if (q->nconds == QUERY_MAX_CONDS) {
+                    snprintf(err, err_size, "Demasiadas condiciones (max %d)", QUERY_MAX_CONDS);
+                    return -1;
+                }
+                if (parse_cond(tok, &q->conds[q->nconds++], err, err_size) != 0)
+                    return -1;
+            }
+            continue;
+        } else if (strcasecmp(tok, "SORT") == 0) {
+            char *name = strtok_r(NULL, " ", &save);
+            q->sort_field = name ? field_by_name(name, strlen(name)) : -1;
+            if (q->sort_field < 0) {
+                snprintf(err, err_size, "SORT requiere un campo (pid, name, rss, cpu...)");
+                return -1;
+            }
+            tok = strtok_r(NULL, " ", &save);
+            if (tok && (strcasecmp(tok, "DESC") == 0 || strcasecmp(tok, "ASC") == 0)) {
+                q->desc = strcasecmp(tok, "DESC") == 0;
+                tok = strtok_r(NULL, " ", &save);
+            }
+            continue;
+        } else if (strcasecmp(tok, "LIMIT") == 0 || strcasecmp(tok, "OFFSET") == 0) {
+            char *value = strtok_r(NULL, " ", &save);
+            char *end = NULL;
+            long n = value ? strtol(value, &end, 10) : -1;
+            if (!value || *end != '\0' || n < 0) {
+                snprintf(err, err_size, "%s requiere un numero >= 0", tok);
+                return -1;
+            }
+            if (strcasecmp(tok, "LIMIT") == 0)
+                q->limit = n;
+            else
+                q->offset = n;
+        } else if (strcasecmp(tok, "AT") == 0) {
+            char *value = strtok_r(NULL, " ", &save);
+            char *end = NULL;
+            if (value && isdigit((unsigned char)value[0]))
+                q->at = strtoul(value, &end, 10);
+            if (end == NULL || *end != '\0' || q->at == 0) {
+                snprintf(err, err_size, "AT requiere una generacion");
+                return -1;
+            }
+        } else if (strcasecmp(tok, "FIELDS") == 0) {
+            char *list = strtok_r(NULL, " ", &save);
+            if (!list) {
+                snprintf(err, err_size, "FIELDS requiere una lista (ej. pid,name,rss)");
+                return -1;
+            }
+            if (parse_fields(list, q, err, err_size) != 0)
+                return -1;
+        } else {
+            snprintf(err, err_size, "Clausula desconocida '%s'", tok);
+            return -1;
+        }
+        tok = strtok_r(NULL, " ", &save);
+    }
+    return 0;
+}
+
+static int matches(const Query *q, const ProcInfo *e)
+{
+    for (int i = 0; i < q->nconds; i++) {
+        const QueryCond *c = &q->conds[i];
+        int ok;
+
+        if (c->field == QF_NAME) {
+            if (c->op == OP_HAS)
+                ok = strcasestr(e->comm, c->text) != NULL;
+            else
+                ok = (strcmp(e->comm, c->text) == 0) == (c->op == OP_EQ);
+        } else {
+            long long v = field_value(e, c->field);
+            switch (c->op) {
+            case OP_EQ: ok = v == c->num; break;
+            case OP_NE: ok = v != c->num; break;
+            case OP_LT: ok = v <  c->num; break;
+            case OP_LE: ok = v <= c->num; break;
+            case OP_GT: ok = v >  c->num; break;
+            default:    ok = v >= c->num; break;
+            }
+        }
+        if (!ok)
+            return 0;
+    }
+    return 1;
+}
+
+/* Orden de salida: el campo de SORT y, a igualdad, el PID. */
+static int compare(const void *pa, const void *pb, void *arg)
+{
+    const Query *q = arg;
+    const ProcInfo *a = *(const ProcInfo *const *)pa;
+    const ProcInfo *b = *(const ProcInfo *const *)pb;
+    int res = 0;
+
+    if (q->sort_field == QF_NAME) {
+        res = strcmp(a->comm, b->comm);
+    } else if (q->sort_field >= 0) {
+        long long x = field_value(a, q->sort_field), y = field_value(b, q->sort_field);
+        res = (x > y) - (x < y);
+    }
+    if (q->desc)
+        res = -res;
+    if (res == 0)
+        res = (a->pid > b->pid) - (a->pid < b->pid);
+    return res;
+}
+
+/* Hunde heap[i] en un heap donde la raíz es la peor fila (la última en salir). */
+static void sift_down(const ProcInfo **heap, int size, int i, const Query *q)
+{
+    for (;;) {
+        int worst = i, l = 2 * i + 1, r = l + 1;
+        if (l < size && compare(&heap[l], &heap[worst], (void *)q) > 0)
+            worst = l;
+        if (r < size && compare(&heap[r], &heap[worst], (void *)q) > 0)
+            worst = r;
+        if (worst == i)
+            return;
+        const ProcInfo *tmp = heap[i];
+        heap[i] = heap[worst];
+        heap[worst] = tmp;
+        i = worst;
+    }
+}
+
+static void sift_up(const ProcInfo **heap, int i, const Query *q)
+{
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (compare(&heap[i], &heap[parent], (void *)q) <= 0)
+            return;
+        const ProcInfo *tmp = heap[i];
+        heap[i] = heap[parent];
+        heap[parent] = tmp;
+        i = parent;
+    }
+}
+
+/*
+ * Deja en *rows las filas que cumplen el WHERE, ordenadas, hasta
+ * OFFSET + LIMIT (las primeras OFFSET incluidas), y en *total cuántas
+ * cumplen. El llamador libera *rows. Retorna 0 si OK, -1 sin memoria.
+ */
+static int select_rows(const Query *q, const ProcTable *table,
+                       const ProcInfo ***out_rows, int *out_count, int *out_total)
+{
+    long k = q->limit;
+
+    /* Hacen falta las primeras OFFSET + LIMIT; las de OFFSET no se envían */
+    if (k < 0 || k > table->count)
+        k = table->count;
+    k = q->offset < table->count - k ? k + q->offset : table->count;
+    const ProcInfo **rows = malloc((size_t)(k + 1) * sizeof(*rows));
+    if (!rows)
+        return -1;
+
+    /*
+     * Sin SORT la tabla ya está en orden de PID: alcanza con las primeras
+     * k que cumplan. Con SORT, un heap con las k mejores hasta ahora.
+     */
+    int total = 0, count = 0;
+    for (int i = 0; i < table->count; i++) {
+        const ProcInfo *e = &table->entries[i];
+        if (!matches(q, e))
+            continue;
+        total++;
+        if (k == 0)
+            continue;
+        if (q->sort_field < 0) {
+            if (count < k)
+                rows[count++] = e;
+        } else if (count < k) {
+            rows[count] = e;
+            sift_up(rows, count++, q);
+        } else if (compare(&e, &rows[0], (void *)q) < 0) {
+            rows[0] = e;
+            sift_down(rows, count, 0, q);
+        }
+    }
+    if (q->sort_field >= 0)
+        qsort_r(rows, (size_t)count, sizeof(*rows), compare, (void *)q);
+
+    *out_rows  = rows;
+    *out_count = count;
+    *out_total = total;
+    return 0;
+}
+
+/* ── Test harness ───────────────────────────────────────────────────── */
+
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+static int cur_iter = 0;  /* Current iteration for CHECK context */
+
+#define CHECK(cond, fmt, ...)                                       \
+    do {                                                            \
+        tests_run++;                                                \
+        if (cond) {                                                 \
+            tests_passed++;                                         \
+        } else {                                                    \
+            tests_failed++;                                         \
+            fprintf(stderr, "  FAIL [iter=%d]: " fmt "\n",          \
+                    cur_iter, ##__VA_ARGS__);                        \
+        }                                                           \
+    } while (0)
+
+#define NUM_ITERATIONS 300
+#define MAX_ROWS       200
+
+static const char *names[] = { "bash", "nginx", "sshd", "Nginx-worker", "sleep", "a b" };
+#define NUM_NAMES (int)(sizeof(names) / sizeof(names[0]))
+
+/* Tabla ordenada por PID con pocos valores distintos, para forzar empates. */
+static void random_table(ProcTable *t, int n)
+{
+    static const char states[] = "RSDZ";
+    int pid = 0;
+
+    for (int i = 0; i < n; i++) {
+        ProcInfo *e = &t->entries[i];
+        memset(e, 0, sizeof(*e));
+        pid += 1 + rand() % 50;
+        e->pid        = pid;
+        e->ppid       = rand() % 2 ? 1 : rand() % (pid + 1);
+        snprintf(e->comm, sizeof(e->comm), "%s", names[rand() % NUM_NAMES]);
+        e->state      = states[rand() % 4];
+        e->threads    = 1 + rand() % 4;
+        e->uid        = rand() % 3 * 500;
+        e->rss_kb     = rand() % 8 * 1024;
+        e->start_time = 1700000000LL + rand() % 5;
+        e->cpu_tenths = rand() % 6 * 5;
+    }
+    t->count = n;
+}
+
+/* Consulta al azar como la escribiría un cliente. */
+static void random_query_text(char *buf, size_t size)
+{
+    static const char *conds[] = {
+        "rss>2048", "rss<=4096", "cpu>=1.0", "cpu=0", "uid=0", "uid!=500",
+        "state=R", "state!=s", "threads>1", "name~nginx", "name=bash",
+        "name!=sleep", "ppid=1", "pid>100", "start>1700000001",
+    };
+    static const char *sorts[] = {
+        "pid", "ppid", "name", "uid", "state", "threads", "rss", "cpu", "start", "comm"
+    };
+    int len = 0;
+
+    buf[0] = '\0';
+    if (rand() % 2) {
+        len += snprintf(buf + len, size - len, "WHERE");
+        int n = 1 + rand() % 3;
+        for (int i = 0; i < n; i++) {
+            len += snprintf(buf + len, size - len, "%s%s", i ? " AND " : " ",
+                            conds[rand() % (int)(sizeof(conds) / sizeof(conds[0]))]);
+        }
+    }
+    if (rand() % 4 != 0) {
+        len += snprintf(buf + len, size - len, " SORT %s%s",
+                        sorts[rand() % (int)(sizeof(sorts) / sizeof(sorts[0]))],
+                        rand() % 3 == 0 ? "" : rand() % 2 ? " DESC" : " ASC");
+    }
+    if (rand() % 2)
+        len += snprintf(buf + len, size - len, " OFFSET %d", rand() % (MAX_ROWS + 20));
+    if (rand() % 4 != 0)
+        len += snprintf(buf + len, size - len, " LIMIT %d", rand() % 30);
+}
+
+/* Referencia: filtra todo, ordena con qsort y corta la página. */
+static int reference_page(const Query *q, const ProcTable *t, const ProcInfo **page,
+                          int *total)
+{
+    const ProcInfo **all = malloc((size_t)(t->count + 1) * sizeof(*all));
+    int n = 0, count = 0;
+
+    for (int i = 0; i < t->count; i++) {
+        if (matches(q, &t->entries[i]))
+            all[n++] = &t->entries[i];
+    }
+    qsort_r(all, (size_t)n, sizeof(*all), compare, (void *)q);
+    for (long i = q->offset; i < n && (q->limit < 0 || i < q->offset + q->limit); i++)
+        page[count++] = all[i];
+    *total = n;
+    free(all);
+    return count;
+}
+
+/* Property 13a: el heap de SORT ... LIMIT da la misma página que qsort */
+static void test_heap_matches_qsort(ProcTable *t)
+{
+    const ProcInfo *expected[MAX_ROWS + 1];
+    char text[512], copy[512], err[128];
+
+    for (cur_iter = 0; cur_iter < NUM_ITERATIONS; cur_iter++) {
+        Query q;
+        random_table(t, rand() % (MAX_ROWS + 1));
+        random_query_text(text, sizeof(text));
+        snprintf(copy, sizeof(copy), "%s", text);
+        if (query_parse(copy, &q, err, sizeof(err)) != 0) {
+            CHECK(0, "consulta valida rechazada '%s': %s", text, err);
+            continue;
+        }
+
+        const ProcInfo **rows;
+        int count, total, ref_total;
+        int ref_count = reference_page(&q, t, expected, &ref_total);
+        if (select_rows(&q, t, &rows, &count, &total) != 0) {
+            CHECK(0, "select_rows sin memoria");
+            continue;
+        }
+
+        int page = count > q.offset ? count - (int)q.offset : 0;
+        int same = page == ref_count;
+        for (int i = 0; same && i < page; i++)
+            same = rows[q.offset + i] == expected[i];
+        CHECK(same, "'%s' sobre %d filas: %d filas, qsort da %d", text, t->count, page, ref_count);
+        CHECK(total == ref_total, "'%s': total %d, esperado %d", text, total, ref_total);
+        free(rows);
+    }
+}
+
+/* Property 13b: OFFSET en o más allá de las filas que cumplen */
+static void test_offset_past_end(ProcTable *t)
+{
+    char text[128], err[128];
+
+    for (cur_iter = 0; cur_iter < NUM_ITERATIONS; cur_iter++) {
+        Query q;
+        random_table(t, rand() % (MAX_ROWS + 1));
+        int past = rand() % 3 == 0 ? 1000000000 : rand() % 10;
+        const char *where = rand() % 2 ? "WHERE name~nginx " : "";
+        const char *sort = rand() % 2 ? "SORT rss DESC " : "";
+
+        /* Cuántas cumplen el WHERE, para pedir desde ahí */
+        snprintf(text, sizeof(text), "%s", where);
+        query_parse(text, &q, err, sizeof(err));
+        int matching = 0;
+        for (int i = 0; i < t->count; i++)
+            matching += matches(&q, &t->entries[i]);
+
+        int limit = rand() % 3 == 0 ? -1 : rand() % 20;
+        if (limit < 0)
+            snprintf(text, sizeof(text), "%s%sOFFSET %d", where, sort, matching + past);
+        else
+            snprintf(text, sizeof(text), "%s%sOFFSET %d LIMIT %d", where, sort, matching + past, limit);
+        if (query_parse(text, &q, err, sizeof(err)) != 0) {
+            CHECK(0, "OFFSET valido rechazado: %s", err);
+            continue;
+        }
+
+        const ProcInfo **rows;
+        int count, total;
+        if (select_rows(&q, t, &rows, &count, &total) != 0) {
+            CHECK(0, "select_rows sin memoria");
+            continue;
+        }
+        CHECK(count <= q.offset, "OFFSET %ld con %d filas deja %d en la pagina",
+              q.offset, matching, count - (int)q.offset);
+        CHECK(total == matching, "OFFSET %ld: total %d, esperado %d", q.offset, total, matching);
+        free(rows);
+    }
+}
+
+/* Property 13c: cláusulas inválidas */
+static void test_invalid_clauses(void)
+{
+    static const char *invalid[] = {
+        "SORT", "SORT bogus", "LIMIT", "LIMIT -1", "LIMIT 3x", "OFFSET", "OFFSET -2",
+        "OFFSET abc", "WHERE rss", "WHERE rss>", "WHERE rss>abc", "WHERE >5",
+        "WHERE name<x", "WHERE name>=x", "WHERE rss~x", "WHERE state=RR",
+        "WHERE state>R", "WHERE bogus=1", "WHERE cpu>1.5.2", "FIELDS",
+        "FIELDS pid,bogus", "FIELDS ,", "AT", "AT 0", "AT x", "AT -3", "BOGUS",
+        "LIMIT 5 BOGUS", "rss>1",
+        "WHERE pid>1 pid>2 pid>3 pid>4 pid>5 pid>6 pid>7 pid>8 pid>9",
+    };
+    static const char *words[] = {
+        "WHERE", "SORT", "OFFSET", "LIMIT", "FIELDS", "AT", "AND", "ASC", "DESC",
+        "pid", "rss>10", "name~x", "state=R", "cpu<", "-1", "0", "7", "pid,name",
+        "bogus", "name<x", "~", "=", "",
+    };
+    char text[256], err[128];
+
+    cur_iter = 0;
+    for (int i = 0; i < (int)(sizeof(invalid) / sizeof(invalid[0])); i++) {
+        Query q;
+        snprintf(text, sizeof(text), "%s", invalid[i]);
+        err[0] = '\0';
+        CHECK(query_parse(text, &q, err, sizeof(err)) != 0 && err[0] != '\0',
+              "clausula invalida aceptada (o sin motivo): '%s'", invalid[i]);
+    }
+
+    /* Secuencias al azar: o se rechazan con motivo o quedan en rango */
+    for (cur_iter = 0; cur_iter < NUM_ITERATIONS; cur_iter++) {
+        Query q;
+        int len = 0, n = rand() % 8;
+        for (int i = 0; i < n; i++) {
+            len += snprintf(text + len, sizeof(text) - len, "%s%s", i ? " " : "",
+                            words[rand() % (int)(sizeof(words) / sizeof(words[0]))]);
+        }
+        text[len] = '\0';
+        char shown[256];
+        snprintf(shown, sizeof(shown), "%s", text);
+        err[0] = '\0';
+        if (query_parse(text, &q, err, sizeof(err)) != 0) {
+            CHECK(err[0] != '\0', "'%s' rechazada sin motivo", shown);
+            continue;
+        }
+        int ok = q.nconds >= 0 && q.nconds <= QUERY_MAX_CONDS &&
+                 q.nfields >= 0 && q.nfields <= QF_COUNT &&
+                 q.sort_field >= -1 && q.sort_field < QF_COUNT &&
+                 q.offset >= 0 && q.limit >= -1;
+        for (int i = 0; ok && i < q.nconds; i++)
+            ok = q.conds[i].field >= 0 && q.conds[i].field < QF_COUNT;
+        CHECK(ok, "'%s' aceptada fuera de rango", shown);
+    }
+}
+
+int main(void)
+{
+    unsigned int seed = (unsigned int)time(NULL);
+    srand(seed);
+
+    printf("=== Property 13: Consultas sobre la tabla de procesos ===\n");
+    printf("    Validates: Requirements 4.1\n");
+    printf("    Seed: %u\n\n", seed);
+
+    ProcTable table = { malloc(MAX_ROWS * sizeof(ProcInfo)), 0, MAX_ROWS };
+    test_heap_matches_qsort(&table);
+    test_offset_past_end(&table);
+    test_invalid_clauses();
+    free(table.entries);
+
+    printf("\nResults: %d/%d checks passed", tests_passed, tests_run);
+    if (tests_failed > 0) {
+        printf(" (%d failed)", tests_failed);
+    }
+    printf("\n");
+
+    if (tests_failed == 0) {
+        printf("PASS\n");
+        return 0;
+    } else {
+        printf("FAIL\n");
+        return 1;
+    }
+}
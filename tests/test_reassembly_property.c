@@ -0,0 +1,408 @@
+/**
+ * Property-based test for the client receive buffer (Property 10).
+ *
+ * **Validates: Requirements 4.1**
+ *
+ * Property 10: Reensamblado de mensajes en el cliente
+ *   a) For any sequence of framed messages (split into several frames
+ *      with the MORE flag, events mixed with replies, empty payloads)
+ *      delivered in chunks of random size, the reader returns exactly
+ *      the same messages, with their types, in order.
+ *   b) The receive buffer never grows past what one recv() can add:
+ *      frames are copied to the message as they arrive.
+ *   c) In text mode only complete lines are delivered, and their
+ *      concatenation equals the input.
+ *   d) A header with a reserved byte set or an oversized payload is
+ *      rejected as a corrupt stream.
+ *
+ * The test embeds the buffer logic of src/client/net.c directly, with
+ * recv() replaced by a copy of the next chunk, so it builds without
+ * sockets or ncurses.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* ── Embedded reader (src/client/net.c), without compression ──────── */
+
+#define NET_BUFFER_SIZE       65536
+#define NET_FRAME_HEADER_SIZE 8
+#define NET_FRAME_MAX_PAYLOAD (64u * 1024 * 1024)
+#define NET_FRAME_RESP        2
+#define NET_FRAME_EVENT       3
+#define NET_FRAME_F_MORE      0x01
+#define NET_FRAME_F_COMPRESSED 0x02
+
+typedef struct {
+    int framed;
+    char *buf;
+    size_t start;
+    size_t len;
+    size_t cap;
+    int frame_open;
+    int frame_last;
+    size_t frame_left;
+    char *msg;
+    size_t msg_len;
+    size_t msg_cap;
+    int msg_type;
+    int msg_packed;
+} NetReader;
+
+static int grow(char **buf, size_t *cap, size_t used, size_t extra) {
+    if (*cap - used >= extra + 1) {
+        return 0;
+    }
+    size_t new_cap = *cap ? *cap : NET_BUFFER_SIZE;
+    while (new_cap - used < extra + 1) {
+        new_cap *= 2;
+    }
+    char *tmp = realloc(*buf, new_cap);
+    if (!tmp) {
+        return -1;
+    }
+    *buf = tmp;
+    *cap = new_cap;
+    return 0;
+}
+
+static char *reader_data(const NetReader *rd) {
+    return rd->buf + rd->start;
+}
+
+/* reader_fill con recv() reemplazado por copiar chunk */
+static int reader_fill(NetReader *rd, const char *chunk, size_t n) {
+    if (rd->start > 0 && rd->cap - rd->start - rd->len < NET_BUFFER_SIZE + 1) {
+        memmove(rd->buf, reader_data(rd), rd->len);
+        rd->start = 0;
+    }
+    if (grow(&rd->buf, &rd->cap, rd->start + rd->len, NET_BUFFER_SIZE) != 0) {
+        return -1;
+    }
+    memcpy(reader_data(rd) + rd->len, chunk, n);
+    rd->len += n;
+    return (int)n;
+}
+
+static void reader_consume(NetReader *rd, size_t n) {
+    rd->start += n;
+    rd->len -= n;
+    if (rd->len == 0) {
+        rd->start = 0;
+    }
+}
+
+static int reader_unpack(NetReader *rd) {
+    (void)rd;
+    return -1; /* Los mensajes de la prueba no van comprimidos */
+}
+
+static int reader_extract(NetReader *rd) {
+    if (!rd->framed) {
+        size_t n = rd->len;
+        while (n > 0 && reader_data(rd)[n - 1] != '\n') {
+            n--;
+        }
+        if (n == 0) {
+            return 0;
+        }
+        if (grow(&rd->msg, &rd->msg_cap, 0, n) != 0) {
+            return -1;
+        }
+        memcpy(rd->msg, reader_data(rd), n);
+        rd->msg_len = n;
+        rd->msg[rd->msg_len] = '\0';
+        rd->msg_type = NET_FRAME_RESP;
+        reader_consume(rd, n);
+        return 1;
+    }
+
+    for (;;) {
+        if (!rd->frame_open) {
+            if (rd->len < NET_FRAME_HEADER_SIZE) {
+                return 0;
+            }
+            const unsigned char *h = (const unsigned char *)reader_data(rd);
+            size_t plen = ((size_t)h[0] << 24) | ((size_t)h[1] << 16) |
+                          ((size_t)h[2] << 8) | (size_t)h[3];
+            if (plen > NET_FRAME_MAX_PAYLOAD || h[4] == 0 || h[6] != 0 || h[7] != 0 ||
+                rd->msg_len + plen > NET_FRAME_MAX_PAYLOAD) {
+                return -1;
+            }
+            rd->msg_type = h[4];
+            rd->msg_packed |= h[5] & NET_FRAME_F_COMPRESSED;
+            rd->frame_last = !(h[5] & NET_FRAME_F_MORE);
+            rd->frame_left = plen;
+            rd->frame_open = 1;
+            reader_consume(rd, NET_FRAME_HEADER_SIZE);
+        }
+
+        size_t n = rd->len < rd->frame_left ? rd->len : rd->frame_left;
+        if (grow(&rd->msg, &rd->msg_cap, rd->msg_len, n) != 0) {
+            return -1;
+        }
+        memcpy(rd->msg + rd->msg_len, reader_data(rd), n);
+        rd->msg_len += n;
+        rd->msg[rd->msg_len] = '\0';
+        rd->frame_left -= n;
+        reader_consume(rd, n);
+        if (rd->frame_left > 0) {
+            return 0;
+        }
+        rd->frame_open = 0;
+        if (rd->frame_last) {
+            break;
+        }
+    }
+
+    if (rd->msg_packed) {
+        rd->msg_packed = 0;
+        if (reader_unpack(rd) != 0) {
+            return -1;
+        }
+    }
+    return 1;
+}
+
+/* ── Test harness ───────────────────────────────────────────────────── */
+
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+static int cur_iter = 0;  /* Current iteration for CHECK context */
+
+#define CHECK(cond, fmt, ...)                                       \
+    do {                                                            \
+        tests_run++;                                                \
+        if (cond) {                                                 \
+            tests_passed++;                                         \
+        } else {                                                    \
+            tests_failed++;                                         \
+            fprintf(stderr, "  FAIL [iter=%d]: " fmt "\n",          \
+                    cur_iter, ##__VA_ARGS__);                        \
+        }                                                           \
+    } while (0)
+
+#define NUM_ITERATIONS 200
+#define MAX_MSGS       40
+
+/* Random int in [lo, hi] inclusive */
+static int rand_range(int lo, int hi)
+{
+    return lo + rand() % (hi - lo + 1);
+}
+
+typedef struct {
+    char *data;
+    size_t len;
+    int type;
+} Message;
+
+/* Agrega un frame al flujo */
+static size_t put_frame(unsigned char *p, int type, int flags, const char *payload, size_t len)
+{
+    p[0] = (unsigned char)(len >> 24);
+    p[1] = (unsigned char)(len >> 16);
+    p[2] = (unsigned char)(len >> 8);
+    p[3] = (unsigned char)len;
+    p[4] = (unsigned char)type;
+    p[5] = (unsigned char)flags;
+    p[6] = 0;
+    p[7] = 0;
+    memcpy(p + NET_FRAME_HEADER_SIZE, payload, len);
+    return NET_FRAME_HEADER_SIZE + len;
+}
+
+/* Tamaño de mensaje: casi siempre chico, a veces vacío o de varios recv() */
+static size_t gen_size(void)
+{
+    switch (rand() % 10) {
+    case 0:  return 0;
+    case 1:  return (size_t)rand_range(NET_BUFFER_SIZE, 3 * NET_BUFFER_SIZE);
+    default: return (size_t)rand_range(1, 2000);
+    }
+}
+
+/* Entrega el flujo en chunks al azar y compara lo extraído con msgs */
+static void feed_and_check(NetReader *rd, const unsigned char *stream, size_t total,
+                           const Message *msgs, int count)
+{
+    size_t off = 0, max_cap = 0;
+    int got = 0, ok = 1, r = 0;
+
+    while (ok && got < count) {
+        r = reader_extract(rd);
+        if (r < 0) {
+            ok = 0;
+            break;
+        }
+        if (r == 1) {
+            if (rd->msg_len != msgs[got].len || rd->msg_type != msgs[got].type ||
+                memcmp(rd->msg, msgs[got].data, msgs[got].len) != 0) {
+                ok = 0;
+            }
+            got++;
+            rd->msg_len = 0;
+            continue;
+        }
+        if (off >= total) {
+            break;
+        }
+        size_t n = (size_t)(rand() % 4 ? rand_range(1, 64) : rand_range(1, NET_BUFFER_SIZE));
+        if (n > total - off) {
+            n = total - off;
+        }
+        reader_fill(rd, (const char *)stream + off, n);
+        off += n;
+        if (rd->cap > max_cap) {
+            max_cap = rd->cap;
+        }
+    }
+
+    CHECK(ok && got == count && off == total && rd->len == 0,
+          "%s: %d de %d mensajes (res %d, %zu de %zu bytes)",
+          rd->framed ? "FRAMED" : "texto", got, count, r, off, total);
+    CHECK(max_cap <= 2 * NET_BUFFER_SIZE,
+          "buffer de recepcion de %zu bytes (mensajes hasta %d KB)",
+          max_cap, 3 * NET_BUFFER_SIZE / 1024);
+}
+
+/* Property 10a/b: mensajes enmarcados en chunks al azar */
+static void test_framed(void)
+{
+    for (cur_iter = 0; cur_iter < NUM_ITERATIONS; cur_iter++) {
+        Message msgs[MAX_MSGS];
+        int count = rand_range(1, MAX_MSGS);
+        size_t cap = 0;
+
+        for (int i = 0; i < count; i++) {
+            msgs[i].len = gen_size();
+            msgs[i].type = rand() % 4 ? NET_FRAME_RESP : NET_FRAME_EVENT;
+            msgs[i].data = malloc(msgs[i].len + 1);
+            for (size_t k = 0; k < msgs[i].len; k++)
+                msgs[i].data[k] = (char)rand();
+            /* Como mucho un frame por byte, más el último */
+            cap += msgs[i].len * (NET_FRAME_HEADER_SIZE + 1) + NET_FRAME_HEADER_SIZE;
+        }
+
+        unsigned char *stream = malloc(cap);
+        size_t total = 0;
+        for (int i = 0; i < count; i++) {
+            size_t sent = 0;
+            do {
+                size_t part = msgs[i].len - sent;
+                if (part > 0 && rand() % 3 == 0)
+                    part = (size_t)rand_range(0, (int)part);
+                int more = sent + part < msgs[i].len;
+                total += put_frame(stream + total, msgs[i].type, more ? NET_FRAME_F_MORE : 0,
+                                   msgs[i].data + sent, part);
+                sent += part;
+            } while (sent < msgs[i].len);
+        }
+
+        NetReader rd;
+        memset(&rd, 0, sizeof(rd));
+        rd.framed = 1;
+        feed_and_check(&rd, stream, total, msgs, count);
+
+        free(rd.buf);
+        free(rd.msg);
+        free(stream);
+        for (int i = 0; i < count; i++)
+            free(msgs[i].data);
+    }
+}
+
+/* Property 10c: en modo texto solo se entregan líneas completas */
+static void test_text(void)
+{
+    for (cur_iter = 0; cur_iter < NUM_ITERATIONS; cur_iter++) {
+        size_t total = (size_t)rand_range(1, 200000);
+        char *stream = malloc(total);
+        for (size_t k = 0; k < total; k++)
+            stream[k] = rand() % 40 ? (char)rand_range('a', 'z') : '\n';
+        stream[total - 1] = '\n';
+
+        NetReader rd;
+        memset(&rd, 0, sizeof(rd));
+        char *joined = malloc(total);
+        size_t off = 0, out = 0;
+        int whole = 1, r;
+
+        while (off < total || rd.len > 0) {
+            while ((r = reader_extract(&rd)) == 1) {
+                whole &= rd.msg[rd.msg_len - 1] == '\n';
+                memcpy(joined + out, rd.msg, rd.msg_len);
+                out += rd.msg_len;
+            }
+            if (r < 0 || off >= total)
+                break;
+            size_t n = (size_t)rand_range(1, 5000);
+            if (n > total - off)
+                n = total - off;
+            reader_fill(&rd, stream + off, n);
+            off += n;
+        }
+
+        CHECK(whole && out == total && memcmp(joined, stream, total) == 0,
+              "texto: %zu de %zu bytes en lineas completas", out, total);
+        free(joined);
+        free(stream);
+        free(rd.buf);
+        free(rd.msg);
+    }
+}
+
+/* Property 10d: cabeceras corruptas */
+static void test_corrupt(void)
+{
+    for (cur_iter = 0; cur_iter < NUM_ITERATIONS; cur_iter++) {
+        unsigned char hdr[NET_FRAME_HEADER_SIZE];
+        put_frame(hdr, NET_FRAME_RESP, 0, "", 0);
+        switch (rand() % 3) {
+        case 0: hdr[6 + rand() % 2] = (unsigned char)rand_range(1, 255); break;
+        case 1: hdr[4] = 0; break;
+        default: hdr[0] = (unsigned char)rand_range(5, 255); break; /* > 64 MB */
+        }
+
+        NetReader rd;
+        memset(&rd, 0, sizeof(rd));
+        rd.framed = 1;
+        reader_fill(&rd, (const char *)hdr, sizeof(hdr));
+        CHECK(reader_extract(&rd) == -1, "cabecera %02x %02x %02x %02x %02x %02x %02x %02x aceptada",
+              hdr[0], hdr[1], hdr[2], hdr[3], hdr[4], hdr[5], hdr[6], hdr[7]);
+        free(rd.buf);
+        free(rd.msg);
+    }
+}
+
+int main(void)
+{
+    unsigned int seed = (unsigned int)time(NULL);
+    srand(seed);
+
+    printf("=== Property 10: Reensamblado de mensajes en el cliente ===\n");
+    printf("    Validates: Requirements 4.1\n");
+    printf("    Seed: %u\n\n", seed);
+
+    test_framed();
+    test_text();
+    test_corrupt();
+
+    printf("\nResults: %d/%d checks passed", tests_passed, tests_run);
+    if (tests_failed > 0) {
+        printf(" (%d failed)", tests_failed);
+    }
+    printf("\n");
+
+    if (tests_failed == 0) {
+        printf("PASS\n");
+        return 0;
+    } else {
+        printf("FAIL\n");
+        return 1;
+    }
+}
@@ -0,0 +1,208 @@
+/**
+ * Property-based test for STOP on START --group jobs (Property 12).
+ *
+ * **Validates: Requirements 4.1**
+ *
+ * Property 12: STOP solo señala al grupo de un trabajo vivo
+ *   a) A running group job whose process still leads its group is
+ *      stopped as a group.
+ *   b) Once the job exited, its record never makes STOP signal a group,
+ *      even when the PID now belongs to another process that leads its
+ *      own group (PID reused) or to a process inside someone else's
+ *      group.
+ *   c) A stale record still marked running (the exit was not recorded
+ *      yet) only counts if the process at that PID leads its own group,
+ *      and a PID with no process behind it is never a group.
+ *
+ * The test embeds stop_is_group (src/server/main.c) and
+ * stopper_leads_group (src/server/stopper.c) over a small job table, and
+ * uses real processes: PID reuse is simulated by pointing an exited
+ * record at a live process.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+/* ── Embedded copy of the job table lookup (src/server/jobs.h) ──────── */
+
+typedef struct {
+    pid_t pid;
+    int running;
+    int group;
+} JobInfo;
+
+#define MAX_JOBS 8
+static JobInfo jobs[MAX_JOBS];
+static int job_count;
+
+static int jobs_lookup(pid_t pid, JobInfo *info)
+{
+    for (int i = 0; i < job_count; i++) {
+        if (jobs[i].pid == pid) {
+            *info = jobs[i];
+            return 0;
+        }
+    }
+    return -1;
+}
+
+/* ── Embedded copy of stopper_leads_group (src/server/stopper.c) ───── */
+
+static int sys_pidfd_open(pid_t pid)
+{
+    return (int)syscall(SYS_pidfd_open, pid, 0);
+}
+
+static int stopper_leads_group(pid_t pid)
+{
+    int pidfd = sys_pidfd_open(pid);
+    if (pidfd < 0)
+        return 0;
+
+    struct pollfd pfd = { .fd = pidfd, .events = POLLIN };
+    int leads = getpgid(pid) == pid && poll(&pfd, 1, 0) == 0;
+    close(pidfd);
+    return leads;
+}
+
+/* ── Embedded copy of stop_is_group (src/server/main.c) ─────────────── */
+
+static int stop_is_group(int pid) {
+    JobInfo info;
+    return jobs_lookup(pid, &info) == 0 && info.group && info.running &&
+           stopper_leads_group(pid);
+}
+
+/* ── Test harness ───────────────────────────────────────────────────── */
+
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+static int cur_iter = 0;  /* Current iteration for CHECK context */
+
+#define CHECK(cond, fmt, ...)                                       \
+    do {                                                            \
+        tests_run++;                                                \
+        if (cond) {                                                 \
+            tests_passed++;                                         \
+        } else {                                                    \
+            tests_failed++;                                         \
+            fprintf(stderr, "  FAIL [iter=%d]: " fmt "\n",          \
+                    cur_iter, ##__VA_ARGS__);                        \
+        }                                                           \
+    } while (0)
+
+#define NUM_ITERATIONS 20
+
+/* Hijo que duerme; con leader, en su propia sesión (como START --group). */
+static pid_t spawn_sleeper(int leader)
+{
+    pid_t pid = fork();
+    if (pid == 0) {
+        if (leader)
+            setsid();
+        pause();
+        _exit(0);
+    }
+    /* Esperar a que setsid() haya corrido */
+    for (int i = 0; leader && i < 1000 && getpgid(pid) != pid; i++)
+        usleep(1000);
+    return pid;
+}
+
+static void reap(pid_t pid)
+{
+    kill(pid, SIGKILL);
+    waitpid(pid, NULL, 0);
+}
+
+/* Property 12a: trabajo de grupo vivo */
+static void test_running_group(void)
+{
+    for (cur_iter = 0; cur_iter < NUM_ITERATIONS; cur_iter++) {
+        pid_t leader = spawn_sleeper(1);
+        jobs[0] = (JobInfo){ leader, 1, 1 };
+        job_count = 1;
+
+        CHECK(stop_is_group(leader), "trabajo de grupo %d vivo no se trata como grupo", leader);
+
+        /* Sin --group, el mismo proceso se detiene solo */
+        jobs[0].group = 0;
+        CHECK(!stop_is_group(leader), "trabajo %d sin --group tratado como grupo", leader);
+        reap(leader);
+    }
+}
+
+/* Property 12b: registro de un trabajo que terminó, con el PID reciclado */
+static void test_exited_reused(void)
+{
+    for (cur_iter = 0; cur_iter < NUM_ITERATIONS; cur_iter++) {
+        /* El nuevo dueño del número lidera su grupo, o está en el nuestro */
+        int new_is_leader = rand() % 2;
+        pid_t owner = spawn_sleeper(new_is_leader);
+        jobs[0] = (JobInfo){ owner, 0, 1 };
+        job_count = 1;
+
+        CHECK(!stop_is_group(owner),
+              "registro terminado con PID %d reciclado (%s) tratado como grupo",
+              owner, new_is_leader ? "lider" : "no lider");
+        reap(owner);
+    }
+}
+
+/* Property 12c: registro viejo aún marcado como corriendo */
+static void test_stale_running(void)
+{
+    for (cur_iter = 0; cur_iter < NUM_ITERATIONS; cur_iter++) {
+        pid_t member = spawn_sleeper(0);
+        jobs[0] = (JobInfo){ member, 1, 1 };
+        job_count = 1;
+        CHECK(!stop_is_group(member), "PID %d dentro de otro grupo tratado como grupo", member);
+
+        /* Terminó y se recogió, pero la salida aún no se registró */
+        reap(member);
+        CHECK(!stop_is_group(member), "PID %d sin proceso tratado como grupo", member);
+
+        /* Sin registro, nunca es grupo */
+        job_count = 0;
+        CHECK(!stop_is_group(getpid()), "PID sin registro tratado como grupo");
+    }
+}
+
+int main(void)
+{
+    unsigned int seed = (unsigned int)time(NULL);
+    srand(seed);
+
+    printf("=== Property 12: STOP de grupos solo con trabajos vivos ===\n");
+    printf("    Validates: Requirements 4.1\n");
+    printf("    Seed: %u\n\n", seed);
+
+    test_running_group();
+    test_exited_reused();
+    test_stale_running();
+
+    printf("\nResults: %d/%d checks passed", tests_passed, tests_run);
+    if (tests_failed > 0) {
+        printf(" (%d failed)", tests_failed);
+    }
+    printf("\n");
+
+    if (tests_failed == 0) {
+        printf("PASS\n");
+        return 0;
+    } else {
+        printf("FAIL\n");
+        return 1;
+    }
+}
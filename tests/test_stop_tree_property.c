@@ -0,0 +1,358 @@
+/**
+ * Property-based test for STOP --tree and STOP --name (Property 16).
+ *
+ * **Validates: Requirements 4.1**
+ *
+ * Property 16: Resolución de PIDs para STOP en bloque
+ *   a) For any table, including ones where PID reuse left a cycle in the
+ *      parent links or a process that is its own parent,
+ *      proctable_descendants returns the root first, each PID once,
+ *      parents before children, never more than the table holds, and
+ *      exactly the processes reachable from the root through parent
+ *      links. A root missing from the table yields 0.
+ *   b) proctable_match returns exactly the PIDs whose comm matches the
+ *      glob, in table order, for patterns with *, ? and brackets and for
+ *      names with spaces.
+ *
+ * The test embeds both functions (src/server/procscan.c) and checks them
+ * against a naive closure and a small reference glob matcher.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fnmatch.h>
+#include <time.h>
+
+/* ── Embedded types (src/server/procscan.h) ─────────────────────────── */
+
+#define PROCSCAN_COMM_SIZE 64
+
+typedef struct {
+    int pid;
+    int ppid;
+    char comm[PROCSCAN_COMM_SIZE];
+} ProcInfo;
+
+typedef struct {
+    ProcInfo *entries;
+    int count;
+    int capacity;
+} ProcTable;
+
+/* ── Embedded descendants and match (src/server/procscan.c) ─────────── */
+
+/* Posición de pid en el índice (direccionamiento abierto), o -1. */
+static int index_find(const int *slots, size_t mask, const ProcTable *table, int pid)
+{
+    for (size_t h = ((unsigned int)pid * 2654435761u) & mask; slots[h]; h = (h + 1) & mask) {
+        if (table->entries[slots[h] - 1].pid == pid)
+            return slots[h] - 1;
+    }
+    return -1;
+}
+
+int proctable_descendants(const ProcTable *table, int root, int *out)
+{
+    int n = table->count;
+    size_t buckets = 16;
+    while (buckets < (size_t)n * 2)
+        buckets <<= 1;
+
+    int *slots = calloc(buckets, sizeof(int));      /* Posición + 1, 0 = libre */
+    int *first = malloc((size_t)(n + 1) * sizeof(int));
+    int *next  = malloc((size_t)(n + 1) * sizeof(int));
+    int *queue = malloc((size_t)(n + 1) * sizeof(int));
+    unsigned char *seen = calloc((size_t)n + 1, 1);   /* Ya encolado */
+    if (!slots || !first || !next || !queue || !seen) {
+        free(slots); free(first); free(next); free(queue); free(seen);
+        return -1;
+    }
+
+    size_t mask = buckets - 1;
+    for (int i = 0; i < n; i++) {
+        size_t h = ((unsigned int)table->entries[i].pid * 2654435761u) & mask;
+        while (slots[h])
+            h = (h + 1) & mask;
+        slots[h] = i + 1;
+        first[i] = -1;
+    }
+    /* Lista de hijos de cada proceso */
+    for (int i = 0; i < n; i++) {
+        const ProcInfo *e = &table->entries[i];
+        int parent = e->ppid != e->pid ? index_find(slots, mask, table, e->ppid) : -1;
+        if (parent >= 0) {
+            next[i] = first[parent];
+            first[parent] = i;
+        }
+    }
+
+    /*
+     * Recorrido en anchura desde root. Con PIDs reciclados entre lecturas
+     * la tabla puede tener ciclos: cada entrada se encola una sola vez, así
+     * la cola (y out) nunca pasan de n.
+     */
+    int count = 0, head = 0;
+    int r = index_find(slots, mask, table, root);
+    if (r >= 0) {
+        queue[count++] = r;
+        seen[r] = 1;
+    }
+    while (head < count) {
+        int i = queue[head++];
+        out[head - 1] = table->entries[i].pid;
+        for (int c = first[i]; c >= 0; c = next[c]) {
+            if (!seen[c]) {
+                seen[c] = 1;
+                queue[count++] = c;
+            }
+        }
+    }
+
+    free(slots);
+    free(first);
+    free(next);
+    free(queue);
+    free(seen);
+    return count;
+}
+
+int proctable_match(const ProcTable *table, const char *pattern, int *out)
+{
+    int count = 0;
+    for (int i = 0; i < table->count; i++) {
+        if (fnmatch(pattern, table->entries[i].comm, 0) == 0)
+            out[count++] = table->entries[i].pid;
+    }
+    return count;
+}
+
+/* ── Test harness ───────────────────────────────────────────────────── */
+
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+static int cur_iter = 0;  /* Current iteration for CHECK context */
+
+#define CHECK(cond, fmt, ...)                                       \
+    do {                                                            \
+        tests_run++;                                                \
+        if (cond) {                                                 \
+            tests_passed++;                                         \
+        } else {                                                    \
+            tests_failed++;                                         \
+            fprintf(stderr, "  FAIL [iter=%d]: " fmt "\n",          \
+                    cur_iter, ##__VA_ARGS__);                        \
+        }                                                           \
+    } while (0)
+
+#define NUM_ITERATIONS 300
+#define MAX_ROWS       300
+
+static const char *names[] = {
+    "nginx", "nginx: worker", "sshd", "bash", "Bash", "sleep", "a?b", "kworker/0:1", "",
+};
+#define NUM_NAMES (int)(sizeof(names) / sizeof(names[0]))
+
+/*
+ * Tabla ordenada por PID: cada proceso cuelga de uno anterior, de uno que
+ * no está (ya terminó) o de 0. Con reuse, algunos padres se cambian por
+ * PIDs posteriores, que es lo que deja un PID reciclado: ciclos y
+ * procesos que son su propio padre.
+ */
+static void random_table(ProcTable *t, int n, int reuse)
+{
+    int pid = 0;
+
+    for (int i = 0; i < n; i++) {
+        ProcInfo *e = &t->entries[i];
+        pid += 1 + rand() % 3;
+        e->pid = pid;
+        int pick = rand() % 10;
+        if (i == 0 || pick == 0)
+            e->ppid = 0;
+        else if (pick == 1)
+            e->ppid = pid + 1000;                   /* Padre que ya no está */
+        else
+            e->ppid = t->entries[rand() % i].pid;
+        snprintf(e->comm, sizeof(e->comm), "%s", names[rand() % NUM_NAMES]);
+    }
+    t->count = n;
+
+    for (int k = 0; reuse && n > 0 && k < 1 + n / 20; k++) {
+        ProcInfo *e = &t->entries[rand() % n];
+        e->ppid = rand() % 4 == 0 ? e->pid : t->entries[rand() % n].pid;
+    }
+}
+
+static int find(const ProcTable *t, int pid)
+{
+    for (int i = 0; i < t->count; i++) {
+        if (t->entries[i].pid == pid)
+            return i;
+    }
+    return -1;
+}
+
+/* Referencia: agrega hijos hasta que no cambie nada. */
+static int reference_descendants(const ProcTable *t, int root, unsigned char *in)
+{
+    int count = 0;
+
+    memset(in, 0, (size_t)t->count);
+    int r = find(t, root);
+    if (r < 0)
+        return 0;
+    in[r] = 1;
+    count = 1;
+    for (int changed = 1; changed;) {
+        changed = 0;
+        for (int i = 0; i < t->count; i++) {
+            const ProcInfo *e = &t->entries[i];
+            int parent = e->ppid != e->pid ? find(t, e->ppid) : -1;
+            if (!in[i] && parent >= 0 && in[parent]) {
+                in[i] = 1;
+                count++;
+                changed = 1;
+            }
+        }
+    }
+    return count;
+}
+
+/* Property 16a: descendientes con ciclos y PIDs reciclados */
+static void test_descendants(ProcTable *t)
+{
+    int out[MAX_ROWS + 1];
+    unsigned char in[MAX_ROWS];
+
+    for (cur_iter = 0; cur_iter < NUM_ITERATIONS; cur_iter++) {
+        int n = rand() % (MAX_ROWS + 1);
+        random_table(t, n, cur_iter % 3 != 0);
+        int root = n > 0 && rand() % 8 != 0 ? t->entries[rand() % n].pid : 999999;
+
+        int count = proctable_descendants(t, root, out);
+        int expected = reference_descendants(t, root, in);
+
+        CHECK(count == expected, "raiz %d sobre %d filas: %d PIDs, esperados %d",
+              root, n, count, expected);
+        if (count <= 0)
+            continue;
+        CHECK(out[0] == root, "el primero es %d, no la raiz %d", out[0], root);
+
+        int ok = 1;
+        unsigned char seen[MAX_ROWS];
+        memset(seen, 0, sizeof(seen));
+        for (int k = 0; ok && k < count; k++) {
+            int i = find(t, out[k]);
+            ok = i >= 0 && in[i] && !seen[i];
+            if (!ok) {
+                CHECK(0, "PID %d repetido o fuera del arbol de %d", out[k], root);
+                break;
+            }
+            seen[i] = 1;
+            /* El padre ya salió, salvo para la raíz */
+            if (k > 0) {
+                int parent = find(t, t->entries[i].ppid);
+                ok = parent >= 0 && seen[parent];
+                CHECK(ok, "PID %d antes que su padre %d", out[k], t->entries[i].ppid);
+            }
+        }
+    }
+
+    /* Un ciclo puro: 2 -> 3 -> 4 -> 2, y 5 es su propio padre */
+    cur_iter = 0;
+    ProcInfo cycle[] = {
+        { 2, 4, "a" }, { 3, 2, "b" }, { 4, 3, "c" }, { 5, 5, "d" },
+    };
+    ProcTable ct = { cycle, 4, 4 };
+    CHECK(proctable_descendants(&ct, 3, out) == 3 && out[0] == 3 && out[1] == 4 && out[2] == 2,
+          "el ciclo 2-3-4 desde 3 no dio 3 4 2");
+    CHECK(proctable_descendants(&ct, 5, out) == 1 && out[0] == 5,
+          "un proceso que es su propio padre no dio solo a si mismo");
+}
+
+/* Glob de referencia: *, ? y [abc]/[a-z]/[!x], sin escapes. */
+static int glob_ref(const char *p, const char *s)
+{
+    if (*p == '\0')
+        return *s == '\0';
+    if (*p == '*')
+        return glob_ref(p + 1, s) || (*s && glob_ref(p, s + 1));
+    if (*s == '\0')
+        return 0;
+    if (*p == '?')
+        return glob_ref(p + 1, s + 1);
+    if (*p == '[') {
+        const char *q = p + 1;
+        int negate = *q == '!';
+        int hit = 0;
+        if (negate)
+            q++;
+        do {
+            if (q[1] == '-' && q[2] && q[2] != ']') {
+                hit |= *s >= q[0] && *s <= q[2];
+                q += 3;
+            } else {
+                hit |= *s == *q;
+                q++;
+            }
+        } while (*q && *q != ']');
+        return hit != negate && glob_ref(q + 1, s + 1);
+    }
+    return *p == *s && glob_ref(p + 1, s + 1);
+}
+
+/* Property 16b: --name con globs */
+static void test_match(ProcTable *t)
+{
+    static const char *patterns[] = {
+        "nginx", "nginx*", "*nginx*", "ngin?", "?ash", "[bB]ash", "[!b]ash", "*: *",
+        "kworker/*", "*", "?", "s*p", "a?b", "[a-c]*", "*[0-9]", "",
+    };
+    int out[MAX_ROWS + 1];
+
+    for (cur_iter = 0; cur_iter < NUM_ITERATIONS; cur_iter++) {
+        random_table(t, rand() % (MAX_ROWS + 1), 0);
+        const char *pattern = patterns[rand() % (int)(sizeof(patterns) / sizeof(patterns[0]))];
+
+        int count = proctable_match(t, pattern, out);
+        int k = 0, ok = 1;
+        for (int i = 0; i < t->count; i++) {
+            if (glob_ref(pattern, t->entries[i].comm))
+                ok &= k < count && out[k++] == t->entries[i].pid;
+        }
+        CHECK(ok && k == count, "'%s': %d PIDs, la referencia da %d", pattern, count, k);
+    }
+}
+
+int main(void)
+{
+    unsigned int seed = (unsigned int)time(NULL);
+    srand(seed);
+
+    printf("=== Property 16: Resolucion de PIDs para STOP en bloque ===\n");
+    printf("    Validates: Requirements 4.1\n");
+    printf("    Seed: %u\n\n", seed);
+
+    ProcTable table = { malloc(MAX_ROWS * sizeof(ProcInfo)), 0, MAX_ROWS };
+    test_descendants(&table);
+    test_match(&table);
+    free(table.entries);
+
+    printf("\nResults: %d/%d checks passed", tests_passed, tests_run);
+    if (tests_failed > 0) {
+        printf(" (%d failed)", tests_failed);
+    }
+    printf("\n");
+
+    if (tests_failed == 0) {
+        printf("PASS\n");
+        return 0;
+    } else {
+        printf("FAIL\n");
+        return 1;
+    }
+}
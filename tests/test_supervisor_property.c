@@ -0,0 +1,392 @@
+/**
+ * Property-based test for supervised jobs (Property 14).
+ *
+ * **Validates: Requirements 4.1**
+ *
+ * Property 14: Relanzamiento de trabajos supervisados
+ *   a) For any sequence of failures, each restart waits twice the previous
+ *      one (starting at SUPERVISOR_BACKOFF_MIN_MS, capped at
+ *      SUPERVISOR_BACKOFF_MAX_MS), and a run of at least
+ *      SUPERVISOR_STABLE_MS resets the wait.
+ *   b) A job that restarts SUPERVISOR_LOOP_RESTARTS times within
+ *      SUPERVISOR_LOOP_WINDOW_MS ends in crash loop on the next failure
+ *      and is not scheduled again; failures spread wider never loop.
+ *   c) The policy decides: never and on-failure with exit 0 end as done.
+ *   d) STOP marks a job only through supervisor_stopping: after it the
+ *      exit leaves the job stopped, also when the exit was recorded first
+ *      and the restart is already scheduled; other PIDs change nothing.
+ *
+ * The test embeds the state machine of src/server/supervisor.c with a
+ * fake clock: the timer wheel records the delay and spawning hands out
+ * fresh PIDs, so restarts happen when the test fires the timer.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/wait.h>
+
+/* ── Embedded constants (src/server/supervisor.h) ───────────────────── */
+
+#define SUPERVISOR_MAX_JOBS        4
+#define SUPERVISOR_BACKOFF_MIN_MS  500
+#define SUPERVISOR_BACKOFF_MAX_MS  30000
+#define SUPERVISOR_STABLE_MS       10000
+#define SUPERVISOR_LOOP_RESTARTS   5
+#define SUPERVISOR_LOOP_WINDOW_MS  60000
+
+#define RESTART_NEVER       0
+#define RESTART_ON_FAILURE  1
+#define RESTART_ALWAYS      2
+
+#define JOB_STARTING   0
+#define JOB_RUNNING    1
+#define JOB_BACKOFF    2
+#define JOB_STOPPED    3
+#define JOB_DONE       4
+#define JOB_CRASHLOOP  5
+
+/* ── Fakes: clock, timer wheel and spawner ──────────────────────────── */
+
+static long long fake_now;
+static int next_pid = 1000;
+
+static long long now_ms(void)
+{
+    return fake_now;
+}
+
+typedef struct {
+    void (*fn)(void *arg);
+    void *arg;
+    unsigned int delay;
+    int armed;
+} Timer;
+
+static void timerwheel_add(Timer *t, unsigned int delay, void (*fn)(void *), void *arg)
+{
+    t->fn = fn;
+    t->arg = arg;
+    t->delay = delay;
+    t->armed = 1;
+}
+
+/* ── Embedded state machine (src/server/supervisor.c) ───────────────── */
+
+typedef struct {
+    int id;
+    int state;
+    int policy;
+    pid_t pid;
+    pid_t last_pid;
+    int stopping;
+    unsigned long restarts;
+    long long started_ms;
+    long long restart_at_ms;
+    long long backoff_ms;
+    long long recent[SUPERVISOR_LOOP_RESTARTS];
+    int recent_next;
+    Timer timer;
+    int timer_armed;
+} SupervisedJob;
+
+static SupervisedJob table[SUPERVISOR_MAX_JOBS];
+
+static void restart_due(void *arg);
+
+static void job_ended(SupervisedJob *job, int failed, long long now)
+{
+    job->last_pid = job->pid;
+    job->pid = 0;
+
+    if (job->stopping) {
+        job->state = JOB_STOPPED;
+        return;
+    }
+    if (job->policy == RESTART_NEVER || (job->policy == RESTART_ON_FAILURE && !failed)) {
+        job->state = JOB_DONE;
+        return;
+    }
+
+    if (now - job->started_ms >= SUPERVISOR_STABLE_MS)
+        job->backoff_ms = SUPERVISOR_BACKOFF_MIN_MS;
+
+    long long oldest = job->recent[job->recent_next];
+    if (job->restarts >= SUPERVISOR_LOOP_RESTARTS &&
+        now - oldest <= SUPERVISOR_LOOP_WINDOW_MS) {
+        job->state = JOB_CRASHLOOP;
+        return;
+    }
+
+    job->state = JOB_BACKOFF;
+    job->restart_at_ms = now + job->backoff_ms;
+    job->timer_armed = 1;
+    timerwheel_add(&job->timer, (unsigned int)job->backoff_ms, restart_due, job);
+    job->backoff_ms *= 2;
+    if (job->backoff_ms > SUPERVISOR_BACKOFF_MAX_MS)
+        job->backoff_ms = SUPERVISOR_BACKOFF_MAX_MS;
+}
+
+/* job_spawn sin lanzar nada: un PID nuevo */
+static int job_spawn(SupervisedJob *job, pid_t *out_pid)
+{
+    job->pid = next_pid++;
+    job->state = JOB_RUNNING;
+    job->started_ms = now_ms();
+    *out_pid = job->pid;
+    return 0;
+}
+
+static void job_restart(void *arg)
+{
+    SupervisedJob *job = arg;
+    long long now = now_ms();
+
+    if (job->state != JOB_BACKOFF)
+        return;
+    job->state = JOB_STARTING;
+    job->restarts++;
+    job->recent[job->recent_next] = now;
+    job->recent_next = (job->recent_next + 1) % SUPERVISOR_LOOP_RESTARTS;
+
+    pid_t pid;
+    job_spawn(job, &pid);
+}
+
+static void restart_due(void *arg)
+{
+    SupervisedJob *job = arg;
+
+    job->timer_armed = 0;
+    if (job->state == JOB_BACKOFF)
+        job_restart(arg);
+}
+
+static void supervisor_launch(SupervisedJob *job, int policy)
+{
+    pid_t pid;
+
+    memset(job, 0, sizeof(*job));
+    job->id = 1;
+    job->state = JOB_STARTING;
+    job->policy = policy;
+    job->backoff_ms = SUPERVISOR_BACKOFF_MIN_MS;
+    job_spawn(job, &pid);
+}
+
+static void supervisor_exited(pid_t pid, int status)
+{
+    for (int i = 0; i < SUPERVISOR_MAX_JOBS; i++) {
+        SupervisedJob *job = &table[i];
+        if (job->id != 0 && job->state == JOB_RUNNING && job->pid == pid) {
+            job_ended(job, !WIFEXITED(status) || WEXITSTATUS(status) != 0, now_ms());
+            break;
+        }
+    }
+}
+
+static void supervisor_stopping(pid_t pid)
+{
+    for (int i = 0; i < SUPERVISOR_MAX_JOBS; i++) {
+        SupervisedJob *job = &table[i];
+        if (job->id == 0)
+            continue;
+        if (job->state == JOB_RUNNING && job->pid == pid) {
+            job->stopping = 1;
+            break;
+        }
+        if (job->state == JOB_BACKOFF && job->last_pid == pid) {
+            job->stopping = 1;
+            job->state = JOB_STOPPED;
+            break;
+        }
+    }
+}
+
+/* ── Test harness ───────────────────────────────────────────────────── */
+
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+static int cur_iter = 0;  /* Current iteration for CHECK context */
+
+#define CHECK(cond, fmt, ...)                                       \
+    do {                                                            \
+        tests_run++;                                                \
+        if (cond) {                                                 \
+            tests_passed++;                                         \
+        } else {                                                    \
+            tests_failed++;                                         \
+            fprintf(stderr, "  FAIL [iter=%d]: " fmt "\n",          \
+                    cur_iter, ##__VA_ARGS__);                        \
+        }                                                           \
+    } while (0)
+
+#define NUM_ITERATIONS 200
+
+#define EXIT_FAIL   (1 << 8)    /* Estado de waitpid: exit(1) */
+#define EXIT_OK     0
+#define KILLED_TERM SIGTERM     /* Estado de waitpid: muerto por SIGTERM */
+
+/* Vence la espera agendada, si hay una. */
+static void fire_timer(SupervisedJob *job)
+{
+    if (job->timer.armed) {
+        job->timer.armed = 0;
+        fake_now += job->timer.delay;
+        job->timer.fn(job->timer.arg);
+    }
+}
+
+/* Property 14a/14b: esperas y bucle de fallos contra un modelo propio */
+static void test_backoff_and_loop(void)
+{
+    for (cur_iter = 0; cur_iter < NUM_ITERATIONS; cur_iter++) {
+        SupervisedJob *job = &table[0];
+        fake_now = 1000000;
+        supervisor_launch(job, rand() % 2 ? RESTART_ALWAYS : RESTART_ON_FAILURE);
+
+        long long expect_wait = SUPERVISOR_BACKOFF_MIN_MS;
+        long long starts[64];
+        int nstarts = 0;
+        int steps = 1 + rand() % 40;
+
+        for (int s = 0; s < steps; s++) {
+            /* Corridas cortas o largas, para rachas y reinicios de la espera */
+            long long run = rand() % 4 == 0 ? SUPERVISOR_STABLE_MS + rand() % 70000
+                                            : rand() % 3000;
+            fake_now += run;
+            if (run >= SUPERVISOR_STABLE_MS)
+                expect_wait = SUPERVISOR_BACKOFF_MIN_MS;
+
+            int looping = nstarts >= SUPERVISOR_LOOP_RESTARTS &&
+                          fake_now - starts[nstarts - SUPERVISOR_LOOP_RESTARTS] <=
+                              SUPERVISOR_LOOP_WINDOW_MS;
+            supervisor_exited(job->pid, rand() % 2 ? EXIT_FAIL : KILLED_TERM);
+
+            if (looping) {
+                CHECK(job->state == JOB_CRASHLOOP && !job->timer.armed,
+                      "paso %d: %d relanzamientos en la ventana sin quedar en bucle (estado %d)",
+                      s, SUPERVISOR_LOOP_RESTARTS, job->state);
+                break;
+            }
+            CHECK(job->state == JOB_BACKOFF && job->timer.armed,
+                  "paso %d: fallo sin relanzamiento agendado (estado %d)", s, job->state);
+            CHECK(job->timer.delay == expect_wait, "paso %d: espera %u ms, esperada %lld",
+                  s, job->timer.delay, expect_wait);
+
+            expect_wait *= 2;
+            if (expect_wait > SUPERVISOR_BACKOFF_MAX_MS)
+                expect_wait = SUPERVISOR_BACKOFF_MAX_MS;
+            pid_t old = job->last_pid;
+            fire_timer(job);
+            starts[nstarts++] = fake_now;
+            CHECK(job->state == JOB_RUNNING && job->pid != old,
+                  "paso %d: no se relanzo con un PID nuevo", s);
+        }
+    }
+
+    /* Fallos espaciados más que la ventana: nunca hay bucle */
+    cur_iter = 0;
+    SupervisedJob *job = &table[0];
+    fake_now = 0;
+    supervisor_launch(job, RESTART_ALWAYS);
+    for (int s = 0; s < 50; s++) {
+        fake_now += SUPERVISOR_LOOP_WINDOW_MS / SUPERVISOR_LOOP_RESTARTS + 1000;
+        supervisor_exited(job->pid, EXIT_FAIL);
+        fire_timer(job);
+    }
+    CHECK(job->state == JOB_RUNNING && job->restarts == 50,
+          "fallos espaciados terminaron en estado %d tras %lu relanzamientos",
+          job->state, job->restarts);
+}
+
+/* Property 14c: políticas */
+static void test_policies(void)
+{
+    SupervisedJob *job = &table[0];
+
+    for (cur_iter = 0; cur_iter < NUM_ITERATIONS; cur_iter++) {
+        int policy = rand() % 3;
+        int status = rand() % 3 == 0 ? EXIT_OK : rand() % 2 ? EXIT_FAIL : KILLED_TERM;
+        fake_now = 5000;
+        supervisor_launch(job, policy);
+        supervisor_exited(job->pid, status);
+
+        int restart = policy == RESTART_ALWAYS ||
+                      (policy == RESTART_ON_FAILURE && status != EXIT_OK);
+        CHECK(job->state == (restart ? JOB_BACKOFF : JOB_DONE),
+              "politica %d con estado %#x quedo en %d", policy, status, job->state);
+    }
+}
+
+/* Property 14d: STOP */
+static void test_stopping(void)
+{
+    SupervisedJob *job = &table[0];
+
+    for (cur_iter = 0; cur_iter < NUM_ITERATIONS; cur_iter++) {
+        fake_now = 0;
+        supervisor_launch(job, RESTART_ALWAYS);
+        pid_t pid = job->pid;
+
+        /* Otro PID no toca al trabajo */
+        supervisor_stopping(pid + 1 + rand() % 100);
+        CHECK(job->state == JOB_RUNNING && !job->stopping, "STOP de otro PID marco el trabajo");
+
+        if (rand() % 2) {
+            /* La señal llega antes que la salida */
+            supervisor_stopping(pid);
+            supervisor_exited(pid, KILLED_TERM);
+            CHECK(job->state == JOB_STOPPED, "detenido y terminado quedo en %d", job->state);
+        } else {
+            /* La salida se anota antes que el aviso de STOP */
+            supervisor_exited(pid, KILLED_TERM);
+            CHECK(job->state == JOB_BACKOFF, "salida sin STOP quedo en %d", job->state);
+            supervisor_stopping(pid);
+            CHECK(job->state == JOB_STOPPED, "STOP tardio quedo en %d", job->state);
+        }
+        fire_timer(job);
+        CHECK(job->state == JOB_STOPPED && job->pid == 0,
+              "el trabajo detenido se relanzo (estado %d, PID %d)", job->state, job->pid);
+
+        /* Un aviso con el PID viejo después de relanzar no detiene al nuevo */
+        supervisor_launch(job, RESTART_ALWAYS);
+        pid = job->pid;
+        supervisor_exited(pid, EXIT_FAIL);
+        fire_timer(job);
+        supervisor_stopping(pid);
+        CHECK(job->state == JOB_RUNNING && !job->stopping,
+              "STOP del PID anterior detuvo al relanzado");
+    }
+}
+
+int main(void)
+{
+    unsigned int seed = (unsigned int)time(NULL);
+    srand(seed);
+
+    printf("=== Property 14: Relanzamiento de trabajos supervisados ===\n");
+    printf("    Validates: Requirements 4.1\n");
+    printf("    Seed: %u\n\n", seed);
+
+    test_backoff_and_loop();
+    test_policies();
+    test_stopping();
+
+    printf("\nResults: %d/%d checks passed", tests_passed, tests_run);
+    if (tests_failed > 0) {
+        printf(" (%d failed)", tests_failed);
+    }
+    printf("\n");
+
+    if (tests_failed == 0) {
+        printf("PASS\n");
+        return 0;
+    } else {
+        printf("FAIL\n");
+        return 1;
+    }
+}
@@ -0,0 +1,484 @@
+/**
+ * Property-based test for the timer wheel and STOP escalation (Property 15).
+ *
+ * **Validates: Requirements 4.1**
+ *
+ * Property 15: Rueda de temporizadores y escalado de STOP
+ *   a) For any set of timers (delays from 0 to more than one turn of the
+ *      wheel), each fires exactly once, in order of its expiry tick, never
+ *      before its delay minus one tick and not long after it.
+ *   b) A callback can schedule its own timer again, and the chain keeps
+ *      firing in order.
+ *   c) The wheel has no cancel: STOP "cancels" its SIGKILL by checking the
+ *      pidfd when the grace period ends. A process that exits within the
+ *      grace period is never sent SIGKILL and is counted as graceful; one
+ *      that ignores the signal gets SIGKILL after the grace period and is
+ *      reported through the on_kill hook.
+ *
+ * The test embeds src/server/timerwheel.c and the escalation path of
+ * src/server/stopper.c, and runs them on the real clock with real
+ * processes.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <poll.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+/* ── Embedded timer wheel (src/server/timerwheel.h, timerwheel.c) ───── */
+
+#define TIMERWHEEL_TICK_MS  10
+#define TIMERWHEEL_SLOTS    256
+
+typedef void (*TimerFn)(void *arg);
+
+typedef struct Timer {
+    unsigned long expires;
+    TimerFn fn;
+    void *arg;
+    struct Timer *next;
+} Timer;
+
+static pthread_mutex_t wheel_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t wheel_cond;
+static Timer *slots[TIMERWHEEL_SLOTS];
+static unsigned long current_tick;  /* Último tick procesado */
+static long long base_ms;           /* Momento del tick 0 */
+static int pending;
+
+static long long now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/* Tick correspondiente al reloj actual. */
+static unsigned long tick_now(void)
+{
+    return (unsigned long)((now_ms() - base_ms) / TIMERWHEEL_TICK_MS);
+}
+
+/*
+ * Procesa el slot del tick current_tick: saca los vencidos a `fired`.
+ * Los de vueltas posteriores de la rueda se quedan en el slot.
+ */
+static Timer *collect_expired(void)
+{
+    Timer **link = &slots[current_tick % TIMERWHEEL_SLOTS];
+    Timer *fired = NULL;
+
+    while (*link) {
+        Timer *t = *link;
+        if (t->expires <= current_tick) {
+            *link = t->next;
+            t->next = fired;
+            fired = t;
+            pending--;
+        } else {
+            link = &t->next;
+        }
+    }
+    return fired;
+}
+
+static void *wheel_main(void *unused)
+{
+    (void)unused;
+    pthread_mutex_lock(&wheel_lock);
+    for (;;) {
+        if (pending == 0) {
+            pthread_cond_wait(&wheel_cond, &wheel_lock);
+            continue;
+        }
+
+        long long deadline = base_ms + (long long)(current_tick + 1) * TIMERWHEEL_TICK_MS;
+        if (now_ms() < deadline) {
+            struct timespec ts = {
+                .tv_sec = deadline / 1000,
+                .tv_nsec = (deadline % 1000) * 1000000
+            };
+            pthread_cond_timedwait(&wheel_cond, &wheel_lock, &ts);
+            continue;
+        }
+
+        current_tick++;
+        Timer *fired = collect_expired();
+
+        /* Los callbacks corren sin el lock: pueden volver a agendar */
+        pthread_mutex_unlock(&wheel_lock);
+        while (fired) {
+            Timer *t = fired;
+            fired = t->next;
+            t->next = NULL;
+            t->fn(t->arg);
+        }
+        pthread_mutex_lock(&wheel_lock);
+    }
+    return NULL;
+}
+
+int timerwheel_start(void)
+{
+    pthread_condattr_t attr;
+    pthread_t tid;
+
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&wheel_cond, &attr);
+    pthread_condattr_destroy(&attr);
+    base_ms = now_ms();
+
+    if (pthread_create(&tid, NULL, wheel_main, NULL) != 0) {
+        perror("Could not create timer thread");
+        return -1;
+    }
+    pthread_detach(tid);
+    return 0;
+}
+
+void timerwheel_add(Timer *t, unsigned int delay_ms, TimerFn fn, void *arg)
+{
+    unsigned long ticks = (delay_ms + TIMERWHEEL_TICK_MS - 1) / TIMERWHEEL_TICK_MS;
+
+    pthread_mutex_lock(&wheel_lock);
+    /* Con la rueda vacía el hilo no avanzó los ticks: ponerla al día */
+    if (pending == 0)
+        current_tick = tick_now();
+    if (ticks == 0)
+        ticks = 1;
+
+    t->expires = current_tick + ticks;
+    t->fn = fn;
+    t->arg = arg;
+    t->next = slots[t->expires % TIMERWHEEL_SLOTS];
+    slots[t->expires % TIMERWHEEL_SLOTS] = t;
+    if (pending++ == 0)
+        pthread_cond_signal(&wheel_cond);
+    pthread_mutex_unlock(&wheel_lock);
+}
+
+int timerwheel_pending(void)
+{
+    pthread_mutex_lock(&wheel_lock);
+    int count = pending;
+    pthread_mutex_unlock(&wheel_lock);
+    return count;
+}
+
+/* ── Embedded escalation (src/server/stopper.c), sin grupos ─────────── */
+
+typedef struct {
+    Timer timer;
+    pid_t pid;
+    int pidfd;
+    unsigned int grace_ms;
+} Escalation;
+
+static unsigned long waiting, graceful, escalated;
+static void (*on_kill)(pid_t pid);
+
+static int sys_pidfd_open(pid_t pid)
+{
+    return (int)syscall(SYS_pidfd_open, pid, 0);
+}
+
+static int sys_pidfd_send_signal(int pidfd, int sig)
+{
+    return (int)syscall(SYS_pidfd_send_signal, pidfd, sig, NULL, 0);
+}
+
+static void escalate(void *arg)
+{
+    Escalation *e = arg;
+    struct pollfd pfd = { .fd = e->pidfd, .events = POLLIN };
+
+    if (poll(&pfd, 1, 0) == 1) {
+        __atomic_fetch_add(&graceful, 1, __ATOMIC_RELAXED);
+    } else if (sys_pidfd_send_signal(e->pidfd, SIGKILL) == 0) {
+        if (on_kill)
+            on_kill(e->pid);
+        __atomic_fetch_add(&escalated, 1, __ATOMIC_RELAXED);
+    } else {
+        __atomic_fetch_add(&graceful, 1, __ATOMIC_RELAXED);
+    }
+
+    __atomic_fetch_sub(&waiting, 1, __ATOMIC_RELAXED);
+    close(e->pidfd);
+    free(e);
+}
+
+static int stopper_signal(pid_t pid, int sig, unsigned int grace_ms)
+{
+    int pidfd = sys_pidfd_open(pid);
+    if (pidfd < 0)
+        return errno;
+
+    if (sys_pidfd_send_signal(pidfd, sig) < 0) {
+        int err = errno;
+        close(pidfd);
+        return err;
+    }
+    if (sig == SIGKILL || grace_ms == 0) {
+        close(pidfd);
+        return 0;
+    }
+
+    Escalation *e = malloc(sizeof(Escalation));
+    e->pid = pid;
+    e->pidfd = pidfd;
+    e->grace_ms = grace_ms;
+    __atomic_fetch_add(&waiting, 1, __ATOMIC_RELAXED);
+    timerwheel_add(&e->timer, grace_ms, escalate, e);
+    return 0;
+}
+
+/* ── Test harness ───────────────────────────────────────────────────── */
+
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+static int cur_iter = 0;  /* Current iteration for CHECK context */
+
+#define CHECK(cond, fmt, ...)                                       \
+    do {                                                            \
+        tests_run++;                                                \
+        if (cond) {                                                 \
+            tests_passed++;                                         \
+        } else {                                                    \
+            tests_failed++;                                         \
+            fprintf(stderr, "  FAIL [iter=%d]: " fmt "\n",          \
+                    cur_iter, ##__VA_ARGS__);                        \
+        }                                                           \
+    } while (0)
+
+#define NUM_ROUNDS   3
+#define ORDER_ROUNDS 1          /* Cada una dura más de una vuelta de la rueda */
+#define NUM_TIMERS   500
+#define MAX_DELAY    (TIMERWHEEL_TICK_MS * TIMERWHEEL_SLOTS + 400)
+#define LATE_MS      150        /* Holgura para el planificador */
+
+typedef struct {
+    Timer timer;
+    unsigned int delay;
+    long long added_ms;
+    long long fired_ms;
+    int fires;
+    int order;                  /* Posición en la que disparó */
+} Probe;
+
+static Probe probes[NUM_TIMERS];
+static int fired_count;
+
+static void probe_fired(void *arg)
+{
+    Probe *p = arg;
+    p->fired_ms = now_ms();
+    p->fires++;
+    p->order = __atomic_fetch_add(&fired_count, 1, __ATOMIC_RELAXED);
+}
+
+/* Espera a que disparen count temporizadores, con un tope. */
+static void wait_fired(int *counter, int count, int max_ms)
+{
+    for (int waited = 0; __atomic_load_n(counter, __ATOMIC_RELAXED) < count &&
+                         waited < max_ms; waited += 5)
+        usleep(5000);
+}
+
+/* Property 15a: orden y momento de disparo */
+static void test_firing_order(void)
+{
+    for (cur_iter = 0; cur_iter < ORDER_ROUNDS; cur_iter++) {
+        memset(probes, 0, sizeof(probes));
+        __atomic_store_n(&fired_count, 0, __ATOMIC_RELAXED);
+
+        for (int i = 0; i < NUM_TIMERS; i++) {
+            Probe *p = &probes[i];
+            /* Muchos en el mismo tick, y algunos más allá de una vuelta */
+            p->delay = rand() % 4 == 0 ? (unsigned int)(rand() % 5) * TIMERWHEEL_TICK_MS
+                                       : (unsigned int)(rand() % MAX_DELAY);
+            p->added_ms = now_ms();
+            timerwheel_add(&p->timer, p->delay, probe_fired, p);
+        }
+        wait_fired(&fired_count, NUM_TIMERS, MAX_DELAY + 2000);
+        usleep(50000);  /* Ninguno dispara dos veces */
+
+        CHECK(fired_count == NUM_TIMERS, "dispararon %d de %d", fired_count, NUM_TIMERS);
+        CHECK(timerwheel_pending() == 0, "quedan %d pendientes", timerwheel_pending());
+        for (int i = 0; i < NUM_TIMERS; i++) {
+            Probe *p = &probes[i];
+            long long elapsed = p->fired_ms - p->added_ms;
+            CHECK(p->fires == 1, "temporizador %d disparo %d veces", i, p->fires);
+            CHECK(elapsed >= (long long)p->delay - TIMERWHEEL_TICK_MS,
+                  "temporizador de %u ms disparo a los %lld ms", p->delay, elapsed);
+            CHECK(elapsed <= (long long)p->delay + LATE_MS,
+                  "temporizador de %u ms disparo tarde, a los %lld ms", p->delay, elapsed);
+        }
+        /* Un tick posterior nunca dispara antes que uno anterior */
+        for (int i = 0; i < NUM_TIMERS; i++) {
+            for (int j = 0; j < NUM_TIMERS; j++) {
+                if (probes[i].timer.expires < probes[j].timer.expires &&
+                    probes[i].order > probes[j].order) {
+                    CHECK(0, "tick %lu disparo despues del tick %lu",
+                          probes[i].timer.expires, probes[j].timer.expires);
+                    i = j = NUM_TIMERS;
+                }
+            }
+        }
+    }
+}
+
+/* Property 15b: un callback vuelve a agendar su temporizador */
+typedef struct {
+    Timer timer;
+    int left;
+    unsigned long last_expires;
+    int in_order;
+    int done;
+} Chain;
+
+static void chain_fired(void *arg)
+{
+    Chain *c = arg;
+    if (c->timer.expires <= c->last_expires)
+        c->in_order = 0;
+    c->last_expires = c->timer.expires;
+    if (--c->left > 0)
+        timerwheel_add(&c->timer, (unsigned int)(rand() % 30), chain_fired, c);
+    else
+        __atomic_store_n(&c->done, 1, __ATOMIC_RELAXED);
+}
+
+static void test_rearm(void)
+{
+    for (cur_iter = 0; cur_iter < NUM_ROUNDS; cur_iter++) {
+        Chain c = { .left = 20, .in_order = 1 };
+        timerwheel_add(&c.timer, 0, chain_fired, &c);
+        wait_fired(&c.done, 1, 3000);
+        CHECK(c.done && c.left == 0, "la cadena se corto con %d pendientes", c.left);
+        CHECK(c.in_order, "un temporizador reagendado disparo antes que el anterior");
+    }
+}
+
+/* Property 15c: el SIGKILL del plazo solo llega si el proceso sigue vivo */
+#define NUM_CHILDREN 8
+
+static pid_t killed[NUM_CHILDREN * NUM_ROUNDS];
+static int killed_count;
+
+static void note_kill(pid_t pid)
+{
+    killed[__atomic_fetch_add(&killed_count, 1, __ATOMIC_RELAXED)] = pid;
+}
+
+static int was_killed(pid_t pid)
+{
+    for (int i = 0; i < killed_count; i++) {
+        if (killed[i] == pid)
+            return 1;
+    }
+    return 0;
+}
+
+static void test_escalation(void)
+{
+    on_kill = note_kill;
+
+    for (cur_iter = 0; cur_iter < NUM_ROUNDS; cur_iter++) {
+        pid_t pids[NUM_CHILDREN];
+        int ignores[NUM_CHILDREN];
+        unsigned int grace[NUM_CHILDREN];
+        long long sent_ms[NUM_CHILDREN];
+        unsigned long base_graceful = graceful, base_escalated = escalated;
+        int expect_escalated = 0;
+
+        for (int i = 0; i < NUM_CHILDREN; i++) {
+            ignores[i] = rand() % 2;
+            grace[i] = 20 + rand() % 200;
+            expect_escalated += ignores[i];
+            pids[i] = fork();
+            if (pids[i] == 0) {
+                if (ignores[i])
+                    signal(SIGTERM, SIG_IGN);
+                for (;;)
+                    pause();
+            }
+        }
+        usleep(50000);  /* Que los hijos ya ignoren SIGTERM */
+
+        for (int i = 0; i < NUM_CHILDREN; i++) {
+            sent_ms[i] = now_ms();
+            CHECK(stopper_signal(pids[i], SIGTERM, grace[i]) == 0, "no se pudo senalar %d", pids[i]);
+        }
+        for (int i = 0; i < NUM_CHILDREN; i++) {
+            int status;
+            waitpid(pids[i], &status, 0);
+            long long elapsed = now_ms() - sent_ms[i];
+            int sig = WIFSIGNALED(status) ? WTERMSIG(status) : 0;
+
+            if (ignores[i]) {
+                CHECK(sig == SIGKILL, "hijo que ignora SIGTERM termino con senal %d", sig);
+                CHECK(elapsed >= (long long)grace[i] - TIMERWHEEL_TICK_MS,
+                      "SIGKILL a los %lld ms con plazo de %u ms", elapsed, grace[i]);
+            } else {
+                CHECK(sig == SIGTERM, "hijo termino con senal %d en vez de SIGTERM", sig);
+            }
+        }
+        /* Los plazos de los que terminaron solos vencen igual, sin señal */
+        for (int waited = 0; __atomic_load_n(&waiting, __ATOMIC_RELAXED) > 0 && waited < 2000;
+             waited += 5)
+            usleep(5000);
+        for (int i = 0; i < NUM_CHILDREN; i++) {
+            if (ignores[i])
+                CHECK(was_killed(pids[i]), "SIGKILL a %d sin aviso a on_kill", pids[i]);
+            else
+                CHECK(!was_killed(pids[i]), "SIGKILL avisado para %d, que termino en plazo", pids[i]);
+        }
+        CHECK(escalated - base_escalated == (unsigned long)expect_escalated,
+              "%lu escalados, esperados %d", escalated - base_escalated, expect_escalated);
+        CHECK(graceful - base_graceful == (unsigned long)(NUM_CHILDREN - expect_escalated),
+              "%lu en plazo, esperados %d", graceful - base_graceful,
+              NUM_CHILDREN - expect_escalated);
+    }
+}
+
+int main(void)
+{
+    unsigned int seed = (unsigned int)time(NULL);
+    srand(seed);
+
+    printf("=== Property 15: Rueda de temporizadores y escalado de STOP ===\n");
+    printf("    Validates: Requirements 4.1\n");
+    printf("    Seed: %u\n\n", seed);
+
+    if (timerwheel_start() != 0)
+        return 1;
+    test_firing_order();
+    test_rearm();
+    test_escalation();
+
+    printf("\nResults: %d/%d checks passed", tests_passed, tests_run);
+    if (tests_failed > 0) {
+        printf(" (%d failed)", tests_failed);
+    }
+    printf("\n");
+
+    if (tests_failed == 0) {
+        printf("PASS\n");
+        return 0;
+    } else {
+        printf("FAIL\n");
+        return 1;
+    }
+}
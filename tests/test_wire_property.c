@@ -0,0 +1,476 @@
+/**
+ * Property-based test for process_list_decode() (Property 7).
+ *
+ * **Validates: Requirements 4.1**
+ *
+ * Property 7: Tablas en binario (ENCODING BINARY)
+ *   - For any table encoded as the server does (src/server/wire.h), with
+ *     or without metrics, process_list_decode must recover every column
+ *     of every row, the generation, the offset and the total.
+ *   - Any truncated or corrupted buffer is rejected (or decoded without
+ *     reading out of bounds) and leaves the list empty on error.
+ *
+ * The test embeds the decode logic and a reference encoder directly to
+ * avoid linking against ncurses.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* ── Embedded types and decode logic (no ncurses dependency) ────────── */
+
+#define PROC_NAME_SIZE 256
+
+#define PROC_WIRE_MAGIC      "\0PSB"
+#define PROC_WIRE_MAGIC_LEN  4
+#define PROC_WIRE_VERSION    1
+#define PROC_WIRE_F_METRICS  0x01
+
+typedef struct {
+    int pid;
+    char name[PROC_NAME_SIZE];
+    int uid;
+    char state;
+    int threads;
+    long rss_kb;
+    int cpu_tenths;
+    time_t start_time;
+} ProcessEntry;
+
+typedef struct {
+    ProcessEntry *entries;
+    int count;
+    int capacity;
+    int has_metrics;
+} ProcessList;
+
+static void process_list_free(ProcessList *list)
+{
+    free(list->entries);
+    list->entries     = NULL;
+    list->count       = 0;
+    list->capacity    = 0;
+    list->has_metrics = 0;
+}
+
+/* Copia un nombre de proceso truncándolo a PROC_NAME_SIZE - 1. */
+static void copy_name(char *dst, const char *src, int len)
+{
+    if (len >= PROC_NAME_SIZE)
+        len = PROC_NAME_SIZE - 1;
+    if (len < 0)
+        len = 0;
+    memcpy(dst, src, (size_t)len);
+    dst[len] = '\0';
+}
+
+/* Lector de la codificación binaria: marca err al pasarse del final. */
+typedef struct {
+    const unsigned char *p;
+    const unsigned char *end;
+    int err;
+} WireReader;
+
+static unsigned long long wire_varint(WireReader *r)
+{
+    unsigned long long v = 0;
+    int shift = 0;
+
+    while (r->p < r->end && shift < 64) {
+        unsigned char b = *r->p++;
+        v |= (unsigned long long)(b & 0x7f) << shift;
+        if (!(b & 0x80))
+            return v;
+        shift += 7;
+    }
+    r->err = 1;
+    return 0;
+}
+
+static unsigned int wire_u32(WireReader *r)
+{
+    if (r->end - r->p < 4) {
+        r->err = 1;
+        return 0;
+    }
+    unsigned int v = ((unsigned int)r->p[0] << 24) | ((unsigned int)r->p[1] << 16) |
+                     ((unsigned int)r->p[2] << 8) | (unsigned int)r->p[3];
+    r->p += 4;
+    return v;
+}
+
+static int process_list_is_binary(const char *data, size_t len)
+{
+    return len >= PROC_WIRE_MAGIC_LEN && memcmp(data, PROC_WIRE_MAGIC, PROC_WIRE_MAGIC_LEN) == 0;
+}
+
+static int process_list_decode(const char *data, size_t len, ProcessList *list,
+                        unsigned long *generation, int *offset, int *total)
+{
+    WireReader r = { (const unsigned char *)data, (const unsigned char *)data + len, 0 };
+    const unsigned char **names = NULL;
+    int *name_lens = NULL;
+
+    list->entries     = NULL;
+    list->count       = 0;
+    list->capacity    = 0;
+    list->has_metrics = 0;
+
+    if (!process_list_is_binary(data, len) || len < PROC_WIRE_MAGIC_LEN + 2 ||
+        (unsigned char)data[PROC_WIRE_MAGIC_LEN] != PROC_WIRE_VERSION)
+        return -1;
+    r.p += PROC_WIRE_MAGIC_LEN + 1;
+    int flags = *r.p++;
+
+    *generation = (unsigned long)wire_varint(&r);
+    *offset     = (int)wire_varint(&r);
+    *total      = (int)wire_varint(&r);
+    unsigned long long count = wire_varint(&r);
+    unsigned long long nnames = wire_varint(&r);
+
+    /* Cada fila ocupa al menos 2 bytes y cada nombre 1: acota las reservas */
+    if (r.err || count > (size_t)(r.end - r.p) / 2 || nnames > (size_t)(r.end - r.p))
+        return -1;
+
+    names = malloc((size_t)(nnames + 1) * sizeof(*names));
+    name_lens = malloc((size_t)(nnames + 1) * sizeof(*name_lens));
+    list->entries = malloc((size_t)(count + 1) * sizeof(ProcessEntry));
+    if (!names || !name_lens || !list->entries)
+        goto fail;
+    list->capacity = (int)count + 1;
+
+    for (unsigned long long k = 0; k < nnames; k++) {
+        unsigned long long n = wire_varint(&r);
+        if (r.err || n > (size_t)(r.end - r.p))
+            goto fail;
+        names[k] = r.p;
+        name_lens[k] = (int)n;
+        r.p += n;
+    }
+
+    /* Columnas: PIDs como diferencias, luego el índice de cada nombre */
+    int pid = 0;
+    for (unsigned long long i = 0; i < count; i++) {
+        ProcessEntry *e = &list->entries[i];
+        pid += (int)wire_varint(&r);
+        e->pid = pid;
+        e->uid = -1;
+        e->state = 0;
+        e->threads = 0;
+        e->rss_kb = 0;
+        e->cpu_tenths = 0;
+        e->start_time = 0;
+    }
+    for (unsigned long long i = 0; i < count; i++) {
+        unsigned long long k = wire_varint(&r);
+        if (r.err || k >= nnames)
+            goto fail;
+        copy_name(list->entries[i].name, (const char *)names[k], name_lens[k]);
+    }
+
+    if (flags & PROC_WIRE_F_METRICS) {
+        if ((size_t)(r.end - r.p) < count * 21)
+            goto fail;
+        for (unsigned long long i = 0; i < count; i++) {
+            unsigned int uid = wire_u32(&r);
+            list->entries[i].uid = uid == 0xffffffffu ? -1 : (int)uid;
+        }
+        for (unsigned long long i = 0; i < count; i++)
+            list->entries[i].state = (char)*r.p++;
+        for (unsigned long long i = 0; i < count; i++)
+            list->entries[i].threads = (int)wire_u32(&r);
+        for (unsigned long long i = 0; i < count; i++)
+            list->entries[i].rss_kb = (long)wire_u32(&r);
+        for (unsigned long long i = 0; i < count; i++)
+            list->entries[i].cpu_tenths = (int)wire_u32(&r);
+        for (unsigned long long i = 0; i < count; i++)
+            list->entries[i].start_time = (time_t)wire_u32(&r);
+        list->has_metrics = 1;
+    }
+    if (r.err)
+        goto fail;
+
+    list->count = (int)count;
+    free(names);
+    free(name_lens);
+    return 0;
+
+fail:
+    free(names);
+    free(name_lens);
+    process_list_free(list);
+    return -1;
+}
+
+/* ── Reference encoder (same format as src/server/wire.c) ───────────── */
+
+static unsigned char *put_varint(unsigned char *p, unsigned long long v)
+{
+    while (v >= 0x80) {
+        *p++ = (unsigned char)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (unsigned char)v;
+    return p;
+}
+
+static unsigned char *put_u32(unsigned char *p, unsigned int v)
+{
+    p[0] = (unsigned char)(v >> 24);
+    p[1] = (unsigned char)(v >> 16);
+    p[2] = (unsigned char)(v >> 8);
+    p[3] = (unsigned char)v;
+    return p + 4;
+}
+
+/* Codifica rows en buf (tabla de nombres cuadrática: basta para el test). */
+static size_t encode(unsigned char *buf, const ProcessEntry *rows, int count,
+                     unsigned long gen, int offset, int total, int metrics)
+{
+    static int index[1024], first[1024];
+    int names = 0;
+    unsigned char *p = buf;
+
+    for (int i = 0; i < count; i++) {
+        int k = 0;
+        while (k < names && strcmp(rows[first[k]].name, rows[i].name) != 0)
+            k++;
+        if (k == names)
+            first[names++] = i;
+        index[i] = k;
+    }
+
+    memcpy(p, PROC_WIRE_MAGIC, PROC_WIRE_MAGIC_LEN);
+    p += PROC_WIRE_MAGIC_LEN;
+    *p++ = PROC_WIRE_VERSION;
+    *p++ = metrics ? PROC_WIRE_F_METRICS : 0;
+    p = put_varint(p, gen);
+    p = put_varint(p, (unsigned long long)offset);
+    p = put_varint(p, (unsigned long long)total);
+    p = put_varint(p, (unsigned long long)count);
+    p = put_varint(p, (unsigned long long)names);
+    for (int k = 0; k < names; k++) {
+        size_t n = strlen(rows[first[k]].name);
+        p = put_varint(p, n);
+        memcpy(p, rows[first[k]].name, n);
+        p += n;
+    }
+
+    int prev = 0;
+    for (int i = 0; i < count; i++) {
+        p = put_varint(p, (unsigned long long)(rows[i].pid - prev));
+        prev = rows[i].pid;
+    }
+    for (int i = 0; i < count; i++)
+        p = put_varint(p, (unsigned long long)index[i]);
+    if (metrics) {
+        for (int i = 0; i < count; i++)
+            p = put_u32(p, rows[i].uid < 0 ? 0xffffffffu : (unsigned int)rows[i].uid);
+        for (int i = 0; i < count; i++)
+            *p++ = (unsigned char)rows[i].state;
+        for (int i = 0; i < count; i++)
+            p = put_u32(p, (unsigned int)rows[i].threads);
+        for (int i = 0; i < count; i++)
+            p = put_u32(p, (unsigned int)rows[i].rss_kb);
+        for (int i = 0; i < count; i++)
+            p = put_u32(p, (unsigned int)rows[i].cpu_tenths);
+        for (int i = 0; i < count; i++)
+            p = put_u32(p, (unsigned int)rows[i].start_time);
+    }
+    return (size_t)(p - buf);
+}
+
+/* ── Test helpers ───────────────────────────────────────────────────── */
+
+static int tests_run    = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+static int cur_iter = 0;  /* Current iteration for CHECK context */
+
+#define CHECK(cond, fmt, ...)                                       \
+    do {                                                            \
+        tests_run++;                                                \
+        if (cond) {                                                 \
+            tests_passed++;                                         \
+        } else {                                                    \
+            tests_failed++;                                         \
+            fprintf(stderr, "  FAIL [iter=%d]: " fmt "\n",          \
+                    cur_iter, ##__VA_ARGS__);                        \
+        }                                                           \
+    } while (0)
+
+/* ── Random generators ──────────────────────────────────────────────── */
+
+#define MAX_ROWS 256
+#define NUM_ITERATIONS 200
+
+/* Random int in [lo, hi] inclusive */
+static int rand_range(int lo, int hi)
+{
+    return lo + rand() % (hi - lo + 1);
+}
+
+/* Nombres de un conjunto chico (se repiten) o al azar, a veces con espacios */
+static void rand_proc_name(char *buf)
+{
+    static const char *pool[] = { "bash", "sleep", "kworker/0:1-events", "nginx", "a b" };
+    static const char chars[] = "abcdefghijklmnopqrstuvwxyz0123456789/:-_ ";
+
+    if (rand() % 2) {
+        strcpy(buf, pool[rand() % 5]);
+        return;
+    }
+    int len = rand_range(0, 60);
+    for (int i = 0; i < len; i++)
+        buf[i] = chars[rand() % (int)(sizeof(chars) - 1)];
+    buf[len] = '\0';
+}
+
+static void random_rows(ProcessEntry *rows, int count, int metrics)
+{
+    static const char states[] = "RSDZTIX";
+    int pid = 0;
+
+    for (int i = 0; i < count; i++) {
+        ProcessEntry *e = &rows[i];
+        memset(e, 0, sizeof(*e));
+        pid += rand() % 4 ? 1 : rand_range(1, 100000);
+        e->pid = pid;
+        e->uid = -1;
+        if (metrics) {
+            e->uid        = rand_range(-1, 70000);
+            e->state      = states[rand() % 7];
+            e->threads    = rand_range(0, 5000);
+            e->rss_kb     = (long)rand_range(0, 1 << 30);
+            e->cpu_tenths = rand_range(0, 64000);
+            e->start_time = (time_t)rand_range(1000000000, 2000000000);
+        }
+        rand_proc_name(e->name);
+    }
+}
+
+/* ── Properties ─────────────────────────────────────────────────────── */
+
+static void test_roundtrip(void)
+{
+    static ProcessEntry rows[MAX_ROWS];
+    static unsigned char buf[MAX_ROWS * 128 + 128];
+
+    printf("  Property 7a: la tabla decodificada es la codificada\n");
+    for (cur_iter = 0; cur_iter < NUM_ITERATIONS; cur_iter++) {
+        int count = rand_range(0, MAX_ROWS);
+        int metrics = rand() % 2;
+        unsigned long gen = (unsigned long)rand_range(1, 1 << 30);
+        int offset = rand_range(0, 100000), total = offset + count + rand_range(0, 1000);
+
+        random_rows(rows, count, metrics);
+        size_t len = encode(buf, rows, count, gen, offset, total, metrics);
+
+        ProcessList list;
+        unsigned long got_gen;
+        int got_offset, got_total;
+        CHECK(process_list_decode((const char *)buf, len, &list, &got_gen,
+                                  &got_offset, &got_total) == 0, "decode failed");
+        CHECK(got_gen == gen && got_offset == offset && got_total == total,
+              "header %lu/%d/%d != %lu/%d/%d", got_gen, got_offset, got_total,
+              gen, offset, total);
+        CHECK(list.count == count, "count %d != %d", list.count, count);
+        CHECK(list.has_metrics == metrics, "has_metrics %d != %d", list.has_metrics, metrics);
+        for (int i = 0; i < count && i < list.count; i++) {
+            const ProcessEntry *a = &rows[i], *b = &list.entries[i];
+            CHECK(a->pid == b->pid && a->uid == b->uid && a->state == b->state &&
+                  a->threads == b->threads && a->rss_kb == b->rss_kb &&
+                  a->cpu_tenths == b->cpu_tenths && a->start_time == b->start_time,
+                  "row %d: columns differ (pid %d vs %d)", i, a->pid, b->pid);
+            CHECK(strcmp(a->name, b->name) == 0, "row %d: name '%s' != '%s'",
+                  i, b->name, a->name);
+        }
+        process_list_free(&list);
+    }
+}
+
+static void test_truncated_rejected(void)
+{
+    static ProcessEntry rows[32];
+    static unsigned char buf[32 * 128 + 128];
+
+    printf("  Property 7b: un buffer truncado se rechaza\n");
+    for (cur_iter = 0; cur_iter < NUM_ITERATIONS; cur_iter++) {
+        int count = rand_range(1, 32);
+        random_rows(rows, count, 1);
+        size_t len = encode(buf, rows, count, 7, 0, count, 1);
+
+        /* Copia exacta en el heap, así un acceso fuera de rango se nota con ASan */
+        for (size_t cut = 0; cut < len; cut++) {
+            unsigned char *copy = malloc(cut + 1);
+            memcpy(copy, buf, cut);
+            ProcessList list;
+            unsigned long gen;
+            int offset, total;
+            int res = process_list_decode((const char *)copy, cut, &list, &gen, &offset, &total);
+            CHECK(res == -1 && list.count == 0 && list.entries == NULL,
+                  "prefix of %zu/%zu bytes accepted", cut, len);
+            free(copy);
+        }
+    }
+}
+
+static void test_corrupted_bounded(void)
+{
+    static ProcessEntry rows[32];
+    static unsigned char buf[32 * 128 + 128];
+
+    printf("  Property 7c: bytes corruptos no rompen el decodificador\n");
+    for (cur_iter = 0; cur_iter < NUM_ITERATIONS * 10; cur_iter++) {
+        int count = rand_range(0, 32);
+        random_rows(rows, count, rand() % 2);
+        size_t len = encode(buf, rows, count, 7, 0, count, 1);
+
+        for (int k = rand_range(1, 4); k > 0; k--)
+            buf[rand_range(PROC_WIRE_MAGIC_LEN + 1, (int)len - 1 > PROC_WIRE_MAGIC_LEN + 1 ?
+                                                    (int)len - 1 : PROC_WIRE_MAGIC_LEN + 1)] =
+                (unsigned char)rand();
+
+        ProcessList list;
+        unsigned long gen;
+        int offset, total;
+        int res = process_list_decode((const char *)buf, len, &list, &gen, &offset, &total);
+        CHECK(res == 0 ? list.count >= 0 && list.count <= (int)len / 2
+                       : list.count == 0 && list.entries == NULL,
+              "res %d with count %d", res, list.count);
+        for (int i = 0; res == 0 && i < list.count; i++)
+            CHECK(strlen(list.entries[i].name) < PROC_NAME_SIZE, "row %d: name overflow", i);
+        process_list_free(&list);
+    }
+}
+
+int main(void)
+{
+    unsigned int seed = (unsigned int)time(NULL);
+    srand(seed);
+
+    printf("=== Property 7: Tablas en binario ===\n");
+    printf("    Validates: Requirements 4.1\n");
+    printf("    Seed: %u\n\n", seed);
+
+    test_roundtrip();
+    test_truncated_rejected();
+    test_corrupted_bounded();
+
+    printf("\nResults: %d/%d checks passed", tests_passed, tests_run);
+    if (tests_failed > 0) {
+        printf(" (%d failed)", tests_failed);
+    }
+    printf("\n");
+
+    if (tests_failed == 0) {
+        printf("PASS\n");
+        return 0;
+    } else {
+        printf("FAIL\n");
+        return 1;
+    }
+}